@@ -46,6 +46,7 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
     auto *p = pages_ + frame_id;
     //    assert(p->pin_count_ == 0);
     p->pin_count_ += 1;
+    TrackRecLSN(p);
     return p;
   }
   // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
@@ -65,7 +66,7 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
   auto *page = pages_ + frame_id;
   // 2.     If R is dirty, write it back to the disk.
   if (page->IsDirty()) {
-    disk_manager_->WritePage(page->GetPageId(), page->data_);
+    WritePageOut(page);
   }
   // 3.     Delete R from the page table and insert P.
   page_table_.erase(page->page_id_);
@@ -74,6 +75,8 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
   page->ResetMemory();
   page->page_id_ = page_id;
   page->pin_count_ = 1;
+  page->rec_lsn_ = INVALID_LSN;
+  TrackRecLSN(page);
   disk_manager_->ReadPage(page_id, page->data_);
   return page;
 }
@@ -92,6 +95,9 @@ bool BufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
   assert(page->pin_count_ > 0);
   page->pin_count_ -= 1;
   page->is_dirty_ |= is_dirty;
+  if (page->pin_count_ == 0 && !page->is_dirty_) {
+    page->rec_lsn_ = INVALID_LSN;
+  }
   replacer_->Unpin(res->second);
   return true;
 }
@@ -104,8 +110,7 @@ bool BufferPoolManager::FlushPageImpl(page_id_t page_id) {
     return false;
   }
   auto frame_id = find_res->second;
-  auto *page = pages_ + frame_id;
-  disk_manager_->WritePage(page_id, page->data_);
+  WritePageOut(pages_ + frame_id);
   return true;
 }
 
@@ -145,6 +150,8 @@ Page *BufferPoolManager::NewPageImpl(page_id_t *page_id) {
   page->ResetMemory();
   page->pin_count_ = 1;
   page->page_id_ = *page_id;
+  page->rec_lsn_ = INVALID_LSN;
+  TrackRecLSN(page);
   page_table_.insert(std::pair<page_id_t, frame_id_t>(*page_id, frame_id));
   // 4.   Set the page ID output parameter. Return a pointer to P.
   return page;
@@ -166,10 +173,15 @@ bool BufferPoolManager::DeletePageImpl(page_id_t page_id) {
     return false;
   }
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
+  //      The frame must also leave the replacer, otherwise it could be handed out twice.
+  replacer_->Pin(find_res->second);
   free_list_.push_back(find_res->second);
   page_table_.erase(page_id);
   page->ResetMemory();
-  return false;
+  page->page_id_ = INVALID_PAGE_ID;
+  page->is_dirty_ = false;
+  page->rec_lsn_ = INVALID_LSN;
+  return true;
 }
 
 void BufferPoolManager::FlushAllPagesImpl() {
@@ -178,10 +190,45 @@ void BufferPoolManager::FlushAllPagesImpl() {
     auto &p = pages_[i];
     assert(p.GetPinCount() == 0);
     if (p.IsDirty()) {
-      disk_manager_->WritePage(p.GetPageId(), p.data_);
+      WritePageOut(&p);
     }
   }
   // You can do it!
 }
 
+std::vector<std::pair<page_id_t, lsn_t>> BufferPoolManager::GetDirtyPageTable() {
+  std::lock_guard<std::recursive_mutex> guard(latch_);
+  std::vector<std::pair<page_id_t, lsn_t>> dirty_page_table;
+  for (size_t i = 0; i < pool_size_; ++i) {
+    auto &p = pages_[i];
+    // A pinned page may be modified at any moment, so it counts as dirty from the time it was pinned.
+    if (p.page_id_ != INVALID_PAGE_ID && p.rec_lsn_ != INVALID_LSN && (p.is_dirty_ || p.pin_count_ > 0)) {
+      dirty_page_table.emplace_back(p.page_id_, p.rec_lsn_);
+    }
+  }
+  return dirty_page_table;
+}
+
+void BufferPoolManager::WritePageOut(Page *page) {
+  FlushLogForPage(page);
+  disk_manager_->WritePage(page->page_id_, page->data_);
+  page->is_dirty_ = false;
+  page->rec_lsn_ = INVALID_LSN;
+  // Whoever still has the page pinned may modify it again with any LSN from now on.
+  TrackRecLSN(page);
+}
+
+void BufferPoolManager::TrackRecLSN(Page *page) {
+  if (page->rec_lsn_ == INVALID_LSN && page->pin_count_ > 0 && log_manager_ != nullptr) {
+    page->rec_lsn_ = log_manager_->GetNextLSN();
+  }
+}
+
+void BufferPoolManager::FlushLogForPage(Page *page) {
+  // Write-ahead logging: the log records describing the page must be durable before the page itself.
+  if (enable_logging && log_manager_ != nullptr && page->GetLSN() > log_manager_->GetPersistentLSN()) {
+    log_manager_->Flush(page->GetLSN());
+  }
+}
+
 }  // namespace bustub
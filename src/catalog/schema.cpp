@@ -18,8 +18,12 @@
 
 namespace bustub {
 
-Schema::Schema(const std::vector<Column> &columns) : tuple_is_inlined_(true) {
-  uint32_t curr_offset = 0;
+Schema::Schema(const std::vector<Column> &columns, TupleFormat format)
+    : format_(format),
+      null_bitmap_size_(format == TupleFormat::PLAIN ? 0 : (static_cast<uint32_t>(columns.size()) + 7) / 8),
+      tuple_is_inlined_(true) {
+  // The columns follow the null bitmap. In a COMPACT tuple this is where they are if no column before them is null.
+  uint32_t curr_offset = null_bitmap_size_;
   for (uint32_t index = 0; index < columns.size(); index++) {
     Column column = columns[index];
     // handle uninlined column
@@ -0,0 +1,38 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena.cpp
+//
+// Identification: src/common/arena.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/arena.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+char *Arena::Allocate(size_t size) {
+  size = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  // Chunks kept by Reset() are reused in order, skipping those too small for this allocation.
+  for (; chunk_idx_ < chunks_.size(); chunk_idx_++, offset_ = 0) {
+    Chunk &chunk = chunks_[chunk_idx_];
+    if (offset_ + size <= chunk.size_) {
+      char *data = chunk.data_.get() + offset_;
+      offset_ += size;
+      return data;
+    }
+  }
+  size_t chunk_size = std::max(chunk_size_, size);
+  chunks_.push_back(Chunk{std::make_unique<char[]>(chunk_size), chunk_size});
+  memory_usage_ += chunk_size;
+  chunk_idx_ = chunks_.size() - 1;
+  offset_ = size;
+  return chunks_.back().data_.get();
+}
+
+}  // namespace bustub
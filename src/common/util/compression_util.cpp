@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compression_util.cpp
+//
+// Identification: src/common/util/compression_util.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/compression_util.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace bustub {
+
+namespace {
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 12;
+constexpr size_t NO_POSITION = SIZE_MAX;
+
+inline uint32_t Read32(const char *p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline uint32_t HashSequence(uint32_t sequence) { return (sequence * 2654435761U) >> (32 - HASH_BITS); }
+
+/** Writes the part of a length that does not fit into its token nibble. */
+inline void WriteLength(char **out, size_t length) {
+  while (length >= 255) {
+    *(*out)++ = static_cast<char>(255);
+    length -= 255;
+  }
+  *(*out)++ = static_cast<char>(length);
+}
+
+inline bool ReadLength(const char **in, const char *end, size_t *length) {
+  uint8_t byte;
+  do {
+    if (*in == end) {
+      return false;
+    }
+    byte = static_cast<uint8_t>(*(*in)++);
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+void WriteSequence(char **out, const char *literals, size_t num_literals, size_t offset, size_t match_length) {
+  size_t extra_match = match_length == 0 ? 0 : match_length - MIN_MATCH;
+  char *token = (*out)++;
+  *token = static_cast<char>((std::min<size_t>(num_literals, 15) << 4) | std::min<size_t>(extra_match, 15));
+  if (num_literals >= 15) {
+    WriteLength(out, num_literals - 15);
+  }
+  memcpy(*out, literals, num_literals);
+  *out += num_literals;
+  if (match_length == 0) {
+    return;
+  }
+  *(*out)++ = static_cast<char>(offset & 0xff);
+  *(*out)++ = static_cast<char>(offset >> 8);
+  if (extra_match >= 15) {
+    WriteLength(out, extra_match - 15);
+  }
+}
+
+}  // namespace
+
+size_t CompressionUtil::Compress(const char *src, size_t size, char *dst) {
+  std::vector<size_t> last_position(1 << HASH_BITS, NO_POSITION);
+  char *out = dst;
+  size_t anchor = 0;
+  size_t pos = 0;
+  while (pos + MIN_MATCH <= size) {
+    uint32_t sequence = Read32(src + pos);
+    size_t &candidate = last_position[HashSequence(sequence)];
+    size_t match = candidate;
+    candidate = pos;
+    if (match == NO_POSITION || pos - match > MAX_OFFSET || Read32(src + match) != sequence) {
+      pos++;
+      continue;
+    }
+    size_t match_length = MIN_MATCH;
+    while (pos + match_length < size && src[match + match_length] == src[pos + match_length]) {
+      match_length++;
+    }
+    WriteSequence(&out, src + anchor, pos - anchor, pos - match, match_length);
+    pos += match_length;
+    anchor = pos;
+  }
+  WriteSequence(&out, src + anchor, size - anchor, 0, 0);
+  return out - dst;
+}
+
+bool CompressionUtil::Decompress(const char *src, size_t size, char *dst, size_t raw_size) {
+  const char *in = src;
+  const char *in_end = src + size;
+  size_t pos = 0;
+  while (in < in_end) {
+    auto token = static_cast<uint8_t>(*in++);
+    size_t num_literals = token >> 4;
+    if (num_literals == 15 && !ReadLength(&in, in_end, &num_literals)) {
+      return false;
+    }
+    if (num_literals > static_cast<size_t>(in_end - in) || num_literals > raw_size - pos) {
+      return false;
+    }
+    memcpy(dst + pos, in, num_literals);
+    in += num_literals;
+    pos += num_literals;
+    if (in == in_end) {
+      break;
+    }
+
+    if (in_end - in < 2) {
+      return false;
+    }
+    size_t offset = static_cast<uint8_t>(in[0]) | (static_cast<size_t>(static_cast<uint8_t>(in[1])) << 8);
+    in += 2;
+    size_t match_length = token & 0xf;
+    if (match_length == 15 && !ReadLength(&in, in_end, &match_length)) {
+      return false;
+    }
+    match_length += MIN_MATCH;
+    if (offset == 0 || offset > pos || match_length > raw_size - pos) {
+      return false;
+    }
+    // The match may overlap the bytes it produces, so copy byte by byte.
+    for (size_t i = 0; i < match_length; i++, pos++) {
+      dst[pos] = dst[pos - offset];
+    }
+  }
+  return pos == raw_size;
+}
+
+}  // namespace bustub
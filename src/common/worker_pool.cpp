@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// worker_pool.cpp
+//
+// Identification: src/common/worker_pool.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/worker_pool.h"
+
+#include <utility>
+
+namespace bustub {
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    shutdown_ = true;
+  }
+  has_task_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+std::future<void> WorkerPool::Submit(std::function<void()> &&task) {
+  std::packaged_task<void()> packaged_task(std::move(task));
+  std::future<void> future = packaged_task.get_future();
+  std::lock_guard<std::mutex> guard(latch_);
+  tasks_.push_back(std::move(packaged_task));
+  // Every queued task needs an idle thread to pick it up.
+  if (idle_count_ < tasks_.size()) {
+    threads_.emplace_back([this] { WorkerLoop(); });
+  } else {
+    has_task_.notify_one();
+  }
+  return future;
+}
+
+size_t WorkerPool::GetThreadCount() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return threads_.size();
+}
+
+void WorkerPool::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    idle_count_++;
+    has_task_.wait(lock, [this] { return shutdown_ || !tasks_.empty(); });
+    idle_count_--;
+    if (tasks_.empty()) {
+      return;
+    }
+    std::packaged_task<void()> task = std::move(tasks_.front());
+    tasks_.pop_front();
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
+
+}  // namespace bustub
@@ -30,6 +30,11 @@ Transaction *TransactionManager::Begin(Transaction *txn, IsolationLevel isolatio
     txn = new Transaction(next_txn_id_++, isolation_level);
   }
 
+  if (enable_logging) {
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::BEGIN);
+    txn->SetPrevLSN(log_manager_->AppendLogRecord(&log_record));
+  }
+
   txn_map[txn->GetTransactionId()] = txn;
   return txn;
 }
@@ -50,6 +55,14 @@ void TransactionManager::Commit(Transaction *txn) {
   }
   write_set->clear();
 
+  if (enable_logging) {
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::COMMIT);
+    lsn_t lsn = log_manager_->AppendLogRecord(&log_record);
+    txn->SetPrevLSN(lsn);
+    // The commit is only durable once its record is on disk. Concurrent committers share the same log write.
+    log_manager_->Flush(lsn);
+  }
+
   // Release all the locks.
   ReleaseLocks(txn);
   // Release the global transaction latch.
@@ -100,6 +113,11 @@ void TransactionManager::Abort(Transaction *txn) {
   table_write_set->clear();
   index_write_set->clear();
 
+  if (enable_logging) {
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::ABORT);
+    txn->SetPrevLSN(log_manager_->AppendLogRecord(&log_record));
+  }
+
   // Release all the locks.
   ReleaseLocks(txn);
   // Release the global transaction latch.
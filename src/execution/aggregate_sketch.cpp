@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregate_sketch.cpp
+//
+// Identification: src/execution/aggregate_sketch.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/aggregate_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace bustub {
+
+void HyperLogLog::Add(uint64_t hash) {
+  if (!registers_.empty()) {
+    AddToRegisters(hash);
+    return;
+  }
+  if (std::find(sparse_.begin(), sparse_.end(), hash) != sparse_.end()) {
+    return;
+  }
+  if (sparse_.size() < SPARSE_LIMIT) {
+    sparse_.push_back(hash);
+    return;
+  }
+  registers_.assign(REGISTER_COUNT, 0);
+  for (uint64_t sparse_hash : sparse_) {
+    AddToRegisters(sparse_hash);
+  }
+  std::vector<uint64_t>().swap(sparse_);
+  AddToRegisters(hash);
+}
+
+void HyperLogLog::AddToRegisters(uint64_t hash) {
+  // The top bits pick the register, the others are where the leading zeros are counted.
+  uint64_t idx = hash >> (64 - PRECISION);
+  uint64_t rest = hash << PRECISION;
+  auto rank = static_cast<uint8_t>(rest == 0 ? 64 - PRECISION + 1 : __builtin_clzll(rest) + 1);
+  registers_[idx] = std::max(registers_[idx], rank);
+}
+
+uint64_t HyperLogLog::Estimate() const {
+  if (registers_.empty()) {
+    return sparse_.size();
+  }
+  double m = REGISTER_COUNT;
+  double sum = 0;
+  uint32_t zeros = 0;
+  for (uint8_t rank : registers_) {
+    sum += std::ldexp(1.0, -rank);
+    zeros += rank == 0 ? 1 : 0;
+  }
+  double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+  // Small cardinalities are counted better by the registers still empty. 64-bit hashes need no large range correction.
+  if (estimate <= 2.5 * m && zeros > 0) {
+    estimate = m * std::log(m / zeros);
+  }
+  return static_cast<uint64_t>(std::llround(estimate));
+}
+
+void KllSketch::Add(double value) {
+  if (levels_.empty()) {
+    AddLevel();
+  }
+  levels_[0].push_back(value);
+  size_++;
+  if (size_ >= capacity_) {
+    Compress();
+  }
+}
+
+void KllSketch::AddLevel() {
+  levels_.emplace_back();
+  capacity_ = 0;
+  for (size_t level = 0; level < levels_.size(); level++) {
+    capacity_ += Capacity(level);
+  }
+}
+
+size_t KllSketch::Capacity(size_t level) const {
+  size_t depth = levels_.size() - 1 - level;
+  return std::max<size_t>(2, static_cast<size_t>(std::ceil(k_ * std::pow(2.0 / 3.0, depth))));
+}
+
+void KllSketch::Compress() {
+  for (size_t level = 0; level < levels_.size(); level++) {
+    if (levels_[level].size() < Capacity(level)) {
+      continue;
+    }
+    if (level + 1 == levels_.size()) {
+      AddLevel();
+    }
+    std::vector<double> &values = levels_[level];
+    std::sort(values.begin(), values.end());
+    // An odd value out stays behind, the others are halved into the next level.
+    std::vector<double> kept;
+    if (values.size() % 2 == 1) {
+      kept.push_back(values.back());
+      values.pop_back();
+    }
+    random_ ^= random_ << 13;
+    random_ ^= random_ >> 7;
+    random_ ^= random_ << 17;
+    size_t offset = random_ & 1;
+    std::vector<double> &next = levels_[level + 1];
+    for (size_t i = offset; i < values.size(); i += 2) {
+      next.push_back(values[i]);
+    }
+    size_ -= values.size() / 2;
+    values = std::move(kept);
+    return;
+  }
+}
+
+double KllSketch::Quantile(double fraction) const {
+  std::vector<std::pair<double, uint64_t>> weighted;
+  uint64_t total = 0;
+  for (size_t level = 0; level < levels_.size(); level++) {
+    for (double value : levels_[level]) {
+      weighted.emplace_back(value, uint64_t{1} << level);
+      total += uint64_t{1} << level;
+    }
+  }
+  std::sort(weighted.begin(), weighted.end());
+  double target = std::clamp(fraction, 0.0, 1.0) * total;
+  uint64_t rank = 0;
+  for (const auto &[value, weight] : weighted) {
+    rank += weight;
+    if (rank >= target) {
+      return value;
+    }
+  }
+  return weighted.back().first;
+}
+
+}  // namespace bustub
@@ -10,32 +10,67 @@
 //
 //===----------------------------------------------------------------------===//
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "execution/executors/aggregation_executor.h"
 
+#include "common/exception.h"
+#include "common/util/hash_util.h"
+
 namespace bustub {
 
 AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
                                          std::unique_ptr<AbstractExecutor> &&child)
-    : AbstractExecutor(exec_ctx), plan_(plan), child_(std::move(child)) {
-  //  const Schema *schema = plan_->OutputSchema();
-  //  plan->GetAggregates()
-
-  //  std::vector<const AbstractExpression *> aggExp;
-  //  for (auto it = schema->GetColumns().begin(); it != schema->GetColumns().end(); ++it) {
-  //    const Column &column = *it;
-  //    const AggregateValueExpression *exp = (const AggregateValueExpression *)(column.GetExpr());
-  //    if (!exp->isGroupByTerm()) {
-  //      aggExp.push_back(exp);
-  //    }
-  //  }
-  aht_ = new SimpleAggregationHashTable(plan->GetAggregates(), plan->GetAggregateTypes());
-}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_(std::move(child)),
+      aht_(plan->GetAggregateTypes(), plan->GetPercentiles()),
+      aht_iterator_(aht_.End()) {}
 
 const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return child_.get(); }
 
 void AggregationExecutor::Init() {
+  child_->Init();
+  CompilePrograms();
+  aht_.Clear();
+  level_ = 0;
+  runs_.clear();
+  pending_.clear();
+  spill_schema_.reset();
+  spilled_run_count_ = 0;
+  if (ConsumesBatches()) {
+    VectorBatch batch;
+    std::vector<ColumnVector> group_by_vectors(plan_->GetGroupBys().size());
+    std::vector<ColumnVector> aggregate_vectors(plan_->GetAggregates().size());
+    while (child_->NextBatch(&batch)) {
+      for (size_t i = 0; i < group_by_vectors.size(); ++i) {
+        plan_->GetGroupByAt(i)->EvaluateBatch(batch, &group_by_vectors[i]);
+      }
+      for (size_t i = 0; i < aggregate_vectors.size(); ++i) {
+        plan_->GetAggregateAt(i)->EvaluateBatch(batch, &aggregate_vectors[i]);
+      }
+      if (runs_.empty()) {
+        aht_.InsertCombineBatch(group_by_vectors, aggregate_vectors, batch.GetSize());
+        CheckMemory();
+        continue;
+      }
+      std::vector<Value> groupby(group_by_vectors.size());
+      std::vector<Value> agg(aggregate_vectors.size());
+      for (size_t row = 0; row < batch.GetSize(); ++row) {
+        for (size_t i = 0; i < groupby.size(); ++i) {
+          groupby[i] = group_by_vectors[i].GetValue(row);
+        }
+        for (size_t i = 0; i < agg.size(); ++i) {
+          agg[i] = aggregate_vectors[i].GetValue(row);
+        }
+        Consume(groupby, agg);
+      }
+    }
+    FinishPass();
+    aht_iterator_ = aht_.Begin();
+    return;
+  }
   while (true) {
     Tuple inputTuple;
     RID inputRid;
@@ -46,45 +81,178 @@ void AggregationExecutor::Init() {
     std::vector<Value> agg;
     std::vector<Value> groupby;
     for (size_t i = 0; i < plan_->GetGroupBys().size(); ++i) {
-      groupby.push_back(plan_->GetGroupByAt(i)->Evaluate(&inputTuple, child_->GetOutputSchema()));
+      groupby.push_back(group_by_programs_[i].IsCompiled()
+                            ? group_by_programs_[i].Evaluate(&inputTuple)
+                            : plan_->GetGroupByAt(i)->Evaluate(&inputTuple, child_->GetOutputSchema()));
     }
     for (size_t i = 0; i < plan_->GetAggregates().size(); ++i) {
-      agg.push_back(plan_->GetAggregateAt(i)->Evaluate(&inputTuple, child_->GetOutputSchema()));
+      agg.push_back(aggregate_programs_[i].IsCompiled()
+                        ? aggregate_programs_[i].Evaluate(&inputTuple)
+                        : plan_->GetAggregateAt(i)->Evaluate(&inputTuple, child_->GetOutputSchema()));
     }
-    auto ak = AggregateKey();
-    ak.group_bys_ = groupby;
-    auto av = AggregateValue();
-    av.aggregates_ = agg;
-    aht_->InsertCombine(ak, av);
+    Consume(groupby, agg);
   }
-  aht_iterator_ = new SimpleAggregationHashTable::Iterator(aht_->Begin());
+  FinishPass();
+  aht_iterator_ = aht_.Begin();
 }
 
 bool AggregationExecutor::Next(Tuple *tuple, RID *rid) {
-  bool res = false;
-  while (*aht_iterator_ != aht_->End()) {
-    auto &key = aht_iterator_->Key().group_bys_;
-    auto &value = aht_iterator_->Val().aggregates_;
-    //    Tuple valueTuple(value, child_->GetOutputSchema());
-    if (plan_->GetHaving() == nullptr || plan_->GetHaving()->EvaluateAggregate(key, value).GetAs<bool>()) {
-      //            const Schema *outputSchema = plan_->OutputSchema();
-      std::vector<Value> values;
-      for (auto it = plan_->OutputSchema()->GetColumns().begin(); it != plan_->OutputSchema()->GetColumns().end();
-           ++it) {
-        values.push_back(it->GetExpr()->EvaluateAggregate(key, value));
+  std::vector<Value> values;
+  if (!NextGroup(&values)) {
+    return false;
+  }
+  *tuple = Tuple(values, plan_->OutputSchema());
+  return true;
+}
+
+bool AggregationExecutor::NextBatch(VectorBatch *batch) {
+  batch->Reset(plan_->OutputSchema());
+  std::vector<Value> values;
+  while (batch->GetSize() < VECTOR_SIZE && NextGroup(&values)) {
+    for (uint32_t i = 0; i < values.size(); ++i) {
+      batch->GetColumn(i).Append(values[i]);
+    }
+    batch->SetSize(batch->GetSize() + 1);
+  }
+  return batch->GetSize() > 0;
+}
+
+bool AggregationExecutor::SupportsBatch() { return exec_ctx_->IsVectorized() && ConsumesBatches(); }
+
+bool AggregationExecutor::ConsumesBatches() {
+  if (!child_->SupportsBatch()) {
+    return false;
+  }
+  for (const auto *expr : plan_->GetGroupBys()) {
+    if (!expr->SupportsBatch()) {
+      return false;
+    }
+  }
+  for (const auto *expr : plan_->GetAggregates()) {
+    if (!expr->SupportsBatch()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AggregationExecutor::NextGroup(std::vector<Value> *values) {
+  while (aht_iterator_ != aht_.End() || StartNextPass()) {
+    AggregateKey agg_key = aht_iterator_.Key();
+    AggregateValue agg_value = aht_iterator_.Val();
+    const auto &key = agg_key.group_bys_;
+    const auto &value = agg_value.aggregates_;
+    const AbstractExpression *having = plan_->GetHaving();
+    bool matches = having == nullptr;
+    if (!matches) {
+      matches = having_program_.IsCompiled() ? having_program_.MatchesAggregate(key, value)
+                                             : having->EvaluateAggregate(key, value).GetAs<bool>();
+    }
+    if (matches) {
+      values->clear();
+      for (const auto &column : plan_->OutputSchema()->GetColumns()) {
+        // An aggregate has the type of its input, which may differ from the type of its output column.
+        Value result = column.GetExpr()->EvaluateAggregate(key, value);
+        values->push_back(result.GetTypeId() == column.GetType() ? result : result.CastAs(column.GetType()));
       }
-      *tuple = Tuple(values, plan_->OutputSchema());
-      res = true;
-      aht_iterator_->operator++();
-      break;
     }
-    aht_iterator_->operator++();
+    ++aht_iterator_;
+    if (matches) {
+      return true;
+    }
   }
-  return res;
+  return false;
 }
-AggregationExecutor::~AggregationExecutor() {
-  delete aht_;
-  delete aht_iterator_;
+
+void AggregationExecutor::Consume(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) {
+  if (runs_.empty()) {
+    aht_.InsertCombine(group_bys, aggregates);
+    CheckMemory();
+    return;
+  }
+  uint64_t hash;
+  if (aht_.CombineIfPresent(group_bys, aggregates, &hash)) {
+    return;
+  }
+  // The first spilled row fixes the format of the runs.
+  std::vector<Value> values(group_bys);
+  values.insert(values.end(), aggregates.begin(), aggregates.end());
+  if (spill_schema_ == nullptr) {
+    std::vector<Column> columns;
+    for (size_t i = 0; i < values.size(); ++i) {
+      std::string name = "spilled_" + std::to_string(i);
+      TypeId type = values[i].GetTypeId();
+      columns.push_back(type == TypeId::VARCHAR ? Column(name, type, 0, nullptr) : Column(name, type));
+    }
+    spill_schema_ = std::make_unique<Schema>(columns);
+  }
+  TmpTupleRun *run = runs_[HashUtil::CombineHashes(hash, level_) % FANOUT].get();
+  if (!run->Append(Tuple(values, spill_schema_.get()))) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Aggregation cannot spill: no free frame in the buffer pool.");
+  }
+}
+
+void AggregationExecutor::CheckMemory() {
+  // Past the last level the runs are most likely groups that no hash can split, so they stay in memory.
+  if (aht_.GetMemoryUsage() <= exec_ctx_->GetMemoryBudget() || level_ >= MAX_LEVEL) {
+    return;
+  }
+  for (uint32_t i = 0; i < FANOUT; ++i) {
+    runs_.push_back(std::make_unique<TmpTupleRun>(exec_ctx_->GetBufferPoolManager()));
+  }
+}
+
+void AggregationExecutor::FinishPass() {
+  for (auto &run : runs_) {
+    run->FinishAppend();
+    if (run->GetTupleCount() > 0) {
+      pending_.push_back(SpilledRun{std::move(run), level_ + 1});
+      spilled_run_count_++;
+    }
+  }
+  runs_.clear();
+}
+
+bool AggregationExecutor::StartNextPass() {
+  if (pending_.empty()) {
+    return false;
+  }
+  SpilledRun spilled = std::move(pending_.back());
+  pending_.pop_back();
+  aht_.Clear();
+  level_ = spilled.level_;
+  size_t group_by_count = plan_->GetGroupBys().size();
+  std::vector<Value> groupby(group_by_count);
+  std::vector<Value> agg(plan_->GetAggregates().size());
+  Tuple tuple;
+  while (spilled.run_->Next(&tuple)) {
+    for (size_t i = 0; i < groupby.size(); ++i) {
+      groupby[i] = tuple.GetValue(spill_schema_.get(), i);
+    }
+    for (size_t i = 0; i < agg.size(); ++i) {
+      agg[i] = tuple.GetValue(spill_schema_.get(), group_by_count + i);
+    }
+    Consume(groupby, agg);
+  }
+  spilled.run_.reset();
+  FinishPass();
+  aht_iterator_ = aht_.Begin();
+  return true;
+}
+
+void AggregationExecutor::CompilePrograms() {
+  const Schema *child_schema = child_->GetOutputSchema();
+  group_by_programs_.resize(plan_->GetGroupBys().size());
+  for (size_t i = 0; i < group_by_programs_.size(); ++i) {
+    group_by_programs_[i].Compile(plan_->GetGroupByAt(i), child_schema);
+  }
+  aggregate_programs_.resize(plan_->GetAggregates().size());
+  for (size_t i = 0; i < aggregate_programs_.size(); ++i) {
+    aggregate_programs_[i].Compile(plan_->GetAggregateAt(i), child_schema);
+  }
+  if (plan_->GetHaving() != nullptr) {
+    having_program_.CompileAggregate(plan_->GetHaving());
+  }
 }
 
 }  // namespace bustub
@@ -0,0 +1,601 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_hash_table.cpp
+//
+// Identification: src/execution/aggregation_hash_table.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/aggregation_hash_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include "common/exception.h"
+#include "type/type.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the value of an integer Value of any width */
+int64_t IntegerOf(const Value &value) {
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+      return value.GetAs<int8_t>();
+    case TypeId::SMALLINT:
+      return value.GetAs<int16_t>();
+    case TypeId::INTEGER:
+      return value.GetAs<int32_t>();
+    default:
+      return value.GetAs<int64_t>();
+  }
+}
+
+/** @return the Value of type type holding an integer of that type */
+Value IntegerValue(TypeId type, int64_t value) {
+  switch (type) {
+    case TypeId::TINYINT:
+      return ValueFactory::GetTinyIntValue(static_cast<int8_t>(value));
+    case TypeId::SMALLINT:
+      return ValueFactory::GetSmallIntValue(static_cast<int16_t>(value));
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(static_cast<int32_t>(value));
+    default:
+      return ValueFactory::GetBigIntValue(value);
+  }
+}
+
+}  // namespace
+
+AggregationHashTable::AggregationHashTable(const std::vector<AggregationType> &agg_types,
+                                           const std::vector<double> &percentiles)
+    : agg_types_(agg_types), percentiles_(percentiles), slots_(INITIAL_SLOTS, Slot{0, 0}) {
+  BUSTUB_ASSERT(agg_types_.size() <= 64, "A group tracks the aggregates with a value in a 64-bit mask.");
+  percentiles_.resize(agg_types_.size(), 0.5);
+  // AVG keeps a sum and a count, every other aggregate a single word.
+  for (AggregationType agg_type : agg_types_) {
+    state_offsets_.push_back(state_words_);
+    state_words_ += agg_type == AggregationType::AvgAggregate ? 2 : 1;
+  }
+}
+
+void AggregationHashTable::InsertCombine(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) {
+  MakeKey(group_bys, aggregates);
+  Combine(FindOrInsert(true), aggregates);
+}
+
+bool AggregationHashTable::CombineIfPresent(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates,
+                                            uint64_t *hash) {
+  MakeKey(group_bys, aggregates);
+  size_t group = FindOrInsert(false);
+  if (group == NO_GROUP) {
+    *hash = HashKey(key_.data(), key_.size());
+    return false;
+  }
+  Combine(group, aggregates);
+  return true;
+}
+
+void AggregationHashTable::MakeKey(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) {
+  if (!types_known_) {
+    std::vector<TypeId> key_types;
+    for (const auto &value : group_bys) {
+      key_types.push_back(value.GetTypeId());
+    }
+    std::vector<TypeId> input_types;
+    for (const auto &value : aggregates) {
+      input_types.push_back(value.GetTypeId());
+    }
+    InitTypes(key_types, input_types);
+  }
+  key_.clear();
+  for (size_t i = 0; i < group_bys.size(); i++) {
+    AppendKeyValue(group_bys[i], key_types_[i]);
+  }
+}
+
+void AggregationHashTable::Combine(size_t group, const std::vector<Value> &aggregates) {
+  for (uint32_t i = 0; i < aggregates.size(); i++) {
+    const Value &input = aggregates[i];
+    if (agg_types_[i] == AggregationType::CountAggregate) {
+      StateOf(group, i)++;
+    } else if (input.IsNull()) {
+      continue;
+    } else if (state_kinds_[i] == StateKind::Integer) {
+      Accumulate(group, i, IntegerOf(input.GetTypeId() == TypeId::DECIMAL ? input.CastAs(TypeId::BIGINT) : input));
+    } else if (state_kinds_[i] == StateKind::Decimal) {
+      Accumulate(group, i, input.CastAs(TypeId::DECIMAL).GetAs<double>());
+    } else {
+      Accumulate(group, i, input);
+    }
+  }
+}
+
+void AggregationHashTable::InsertCombineBatch(const std::vector<ColumnVector> &group_bys,
+                                              const std::vector<ColumnVector> &aggregates, size_t size) {
+  if (!types_known_) {
+    std::vector<TypeId> key_types;
+    for (const auto &column : group_bys) {
+      key_types.push_back(column.GetType());
+    }
+    std::vector<TypeId> input_types;
+    for (const auto &column : aggregates) {
+      input_types.push_back(column.GetType());
+    }
+    InitTypes(key_types, input_types);
+  }
+  bool types_match = true;
+  for (size_t i = 0; i < group_bys.size(); i++) {
+    types_match = types_match && group_bys[i].GetType() == key_types_[i];
+  }
+  for (size_t i = 0; i < aggregates.size(); i++) {
+    types_match = types_match && aggregates[i].GetType() == input_types_[i];
+  }
+  if (!types_match) {
+    std::vector<Value> key(group_bys.size());
+    std::vector<Value> inputs(aggregates.size());
+    for (size_t row = 0; row < size; row++) {
+      for (size_t i = 0; i < group_bys.size(); i++) {
+        key[i] = group_bys[i].GetValue(row);
+      }
+      for (size_t i = 0; i < aggregates.size(); i++) {
+        inputs[i] = aggregates[i].GetValue(row);
+      }
+      InsertCombine(key, inputs);
+    }
+    return;
+  }
+
+  // Find the groups of all rows first, then update one aggregate at a time with a loop over a typed array.
+  row_groups_.resize(size);
+  for (size_t row = 0; row < size; row++) {
+    key_.clear();
+    for (size_t i = 0; i < group_bys.size(); i++) {
+      const ColumnVector &column = group_bys[i];
+      if (!column.IsInlined()) {
+        AppendKeyValue(column.GetValue(row), key_types_[i]);
+      } else if (column.GetType() == TypeId::DECIMAL) {
+        double value = column.GetData<double>()[row];
+        value = value == 0 ? 0 : value;
+        const auto *data = reinterpret_cast<const char *>(&value);
+        key_.insert(key_.end(), data, data + sizeof(double));
+      } else {
+        size_t width = Type::GetTypeSize(column.GetType());
+        const char *data = column.GetData<char>() + row * width;
+        key_.insert(key_.end(), data, data + width);
+      }
+    }
+    row_groups_[row] = FindOrInsert(true);
+  }
+  for (uint32_t i = 0; i < aggregates.size(); i++) {
+    const ColumnVector &column = aggregates[i];
+    switch (column.GetType()) {
+      case TypeId::TINYINT:
+        AccumulateColumn(i, column.GetData<int8_t>(), BUSTUB_INT8_NULL, size);
+        break;
+      case TypeId::SMALLINT:
+        AccumulateColumn(i, column.GetData<int16_t>(), BUSTUB_INT16_NULL, size);
+        break;
+      case TypeId::INTEGER:
+        AccumulateColumn(i, column.GetData<int32_t>(), BUSTUB_INT32_NULL, size);
+        break;
+      case TypeId::BIGINT:
+        AccumulateColumn(i, column.GetData<int64_t>(), BUSTUB_INT64_NULL, size);
+        break;
+      case TypeId::DECIMAL:
+        AccumulateColumn(i, column.GetData<double>(), BUSTUB_DECIMAL_NULL, size);
+        break;
+      default:
+        for (size_t row = 0; row < size; row++) {
+          if (agg_types_[i] == AggregationType::CountAggregate) {
+            StateOf(row_groups_[row], i)++;
+            continue;
+          }
+          Value input = column.GetValue(row);
+          if (!input.IsNull()) {
+            Accumulate(row_groups_[row], i, input);
+          }
+        }
+        break;
+    }
+  }
+}
+
+template <typename T>
+void AggregationHashTable::AccumulateColumn(uint32_t agg_idx, const T *inputs, T null_input, size_t size) {
+  if (agg_types_[agg_idx] == AggregationType::CountAggregate) {
+    for (size_t row = 0; row < size; row++) {
+      StateOf(row_groups_[row], agg_idx)++;
+    }
+    return;
+  }
+  for (size_t row = 0; row < size; row++) {
+    if (inputs[row] == null_input) {
+      continue;
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+      Accumulate(row_groups_[row], agg_idx, static_cast<double>(inputs[row]));
+    } else {
+      Accumulate(row_groups_[row], agg_idx, static_cast<int64_t>(inputs[row]));
+    }
+  }
+}
+
+void AggregationHashTable::Accumulate(size_t group, uint32_t agg_idx, int64_t input) {
+  uint64_t &has_value = arena_[group + 1];
+  uint64_t bit = uint64_t{1} << agg_idx;
+  auto &state = reinterpret_cast<int64_t &>(StateOf(group, agg_idx));
+  switch (agg_types_[agg_idx]) {
+    case AggregationType::SumAggregate:
+    case AggregationType::AvgAggregate:
+      if (__builtin_add_overflow(state, input, &state)) {
+        throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+      }
+      if (agg_types_[agg_idx] == AggregationType::AvgAggregate) {
+        (&StateOf(group, agg_idx))[1]++;
+      }
+      break;
+    case AggregationType::MinAggregate:
+      if ((has_value & bit) == 0 || input < state) {
+        state = input;
+      }
+      break;
+    case AggregationType::MaxAggregate:
+      if ((has_value & bit) == 0 || input > state) {
+        state = input;
+      }
+      break;
+    case AggregationType::CountAggregate:
+      state++;
+      break;
+    case AggregationType::CountDistinctAggregate:
+    case AggregationType::ApproxCountDistinctAggregate:
+      AccumulateDistinct(group, agg_idx, reinterpret_cast<const char *>(&input), sizeof(input));
+      return;
+    case AggregationType::ApproxPercentileAggregate:
+      AccumulatePercentile(group, agg_idx, static_cast<double>(input));
+      return;
+  }
+  has_value |= bit;
+}
+
+void AggregationHashTable::Accumulate(size_t group, uint32_t agg_idx, double input) {
+  uint64_t &has_value = arena_[group + 1];
+  uint64_t bit = uint64_t{1} << agg_idx;
+  double state;
+  memcpy(&state, &StateOf(group, agg_idx), sizeof(double));
+  switch (agg_types_[agg_idx]) {
+    case AggregationType::SumAggregate:
+      state += input;
+      break;
+    case AggregationType::AvgAggregate:
+      state += input;
+      (&StateOf(group, agg_idx))[1]++;
+      break;
+    case AggregationType::MinAggregate:
+      if ((has_value & bit) == 0 || input < state) {
+        state = input;
+      }
+      break;
+    case AggregationType::MaxAggregate:
+      if ((has_value & bit) == 0 || input > state) {
+        state = input;
+      }
+      break;
+    case AggregationType::CountAggregate:
+      state++;
+      break;
+    case AggregationType::CountDistinctAggregate:
+    case AggregationType::ApproxCountDistinctAggregate:
+      // 0.0 and -0.0 are the same value but not the same bytes.
+      input = input == 0 ? 0 : input;
+      AccumulateDistinct(group, agg_idx, reinterpret_cast<const char *>(&input), sizeof(input));
+      return;
+    case AggregationType::ApproxPercentileAggregate:
+      AccumulatePercentile(group, agg_idx, input);
+      return;
+  }
+  memcpy(&StateOf(group, agg_idx), &state, sizeof(double));
+  has_value |= bit;
+}
+
+void AggregationHashTable::Accumulate(size_t group, uint32_t agg_idx, const Value &input) {
+  uint64_t &has_value = arena_[group + 1];
+  uint64_t bit = uint64_t{1} << agg_idx;
+  if (agg_types_[agg_idx] == AggregationType::CountDistinctAggregate ||
+      agg_types_[agg_idx] == AggregationType::ApproxCountDistinctAggregate) {
+    bool is_varchar = input.GetTypeId() == TypeId::VARCHAR;
+    std::vector<char> bytes(is_varchar ? input.GetLength() : Type::GetTypeSize(input.GetTypeId()));
+    if (is_varchar) {
+      memcpy(bytes.data(), input.GetData(), bytes.size());
+    } else {
+      input.SerializeTo(bytes.data());
+    }
+    AccumulateDistinct(group, agg_idx, bytes.data(), bytes.size());
+    return;
+  }
+  uint64_t &state = StateOf(group, agg_idx);
+  if ((has_value & bit) == 0) {
+    state = boxed_.size();
+    boxed_.push_back(input);
+    has_value |= bit;
+    return;
+  }
+  Value &boxed = boxed_[state];
+  if (agg_types_[agg_idx] == AggregationType::MinAggregate && input.CompareLessThan(boxed) == CmpBool::CmpTrue) {
+    boxed = input;
+  } else if (agg_types_[agg_idx] == AggregationType::MaxAggregate &&
+             input.CompareGreaterThan(boxed) == CmpBool::CmpTrue) {
+    boxed = input;
+  }
+}
+
+void AggregationHashTable::AccumulateDistinct(size_t group, uint32_t agg_idx, const char *data, size_t size) {
+  uint64_t &has_value = arena_[group + 1];
+  uint64_t bit = uint64_t{1} << agg_idx;
+  uint64_t &state = StateOf(group, agg_idx);
+  bool is_exact = agg_types_[agg_idx] == AggregationType::CountDistinctAggregate;
+  if ((has_value & bit) == 0) {
+    state = is_exact ? distinct_sets_.size() : hlls_.size();
+    if (is_exact) {
+      distinct_sets_.emplace_back();
+    } else {
+      hlls_.emplace_back();
+    }
+    has_value |= bit;
+  }
+  if (is_exact) {
+    if (distinct_sets_[state].emplace(data, size).second) {
+      side_bytes_ += DISTINCT_ENTRY_BYTES + size;
+    }
+    return;
+  }
+  HyperLogLog &hll = hlls_[state];
+  side_bytes_ -= hll.GetMemoryUsage();
+  hll.Add(HashKey(data, size));
+  side_bytes_ += hll.GetMemoryUsage();
+}
+
+void AggregationHashTable::AccumulatePercentile(size_t group, uint32_t agg_idx, double input) {
+  uint64_t &has_value = arena_[group + 1];
+  uint64_t bit = uint64_t{1} << agg_idx;
+  uint64_t &state = StateOf(group, agg_idx);
+  if ((has_value & bit) == 0) {
+    state = klls_.size();
+    klls_.emplace_back();
+    has_value |= bit;
+  }
+  KllSketch &kll = klls_[state];
+  side_bytes_ -= kll.GetMemoryUsage();
+  kll.Add(input);
+  side_bytes_ += kll.GetMemoryUsage();
+}
+
+TypeId AggregationHashTable::GetResultType(AggregationType agg_type, TypeId input_type) {
+  switch (agg_type) {
+    case AggregationType::CountAggregate:
+    case AggregationType::CountDistinctAggregate:
+    case AggregationType::ApproxCountDistinctAggregate:
+      return TypeId::INTEGER;
+    case AggregationType::AvgAggregate:
+    case AggregationType::ApproxPercentileAggregate:
+      return TypeId::DECIMAL;
+    case AggregationType::SumAggregate:
+      // The same as adding the inputs to an INTEGER zero.
+      return input_type == TypeId::BIGINT || input_type == TypeId::DECIMAL ? input_type : TypeId::INTEGER;
+    default:
+      return input_type;
+  }
+}
+
+void AggregationHashTable::Clear() {
+  slots_.assign(INITIAL_SLOTS, Slot{0, 0});
+  arena_.clear();
+  boxed_.clear();
+  distinct_sets_.clear();
+  hlls_.clear();
+  klls_.clear();
+  side_bytes_ = 0;
+  group_count_ = 0;
+  types_known_ = false;
+}
+
+size_t AggregationHashTable::GetMemoryUsage() const {
+  return slots_.capacity() * sizeof(Slot) + arena_.capacity() * sizeof(uint64_t) + boxed_.capacity() * sizeof(Value) +
+         side_bytes_;
+}
+
+void AggregationHashTable::InitTypes(const std::vector<TypeId> &key_types, const std::vector<TypeId> &input_types) {
+  key_types_ = key_types;
+  input_types_ = input_types;
+  state_kinds_.clear();
+  for (size_t i = 0; i < input_types_.size(); i++) {
+    switch (input_types_[i]) {
+      case TypeId::TINYINT:
+      case TypeId::SMALLINT:
+      case TypeId::INTEGER:
+      case TypeId::BIGINT:
+        state_kinds_.push_back(StateKind::Integer);
+        break;
+      case TypeId::DECIMAL:
+        state_kinds_.push_back(StateKind::Decimal);
+        break;
+      default:
+        if (agg_types_[i] == AggregationType::SumAggregate || agg_types_[i] == AggregationType::AvgAggregate ||
+            agg_types_[i] == AggregationType::ApproxPercentileAggregate) {
+          throw Exception(ExceptionType::MISMATCH_TYPE, "SUM, AVG and percentiles need numeric inputs.");
+        }
+        bool is_count = agg_types_[i] == AggregationType::CountAggregate;
+        state_kinds_.push_back(is_count ? StateKind::Integer : StateKind::Boxed);
+        break;
+    }
+  }
+  types_known_ = true;
+}
+
+void AggregationHashTable::AppendKeyValue(const Value &value, TypeId type) {
+  Value key = value.IsNull() ? ValueFactory::GetNullValueByType(type)
+                             : (value.GetTypeId() == type ? value : value.CastAs(type));
+  // 0.0 and -0.0 are the same group but not the same bytes.
+  if (type == TypeId::DECIMAL && !key.IsNull() && key.GetAs<double>() == 0) {
+    key = ValueFactory::GetDecimalValue(0);
+  }
+  size_t offset = key_.size();
+  if (type == TypeId::VARCHAR) {
+    key_.resize(offset + sizeof(uint32_t) + (key.IsNull() ? 0 : key.GetLength()));
+  } else {
+    key_.resize(offset + Type::GetTypeSize(type));
+  }
+  key.SerializeTo(key_.data() + offset);
+}
+
+size_t AggregationHashTable::FindOrInsert(bool insert) {
+  uint64_t hash = HashKey(key_.data(), key_.size());
+  size_t mask = slots_.size() - 1;
+  size_t idx = hash & mask;
+  for (; slots_[idx].group_ != 0; idx = (idx + 1) & mask) {
+    if (slots_[idx].hash_ != hash) {
+      continue;
+    }
+    size_t group = slots_[idx].group_ - 1;
+    if (arena_[group] == key_.size() &&
+        memcmp(&arena_[group + HEADER_WORDS + state_words_], key_.data(), key_.size()) == 0) {
+      return group;
+    }
+  }
+  if (!insert) {
+    return NO_GROUP;
+  }
+
+  // Accumulators start at zero, which is 0.0 as well.
+  size_t group = arena_.size();
+  arena_.resize(group + GroupWords(key_.size()), 0);
+  arena_[group] = key_.size();
+  memcpy(&arena_[group + HEADER_WORDS + state_words_], key_.data(), key_.size());
+  slots_[idx] = Slot{hash, group + 1};
+  group_count_++;
+  // Linear probing stays short up to half full.
+  if (group_count_ * 2 > slots_.size()) {
+    Grow();
+  }
+  return group;
+}
+
+void AggregationHashTable::Grow() {
+  std::vector<Slot> old_slots(slots_.size() * 2, Slot{0, 0});
+  old_slots.swap(slots_);
+  size_t mask = slots_.size() - 1;
+  for (const auto &slot : old_slots) {
+    if (slot.group_ == 0) {
+      continue;
+    }
+    size_t idx = slot.hash_ & mask;
+    while (slots_[idx].group_ != 0) {
+      idx = (idx + 1) & mask;
+    }
+    slots_[idx] = slot;
+  }
+}
+
+uint64_t AggregationHashTable::HashKey(const char *key, size_t size) {
+  // Mixes the key a word at a time, with the finalizer of MurmurHash3 so that the low bits probed by the table depend
+  // on all bytes.
+  uint64_t hash = size * 0x9e3779b97f4a7c15ULL;
+  for (size_t i = 0; i < size; i += sizeof(uint64_t)) {
+    uint64_t word = 0;
+    memcpy(&word, key + i, std::min(sizeof(uint64_t), size - i));
+    hash = (hash ^ word) * 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 31;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+AggregateKey AggregationHashTable::Iterator::Key() const {
+  const uint64_t *group = &table_->arena_[offset_];
+  const char *key = reinterpret_cast<const char *>(group + HEADER_WORDS + table_->state_words_);
+  AggregateKey result;
+  for (TypeId type : table_->key_types_) {
+    result.group_bys_.push_back(Value::DeserializeFrom(key, type));
+    if (type == TypeId::VARCHAR) {
+      uint32_t length;
+      memcpy(&length, key, sizeof(uint32_t));
+      key += sizeof(uint32_t) + (length == BUSTUB_VALUE_NULL ? 0 : length);
+    } else {
+      key += Type::GetTypeSize(type);
+    }
+  }
+  return result;
+}
+
+AggregateValue AggregationHashTable::Iterator::Val() const {
+  const uint64_t *group = &table_->arena_[offset_];
+  AggregateValue result;
+  for (uint32_t i = 0; i < table_->agg_types_.size(); i++) {
+    const uint64_t *states = group + HEADER_WORDS + table_->state_offsets_[i];
+    uint64_t state = states[0];
+    bool has_value = ((group[1] >> i) & 1) != 0;
+    TypeId input_type = table_->input_types_[i];
+    StateKind kind = table_->state_kinds_[i];
+    AggregationType agg_type = table_->agg_types_[i];
+    if (agg_type == AggregationType::CountAggregate) {
+      result.aggregates_.push_back(ValueFactory::GetIntegerValue(static_cast<int32_t>(state)));
+      continue;
+    }
+    if (agg_type == AggregationType::CountDistinctAggregate ||
+        agg_type == AggregationType::ApproxCountDistinctAggregate) {
+      uint64_t count = 0;
+      if (has_value) {
+        count = agg_type == AggregationType::CountDistinctAggregate ? table_->distinct_sets_[state].size()
+                                                                     : table_->hlls_[state].Estimate();
+      }
+      result.aggregates_.push_back(ValueFactory::GetIntegerValue(static_cast<int32_t>(count)));
+      continue;
+    }
+    TypeId type = GetResultType(agg_type, input_type);
+    if (!has_value) {
+      result.aggregates_.push_back(ValueFactory::GetNullValueByType(type));
+    } else if (agg_type == AggregationType::AvgAggregate) {
+      double sum;
+      if (kind == StateKind::Decimal) {
+        memcpy(&sum, &state, sizeof(double));
+      } else {
+        sum = static_cast<double>(static_cast<int64_t>(state));
+      }
+      result.aggregates_.push_back(ValueFactory::GetDecimalValue(sum / states[1]));
+    } else if (agg_type == AggregationType::ApproxPercentileAggregate) {
+      double quantile = table_->klls_[state].Quantile(table_->percentiles_[i]);
+      result.aggregates_.push_back(ValueFactory::GetDecimalValue(quantile));
+    } else if (kind == StateKind::Boxed) {
+      result.aggregates_.push_back(table_->boxed_[state]);
+    } else if (kind == StateKind::Decimal) {
+      double value;
+      memcpy(&value, &state, sizeof(double));
+      result.aggregates_.push_back(ValueFactory::GetDecimalValue(value));
+    } else {
+      auto value = static_cast<int64_t>(state);
+      // The null sentinel is out of range too.
+      if (type == TypeId::INTEGER && (value < BUSTUB_INT32_MIN || value > BUSTUB_INT32_MAX)) {
+        throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+      }
+      result.aggregates_.push_back(IntegerValue(type, value));
+    }
+  }
+  return result;
+}
+
+AggregationHashTable::Iterator &AggregationHashTable::Iterator::operator++() {
+  offset_ += table_->GroupWords(table_->arena_[offset_]);
+  return *this;
+}
+
+}  // namespace bustub
@@ -0,0 +1,260 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_expression.cpp
+//
+// Identification: src/execution/compiled_expression.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/compiled_expression.h"
+
+#include <cstring>
+
+#include "execution/expressions/aggregate_value_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+bool IsIntegral(TypeId type) {
+  return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT;
+}
+
+bool IsNumeric(TypeId type) { return IsIntegral(type) || type == TypeId::DECIMAL; }
+
+template <typename T>
+bool Compare(ComparisonType comp_type, T lhs, T rhs) {
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      return lhs == rhs;
+    case ComparisonType::NotEqual:
+      return lhs != rhs;
+    case ComparisonType::LessThan:
+      return lhs < rhs;
+    case ComparisonType::LessThanOrEqual:
+      return lhs <= rhs;
+    case ComparisonType::GreaterThan:
+      return lhs > rhs;
+    case ComparisonType::GreaterThanOrEqual:
+    default:
+      return lhs >= rhs;
+  }
+}
+
+/** Reads an integral column, which may be unaligned in the tuple. */
+template <typename T>
+void LoadInt(const char *data, T null_value, int64_t *value, bool *is_null) {
+  T raw;
+  memcpy(&raw, data, sizeof(T));
+  *value = raw;
+  *is_null = raw == null_value;
+}
+
+}  // namespace
+
+bool CompiledExpression::Compile(const AbstractExpression *expr, const Schema *left_schema,
+                                 const Schema *right_schema) {
+  program_.clear();
+  schemas_[0] = left_schema;
+  schemas_[1] = right_schema;
+  result_type_ = Emit(expr, false, 1);
+  compiled_ = result_type_ != TypeId::INVALID;
+  return compiled_;
+}
+
+bool CompiledExpression::CompileAggregate(const AbstractExpression *expr) {
+  program_.clear();
+  schemas_[0] = nullptr;
+  schemas_[1] = nullptr;
+  result_type_ = Emit(expr, true, 1);
+  compiled_ = result_type_ != TypeId::INVALID;
+  return compiled_;
+}
+
+TypeId CompiledExpression::Emit(const AbstractExpression *expr, bool aggregate, uint32_t depth) {
+  if (expr == nullptr || depth > MAX_STACK_DEPTH) {
+    return TypeId::INVALID;
+  }
+
+  if (auto column = dynamic_cast<const ColumnValueExpression *>(expr)) {
+    uint32_t tuple_idx = column->GetTupleIdx();
+    if (aggregate || tuple_idx > 1 || schemas_[tuple_idx] == nullptr || !schemas_[tuple_idx]->HasFixedOffsets()) {
+      return TypeId::INVALID;
+    }
+    const Column &col = schemas_[tuple_idx]->GetColumn(column->GetColIdx());
+    if (!IsNumeric(col.GetType())) {
+      return TypeId::INVALID;
+    }
+    Instruction instruction{OpCode::LoadColumn};
+    instruction.type_ = col.GetType();
+    instruction.tuple_idx_ = tuple_idx;
+    instruction.offset_ = col.GetOffset();
+    program_.push_back(instruction);
+    return col.GetType();
+  }
+
+  if (auto constant = dynamic_cast<const ConstantValueExpression *>(expr)) {
+    const Value &value = constant->GetValue();
+    if (!IsNumeric(value.GetTypeId())) {
+      return TypeId::INVALID;
+    }
+    Instruction instruction{OpCode::LoadConstant};
+    instruction.type_ = value.GetTypeId();
+    instruction.constant_ = FromValue(value);
+    program_.push_back(instruction);
+    return value.GetTypeId();
+  }
+
+  if (auto term = dynamic_cast<const AggregateValueExpression *>(expr)) {
+    if (!aggregate || !IsNumeric(term->GetReturnType())) {
+      return TypeId::INVALID;
+    }
+    Instruction instruction{OpCode::LoadAggregate};
+    instruction.type_ = term->GetReturnType();
+    instruction.tuple_idx_ = term->isGroupByTerm() ? 0 : 1;
+    instruction.offset_ = term->GetTermIdx();
+    program_.push_back(instruction);
+    return term->GetReturnType();
+  }
+
+  if (auto comparison = dynamic_cast<const ComparisonExpression *>(expr)) {
+    TypeId lhs = Emit(comparison->GetChildAt(0), aggregate, depth);
+    size_t rhs_start = program_.size();
+    TypeId rhs = Emit(comparison->GetChildAt(1), aggregate, depth + 1);
+    if (!IsNumeric(lhs) || !IsNumeric(rhs)) {
+      return TypeId::INVALID;
+    }
+    // Mixed comparisons are done on doubles, as DecimalType does.
+    bool as_double = lhs == TypeId::DECIMAL || rhs == TypeId::DECIMAL;
+    if (as_double && lhs != TypeId::DECIMAL) {
+      program_.insert(program_.begin() + rhs_start, Instruction{OpCode::Widen});
+    }
+    if (as_double && rhs != TypeId::DECIMAL) {
+      program_.push_back(Instruction{OpCode::Widen});
+    }
+    Instruction instruction{as_double ? OpCode::CompareDouble : OpCode::CompareInt};
+    instruction.comp_type_ = comparison->GetComparisonType();
+    program_.push_back(instruction);
+    return TypeId::BOOLEAN;
+  }
+
+  return TypeId::INVALID;
+}
+
+CompiledExpression::Slot CompiledExpression::Run(const Tuple *left_tuple, const Tuple *right_tuple,
+                                                 const std::vector<Value> *group_bys,
+                                                 const std::vector<Value> *aggregates) const {
+  const Tuple *tuples[2]{left_tuple, right_tuple};
+  const std::vector<Value> *terms[2]{group_bys, aggregates};
+  Slot stack[MAX_STACK_DEPTH];
+  uint32_t top = 0;
+  for (const auto &instruction : program_) {
+    switch (instruction.op_) {
+      case OpCode::LoadColumn: {
+        const char *data = tuples[instruction.tuple_idx_]->GetData() + instruction.offset_;
+        Slot &slot = stack[top++];
+        switch (instruction.type_) {
+          case TypeId::TINYINT:
+            LoadInt<int8_t>(data, BUSTUB_INT8_NULL, &slot.int_, &slot.is_null_);
+            break;
+          case TypeId::SMALLINT:
+            LoadInt<int16_t>(data, BUSTUB_INT16_NULL, &slot.int_, &slot.is_null_);
+            break;
+          case TypeId::INTEGER:
+            LoadInt<int32_t>(data, BUSTUB_INT32_NULL, &slot.int_, &slot.is_null_);
+            break;
+          case TypeId::BIGINT:
+            LoadInt<int64_t>(data, BUSTUB_INT64_NULL, &slot.int_, &slot.is_null_);
+            break;
+          default:
+            memcpy(&slot.double_, data, sizeof(double));
+            slot.is_null_ = slot.double_ == BUSTUB_DECIMAL_NULL;
+            break;
+        }
+        break;
+      }
+      case OpCode::LoadConstant:
+        stack[top++] = instruction.constant_;
+        break;
+      case OpCode::LoadAggregate: {
+        const Value &value = (*terms[instruction.tuple_idx_])[instruction.offset_];
+        // The aggregates of a group may not have the type the expression declares, e.g. SUM of a BIGINT column.
+        stack[top++] =
+            FromValue(value.GetTypeId() == instruction.type_ ? value : value.CastAs(instruction.type_));
+        break;
+      }
+      case OpCode::Widen: {
+        Slot &slot = stack[top - 1];
+        slot.double_ = static_cast<double>(slot.int_);
+        break;
+      }
+      case OpCode::CompareInt: {
+        Slot &lhs = stack[top - 2];
+        const Slot &rhs = stack[--top];
+        lhs.int_ = Compare(instruction.comp_type_, lhs.int_, rhs.int_) ? 1 : 0;
+        lhs.is_null_ = lhs.is_null_ || rhs.is_null_;
+        break;
+      }
+      case OpCode::CompareDouble: {
+        Slot &lhs = stack[top - 2];
+        const Slot &rhs = stack[--top];
+        lhs.int_ = Compare(instruction.comp_type_, lhs.double_, rhs.double_) ? 1 : 0;
+        lhs.is_null_ = lhs.is_null_ || rhs.is_null_;
+        break;
+      }
+    }
+  }
+  return stack[0];
+}
+
+Value CompiledExpression::Box(const Slot &slot) const {
+  if (slot.is_null_) {
+    return ValueFactory::GetNullValueByType(result_type_);
+  }
+  switch (result_type_) {
+    case TypeId::BOOLEAN:
+      return ValueFactory::GetBooleanValue(slot.int_ != 0);
+    case TypeId::TINYINT:
+      return ValueFactory::GetTinyIntValue(static_cast<int8_t>(slot.int_));
+    case TypeId::SMALLINT:
+      return ValueFactory::GetSmallIntValue(static_cast<int16_t>(slot.int_));
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(static_cast<int32_t>(slot.int_));
+    case TypeId::BIGINT:
+      return ValueFactory::GetBigIntValue(slot.int_);
+    default:
+      return ValueFactory::GetDecimalValue(slot.double_);
+  }
+}
+
+CompiledExpression::Slot CompiledExpression::FromValue(const Value &value) {
+  Slot slot{};
+  slot.is_null_ = value.IsNull();
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+      slot.int_ = value.GetAs<int8_t>();
+      break;
+    case TypeId::SMALLINT:
+      slot.int_ = value.GetAs<int16_t>();
+      break;
+    case TypeId::INTEGER:
+      slot.int_ = value.GetAs<int32_t>();
+      break;
+    case TypeId::BIGINT:
+      slot.int_ = value.GetAs<int64_t>();
+      break;
+    default:
+      slot.double_ = value.GetAs<double>();
+      break;
+  }
+  return slot;
+}
+
+}  // namespace bustub
@@ -19,7 +19,10 @@ DeleteExecutor::DeleteExecutor(ExecutorContext *exec_ctx, const DeletePlanNode *
                                std::unique_ptr<AbstractExecutor> &&child_executor)
     : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
 
-void DeleteExecutor::Init() { tableHeap = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid())->table_.get(); }
+void DeleteExecutor::Init() {
+  child_executor_->Init();
+  tableHeap = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid())->table_.get();
+}
 
 bool DeleteExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) {
   bool hasNext = child_executor_->Next(tuple, rid);
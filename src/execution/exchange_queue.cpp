@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_queue.cpp
+//
+// Identification: src/execution/exchange_queue.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/exchange_queue.h"
+
+#include <utility>
+
+namespace bustub {
+
+bool ExchangeQueue::Push(VectorBatch &&batch) {
+  std::unique_lock<std::mutex> lock(latch_);
+  not_full_.wait(lock, [this] { return closed_ || batches_.size() < capacity_; });
+  if (closed_) {
+    return false;
+  }
+  batches_.push_back(std::move(batch));
+  not_empty_.notify_one();
+  return true;
+}
+
+void ExchangeQueue::FinishProducer() {
+  std::lock_guard<std::mutex> guard(latch_);
+  producers_left_--;
+  if (producers_left_ == 0) {
+    not_empty_.notify_all();
+  }
+}
+
+bool ExchangeQueue::Pop(VectorBatch *batch) {
+  std::unique_lock<std::mutex> lock(latch_);
+  not_empty_.wait(lock, [this] { return closed_ || !batches_.empty() || producers_left_ == 0; });
+  if (closed_ || batches_.empty()) {
+    return false;
+  }
+  *batch = std::move(batches_.front());
+  batches_.pop_front();
+  not_full_.notify_one();
+  return true;
+}
+
+void ExchangeQueue::Close() {
+  std::lock_guard<std::mutex> guard(latch_);
+  closed_ = true;
+  batches_.clear();
+  not_empty_.notify_all();
+  not_full_.notify_all();
+}
+
+}  // namespace bustub
@@ -17,12 +17,17 @@
 #include "execution/executors/abstract_executor.h"
 #include "execution/executors/aggregation_executor.h"
 #include "execution/executors/delete_executor.h"
+#include "execution/executors/gather_executor.h"
+#include "execution/executors/hash_join_executor.h"
 #include "execution/executors/index_scan_executor.h"
 #include "execution/executors/insert_executor.h"
 #include "execution/executors/limit_executor.h"
 #include "execution/executors/nested_index_join_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
+#include "execution/executors/repartition_executor.h"
 #include "execution/executors/seq_scan_executor.h"
+#include "execution/executors/sort_executor.h"
+#include "execution/executors/topn_executor.h"
 #include "execution/executors/update_executor.h"
 #include "storage/index/generic_key.h"
 
@@ -87,6 +92,39 @@ std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateExecutor(ExecutorContex
       return std::make_unique<NestIndexJoinExecutor>(exec_ctx, nested_index_join_plan, std::move(left));
     }
 
+    case PlanType::HashJoin: {
+      auto hash_join_plan = dynamic_cast<const HashJoinPlanNode *>(plan);
+      auto left = ExecutorFactory::CreateExecutor(exec_ctx, hash_join_plan->GetLeftPlan());
+      auto right = ExecutorFactory::CreateExecutor(exec_ctx, hash_join_plan->GetRightPlan());
+      return std::make_unique<HashJoinExecutor>(exec_ctx, hash_join_plan, std::move(left), std::move(right));
+    }
+
+    case PlanType::Sort: {
+      auto sort_plan = dynamic_cast<const SortPlanNode *>(plan);
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, sort_plan->GetChildPlan());
+      return std::make_unique<SortExecutor>(exec_ctx, sort_plan, std::move(child_executor));
+    }
+
+    case PlanType::TopN: {
+      auto topn_plan = dynamic_cast<const TopNPlanNode *>(plan);
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, topn_plan->GetChildPlan());
+      return std::make_unique<TopNExecutor>(exec_ctx, topn_plan, std::move(child_executor));
+    }
+
+    // The instances of a gather's child are created by the gather itself.
+    case PlanType::Gather: {
+      return std::make_unique<GatherExecutor>(exec_ctx, dynamic_cast<const GatherPlanNode *>(plan));
+    }
+
+    // In a parallel subtree, the producers of a repartition are created by the instance that starts them.
+    case PlanType::Repartition: {
+      auto repartition_plan = dynamic_cast<const RepartitionPlanNode *>(plan);
+      auto child_executor = exec_ctx->GetParallelState() != nullptr
+                                ? nullptr
+                                : ExecutorFactory::CreateExecutor(exec_ctx, repartition_plan->GetChildPlan());
+      return std::make_unique<RepartitionExecutor>(exec_ctx, repartition_plan, std::move(child_executor));
+    }
+
     default: {
       BUSTUB_ASSERT(false, "Unsupported plan type.");
     }
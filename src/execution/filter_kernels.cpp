@@ -0,0 +1,273 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// filter_kernels.cpp
+//
+// Identification: src/execution/filter_kernels.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/filter_kernels.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "type/limits.h"
+
+namespace bustub {
+
+template <typename T>
+void FilterKernels::CompareConstantScalar(const T *values, size_t size, ComparisonType comp_type, T constant,
+                                          T null_value, uint64_t *bitmask) {
+  // Branch-free over a word at a time, so that the compiler can vectorize it on its own.
+  for (size_t word = 0; word < BitmaskWords(size); word++) {
+    size_t end = std::min<size_t>(64, size - word * 64);
+    const T *v = values + word * 64;
+    uint64_t bits = 0;
+    for (size_t j = 0; j < end; j++) {
+      bool match;
+      switch (comp_type) {
+        case ComparisonType::Equal:
+          match = v[j] == constant;
+          break;
+        case ComparisonType::NotEqual:
+          match = v[j] != constant;
+          break;
+        case ComparisonType::LessThan:
+          match = v[j] < constant;
+          break;
+        case ComparisonType::LessThanOrEqual:
+          match = v[j] <= constant;
+          break;
+        case ComparisonType::GreaterThan:
+          match = v[j] > constant;
+          break;
+        case ComparisonType::GreaterThanOrEqual:
+        default:
+          match = v[j] >= constant;
+          break;
+      }
+      bits |= static_cast<uint64_t>(match && v[j] != null_value) << j;
+    }
+    bitmask[word] = bits;
+  }
+}
+
+template void FilterKernels::CompareConstantScalar<int32_t>(const int32_t *, size_t, ComparisonType, int32_t, int32_t,
+                                                            uint64_t *);
+template void FilterKernels::CompareConstantScalar<int64_t>(const int64_t *, size_t, ComparisonType, int64_t, int64_t,
+                                                            uint64_t *);
+template void FilterKernels::CompareConstantScalar<double>(const double *, size_t, ComparisonType, double, double,
+                                                           uint64_t *);
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace {
+
+// The AVX2 code is compiled for AVX2 whatever the build targets, and only runs if the CPU turns out to have it.
+
+/** @return the lanes of a 32-bit comparison as 8 bits */
+__attribute__((target("avx2"))) inline uint32_t MoveMask32(__m256i mask) {
+  return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+}
+
+/** @return the lanes of a 64-bit comparison as 4 bits */
+__attribute__((target("avx2"))) inline uint32_t MoveMask64(__m256i mask) {
+  return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(mask)));
+}
+
+/** @return bit i set if negate differs from bit i of match and bit i of is_null is clear, for the low LANES bits */
+template <size_t LANES>
+inline uint32_t Combine(uint32_t match, uint32_t is_null, bool negate) {
+  return ((negate ? ~match : match) & ~is_null) & ((1U << LANES) - 1);
+}
+
+/** Compares 8 int32_t values at a time. */
+struct Int32Lanes {
+  using Value = int32_t;
+  static constexpr size_t LANES = 8;
+
+  template <ComparisonType CMP>
+  __attribute__((target("avx2"))) static uint32_t Match(const int32_t *values, int32_t constant) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+    __m256i c = _mm256_set1_epi32(constant);
+    __m256i is_null = _mm256_cmpeq_epi32(v, _mm256_set1_epi32(BUSTUB_INT32_NULL));
+    // Only equality and greater-than exist for integers, the other comparisons are their complements.
+    __m256i match;
+    if (CMP == ComparisonType::Equal || CMP == ComparisonType::NotEqual) {
+      match = _mm256_cmpeq_epi32(v, c);
+    } else if (CMP == ComparisonType::LessThan || CMP == ComparisonType::GreaterThanOrEqual) {
+      match = _mm256_cmpgt_epi32(c, v);
+    } else {
+      match = _mm256_cmpgt_epi32(v, c);
+    }
+    return Combine<LANES>(MoveMask32(match), MoveMask32(is_null),
+                          CMP == ComparisonType::NotEqual || CMP == ComparisonType::LessThanOrEqual ||
+                              CMP == ComparisonType::GreaterThanOrEqual);
+  }
+};
+
+/** Compares 4 int64_t values at a time. */
+struct Int64Lanes {
+  using Value = int64_t;
+  static constexpr size_t LANES = 4;
+
+  template <ComparisonType CMP>
+  __attribute__((target("avx2"))) static uint32_t Match(const int64_t *values, int64_t constant) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+    __m256i c = _mm256_set1_epi64x(constant);
+    __m256i is_null = _mm256_cmpeq_epi64(v, _mm256_set1_epi64x(BUSTUB_INT64_NULL));
+    __m256i match;
+    if (CMP == ComparisonType::Equal || CMP == ComparisonType::NotEqual) {
+      match = _mm256_cmpeq_epi64(v, c);
+    } else if (CMP == ComparisonType::LessThan || CMP == ComparisonType::GreaterThanOrEqual) {
+      match = _mm256_cmpgt_epi64(c, v);
+    } else {
+      match = _mm256_cmpgt_epi64(v, c);
+    }
+    return Combine<LANES>(MoveMask64(match), MoveMask64(is_null),
+                          CMP == ComparisonType::NotEqual || CMP == ComparisonType::LessThanOrEqual ||
+                              CMP == ComparisonType::GreaterThanOrEqual);
+  }
+};
+
+/** Compares 4 doubles at a time. Unlike the integers, every comparison exists. */
+struct DoubleLanes {
+  using Value = double;
+  static constexpr size_t LANES = 4;
+
+  template <ComparisonType CMP>
+  __attribute__((target("avx2"))) static uint32_t Match(const double *values, double constant) {
+    __m256d v = _mm256_loadu_pd(values);
+    __m256d c = _mm256_set1_pd(constant);
+    __m256d is_null = _mm256_cmp_pd(v, _mm256_set1_pd(BUSTUB_DECIMAL_NULL), _CMP_EQ_OQ);
+    __m256d match;
+    switch (CMP) {
+      case ComparisonType::Equal:
+        match = _mm256_cmp_pd(v, c, _CMP_EQ_OQ);
+        break;
+      case ComparisonType::NotEqual:
+        match = _mm256_cmp_pd(v, c, _CMP_NEQ_UQ);
+        break;
+      case ComparisonType::LessThan:
+        match = _mm256_cmp_pd(v, c, _CMP_LT_OQ);
+        break;
+      case ComparisonType::LessThanOrEqual:
+        match = _mm256_cmp_pd(v, c, _CMP_LE_OQ);
+        break;
+      case ComparisonType::GreaterThan:
+        match = _mm256_cmp_pd(v, c, _CMP_GT_OQ);
+        break;
+      case ComparisonType::GreaterThanOrEqual:
+      default:
+        match = _mm256_cmp_pd(v, c, _CMP_GE_OQ);
+        break;
+    }
+    return Combine<LANES>(static_cast<uint32_t>(_mm256_movemask_pd(match)),
+                          static_cast<uint32_t>(_mm256_movemask_pd(is_null)), false);
+  }
+};
+
+/**
+ * Runs a vector comparison over all full 64-value words of a vector, Lanes::LANES values at a time.
+ * @return the number of values handled
+ */
+template <typename Lanes, ComparisonType CMP>
+__attribute__((target("avx2"))) size_t CompareWords(const typename Lanes::Value *values, size_t size,
+                                                    typename Lanes::Value constant, uint64_t *bitmask) {
+  size_t full_words = size / 64;
+  for (size_t word = 0; word < full_words; word++) {
+    uint64_t bits = 0;
+    for (size_t j = 0; j < 64; j += Lanes::LANES) {
+      bits |= static_cast<uint64_t>(Lanes::template Match<CMP>(values + word * 64 + j, constant)) << j;
+    }
+    bitmask[word] = bits;
+  }
+  return full_words * 64;
+}
+
+/** CompareWords() for a comparison known at run time. Must only be called if IsVectorized(). */
+template <typename Lanes>
+size_t CompareWordsAvx2(const typename Lanes::Value *values, size_t size, ComparisonType comp_type,
+                        typename Lanes::Value constant, uint64_t *bitmask) {
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      return CompareWords<Lanes, ComparisonType::Equal>(values, size, constant, bitmask);
+    case ComparisonType::NotEqual:
+      return CompareWords<Lanes, ComparisonType::NotEqual>(values, size, constant, bitmask);
+    case ComparisonType::LessThan:
+      return CompareWords<Lanes, ComparisonType::LessThan>(values, size, constant, bitmask);
+    case ComparisonType::LessThanOrEqual:
+      return CompareWords<Lanes, ComparisonType::LessThanOrEqual>(values, size, constant, bitmask);
+    case ComparisonType::GreaterThan:
+      return CompareWords<Lanes, ComparisonType::GreaterThan>(values, size, constant, bitmask);
+    case ComparisonType::GreaterThanOrEqual:
+    default:
+      return CompareWords<Lanes, ComparisonType::GreaterThanOrEqual>(values, size, constant, bitmask);
+  }
+}
+
+}  // namespace
+
+void FilterKernels::CompareConstant(const int32_t *values, size_t size, ComparisonType comp_type, int32_t constant,
+                                    uint64_t *bitmask) {
+  size_t done = IsVectorized() ? CompareWordsAvx2<Int32Lanes>(values, size, comp_type, constant, bitmask) : 0;
+  CompareConstantScalar<int32_t>(values + done, size - done, comp_type, constant, BUSTUB_INT32_NULL,
+                                 bitmask + done / 64);
+}
+
+void FilterKernels::CompareConstant(const int64_t *values, size_t size, ComparisonType comp_type, int64_t constant,
+                                    uint64_t *bitmask) {
+  size_t done = IsVectorized() ? CompareWordsAvx2<Int64Lanes>(values, size, comp_type, constant, bitmask) : 0;
+  CompareConstantScalar<int64_t>(values + done, size - done, comp_type, constant, BUSTUB_INT64_NULL,
+                                 bitmask + done / 64);
+}
+
+void FilterKernels::CompareConstant(const double *values, size_t size, ComparisonType comp_type, double constant,
+                                    uint64_t *bitmask) {
+  size_t done = IsVectorized() ? CompareWordsAvx2<DoubleLanes>(values, size, comp_type, constant, bitmask) : 0;
+  CompareConstantScalar<double>(values + done, size - done, comp_type, constant, BUSTUB_DECIMAL_NULL,
+                                bitmask + done / 64);
+}
+
+bool FilterKernels::IsVectorized() { return __builtin_cpu_supports("avx2") != 0; }
+
+#else
+
+void FilterKernels::CompareConstant(const int32_t *values, size_t size, ComparisonType comp_type, int32_t constant,
+                                    uint64_t *bitmask) {
+  CompareConstantScalar<int32_t>(values, size, comp_type, constant, BUSTUB_INT32_NULL, bitmask);
+}
+
+void FilterKernels::CompareConstant(const int64_t *values, size_t size, ComparisonType comp_type, int64_t constant,
+                                    uint64_t *bitmask) {
+  CompareConstantScalar<int64_t>(values, size, comp_type, constant, BUSTUB_INT64_NULL, bitmask);
+}
+
+void FilterKernels::CompareConstant(const double *values, size_t size, ComparisonType comp_type, double constant,
+                                    uint64_t *bitmask) {
+  CompareConstantScalar<double>(values, size, comp_type, constant, BUSTUB_DECIMAL_NULL, bitmask);
+}
+
+bool FilterKernels::IsVectorized() { return false; }
+
+#endif
+
+void FilterKernels::BitmaskToSelection(const uint64_t *bitmask, size_t size, std::vector<uint32_t> *selection) {
+  selection->clear();
+  for (size_t word = 0; word < BitmaskWords(size); word++) {
+    uint64_t bits = bitmask[word];
+    while (bits != 0) {
+      selection->push_back(static_cast<uint32_t>(word * 64 + __builtin_ctzll(bits)));
+      bits &= bits - 1;
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_executor.cpp
+//
+// Identification: src/execution/gather_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/gather_executor.h"
+
+#include <utility>
+
+#include "execution/executor_factory.h"
+
+namespace bustub {
+
+GatherExecutor::GatherExecutor(ExecutorContext *exec_ctx, const GatherPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+GatherExecutor::~GatherExecutor() { StopInstances(); }
+
+void GatherExecutor::Init() {
+  StopInstances();
+  batch_.SetSize(0);
+  batch_row_ = 0;
+
+  WorkerPool *pool = exec_ctx_->GetWorkerPool();
+  if (pool == nullptr) {
+    if (own_pool_ == nullptr) {
+      own_pool_ = std::make_unique<WorkerPool>();
+    }
+    pool = own_pool_.get();
+  }
+  size_t instance_count = plan_->GetInstanceCount();
+  parallel_state_ = std::make_unique<ParallelState>(instance_count);
+  exchange_ = std::make_unique<ExchangeQueue>(instance_count, 2 * instance_count);
+  for (size_t i = 0; i < instance_count; i++) {
+    instance_contexts_.emplace_back(
+        std::make_unique<ExecutorContext>(*exec_ctx_, parallel_state_.get(), i, instance_count));
+    instance_contexts_.back()->SetWorkerPool(pool);
+    instances_.push_back(ExecutorFactory::CreateExecutor(instance_contexts_.back().get(), plan_->GetChildPlan()));
+  }
+  for (size_t i = 0; i < instance_count; i++) {
+    tasks_.push_back(pool->Submit([this, i] { RunInstance(i); }));
+  }
+}
+
+bool GatherExecutor::Next(Tuple *tuple, RID *rid) {
+  while (batch_row_ == batch_.GetSize()) {
+    if (!NextBatch(&batch_)) {
+      return false;
+    }
+    batch_row_ = 0;
+  }
+  *tuple = batch_.GetTuple(batch_row_++, plan_->OutputSchema());
+  return true;
+}
+
+bool GatherExecutor::NextBatch(VectorBatch *batch) {
+  if (exchange_->Pop(batch)) {
+    return true;
+  }
+  WaitForInstances();
+  return false;
+}
+
+void GatherExecutor::RunInstance(size_t instance_idx) {
+  // The instance is destroyed by its task, so that one that stops early releases what it holds right away, e.g. the
+  // partition of a repartition other instances' producers may be waiting on.
+  std::unique_ptr<AbstractExecutor> instance = std::move(instances_[instance_idx]);
+  try {
+    instance->Init();
+    VectorBatch batch;
+    while (instance->PullBatch(&batch)) {
+      if (!exchange_->Push(std::move(batch))) {
+        break;
+      }
+    }
+  } catch (...) {
+    instance.reset();
+    exchange_->FinishProducer();
+    throw;
+  }
+  instance.reset();
+  exchange_->FinishProducer();
+}
+
+void GatherExecutor::WaitForInstances() {
+  // Collect all tasks before rethrowing, so that none is left running.
+  std::vector<std::future<void>> tasks = std::move(tasks_);
+  tasks_.clear();
+  for (auto &task : tasks) {
+    task.wait();
+  }
+  for (auto &task : tasks) {
+    task.get();
+  }
+}
+
+void GatherExecutor::StopInstances() {
+  if (exchange_ != nullptr) {
+    exchange_->Close();
+  }
+  for (auto &task : tasks_) {
+    task.wait();
+  }
+  tasks_.clear();
+  instances_.clear();
+  instance_contexts_.clear();
+  parallel_state_.reset();
+  exchange_.reset();
+}
+
+}  // namespace bustub
@@ -0,0 +1,275 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.cpp
+//
+// Identification: src/execution/hash_join_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/hash_join_executor.h"
+
+#include "common/exception.h"
+
+namespace bustub {
+
+HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                                   std::unique_ptr<AbstractExecutor> &&right_executor)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_executor)),
+      right_executor_(std::move(right_executor)) {}
+
+void HashJoinExecutor::Init() {
+  left_executor_->Init();
+  right_executor_->Init();
+  use_projection_ = projection_.InitFromExpressions(plan_->OutputSchema(), {left_executor_->GetOutputSchema(),
+                                                                            right_executor_->GetOutputSchema()});
+  probe_buffer_.clear();
+  probe_buffer_idx_ = 0;
+  probe_prefix_run_.reset();
+  pending_.clear();
+  current_pair_ = SpilledPair{};
+  spilled_partition_count_ = 0;
+  matches_ = nullptr;
+  match_idx_ = 0;
+
+  // Find the smaller input by reading both children until one of them is exhausted or the memory budget is used up.
+  std::vector<Tuple> left_tuples;
+  std::vector<Tuple> right_tuples;
+  size_t left_size = 0;
+  size_t right_size = 0;
+  bool left_done = false;
+  bool right_done = false;
+  Tuple tuple;
+  RID rid;
+  while (!left_done && !right_done && left_size + right_size <= exec_ctx_->GetMemoryBudget()) {
+    if (left_executor_->Next(&tuple, &rid)) {
+      left_size += MemoryOf(tuple);
+      left_tuples.push_back(tuple);
+    } else {
+      left_done = true;
+    }
+    if (right_executor_->Next(&tuple, &rid)) {
+      right_size += MemoryOf(tuple);
+      right_tuples.push_back(tuple);
+    } else {
+      right_done = true;
+    }
+  }
+  if (left_done || right_done) {
+    build_left_ = left_done && (!right_done || left_tuples.size() <= right_tuples.size());
+  } else {
+    build_left_ = left_size <= right_size;
+  }
+  probe_done_ = build_left_ ? right_done : left_done;
+  bool build_done = build_left_ ? left_done : right_done;
+  std::vector<Tuple> &build_tuples = build_left_ ? left_tuples : right_tuples;
+  probe_buffer_ = std::move(build_left_ ? right_tuples : left_tuples);
+
+  // Neither input fits: the probe tuples read so far would eat into the memory of the build side.
+  if (!build_done) {
+    probe_prefix_run_ = std::make_unique<TmpTupleRun>(exec_ctx_->GetBufferPoolManager());
+    for (const auto &probe_tuple : probe_buffer_) {
+      AppendToRun(probe_prefix_run_.get(), probe_tuple);
+    }
+    probe_prefix_run_->FinishAppend();
+    probe_buffer_.clear();
+  }
+
+  AbstractExecutor *build_executor = build_left_ ? left_executor_.get() : right_executor_.get();
+  size_t build_idx = 0;
+  Build(
+      [&](Tuple *build_tuple) {
+        if (build_idx < build_tuples.size()) {
+          *build_tuple = build_tuples[build_idx++];
+          return true;
+        }
+        RID build_rid;
+        return !build_done && build_executor->Next(build_tuple, &build_rid);
+      },
+      0);
+}
+
+bool HashJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  while (matches_ == nullptr || match_idx_ == matches_->size()) {
+    if (!NextProbeTuple(&probe_tuple_)) {
+      if (!StartNextPass()) {
+        return false;
+      }
+      continue;
+    }
+    matches_ = nullptr;
+    match_idx_ = 0;
+    HashJoinKey key = MakeKey(probe_tuple_, false);
+    if (key.key_.IsNull()) {
+      continue;
+    }
+    Partition &partition = partitions_[PartitionOf(key)];
+    if (partition.probe_run_ != nullptr) {
+      AppendToRun(partition.probe_run_.get(), probe_tuple_);
+      continue;
+    }
+    auto iter = hash_table_.find(key);
+    if (iter != hash_table_.end()) {
+      matches_ = &iter->second;
+    }
+  }
+
+  const Tuple &build_tuple = (*matches_)[match_idx_++];
+  const Tuple &left_tuple = build_left_ ? build_tuple : probe_tuple_;
+  const Tuple &right_tuple = build_left_ ? probe_tuple_ : build_tuple;
+  if (use_projection_) {
+    *tuple = projection_.Project({&left_tuple, &right_tuple});
+    return true;
+  }
+  const Schema *left_schema = left_executor_->GetOutputSchema();
+  const Schema *right_schema = right_executor_->GetOutputSchema();
+  std::vector<Value> values;
+  for (const auto &column : plan_->OutputSchema()->GetColumns()) {
+    values.push_back(column.GetExpr()->EvaluateJoin(&left_tuple, left_schema, &right_tuple, right_schema));
+  }
+  *tuple = Tuple(values, plan_->OutputSchema());
+  return true;
+}
+
+void HashJoinExecutor::Build(const std::function<bool(Tuple *)> &next_build_tuple, uint32_t level) {
+  level_ = level;
+  partitions_.clear();
+  partitions_.resize(FANOUT);
+  hash_table_.clear();
+  memory_used_ = 0;
+
+  // Null keys never compare equal, so those tuples cannot join.
+  Tuple tuple;
+  while (next_build_tuple(&tuple)) {
+    HashJoinKey key = MakeKey(tuple, true);
+    if (key.key_.IsNull()) {
+      continue;
+    }
+    Partition &partition = partitions_[PartitionOf(key)];
+    if (partition.build_run_ != nullptr) {
+      AppendToRun(partition.build_run_.get(), tuple);
+      continue;
+    }
+    partition.size_ += MemoryOf(tuple);
+    memory_used_ += MemoryOf(tuple);
+    partition.tuples_.push_back(tuple);
+    // Past the last level the partitions are most likely a single key that no hash can split, so they stay in memory.
+    while (memory_used_ > exec_ctx_->GetMemoryBudget() && level_ < MAX_LEVEL) {
+      if (!SpillLargestPartition()) {
+        break;
+      }
+    }
+  }
+
+  for (auto &partition : partitions_) {
+    if (partition.build_run_ != nullptr) {
+      partition.build_run_->FinishAppend();
+      partition.probe_run_ = std::make_unique<TmpTupleRun>(exec_ctx_->GetBufferPoolManager());
+      continue;
+    }
+    for (auto &build_tuple : partition.tuples_) {
+      hash_table_[MakeKey(build_tuple, true)].push_back(std::move(build_tuple));
+    }
+    partition.tuples_.clear();
+  }
+}
+
+bool HashJoinExecutor::SpillLargestPartition() {
+  Partition *victim = nullptr;
+  for (auto &partition : partitions_) {
+    if (partition.build_run_ == nullptr && !partition.tuples_.empty() &&
+        (victim == nullptr || partition.size_ > victim->size_)) {
+      victim = &partition;
+    }
+  }
+  if (victim == nullptr) {
+    return false;
+  }
+  victim->build_run_ = std::make_unique<TmpTupleRun>(exec_ctx_->GetBufferPoolManager());
+  for (const auto &tuple : victim->tuples_) {
+    AppendToRun(victim->build_run_.get(), tuple);
+  }
+  memory_used_ -= victim->size_;
+  victim->tuples_.clear();
+  victim->tuples_.shrink_to_fit();
+  victim->size_ = 0;
+  spilled_partition_count_++;
+  return true;
+}
+
+bool HashJoinExecutor::StartNextPass() {
+  for (auto &partition : partitions_) {
+    if (partition.build_run_ == nullptr) {
+      continue;
+    }
+    partition.probe_run_->FinishAppend();
+    // An inner join of a partition with an empty side produces nothing.
+    if (partition.build_run_->GetTupleCount() > 0 && partition.probe_run_->GetTupleCount() > 0) {
+      pending_.push_back(SpilledPair{std::move(partition.build_run_), std::move(partition.probe_run_), level_ + 1});
+    }
+  }
+  partitions_.clear();
+  hash_table_.clear();
+  matches_ = nullptr;
+  if (pending_.empty()) {
+    current_pair_ = SpilledPair{};
+    level_ = 0;
+    return false;
+  }
+
+  current_pair_ = std::move(pending_.back());
+  pending_.pop_back();
+  TmpTupleRun *build_run = current_pair_.build_run_.get();
+  Build([build_run](Tuple *build_tuple) { return build_run->Next(build_tuple); }, current_pair_.level_);
+  current_pair_.build_run_->Clear();
+  return true;
+}
+
+bool HashJoinExecutor::NextProbeTuple(Tuple *tuple) {
+  if (level_ > 0) {
+    return current_pair_.probe_run_->Next(tuple);
+  }
+  if (probe_buffer_idx_ < probe_buffer_.size()) {
+    *tuple = probe_buffer_[probe_buffer_idx_++];
+    return true;
+  }
+  if (probe_prefix_run_ != nullptr) {
+    if (probe_prefix_run_->Next(tuple)) {
+      return true;
+    }
+    probe_prefix_run_.reset();
+  }
+  if (probe_done_) {
+    return false;
+  }
+  RID rid;
+  probe_done_ = !(build_left_ ? right_executor_ : left_executor_)->Next(tuple, &rid);
+  return !probe_done_;
+}
+
+HashJoinKey HashJoinExecutor::MakeKey(const Tuple &tuple, bool is_build) {
+  bool is_left = is_build == build_left_;
+  if (is_left) {
+    return {plan_->LeftJoinKey()->Evaluate(&tuple, left_executor_->GetOutputSchema())};
+  }
+  return {plan_->RightJoinKey()->Evaluate(&tuple, right_executor_->GetOutputSchema())};
+}
+
+uint32_t HashJoinExecutor::PartitionOf(const HashJoinKey &key) const {
+  hash_t hash = HashUtil::CombineHashes(std::hash<HashJoinKey>()(key), level_);
+  return hash % FANOUT;
+}
+
+void HashJoinExecutor::AppendToRun(TmpTupleRun *run, const Tuple &tuple) {
+  if (!run->Append(tuple)) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Hash join cannot spill: no free frame in the buffer pool.");
+  }
+}
+
+}  // namespace bustub
@@ -16,10 +16,30 @@ namespace bustub {
 
 LimitExecutor::LimitExecutor(ExecutorContext *exec_ctx, const LimitPlanNode *plan,
                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
 
-void LimitExecutor::Init() {}
+void LimitExecutor::Init() {
+  child_executor_->Init();
+  skipped_ = 0;
+  emitted_ = 0;
+}
 
-bool LimitExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+bool LimitExecutor::Next(Tuple *tuple, RID *rid) {
+  // Stop pulling from the child as soon as the limit is reached.
+  if (emitted_ == plan_->GetLimit()) {
+    return false;
+  }
+  while (skipped_ < plan_->GetOffset()) {
+    if (!child_executor_->Next(tuple, rid)) {
+      return false;
+    }
+    skipped_++;
+  }
+  if (!child_executor_->Next(tuple, rid)) {
+    return false;
+  }
+  emitted_++;
+  return true;
+}
 
 }  // namespace bustub
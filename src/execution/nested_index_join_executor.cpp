@@ -12,14 +12,112 @@
 
 #include "execution/executors/nested_index_join_executor.h"
 
+#include <algorithm>
+
 namespace bustub {
 
 NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
                                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+void NestIndexJoinExecutor::Init() {
+  child_executor_->Init();
+  inner_table_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetInnerTableOid());
+  index_info_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexName(), inner_table_->name_);
+  BUSTUB_ASSERT(index_info_->index_->GetKeySchema()->GetColumnCount() == 1,
+                "Nested index joins need an index on the join column only.");
+  outer_tuples_.clear();
+  inner_rids_.clear();
+  outer_idx_ = 0;
+  rid_idx_ = 0;
+  use_projection_ = projection_.InitFromExpressions(plan_->OutputSchema(),
+                                                    {child_executor_->GetOutputSchema(), &inner_table_->schema_});
+}
+
+bool NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  const Schema *outer_schema = child_executor_->GetOutputSchema();
+  const Schema *inner_schema = &inner_table_->schema_;
+  while (true) {
+    while (outer_idx_ < outer_tuples_.size() && rid_idx_ == inner_rids_[outer_idx_].size()) {
+      outer_idx_++;
+      rid_idx_ = 0;
+    }
+    if (outer_idx_ == outer_tuples_.size()) {
+      if (!NextBatch()) {
+        return false;
+      }
+      continue;
+    }
+
+    const Tuple &outer_tuple = outer_tuples_[outer_idx_];
+    Tuple inner_tuple;
+    if (!inner_table_->table_->GetTuple(inner_rids_[outer_idx_][rid_idx_++], &inner_tuple,
+                                        exec_ctx_->GetTransaction())) {
+      continue;
+    }
+    if (!plan_->Predicate()->EvaluateJoin(&outer_tuple, outer_schema, &inner_tuple, inner_schema).GetAs<bool>()) {
+      continue;
+    }
+    if (use_projection_) {
+      *tuple = projection_.Project({&outer_tuple, &inner_tuple});
+      return true;
+    }
+    std::vector<Value> values;
+    for (const auto &column : plan_->OutputSchema()->GetColumns()) {
+      values.push_back(column.GetExpr()->EvaluateJoin(&outer_tuple, outer_schema, &inner_tuple, inner_schema));
+    }
+    *tuple = Tuple(values, plan_->OutputSchema());
+    return true;
+  }
+}
+
+bool NestIndexJoinExecutor::NextBatch() {
+  outer_tuples_.clear();
+  outer_idx_ = 0;
+  rid_idx_ = 0;
+  Tuple outer_tuple;
+  RID outer_rid;
+  while (outer_tuples_.size() < BATCH_SIZE && child_executor_->Next(&outer_tuple, &outer_rid)) {
+    outer_tuples_.push_back(outer_tuple);
+  }
+  if (outer_tuples_.empty()) {
+    inner_rids_.clear();
+    return false;
+  }
+
+  // Sort the outer tuples by key, leaving out null keys, which match nothing.
+  const Schema *key_schema = index_info_->index_->GetKeySchema();
+  TypeId key_type = key_schema->GetColumn(0).GetType();
+  std::vector<Value> keys;
+  std::vector<size_t> order;
+  keys.reserve(outer_tuples_.size());
+  for (size_t i = 0; i < outer_tuples_.size(); i++) {
+    keys.push_back(plan_->OuterJoinKey()->Evaluate(&outer_tuples_[i], child_executor_->GetOutputSchema()));
+    if (!keys.back().IsNull()) {
+      keys.back() = keys.back().CastAs(key_type);
+      order.push_back(i);
+    }
+  }
+  std::sort(order.begin(), order.end(),
+            [&](size_t lhs, size_t rhs) { return keys[lhs].CompareLessThan(keys[rhs]) == CmpBool::CmpTrue; });
 
-void NestIndexJoinExecutor::Init() {}
+  // Look up every distinct key once, in key order.
+  std::vector<Tuple> key_tuples;
+  std::vector<size_t> key_of(outer_tuples_.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    if (i == 0 || keys[order[i]].CompareEquals(keys[order[i - 1]]) != CmpBool::CmpTrue) {
+      key_tuples.emplace_back(std::vector<Value>{keys[order[i]]}, key_schema);
+    }
+    key_of[order[i]] = key_tuples.size() - 1;
+  }
+  std::vector<std::vector<RID>> key_rids;
+  index_info_->index_->ScanKeys(key_tuples, &key_rids, exec_ctx_->GetTransaction());
 
-bool NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+  inner_rids_.assign(outer_tuples_.size(), std::vector<RID>{});
+  for (size_t idx : order) {
+    inner_rids_[idx] = key_rids[key_of[idx]];
+  }
+  return true;
+}
 
 }  // namespace bustub
@@ -23,11 +23,18 @@ NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const
       right_executor(std::move(right_executor)) {}
 
 void NestedLoopJoinExecutor::Init() {
+  left_executor->Init();
+  right_executor->Init();
+  if (plan_->Predicate() != nullptr) {
+    predicate_program_.Compile(plan_->Predicate(), left_executor->GetOutputSchema(), right_executor->GetOutputSchema());
+  }
+  projection_.InitByName(plan_->OutputSchema(), {left_executor->GetOutputSchema(), right_executor->GetOutputSchema()});
   RID rid;
   out_is_end = !left_executor->Next(&currentOut, &rid);
 }
 
 bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  arena_.Reset();
   while (true) {
     if (out_is_end) {
       return false;
@@ -41,29 +48,23 @@ bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) {
       out_is_end = !left_executor->Next(&currentOut, &outRid);
       continue;
     }
-    if (plan_->Predicate() != nullptr || plan_->Predicate()
-                                             ->EvaluateJoin(&currentOut, left_executor.get()->GetOutputSchema(),
-                                                            &inertTuple, right_executor.get()->GetOutputSchema())
-                                             .GetAs<bool>()) {
-      std::vector<Value> values;
-      const Schema *left_schema = left_executor.get()->GetOutputSchema();
-      const Schema *right_schema = right_executor.get()->GetOutputSchema();
-      const Schema *out_schema = plan_->OutputSchema();
-      for (uint32_t i = 0; i < out_schema->GetColumnCount(); ++i) {
-        std::string col_name = out_schema->GetColumn(i).GetName();
-        auto col_idx = left_schema->GetColIdx(col_name);
-        if (col_idx != -1) {
-          values.push_back(currentOut.GetValue(left_schema, col_idx));
-          continue;
-        }
-        col_idx = right_schema->GetColIdx(col_name);
-        assert(col_idx != -1);
-        values.push_back(currentOut.GetValue(right_schema, col_idx));
-      }
-      *tuple = Tuple(values, out_schema);
+    if (PredicateMatches(inertTuple)) {
+      *tuple = projection_.Project({&currentOut, &inertTuple}, &arena_);
       return true;
     }
   }
 }
 
+bool NestedLoopJoinExecutor::PredicateMatches(const Tuple &inner_tuple) {
+  if (plan_->Predicate() == nullptr) {
+    return true;
+  }
+  if (predicate_program_.IsCompiled()) {
+    return predicate_program_.MatchesJoin(&currentOut, &inner_tuple);
+  }
+  return plan_->Predicate()
+      ->EvaluateJoin(&currentOut, left_executor->GetOutputSchema(), &inner_tuple, right_executor->GetOutputSchema())
+      .GetAs<bool>();
+}
+
 }  // namespace bustub
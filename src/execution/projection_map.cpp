@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// projection_map.cpp
+//
+// Identification: src/execution/projection_map.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/projection_map.h"
+
+#include <cstring>
+
+#include "common/macros.h"
+#include "execution/expressions/column_value_expression.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the bytes of a serialized VARCHAR, its length prefix included */
+uint32_t VarlenSize(const char *payload) {
+  uint32_t length = *reinterpret_cast<const uint32_t *>(payload);
+  return sizeof(uint32_t) + (length == BUSTUB_VALUE_NULL ? 0 : length);
+}
+
+/** @return the serialized VARCHAR of a column of a tuple */
+const char *VarlenPayload(const Tuple &tuple, const Column &column) {
+  return tuple.GetData() + *reinterpret_cast<const uint32_t *>(tuple.GetData() + column.GetOffset());
+}
+
+}  // namespace
+
+void ProjectionMap::InitByName(const Schema *output, std::initializer_list<const Schema *> inputs) {
+  output_ = output;
+  inputs_.assign(inputs.begin(), inputs.end());
+  sources_.clear();
+  for (const auto &column : output->GetColumns()) {
+    bool found = false;
+    for (uint32_t input_idx = 0; input_idx < inputs_.size() && !found; input_idx++) {
+      int32_t col_idx = inputs_[input_idx]->GetColIdx(column.GetName());
+      if (col_idx != -1) {
+        sources_.push_back(Source{input_idx, static_cast<uint32_t>(col_idx)});
+        found = true;
+      }
+    }
+    BUSTUB_ASSERT(found, "An output column is missing from the inputs.");
+  }
+  Plan();
+}
+
+bool ProjectionMap::InitFromExpressions(const Schema *output, std::initializer_list<const Schema *> inputs) {
+  output_ = output;
+  inputs_.assign(inputs.begin(), inputs.end());
+  sources_.clear();
+  for (const auto &column : output->GetColumns()) {
+    auto expr = dynamic_cast<const ColumnValueExpression *>(column.GetExpr());
+    if (expr == nullptr || expr->GetTupleIdx() >= inputs_.size()) {
+      return false;
+    }
+    sources_.push_back(Source{expr->GetTupleIdx(), expr->GetColIdx()});
+  }
+  Plan();
+  return true;
+}
+
+void ProjectionMap::Plan() {
+  fixed_runs_.clear();
+  varlen_cols_.clear();
+  // Bytes are copied from columns at fixed offsets, where nulls are stored as sentinels, into a tuple without bitmap.
+  raw_ = output_->GetTupleFormat() == TupleFormat::PLAIN;
+  for (const Schema *input : inputs_) {
+    raw_ = raw_ && input->HasFixedOffsets();
+  }
+  if (!raw_) {
+    return;
+  }
+  for (uint32_t i = 0; i < sources_.size(); i++) {
+    const Column &dst = output_->GetColumn(i);
+    const Column &src = inputs_[sources_[i].input_idx_]->GetColumn(sources_[i].col_idx_);
+    if (src.GetType() != dst.GetType()) {
+      raw_ = false;
+      return;
+    }
+    if (!dst.IsInlined()) {
+      varlen_cols_.push_back(i);
+      continue;
+    }
+    if (!fixed_runs_.empty()) {
+      CopyRun &last = fixed_runs_.back();
+      if (last.input_idx_ == sources_[i].input_idx_ && last.src_offset_ + last.length_ == src.GetOffset() &&
+          last.dst_offset_ + last.length_ == dst.GetOffset()) {
+        last.length_ += dst.GetFixedLength();
+        continue;
+      }
+    }
+    fixed_runs_.push_back(CopyRun{sources_[i].input_idx_, src.GetOffset(), dst.GetOffset(), dst.GetFixedLength()});
+  }
+}
+
+Tuple ProjectionMap::Project(std::initializer_list<const Tuple *> inputs, Arena *arena) const {
+  const Tuple *const *tuples = inputs.begin();
+  if (!raw_) {
+    std::vector<Value> values;
+    values.reserve(sources_.size());
+    for (const auto &source : sources_) {
+      values.push_back(tuples[source.input_idx_]->GetValue(inputs_[source.input_idx_], source.col_idx_));
+    }
+    return arena == nullptr ? Tuple(values, output_) : Tuple(values, output_, arena);
+  }
+
+  uint32_t size = output_->GetLength();
+  for (uint32_t col_idx : varlen_cols_) {
+    const Source &source = sources_[col_idx];
+    const Column &src = inputs_[source.input_idx_]->GetColumn(source.col_idx_);
+    size += VarlenSize(VarlenPayload(*tuples[source.input_idx_], src));
+  }
+  Tuple tuple(size, arena);
+  char *data = tuple.GetData();
+  for (const auto &run : fixed_runs_) {
+    memcpy(data + run.dst_offset_, tuples[run.input_idx_]->GetData() + run.src_offset_, run.length_);
+  }
+  uint32_t offset = output_->GetLength();
+  for (uint32_t col_idx : varlen_cols_) {
+    const Source &source = sources_[col_idx];
+    const Column &src = inputs_[source.input_idx_]->GetColumn(source.col_idx_);
+    const char *payload = VarlenPayload(*tuples[source.input_idx_], src);
+    uint32_t payload_size = VarlenSize(payload);
+    *reinterpret_cast<uint32_t *>(data + output_->GetColumn(col_idx).GetOffset()) = offset;
+    memcpy(data + offset, payload, payload_size);
+    offset += payload_size;
+  }
+  return tuple;
+}
+
+}  // namespace bustub
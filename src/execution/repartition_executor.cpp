@@ -0,0 +1,183 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// repartition_executor.cpp
+//
+// Identification: src/execution/repartition_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/repartition_executor.h"
+
+#include <utility>
+
+#include "common/util/hash_util.h"
+#include "common/worker_pool.h"
+#include "execution/executor_factory.h"
+
+namespace bustub {
+
+RepartitionExecutor::RepartitionExecutor(ExecutorContext *exec_ctx, const RepartitionPlanNode *plan,
+                                         std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+RepartitionExecutor::~RepartitionExecutor() {
+  // Producers blocked on the partition of an instance that stopped early must not wait for it.
+  if (state_ != nullptr) {
+    state_->GetPartition(exec_ctx_->GetInstanceIdx())->Close();
+  }
+}
+
+void RepartitionExecutor::Init() {
+  batch_.SetSize(0);
+  batch_row_ = 0;
+  if (child_executor_ != nullptr) {
+    child_executor_->Init();
+    return;
+  }
+  ParallelState *parallel_state = exec_ctx_->GetParallelState();
+  BUSTUB_ASSERT(parallel_state != nullptr, "A repartition without a child executor must run in a parallel subtree.");
+  ExecutorContext *exec_ctx = exec_ctx_;
+  const RepartitionPlanNode *plan = plan_;
+  state_ = parallel_state->GetOrCreate<RepartitionState>(
+      plan_, [exec_ctx, plan] { return std::make_unique<RepartitionState>(exec_ctx, plan); });
+  state_->Start();
+}
+
+bool RepartitionExecutor::Next(Tuple *tuple, RID *rid) {
+  if (child_executor_ != nullptr) {
+    return child_executor_->Next(tuple, rid);
+  }
+  while (batch_row_ == batch_.GetSize()) {
+    if (!NextBatch(&batch_)) {
+      return false;
+    }
+    batch_row_ = 0;
+  }
+  *tuple = batch_.GetTuple(batch_row_++, plan_->OutputSchema());
+  return true;
+}
+
+bool RepartitionExecutor::NextBatch(VectorBatch *batch) {
+  if (child_executor_ != nullptr) {
+    return child_executor_->NextBatch(batch);
+  }
+  if (state_->GetPartition(exec_ctx_->GetInstanceIdx())->Pop(batch)) {
+    return true;
+  }
+  state_->Finish();
+  return false;
+}
+
+RepartitionExecutor::RepartitionState::RepartitionState(ExecutorContext *exec_ctx, const RepartitionPlanNode *plan)
+    : plan_(plan), pool_(exec_ctx->GetWorkerPool()) {
+  BUSTUB_ASSERT(pool_ != nullptr, "A parallel subtree needs a worker pool.");
+  size_t instance_count = exec_ctx->GetParallelState()->GetInstanceCount();
+  parallel_state_ = std::make_unique<ParallelState>(instance_count);
+  for (size_t i = 0; i < instance_count; i++) {
+    instance_contexts_.emplace_back(
+        std::make_unique<ExecutorContext>(*exec_ctx, parallel_state_.get(), i, instance_count));
+    instances_.push_back(ExecutorFactory::CreateExecutor(instance_contexts_.back().get(), plan_->GetChildPlan()));
+    partitions_.emplace_back(std::make_unique<ExchangeQueue>(instance_count, 2 * instance_count));
+  }
+}
+
+RepartitionExecutor::RepartitionState::~RepartitionState() {
+  for (auto &partition : partitions_) {
+    partition->Close();
+  }
+  for (auto &producer : producers_) {
+    producer.wait();
+  }
+}
+
+void RepartitionExecutor::RepartitionState::Start() {
+  std::call_once(started_, [this] {
+    for (size_t i = 0; i < instances_.size(); i++) {
+      producers_.emplace_back(pool_->Submit([this, i] { Produce(i); }));
+    }
+  });
+}
+
+void RepartitionExecutor::RepartitionState::Finish() {
+  for (auto &producer : producers_) {
+    producer.wait();
+  }
+  for (auto &producer : producers_) {
+    producer.get();
+  }
+}
+
+void RepartitionExecutor::RepartitionState::Produce(size_t instance_idx) {
+  std::unique_ptr<AbstractExecutor> instance = std::move(instances_[instance_idx]);
+  const Schema *schema = instance->GetOutputSchema();
+  const std::vector<const AbstractExpression *> &hash_keys = plan_->GetHashKeys();
+  bool keys_support_batch = true;
+  for (const auto *key : hash_keys) {
+    keys_support_batch = keys_support_batch && key->SupportsBatch();
+  }
+
+  // A partition whose queue is closed has stopped reading, the others still need their tuples.
+  std::vector<bool> open(partitions_.size(), true);
+  size_t open_count = partitions_.size();
+  auto finish = [this] {
+    for (auto &partition : partitions_) {
+      partition->FinishProducer();
+    }
+  };
+  try {
+    instance->Init();
+    VectorBatch batch;
+    std::vector<hash_t> hashes;
+    ColumnVector key_values;
+    std::vector<std::vector<uint32_t>> selections(partitions_.size());
+    while (open_count > 0 && instance->PullBatch(&batch)) {
+      // Null keys hash to 0 like in the hash join, so all of them end up in the same partition.
+      hashes.assign(batch.GetSize(), 0);
+      for (size_t key_idx = 0; key_idx < hash_keys.size(); key_idx++) {
+        if (keys_support_batch) {
+          hash_keys[key_idx]->EvaluateBatch(batch, &key_values);
+        }
+        for (size_t row = 0; row < batch.GetSize(); row++) {
+          Value value;
+          if (keys_support_batch) {
+            value = key_values.GetValue(row);
+          } else {
+            Tuple tuple = batch.GetTuple(row, schema);
+            value = hash_keys[key_idx]->Evaluate(&tuple, schema);
+          }
+          hash_t hash = value.IsNull() ? 0 : HashUtil::HashValue(&value);
+          hashes[row] = key_idx == 0 ? hash : HashUtil::CombineHashes(hashes[row], hash);
+        }
+      }
+      for (auto &selection : selections) {
+        selection.clear();
+      }
+      for (size_t row = 0; row < batch.GetSize(); row++) {
+        selections[hashes[row] % partitions_.size()].push_back(static_cast<uint32_t>(row));
+      }
+      for (size_t partition_idx = 0; partition_idx < partitions_.size(); partition_idx++) {
+        if (!open[partition_idx] || selections[partition_idx].empty()) {
+          continue;
+        }
+        VectorBatch partition_batch = batch;
+        partition_batch.Select(selections[partition_idx]);
+        if (!partitions_[partition_idx]->Push(std::move(partition_batch))) {
+          open[partition_idx] = false;
+          open_count--;
+        }
+      }
+    }
+  } catch (...) {
+    instance.reset();
+    finish();
+    throw;
+  }
+  instance.reset();
+  finish();
+}
+
+}  // namespace bustub
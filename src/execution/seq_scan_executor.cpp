@@ -11,39 +11,586 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/seq_scan_executor.h"
 
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/filter_kernels.h"
+#include "execution/parallel_state.h"
+#include "storage/page/compressed_page.h"
+#include "storage/page/pax_page.h"
+#include "storage/page/table_page.h"
+
 namespace bustub {
 
+namespace {
+
+/** Adds the columns read by an expression to col_idxs. */
+void CollectColumns(const AbstractExpression *expr, std::vector<uint32_t> *col_idxs) {
+  auto column = dynamic_cast<const ColumnValueExpression *>(expr);
+  if (column != nullptr) {
+    col_idxs->push_back(column->GetColIdx());
+  }
+  for (const auto *child : expr->GetChildren()) {
+    CollectColumns(child, col_idxs);
+  }
+}
+
+/** @return the comparison that gives the same result with its operands swapped */
+ComparisonType Mirror(ComparisonType comp_type) {
+  switch (comp_type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comp_type;
+  }
+}
+
+/** @return true if a constant of type from can be compared as a value of type to without changing the result */
+bool CastsLosslessly(TypeId from, TypeId to) {
+  bool integral = from == TypeId::TINYINT || from == TypeId::SMALLINT || from == TypeId::INTEGER;
+  switch (to) {
+    case TypeId::INTEGER:
+      return integral;
+    case TypeId::BIGINT:
+      return integral || from == TypeId::BIGINT;
+    case TypeId::DECIMAL:
+      // Integers are compared to decimals as doubles anyway.
+      return integral || from == TypeId::BIGINT || from == TypeId::DECIMAL;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
 SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx),
-      plan_(plan),
-      iterator(
-          exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid())->table_.get()->Begin(exec_ctx_->GetTransaction())) {}
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
 
 void SeqScanExecutor::Init() {
   auto table_id = plan_->GetTableOid();
-  tableHeap = exec_ctx_->GetCatalog()->GetTable(table_id)->table_.get();
+  auto table_info = exec_ctx_->GetCatalog()->GetTable(table_id);
+  tableHeap = table_info->table_.get();
+  table_schema_ = &table_info->schema_;
+
+  // Output columns are matched to the table by name.
+  output_col_idxs_.clear();
+  for (const auto &column : plan_->OutputSchema()->GetColumns()) {
+    output_col_idxs_.push_back(table_schema_->GetColIdx(column.GetName()));
+  }
+  const Schema *output_schema = plan_->OutputSchema();
+  identity_projection_ = output_schema->GetColumnCount() == table_schema_->GetColumnCount() &&
+                         output_schema->GetTupleFormat() == table_schema_->GetTupleFormat();
+  for (uint32_t i = 0; i < output_col_idxs_.size() && identity_projection_; i++) {
+    identity_projection_ = output_col_idxs_[i] == i &&
+                           output_schema->GetColumn(i).GetType() == table_schema_->GetColumn(i).GetType() &&
+                           output_schema->GetColumn(i).GetLength() == table_schema_->GetColumn(i).GetLength();
+  }
+  projection_.InitByName(output_schema, {table_schema_});
+  read_col_idxs_ = output_col_idxs_;
+  if (plan_->GetPredicate() != nullptr) {
+    CollectColumns(plan_->GetPredicate(), &read_col_idxs_);
+  }
+  std::sort(read_col_idxs_.begin(), read_col_idxs_.end());
+  read_col_idxs_.erase(std::unique(read_col_idxs_.begin(), read_col_idxs_.end()), read_col_idxs_.end());
+
+  pax_ = tableHeap->GetLayout() == TableLayout::PAX;
+  compressed_ = tableHeap->GetLayout() == TableLayout::COMPRESSED;
+  columnar_values_.clear();
+  for (const auto &column : table_schema_->GetColumns()) {
+    columnar_values_.push_back(ValueFactory::GetNullValueByType(column.GetType()));
+  }
+
+  cursor_ = ScanCursor();
+  dispenser_ = nullptr;
+  ParallelState *parallel_state = exec_ctx_->GetParallelState();
+  if (parallel_state != nullptr) {
+    TableHeap *table_heap = tableHeap;
+    dispenser_ = parallel_state->GetOrCreate<MorselDispenser>(
+        plan_, [table_heap] { return std::make_unique<MorselDispenser>(table_heap->GetPageIds(), MORSEL_SIZE); });
+  } else {
+    cursor_.page_ids_ = tableHeap->GetPageIds();
+  }
+  if (plan_->GetPredicate() != nullptr) {
+    predicate_program_.Compile(plan_->GetPredicate(), table_schema_);
+  }
+  InitFilterKernel();
+}
+
+void SeqScanExecutor::InitFilterKernel() {
+  use_filter_kernel_ = false;
+  use_zone_map_ = false;
+  use_encoded_filter_ = false;
+  auto comparison = dynamic_cast<const ComparisonExpression *>(plan_->GetPredicate());
+  if (comparison == nullptr) {
+    return;
+  }
+  filter_comp_type_ = comparison->GetComparisonType();
+  auto column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0));
+  auto constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1));
+  if (column == nullptr || constant == nullptr) {
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1));
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0));
+    filter_comp_type_ = Mirror(filter_comp_type_);
+  }
+  if (column == nullptr || constant == nullptr) {
+    return;
+  }
+  const Column &filter_column = table_schema_->GetColumn(column->GetColIdx());
+  TypeId column_type = filter_column.GetType();
+  TypeId constant_type = constant->GetValue().GetTypeId();
+  use_filter_kernel_ = CastsLosslessly(constant_type, column_type);
+  bool comparable = use_filter_kernel_ || constant_type == column_type;
+  // Zone maps can rule out a comparison of any fixed-size column with a constant of its type.
+  use_zone_map_ = comparable && filter_column.IsInlined();
+  if (!comparable) {
+    return;
+  }
+  filter_col_idx_ = column->GetColIdx();
+  // A comparison with null is never true.
+  const Value &value = constant->GetValue();
+  filter_constant_ = value.IsNull() ? ValueFactory::GetNullValueByType(column_type) : value.CastAs(column_type);
+  // A range of values is a range of codes, which compressed pages filter before decoding anything. NotEqual selects
+  // nearly every slot and is left to the kernels.
+  use_encoded_filter_ = compressed_ && CompressedPage::SupportsSelectRange(column_type) &&
+                        filter_comp_type_ != ComparisonType::NotEqual;
+}
+
+bool SeqScanExecutor::PageMayMatch(page_id_t page_id) const {
+  if (!use_zone_map_ || filter_constant_.IsNull()) {
+    return true;
+  }
+  Value min;
+  Value max;
+  if (!tableHeap->GetColumnRange(page_id, filter_col_idx_, &min, &max)) {
+    return true;
+  }
+  // A comparison with null is never true, so a page whose values of the column are all null has no match.
+  if (min.IsNull()) {
+    return false;
+  }
+  const Value &constant = filter_constant_;
+  switch (filter_comp_type_) {
+    case ComparisonType::Equal:
+      return min.CompareLessThanEquals(constant) == CmpBool::CmpTrue &&
+             max.CompareGreaterThanEquals(constant) == CmpBool::CmpTrue;
+    case ComparisonType::NotEqual:
+      return min.CompareNotEquals(constant) == CmpBool::CmpTrue || max.CompareNotEquals(constant) == CmpBool::CmpTrue;
+    case ComparisonType::LessThan:
+      return min.CompareLessThan(constant) == CmpBool::CmpTrue;
+    case ComparisonType::LessThanOrEqual:
+      return min.CompareLessThanEquals(constant) == CmpBool::CmpTrue;
+    case ComparisonType::GreaterThan:
+      return max.CompareGreaterThan(constant) == CmpBool::CmpTrue;
+    case ComparisonType::GreaterThanOrEqual:
+      return max.CompareGreaterThanEquals(constant) == CmpBool::CmpTrue;
+    default:
+      return true;
+  }
+}
+
+bool SeqScanExecutor::PredicateMatches(const Tuple &tuple) const {
+  const AbstractExpression *predicate = plan_->GetPredicate();
+  if (predicate == nullptr) {
+    return true;
+  }
+  if (predicate_program_.IsCompiled()) {
+    return predicate_program_.Matches(&tuple);
+  }
+  // The program only takes numeric operands, so predicates over VARCHAR or BOOLEAN columns run on the expression tree.
+  // A comparison with null is null, which does not match, as in the batch and compiled paths.
+  Value result = predicate->Evaluate(&tuple, table_schema_);
+  return !result.IsNull() && result.GetAs<bool>();
+}
+
+bool SeqScanExecutor::NextMorsel() {
+  MorselDispenser::Morsel morsel;
+  if (dispenser_ == nullptr || !dispenser_->Next(&morsel)) {
+    return false;
+  }
+  cursor_ = ScanCursor();
+  cursor_.page_ids_.assign(morsel.page_ids_, morsel.page_ids_ + morsel.size_);
+  return true;
 }
 
 bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) {
+  if (pax_) {
+    return NextColumnar<PaxPage>(tuple, rid);
+  }
+  if (compressed_) {
+    return NextColumnar<CompressedPage>(tuple, rid);
+  }
+  // The tuple returned by the last call lives in the arena, which its caller is done with by now.
+  arena_.Reset();
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  Tuple view;
   while (true) {
-    if (iterator == tableHeap->End()) {
+    if (cursor_.page_idx_ == cursor_.page_ids_.size() && !NextMorsel()) {
       return false;
     }
-    auto orign_schema = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid())->schema_;
-    *tuple = *iterator;
-    auto scheme = plan_->OutputSchema();
+    page_id_t page_id = cursor_.page_ids_[cursor_.page_idx_];
+    if (!cursor_.rid_valid_ && !PageMayMatch(page_id)) {
+      cursor_.page_idx_++;
+      continue;
+    }
+    auto page = static_cast<TablePage *>(bpm->FetchPage(page_id));
+    page->RLatch();
+    RID cur_rid;
+    bool has_rid = cursor_.rid_valid_;
+    if (cursor_.rid_valid_) {
+      cur_rid = cursor_.rid_;
+    } else {
+      has_rid = page->GetFirstTupleRid(&cur_rid);
+    }
+    // The predicate is evaluated on the tuples in the page, only the one returned is copied out of it.
+    bool found = false;
+    while (has_rid && !found) {
+      found = page->GetTupleView(cur_rid, &view, exec_ctx_->GetTransaction(), exec_ctx_->GetLockManager()) &&
+              PredicateMatches(view);
+      if (found) {
+        *tuple = ProjectIntoArena(view);
+        *rid = cur_rid;
+      }
+      RID next_rid;
+      has_rid = page->GetNextTupleRid(cur_rid, &next_rid);
+      cur_rid = next_rid;
+    }
+    page->RUnlatch();
+    bpm->UnpinPage(page_id, false);
+    cursor_.rid_valid_ = has_rid;
+    if (has_rid) {
+      cursor_.rid_ = cur_rid;
+    } else {
+      cursor_.page_idx_++;
+    }
+    if (found) {
+      return true;
+    }
+  }
+}
 
-    *rid = tuple->GetRid();
-    if (plan_->GetPredicate() == nullptr ||
-        plan_->GetPredicate()->Evaluate(tuple, plan_->OutputSchema()).GetAs<bool>()) {
-      *tuple = ProjectTuple(*tuple, orign_schema, *scheme);
-      break;
+template <typename PageType>
+bool SeqScanExecutor::NextColumnar(Tuple *tuple, RID *rid) {
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  while (true) {
+    if (cursor_.page_idx_ == cursor_.page_ids_.size() && !NextMorsel()) {
+      return false;
+    }
+    page_id_t page_id = cursor_.page_ids_[cursor_.page_idx_];
+    if (!cursor_.rid_valid_ && !PageMayMatch(page_id)) {
+      cursor_.page_idx_++;
+      continue;
+    }
+    auto page = static_cast<PageType *>(bpm->FetchPage(page_id));
+    page->RLatch();
+    uint32_t slot = cursor_.rid_valid_ ? cursor_.rid_.GetSlotNum() : 0;
+    uint32_t tuple_count = page->GetTupleCount();
+    bool found = false;
+    for (; slot < tuple_count && !found; slot++) {
+      if (!page->IsLive(slot)) {
+        continue;
+      }
+      // The row only lives until the next one is read, unless it is the one returned.
+      arena_.Reset();
+      for (uint32_t col_idx : read_col_idxs_) {
+        columnar_values_[col_idx] = page->GetValue(table_schema_, slot, col_idx);
+      }
+      Tuple row(columnar_values_, table_schema_, &arena_);
+      found = PredicateMatches(row);
+      if (found) {
+        *tuple = ProjectIntoArena(row);
+        *rid = RID(page_id, slot);
+      }
+    }
+    page->RUnlatch();
+    bpm->UnpinPage(page_id, false);
+    cursor_.rid_valid_ = slot < tuple_count;
+    if (cursor_.rid_valid_) {
+      cursor_.rid_ = RID(page_id, slot);
     } else {
-      iterator++;
+      cursor_.page_idx_++;
     }
+    if (found) {
+      return true;
+    }
+  }
+}
+
+Tuple SeqScanExecutor::ProjectIntoArena(const Tuple &view) {
+  if (identity_projection_) {
+    return Tuple(view, &arena_);
+  }
+  return projection_.Project({&view}, &arena_);
+}
+
+bool SeqScanExecutor::SupportsBatch() {
+  return exec_ctx_->IsVectorized() && (plan_->GetPredicate() == nullptr || plan_->GetPredicate()->SupportsBatch());
+}
+
+bool SeqScanExecutor::NextBatch(VectorBatch *batch) {
+  batch->Reset(plan_->OutputSchema());
+  while (batch->GetSize() == 0) {
+    if (!FillScanBatch(&cursor_, &state_)) {
+      if (!NextMorsel()) {
+        return false;
+      }
+      continue;
+    }
+    FilterAndProject(&state_, batch);
   }
-  iterator++;
   return true;
 }
 
+void SeqScanExecutor::FilterAndProject(ScanState *state, VectorBatch *batch) const {
+  VectorBatch &scan_batch = state->scan_batch_;
+  if (use_encoded_filter_) {
+    // The batch holds only the matching tuples, selected on the codes of the pages.
+  } else if (use_filter_kernel_) {
+    EvaluateFilterKernel(state);
+    if (state->selection_.size() < scan_batch.GetSize()) {
+      scan_batch.Select(state->selection_);
+    }
+  } else if (plan_->GetPredicate() != nullptr) {
+    plan_->GetPredicate()->EvaluateBatch(scan_batch, &state->predicate_result_);
+    const auto matches = state->predicate_result_.GetData<int8_t>();
+    state->selection_.clear();
+    for (uint32_t i = 0; i < scan_batch.GetSize(); i++) {
+      if (matches[i] == 1) {
+        state->selection_.push_back(i);
+      }
+    }
+    if (state->selection_.size() < scan_batch.GetSize()) {
+      scan_batch.Select(state->selection_);
+    }
+  }
+  // The scan batch is refilled from scratch, so its vectors are handed over rather than copied, and get the emptied
+  // vectors of the batch in exchange. A column output twice is copied but for its last use.
+  for (uint32_t i = 0; i < output_col_idxs_.size(); i++) {
+    ColumnVector &column = scan_batch.GetColumn(output_col_idxs_[i]);
+    if (std::find(output_col_idxs_.begin() + i + 1, output_col_idxs_.end(), output_col_idxs_[i]) !=
+        output_col_idxs_.end()) {
+      batch->GetColumn(i) = column;
+    } else {
+      std::swap(batch->GetColumn(i), column);
+    }
+  }
+  batch->SetSize(scan_batch.GetSize());
+}
+
+void SeqScanExecutor::EvaluateFilterKernel(ScanState *state) const {
+  const ColumnVector &values = state->scan_batch_.GetColumn(filter_col_idx_);
+  size_t size = state->scan_batch_.GetSize();
+  std::vector<uint32_t> &selection = state->selection_;
+  std::vector<uint64_t> &bitmask = state->filter_bitmask_;
+  selection.clear();
+  if (filter_constant_.IsNull()) {
+    return;
+  }
+  bitmask.resize(FilterKernels::BitmaskWords(size));
+  switch (values.GetType()) {
+    case TypeId::INTEGER:
+      FilterKernels::CompareConstant(values.GetData<int32_t>(), size, filter_comp_type_,
+                                     filter_constant_.GetAs<int32_t>(), bitmask.data());
+      break;
+    case TypeId::BIGINT:
+      FilterKernels::CompareConstant(values.GetData<int64_t>(), size, filter_comp_type_,
+                                     filter_constant_.GetAs<int64_t>(), bitmask.data());
+      break;
+    default:
+      FilterKernels::CompareConstant(values.GetData<double>(), size, filter_comp_type_,
+                                     filter_constant_.GetAs<double>(), bitmask.data());
+      break;
+  }
+  FilterKernels::BitmaskToSelection(bitmask.data(), size, &selection);
+}
+
+bool SeqScanExecutor::FillScanBatch(ScanCursor *cursor, ScanState *state) const {
+  if (pax_) {
+    return FillPaxScanBatch(cursor, state);
+  }
+  if (compressed_) {
+    return FillCompressedScanBatch(cursor, state);
+  }
+  VectorBatch &scan_batch = state->scan_batch_;
+  scan_batch.Reset(table_schema_);
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  Tuple tuple;
+  size_t count = 0;
+  while (count < VECTOR_SIZE && cursor->page_idx_ < cursor->page_ids_.size()) {
+    page_id_t page_id = cursor->page_ids_[cursor->page_idx_];
+    if (!cursor->rid_valid_ && !PageMayMatch(page_id)) {
+      cursor->page_idx_++;
+      continue;
+    }
+    auto page = static_cast<TablePage *>(bpm->FetchPage(page_id));
+    page->RLatch();
+    RID rid;
+    bool has_rid = cursor->rid_valid_;
+    if (cursor->rid_valid_) {
+      rid = cursor->rid_;
+    } else {
+      has_rid = page->GetFirstTupleRid(&rid);
+    }
+    while (has_rid && count < VECTOR_SIZE) {
+      if (page->GetTupleView(rid, &tuple, exec_ctx_->GetTransaction(), exec_ctx_->GetLockManager())) {
+        for (uint32_t col_idx : read_col_idxs_) {
+          scan_batch.GetColumn(col_idx).AppendFrom(tuple, table_schema_, col_idx);
+        }
+        count++;
+      }
+      RID next_rid;
+      has_rid = page->GetNextTupleRid(rid, &next_rid);
+      rid = next_rid;
+    }
+    page->RUnlatch();
+    bpm->UnpinPage(page_id, false);
+    // A full batch may stop in the middle of a page.
+    cursor->rid_valid_ = has_rid;
+    if (has_rid) {
+      cursor->rid_ = rid;
+    } else {
+      cursor->page_idx_++;
+    }
+  }
+  scan_batch.SetSize(count);
+  return count > 0;
+}
+
+bool SeqScanExecutor::FillPaxScanBatch(ScanCursor *cursor, ScanState *state) const {
+  VectorBatch &scan_batch = state->scan_batch_;
+  scan_batch.Reset(table_schema_);
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  size_t count = 0;
+  while (count < VECTOR_SIZE && cursor->page_idx_ < cursor->page_ids_.size()) {
+    page_id_t page_id = cursor->page_ids_[cursor->page_idx_];
+    if (!cursor->rid_valid_ && !PageMayMatch(page_id)) {
+      cursor->page_idx_++;
+      continue;
+    }
+    auto page = static_cast<PaxPage *>(bpm->FetchPage(page_id));
+    page->RLatch();
+    uint32_t slot = cursor->rid_valid_ ? cursor->rid_.GetSlotNum() : 0;
+    uint32_t tuple_count = page->GetTupleCount();
+    while (slot < tuple_count && count < VECTOR_SIZE) {
+      if (!page->IsLive(slot)) {
+        slot++;
+        continue;
+      }
+      // A run of live slots is copied a column at a time, with one memcpy for a fixed-size column.
+      uint32_t end = slot + 1;
+      while (end < tuple_count && count + (end - slot) < VECTOR_SIZE && page->IsLive(end)) {
+        end++;
+      }
+      for (uint32_t col_idx : read_col_idxs_) {
+        ColumnVector &vector = scan_batch.GetColumn(col_idx);
+        if (vector.IsInlined()) {
+          uint32_t width = table_schema_->GetColumn(col_idx).GetFixedLength();
+          vector.AppendRaw(page->GetColumnData(table_schema_, col_idx) + slot * width, end - slot);
+          continue;
+        }
+        for (uint32_t i = slot; i < end; i++) {
+          vector.Append(page->GetValue(table_schema_, i, col_idx));
+        }
+      }
+      count += end - slot;
+      slot = end;
+    }
+    page->RUnlatch();
+    bpm->UnpinPage(page_id, false);
+    cursor->rid_valid_ = slot < tuple_count;
+    if (cursor->rid_valid_) {
+      cursor->rid_ = RID(page_id, slot);
+    } else {
+      cursor->page_idx_++;
+    }
+  }
+  scan_batch.SetSize(count);
+  return count > 0;
+}
+
+bool SeqScanExecutor::FillCompressedScanBatch(ScanCursor *cursor, ScanState *state) const {
+  VectorBatch &scan_batch = state->scan_batch_;
+  scan_batch.Reset(table_schema_);
+  std::vector<uint32_t> &slots = state->slots_;
+  slots.resize(VECTOR_SIZE);
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  size_t count = 0;
+  while (count < VECTOR_SIZE && cursor->page_idx_ < cursor->page_ids_.size()) {
+    page_id_t page_id = cursor->page_ids_[cursor->page_idx_];
+    if (!cursor->rid_valid_ && !PageMayMatch(page_id)) {
+      cursor->page_idx_++;
+      continue;
+    }
+    auto page = static_cast<CompressedPage *>(bpm->FetchPage(page_id));
+    page->RLatch();
+    uint32_t slot = cursor->rid_valid_ ? cursor->rid_.GetSlotNum() : 0;
+    uint32_t tuple_count = page->GetTupleCount();
+    // The slots are selected a window at a time, no larger than the room left in the batch.
+    auto end = static_cast<uint32_t>(std::min<size_t>(tuple_count, slot + (VECTOR_SIZE - count)));
+    uint32_t selected = 0;
+    if (use_encoded_filter_) {
+      selected = SelectEncoded(page, slot, end, slots.data());
+    } else {
+      for (uint32_t i = slot; i < end; i++) {
+        slots[selected] = i;
+        selected += static_cast<uint32_t>(page->IsLive(i));
+      }
+    }
+    // Only the selected slots are decoded, straight into the vectors of fixed-size columns.
+    for (uint32_t col_idx : read_col_idxs_) {
+      ColumnVector &vector = scan_batch.GetColumn(col_idx);
+      if (vector.IsInlined()) {
+        size_t size = vector.GetSize();
+        uint32_t width = table_schema_->GetColumn(col_idx).GetFixedLength();
+        vector.Resize(size + selected);
+        page->DecodeFixed(table_schema_, col_idx, slots.data(), selected, vector.GetMutableData<char>() + size * width);
+        continue;
+      }
+      for (uint32_t i = 0; i < selected; i++) {
+        vector.Append(page->GetValue(table_schema_, slots[i], col_idx));
+      }
+    }
+    count += selected;
+    slot = end;
+    page->RUnlatch();
+    bpm->UnpinPage(page_id, false);
+    cursor->rid_valid_ = slot < tuple_count;
+    if (cursor->rid_valid_) {
+      cursor->rid_ = RID(page_id, slot);
+    } else {
+      cursor->page_idx_++;
+    }
+  }
+  scan_batch.SetSize(count);
+  return count > 0;
+}
+
+uint32_t SeqScanExecutor::SelectEncoded(CompressedPage *page, uint32_t from, uint32_t to, uint32_t *selection) const {
+  if (filter_constant_.IsNull()) {
+    return 0;
+  }
+  const Value *constant = &filter_constant_;
+  switch (filter_comp_type_) {
+    case ComparisonType::Equal:
+      return page->SelectRange(table_schema_, filter_col_idx_, constant, true, constant, true, from, to, selection);
+    case ComparisonType::LessThan:
+      return page->SelectRange(table_schema_, filter_col_idx_, nullptr, false, constant, false, from, to, selection);
+    case ComparisonType::LessThanOrEqual:
+      return page->SelectRange(table_schema_, filter_col_idx_, nullptr, false, constant, true, from, to, selection);
+    case ComparisonType::GreaterThan:
+      return page->SelectRange(table_schema_, filter_col_idx_, constant, false, nullptr, false, from, to, selection);
+    default:
+      return page->SelectRange(table_schema_, filter_col_idx_, constant, true, nullptr, false, from, to, selection);
+  }
+}
+
 }  // namespace bustub
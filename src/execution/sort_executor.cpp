@@ -0,0 +1,318 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.cpp
+//
+// Identification: src/execution/sort_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/sort_executor.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+void LoserTree::Build() {
+  size_t k = keys_.size();
+  if (k <= 1) {
+    tree_[0] = 0;
+    return;
+  }
+  // winners[n] is the winner of the subtree rooted at inner node n; the leaves k..2k-1 are the streams themselves.
+  std::vector<size_t> winners(2 * k);
+  for (size_t i = 0; i < k; i++) {
+    winners[k + i] = i;
+  }
+  for (size_t node = k - 1; node > 0; node--) {
+    size_t left = winners[2 * node];
+    size_t right = winners[2 * node + 1];
+    bool left_wins = Beats(left, right);
+    winners[node] = left_wins ? left : right;
+    tree_[node] = left_wins ? right : left;
+  }
+  tree_[0] = winners[1];
+}
+
+void LoserTree::Replay() {
+  size_t k = keys_.size();
+  size_t winner = tree_[0];
+  for (size_t node = (winner + k) / 2; node > 0; node /= 2) {
+    if (Beats(tree_[node], winner)) {
+      std::swap(tree_[node], winner);
+    }
+  }
+  tree_[0] = winner;
+}
+
+namespace {
+
+/** Appends the big-endian bytes of an unsigned integer. */
+template <typename T>
+void AppendBigEndian(T value, std::string *out) {
+  for (int shift = (sizeof(T) - 1) * 8; shift >= 0; shift -= 8) {
+    out->push_back(static_cast<char>((value >> shift) & 0xFF));
+  }
+}
+
+/** Appends a signed integer so that its two's complement order becomes an unsigned byte order. */
+template <typename Signed, typename Unsigned>
+void AppendSigned(Signed value, std::string *out) {
+  constexpr Unsigned sign_bit = static_cast<Unsigned>(1) << (sizeof(Unsigned) * 8 - 1);
+  AppendBigEndian<Unsigned>(static_cast<Unsigned>(value) ^ sign_bit, out);
+}
+
+}  // namespace
+
+void SortExecutor::EncodeKey(const Tuple &tuple, const Schema *schema,
+                             const std::vector<std::pair<OrderByType, const AbstractExpression *>> &order_bys,
+                             std::string *out) {
+  for (const auto &order_by : order_bys) {
+    size_t start = out->size();
+    Value value = order_by.second->Evaluate(&tuple, schema);
+    if (value.IsNull()) {
+      out->push_back('\0');
+    } else {
+      out->push_back('\1');
+      switch (value.GetTypeId()) {
+        case TypeId::BOOLEAN:
+        case TypeId::TINYINT:
+          AppendSigned<int8_t, uint8_t>(value.GetAs<int8_t>(), out);
+          break;
+        case TypeId::SMALLINT:
+          AppendSigned<int16_t, uint16_t>(value.GetAs<int16_t>(), out);
+          break;
+        case TypeId::INTEGER:
+          AppendSigned<int32_t, uint32_t>(value.GetAs<int32_t>(), out);
+          break;
+        case TypeId::BIGINT:
+          AppendSigned<int64_t, uint64_t>(value.GetAs<int64_t>(), out);
+          break;
+        case TypeId::TIMESTAMP:
+          AppendBigEndian<uint64_t>(value.GetAs<uint64_t>(), out);
+          break;
+        case TypeId::DECIMAL: {
+          // -0.0 and 0.0 compare equal, so they need the same bits.
+          double decimal = value.GetAs<double>() == 0 ? 0.0 : value.GetAs<double>();
+          uint64_t bits;
+          memcpy(&bits, &decimal, sizeof(bits));
+          // Negative numbers order backwards by magnitude, positive ones after all negative ones.
+          bits = (bits >> 63) != 0 ? ~bits : bits ^ (static_cast<uint64_t>(1) << 63);
+          AppendBigEndian<uint64_t>(bits, out);
+          break;
+        }
+        case TypeId::VARCHAR: {
+          // The length of a varchar counts its terminating '\0', which is not compared.
+          const char *data = value.GetData();
+          uint32_t length = value.GetLength() == 0 ? 0 : value.GetLength() - 1;
+          for (uint32_t i = 0; i < length; i++) {
+            out->push_back(data[i]);
+            if (data[i] == '\0') {
+              out->push_back('\xFF');
+            }
+          }
+          out->push_back('\0');
+          out->push_back('\0');
+          break;
+        }
+        default:
+          throw Exception(ExceptionType::MISMATCH_TYPE, "Cannot sort on this type.");
+      }
+    }
+    if (order_by.first == OrderByType::Descending) {
+      for (size_t i = start; i < out->size(); i++) {
+        (*out)[i] = static_cast<char>(~(*out)[i]);
+      }
+    }
+  }
+}
+
+SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
+                           std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+void SortExecutor::Init() {
+  child_executor_->Init();
+  tuples_.clear();
+  keys_.clear();
+  order_.clear();
+  memory_used_ = 0;
+  next_idx_ = 0;
+  runs_.clear();
+  readers_.clear();
+  loser_tree_ = LoserTree(0);
+  run_count_ = 0;
+  merge_pass_count_ = 0;
+
+  const Schema *child_schema = child_executor_->GetOutputSchema();
+  Tuple tuple;
+  RID rid;
+  while (child_executor_->Next(&tuple, &rid)) {
+    std::string key;
+    EncodeKey(tuple, child_schema, plan_->GetOrderBys(), &key);
+    memory_used_ += sizeof(Tuple) + tuple.GetLength() + sizeof(std::string) + key.size() + sizeof(uint32_t);
+    keys_.push_back(std::move(key));
+    tuples_.push_back(tuple);
+    if (memory_used_ > exec_ctx_->GetMemoryBudget()) {
+      SpillBuffer();
+    }
+  }
+
+  if (runs_.empty()) {
+    SortBuffer();
+    return;
+  }
+  if (!tuples_.empty()) {
+    SpillBuffer();
+  }
+  MergeRuns();
+  StartMerge();
+}
+
+bool SortExecutor::Next(Tuple *tuple, RID *rid) {
+  if (readers_.empty()) {
+    if (next_idx_ == order_.size()) {
+      return false;
+    }
+    *tuple = tuples_[order_[next_idx_++]];
+    return true;
+  }
+
+  if (loser_tree_.IsEmpty()) {
+    return false;
+  }
+  size_t winner = loser_tree_.Winner();
+  RecordTuple(readers_[winner].record_, tuple);
+  AdvanceReader(winner);
+  loser_tree_.Replay();
+  return true;
+}
+
+void SortExecutor::SortBuffer() {
+  order_.resize(tuples_.size());
+  for (uint32_t i = 0; i < order_.size(); i++) {
+    order_[i] = i;
+  }
+  // Equal keys keep the order of the child.
+  std::stable_sort(order_.begin(), order_.end(), [this](uint32_t a, uint32_t b) { return keys_[a] < keys_[b]; });
+}
+
+void SortExecutor::SpillBuffer() {
+  SortBuffer();
+  auto run = std::make_unique<TmpTupleRun>(exec_ctx_->GetBufferPoolManager());
+  for (uint32_t idx : order_) {
+    AppendRecord(run.get(), keys_[idx], tuples_[idx]);
+  }
+  run->FinishAppend();
+  runs_.push_back(std::move(run));
+  run_count_++;
+
+  tuples_.clear();
+  tuples_.shrink_to_fit();
+  keys_.clear();
+  keys_.shrink_to_fit();
+  order_.clear();
+  memory_used_ = 0;
+}
+
+void SortExecutor::MergeRuns() {
+  size_t fan_in = GetMergeFanIn();
+  while (runs_.size() > fan_in) {
+    // Merging neighbouring runs keeps tuples with equal keys in the order of the child.
+    std::vector<std::unique_ptr<TmpTupleRun>> merged_runs;
+    std::vector<std::unique_ptr<TmpTupleRun>> all_runs = std::move(runs_);
+    for (size_t group = 0; group < all_runs.size(); group += fan_in) {
+      size_t group_end = std::min(group + fan_in, all_runs.size());
+      if (group_end - group == 1) {
+        merged_runs.push_back(std::move(all_runs[group]));
+        continue;
+      }
+      runs_.clear();
+      for (size_t i = group; i < group_end; i++) {
+        runs_.push_back(std::move(all_runs[i]));
+      }
+      StartMerge();
+      auto merged = std::make_unique<TmpTupleRun>(exec_ctx_->GetBufferPoolManager());
+      while (!loser_tree_.IsEmpty()) {
+        size_t winner = loser_tree_.Winner();
+        const Tuple &record = readers_[winner].record_;
+        if (!merged->Append(record)) {
+          throw Exception(ExceptionType::OUT_OF_MEMORY, "Sort cannot spill: no free frame in the buffer pool.");
+        }
+        AdvanceReader(winner);
+        loser_tree_.Replay();
+      }
+      merged->FinishAppend();
+      readers_.clear();
+      merged_runs.push_back(std::move(merged));
+    }
+    runs_ = std::move(merged_runs);
+    merge_pass_count_++;
+  }
+}
+
+void SortExecutor::StartMerge() {
+  readers_.clear();
+  readers_.resize(runs_.size());
+  loser_tree_ = LoserTree(runs_.size());
+  for (size_t i = 0; i < runs_.size(); i++) {
+    readers_[i].run_ = std::move(runs_[i]);
+    AdvanceReader(i);
+  }
+  runs_.clear();
+  loser_tree_.Build();
+}
+
+void SortExecutor::AdvanceReader(size_t stream) {
+  RunReader &reader = readers_[stream];
+  if (reader.run_->Next(&reader.record_)) {
+    loser_tree_.SetKey(stream, RecordKey(reader.record_));
+    return;
+  }
+  // Release the pages of an exhausted run right away, the other runs still need the frames.
+  reader.run_->Clear();
+  loser_tree_.SetDone(stream);
+}
+
+size_t SortExecutor::GetMergeFanIn() const {
+  // Every run being merged pins one page, and a merge pass also pins the page of its output run.
+  return std::max<size_t>(2, exec_ctx_->GetBufferPoolManager()->GetPoolSize() / 2);
+}
+
+// A record is laid out as | key size (4) | key | tuple size (4) | tuple data |, the tuple part in the format of
+// Tuple::SerializeTo.
+void SortExecutor::AppendRecord(TmpTupleRun *run, std::string_view key, const Tuple &tuple) {
+  uint32_t key_size = key.size();
+  uint32_t record_size = sizeof(uint32_t) + key_size + sizeof(uint32_t) + tuple.GetLength();
+  record_buffer_.resize(sizeof(uint32_t) + record_size);
+  char *buffer = record_buffer_.data();
+  memcpy(buffer, &record_size, sizeof(uint32_t));
+  memcpy(buffer + sizeof(uint32_t), &key_size, sizeof(uint32_t));
+  memcpy(buffer + 2 * sizeof(uint32_t), key.data(), key_size);
+  tuple.SerializeTo(buffer + 2 * sizeof(uint32_t) + key_size);
+  Tuple record;
+  record.DeserializeFrom(buffer);
+  if (!run->Append(record)) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Sort cannot spill: no free frame in the buffer pool.");
+  }
+}
+
+std::string_view SortExecutor::RecordKey(const Tuple &record) {
+  uint32_t key_size;
+  memcpy(&key_size, record.GetData(), sizeof(uint32_t));
+  return std::string_view(record.GetData() + sizeof(uint32_t), key_size);
+}
+
+void SortExecutor::RecordTuple(const Tuple &record, Tuple *tuple) {
+  uint32_t key_size;
+  memcpy(&key_size, record.GetData(), sizeof(uint32_t));
+  tuple->DeserializeFrom(record.GetData() + sizeof(uint32_t) + key_size);
+}
+
+}  // namespace bustub
@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_executor.cpp
+//
+// Identification: src/execution/topn_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/topn_executor.h"
+
+#include <algorithm>
+
+#include "execution/executors/sort_executor.h"
+
+namespace bustub {
+
+TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan,
+                           std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+void TopNExecutor::Init() {
+  child_executor_->Init();
+  heap_.clear();
+  tuples_.clear();
+  next_idx_ = 0;
+  size_t n = plan_->GetN();
+  if (n == 0) {
+    return;
+  }
+
+  const Schema *child_schema = child_executor_->GetOutputSchema();
+  Tuple tuple;
+  RID rid;
+  std::string key;
+  for (uint64_t seq = 0; child_executor_->Next(&tuple, &rid); seq++) {
+    key.clear();
+    SortExecutor::EncodeKey(tuple, child_schema, plan_->GetOrderBys(), &key);
+    if (heap_.size() < n) {
+      heap_.push_back(HeapEntry{std::move(key), seq, tuples_.size()});
+      tuples_.push_back(tuple);
+      std::push_heap(heap_.begin(), heap_.end());
+      continue;
+    }
+    // A later tuple with an equal key sorts after the largest one, so it is dropped too.
+    if (key.compare(heap_.front().key_) >= 0) {
+      continue;
+    }
+    std::pop_heap(heap_.begin(), heap_.end());
+    HeapEntry &largest = heap_.back();
+    tuples_[largest.slot_] = tuple;
+    largest.key_.swap(key);
+    largest.seq_ = seq;
+    std::push_heap(heap_.begin(), heap_.end());
+  }
+  std::sort_heap(heap_.begin(), heap_.end());
+}
+
+bool TopNExecutor::Next(Tuple *tuple, RID *rid) {
+  if (next_idx_ == heap_.size()) {
+    return false;
+  }
+  *tuple = tuples_[heap_[next_idx_++].slot_];
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vector_batch.cpp
+//
+// Identification: src/execution/vector_batch.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/vector_batch.h"
+
+#include <cstring>
+
+#include "type/type.h"
+
+namespace bustub {
+
+void ColumnVector::Reset(TypeId type) {
+  type_ = type;
+  width_ = IsInlined() ? Type::GetTypeSize(type) : 0;
+  size_ = 0;
+  data_.clear();
+  varlen_.clear();
+}
+
+void ColumnVector::Append(const Value &value) {
+  if (!IsInlined()) {
+    varlen_.push_back(value);
+  } else {
+    BUSTUB_ASSERT(value.GetTypeId() == type_, "A value must have the type of its vector.");
+    data_.resize(data_.size() + width_);
+    value.SerializeTo(data_.data() + size_ * width_);
+  }
+  size_++;
+}
+
+void ColumnVector::AppendFrom(const Tuple &tuple, const Schema *schema, uint32_t col_idx) {
+  // The null sentinels are in the tuple unless it is compact, where nulls take no space.
+  if (!IsInlined() || !schema->HasFixedOffsets()) {
+    Append(tuple.GetValue(schema, col_idx));
+    return;
+  }
+  const char *src = tuple.GetData() + schema->GetColumn(col_idx).GetOffset();
+  data_.insert(data_.end(), src, src + width_);
+  size_++;
+}
+
+void ColumnVector::AppendRaw(const char *data, size_t count) {
+  BUSTUB_ASSERT(IsInlined(), "Only fixed-size values can be appended raw.");
+  data_.insert(data_.end(), data, data + count * width_);
+  size_ += count;
+}
+
+void ColumnVector::Fill(const Value &value, size_t count) {
+  Reset(type_);
+  if (!IsInlined()) {
+    varlen_.assign(count, value);
+  } else {
+    data_.resize(count * width_);
+    for (size_t i = 0; i < count; i++) {
+      value.SerializeTo(data_.data() + i * width_);
+    }
+  }
+  size_ = count;
+}
+
+void ColumnVector::Resize(size_t size) {
+  BUSTUB_ASSERT(IsInlined(), "Only fixed-size vectors can be resized.");
+  data_.resize(size * width_);
+  size_ = size;
+}
+
+Value ColumnVector::GetValue(size_t row) const {
+  if (!IsInlined()) {
+    return varlen_[row];
+  }
+  return Value::DeserializeFrom(data_.data() + row * width_, type_);
+}
+
+void ColumnVector::Select(const std::vector<uint32_t> &selection) {
+  // Selected rows never move forward, so the vector can be compacted in place.
+  if (!IsInlined()) {
+    for (size_t i = 0; i < selection.size(); i++) {
+      if (selection[i] != i) {
+        // A Value has no move, and the row left behind is never read again.
+        Swap(varlen_[i], varlen_[selection[i]]);
+      }
+    }
+    varlen_.resize(selection.size());
+  } else {
+    char *data = data_.data();
+    for (size_t i = 0; i < selection.size(); i++) {
+      if (selection[i] != i) {
+        memcpy(data + i * width_, data + selection[i] * width_, width_);
+      }
+    }
+    data_.resize(selection.size() * width_);
+  }
+  size_ = selection.size();
+}
+
+void VectorBatch::Reset(const Schema *schema) {
+  columns_.resize(schema->GetColumnCount());
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    columns_[i].Reset(schema->GetColumn(i).GetType());
+  }
+  size_ = 0;
+}
+
+void VectorBatch::Select(const std::vector<uint32_t> &selection) {
+  for (auto &column : columns_) {
+    if (column.GetSize() == size_) {
+      column.Select(selection);
+    }
+  }
+  size_ = selection.size();
+}
+
+void VectorBatch::AppendTuple(const Tuple &tuple, const Schema *schema) {
+  for (uint32_t col_idx = 0; col_idx < columns_.size(); col_idx++) {
+    columns_[col_idx].AppendFrom(tuple, schema, col_idx);
+  }
+  size_++;
+}
+
+Tuple VectorBatch::GetTuple(size_t row, const Schema *schema) const {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.push_back(column.GetValue(row));
+  }
+  return Tuple(values, schema);
+}
+
+}  // namespace bustub
@@ -15,6 +15,8 @@
 #include <list>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "buffer/lru_replacer.h"
 #include "recovery/log_manager.h"
@@ -97,6 +99,13 @@ class BufferPoolManager {
   /** @return size of the buffer pool */
   size_t GetPoolSize() { return pool_size_; }
 
+  /**
+   * Collects the dirty page table for a checkpoint: every page that is dirty or pinned, together with its recLSN,
+   * the LSN of the first log record that may have modified it since it was last written out.
+   * @return (page id, recLSN) pairs
+   */
+  std::vector<std::pair<page_id_t, lsn_t>> GetDirtyPageTable();
+
  protected:
   /**
    * Grading function. Do not modify!
@@ -152,6 +161,24 @@ class BufferPoolManager {
    */
   void FlushAllPagesImpl();
 
+  /**
+   * Forces the log up to the page LSN to disk before the page is written out.
+   * @param page the page that is about to be written to disk
+   */
+  void FlushLogForPage(Page *page);
+
+  /**
+   * Writes the page to disk (after its log records) and marks it clean.
+   * @param page the page to write out
+   */
+  void WritePageOut(Page *page);
+
+  /**
+   * Remembers the next LSN as the recLSN of a pinned page that has none yet.
+   * @param page the page that was just pinned or written out
+   */
+  void TrackRecLSN(Page *page);
+
   /** Number of pages in the buffer pool. */
   size_t pool_size_;
   /** Array of buffer pool pages. */
@@ -159,7 +186,7 @@ class BufferPoolManager {
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. */
-  LogManager *log_manager_ __attribute__((__unused__));
+  LogManager *log_manager_;
   /** Page table for keeping track of buffer pool pages. */
   std::unordered_map<page_id_t, frame_id_t> page_table_;
   /** Replacer to find unpinned pages for replacement. */
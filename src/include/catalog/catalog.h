@@ -8,6 +8,8 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
+#include "common/config.h"
+#include "common/exception.h"
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/index.h"
 #include "storage/table/table_heap.h"
@@ -73,13 +75,19 @@ class Catalog {
    * @param txn the transaction in which the table is being created
    * @param table_name the name of the new table
    * @param schema the schema of the new table
+   * @param layout the page format of the new table; PAX and COMPRESSED tables need logging to be off
    * @return a pointer to the metadata of the new table
    */
-  TableMetadata *CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema) {
+  TableMetadata *CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema,
+                             TableLayout layout = TableLayout::ROW) {
     BUSTUB_ASSERT(names_.count(table_name) == 0, "Table names should be unique!");
+    if (layout != TableLayout::ROW && enable_logging) {
+      throw NotImplementedException("Only ROW tables are logged.");
+    }
     table_oid_t id = next_table_oid_.fetch_add(1);
     auto tableMeta = new TableMetadata(
-        schema, table_name, std::unique_ptr<TableHeap>(new TableHeap(bpm_, lock_manager_, log_manager_, txn)), id);
+        schema, table_name,
+        std::unique_ptr<TableHeap>(new TableHeap(bpm_, lock_manager_, log_manager_, txn, layout, &schema)), id);
     tables_.insert(std::make_pair(id, std::unique_ptr<TableMetadata>(tableMeta)));
     names_.insert(std::make_pair(table_name, id));
     return tableMeta;
@@ -21,13 +21,24 @@
 
 namespace bustub {
 
+/**
+ * The layout of the tuples of a schema.
+ *
+ * PLAIN tuples are the fixed-size columns at their offsets followed by the VARCHAR payloads, a null being stored as
+ * the null sentinel of its type. NULL_BITMAP tuples start with one bit per column, set if the column is null, before
+ * the same layout, so a null check is a bit test. COMPACT tuples have the null bitmap too but leave null columns out
+ * altogether, so the offset of a column depends on the columns before it that are null.
+ */
+enum class TupleFormat { PLAIN, NULL_BITMAP, COMPACT };
+
 class Schema {
  public:
   /**
    * Constructs the schema corresponding to the vector of columns, read left-to-right.
    * @param columns columns that describe the schema's individual columns
+   * @param format the layout of the tuples, PLAIN for the fixed-size keys of indexes
    */
-  explicit Schema(const std::vector<Column> &columns);
+  explicit Schema(const std::vector<Column> &columns, TupleFormat format = TupleFormat::PLAIN);
 
   static Schema *CopySchema(const Schema *from, const std::vector<uint32_t> &attrs) {
     std::vector<Column> cols;
@@ -84,13 +95,26 @@ class Schema {
   /** @return true if all columns are inlined, false otherwise */
   inline bool IsInlined() const { return tuple_is_inlined_; }
 
+  /** @return the layout of the tuples */
+  inline TupleFormat GetTupleFormat() const { return format_; }
+
+  /** @return the number of bytes of the null bitmap at the start of a tuple, 0 if there is none */
+  inline uint32_t GetNullBitmapSize() const { return null_bitmap_size_; }
+
+  /** @return true if every column of a tuple is at the offset of the column, i.e. the tuples are not COMPACT */
+  inline bool HasFixedOffsets() const { return format_ != TupleFormat::COMPACT; }
+
   /** @return string representation of this schema */
   std::string ToString() const;
 
  private:
-  /** Fixed-length column size, i.e. the number of bytes used by one tuple. */
+  /** Fixed-length column size, i.e. the number of bytes used by one tuple, null bitmap included. */
   uint32_t length_;
 
+  /** The layout of the tuples, and the size of their null bitmap. */
+  TupleFormat format_;
+  uint32_t null_bitmap_size_;
+
   /** All the columns in the schema, inlined and uninlined. */
   std::vector<Column> columns_;
 
@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena.h
+//
+// Identification: src/include/common/arena.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * Arena is a bump allocator for memory that is freed all at once, e.g. the tuples an executor builds for one call.
+ *
+ * Allocations are carved out of chunks one after the other and are never freed on their own. Reset() frees them all
+ * but keeps the chunks, so an arena that is reset regularly stops calling the system allocator once it has grown to
+ * its high water mark. Not thread-safe.
+ */
+class Arena {
+ public:
+  /** The size of the chunks, unless an allocation needs a larger one. */
+  static constexpr size_t DEFAULT_CHUNK_SIZE = 16 << 10;
+
+  /** @param chunk_size the size of the chunks */
+  explicit Arena(size_t chunk_size = DEFAULT_CHUNK_SIZE) : chunk_size_(chunk_size) {}
+
+  DISALLOW_COPY_AND_MOVE(Arena);
+
+  /**
+   * Allocates memory aligned to 8 bytes, uninitialized.
+   * @param size the number of bytes
+   * @return the memory, valid until the arena is reset or destroyed
+   */
+  char *Allocate(size_t size);
+
+  /** Frees all allocations, keeping the chunks for the next ones. */
+  void Reset() {
+    chunk_idx_ = 0;
+    offset_ = 0;
+  }
+
+  /** @return the bytes of the chunks */
+  size_t GetMemoryUsage() const { return memory_usage_; }
+
+ private:
+  static constexpr size_t ALIGNMENT = 8;
+
+  struct Chunk {
+    std::unique_ptr<char[]> data_;
+    size_t size_;
+  };
+
+  const size_t chunk_size_;
+  std::vector<Chunk> chunks_;
+  /** The chunk being allocated from and the offset of its first free byte. */
+  size_t chunk_idx_{0};
+  size_t offset_{0};
+  size_t memory_usage_{0};
+};
+
+}  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include <atomic>
 #include <chrono>  // NOLINT
+#include <cstddef>
 #include <cstdint>
 
 namespace bustub {
@@ -35,6 +36,9 @@ static constexpr int PAGE_SIZE = 4096;                                        //
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr size_t DEFAULT_QUERY_MEMORY = 64 << 20;                      // bytes an executor may hold in memory before spilling
+static constexpr size_t VECTOR_SIZE = 1024;                                   // max number of tuples in a VectorBatch
+static constexpr size_t MORSEL_SIZE = 16;                                     // table pages claimed at a time by a scan worker
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
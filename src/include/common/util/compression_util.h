@@ -0,0 +1,49 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compression_util.h
+//
+// Identification: src/include/common/util/compression_util.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+namespace bustub {
+
+/**
+ * CompressionUtil implements a fast LZ77 block compressor in the style of LZ4. A block is a sequence of
+ * (token, literal length, literals, match offset, match length) entries, the last one without a match.
+ * It trades compression ratio for speed, which suits log buffers that are compressed on the flush path.
+ */
+class CompressionUtil {
+ public:
+  /** @return the largest possible compressed size of size input bytes */
+  static size_t MaxCompressedSize(size_t size) { return size + size / 255 + 16; }
+
+  /**
+   * Compresses a block.
+   * @param src the input
+   * @param size the number of input bytes
+   * @param[out] dst the output, which must have room for MaxCompressedSize(size) bytes
+   * @return the number of compressed bytes written to dst
+   */
+  static size_t Compress(const char *src, size_t size, char *dst);
+
+  /**
+   * Decompresses a block produced by Compress.
+   * @param src the compressed block
+   * @param size the number of compressed bytes
+   * @param[out] dst the output
+   * @param raw_size the size of the uncompressed block
+   * @return true if the block decompressed to exactly raw_size bytes, false if it is corrupt
+   */
+  static bool Decompress(const char *src, size_t size, char *dst, size_t raw_size);
+};
+
+}  // namespace bustub
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// worker_pool.h
+//
+// Identification: src/include/common/worker_pool.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * WorkerPool runs tasks on a set of reusable threads.
+ *
+ * A task is handed to an idle thread, and a new thread is started when none is idle. The tasks of a query wait on
+ * each other, e.g. a gather on the instances it merges, so a fixed number of threads could deadlock; instead the pool
+ * grows to the largest number of tasks that ever ran at once and keeps those threads for later queries.
+ */
+class WorkerPool {
+ public:
+  WorkerPool() = default;
+
+  /** Waits for the queued tasks and stops all threads. */
+  ~WorkerPool();
+
+  DISALLOW_COPY_AND_MOVE(WorkerPool);
+
+  /**
+   * Runs a task on a worker thread.
+   * @param task the task
+   * @return a future that becomes ready when the task finishes and holds the exception it threw, if any
+   */
+  std::future<void> Submit(std::function<void()> &&task);
+
+  /** @return the number of threads started so far */
+  size_t GetThreadCount();
+
+ private:
+  void WorkerLoop();
+
+  std::mutex latch_;
+  std::condition_variable has_task_;
+  std::deque<std::packaged_task<void()>> tasks_;
+  std::vector<std::thread> threads_;
+  /** The number of threads waiting for a task. */
+  size_t idle_count_{0};
+  bool shutdown_{false};
+};
+
+}  // namespace bustub
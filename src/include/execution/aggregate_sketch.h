@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregate_sketch.h
+//
+// Identification: src/include/execution/aggregate_sketch.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * HyperLogLog estimates the number of distinct hashes added to it.
+ *
+ * The first SPARSE_LIMIT distinct hashes are kept as is and counted exactly, so that the many small groups of a high
+ * cardinality GROUP BY stay small. Past that the sketch switches to 2^PRECISION one-byte registers that hold the
+ * longest run of leading zeros seen among the hashes they are picked for, for a standard error of about 3%.
+ */
+class HyperLogLog {
+ public:
+  static constexpr uint32_t PRECISION = 10;
+  static constexpr uint32_t REGISTER_COUNT = 1 << PRECISION;
+  static constexpr uint32_t SPARSE_LIMIT = 64;
+
+  /** @param hash the hash of a value, whose bits must all depend on the value */
+  void Add(uint64_t hash);
+
+  /** @return the estimated number of distinct hashes added */
+  uint64_t Estimate() const;
+
+  /** @return the bytes allocated by the sketch */
+  size_t GetMemoryUsage() const { return sparse_.capacity() * sizeof(uint64_t) + registers_.capacity(); }
+
+ private:
+  /** Sets the register of a hash in the dense form. */
+  void AddToRegisters(uint64_t hash);
+
+  /** The distinct hashes added, until there are more than SPARSE_LIMIT. */
+  std::vector<uint64_t> sparse_;
+  /** The registers, empty while the sketch is sparse. */
+  std::vector<uint8_t> registers_;
+};
+
+/**
+ * KllSketch estimates the quantiles of the values added to it with the KLL algorithm.
+ *
+ * Values are kept in levels of compactors, a value of level h standing for 2^h inputs. A level that outgrows its
+ * capacity is sorted and every other value, starting at a random one of the first two, is promoted to the next level.
+ * Capacities shrink by 2/3 per level below the top one, so the sketch holds O(k) values and the rank of a quantile is
+ * off by about 1.7% of the input count for k = 200.
+ */
+class KllSketch {
+ public:
+  /** @param k the capacity of the top level */
+  explicit KllSketch(uint32_t k = 200) : k_(k) {}
+
+  /** Adds a value to the sketch. */
+  void Add(double value);
+
+  /**
+   * @param fraction the rank of the quantile divided by the number of values, in [0, 1]
+   * @return the estimated quantile, a value that was added; the sketch must not be empty
+   */
+  double Quantile(double fraction) const;
+
+  /** @return the bytes allocated by the sketch */
+  size_t GetMemoryUsage() const { return levels_.capacity() * sizeof(std::vector<double>) + size_ * sizeof(double); }
+
+ private:
+  /** @return the number of values level may hold before it is compacted */
+  size_t Capacity(size_t level) const;
+
+  /** Adds a level on top, which lowers the capacities of the others. */
+  void AddLevel();
+
+  /** Compacts the lowest full level. */
+  void Compress();
+
+  const uint32_t k_;
+  /** The values of each level, level h standing for 2^h inputs each. */
+  std::vector<std::vector<double>> levels_;
+  /** The number of values held over all levels, and the sum of their capacities. */
+  size_t size_{0};
+  size_t capacity_{0};
+  /** The state of the random bits that pick which half of a level is promoted. */
+  uint64_t random_{0x9e3779b97f4a7c15ULL};
+};
+
+}  // namespace bustub
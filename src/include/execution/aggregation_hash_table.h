@@ -0,0 +1,216 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_hash_table.h
+//
+// Identification: src/include/execution/aggregation_hash_table.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "common/macros.h"
+#include "execution/aggregate_sketch.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/vector_batch.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * AggregationHashTable maps group-by keys to the state of the aggregates of their group.
+ *
+ * Groups are stored back to back in an arena of 8-byte words: a header, one fixed-width accumulator per aggregate and
+ * the normalized key, i.e. the serialized group-by values. The hash table itself is an array of (hash, group offset)
+ * slots probed linearly, so a lookup hashes the key once and compares the bytes of the keys whose hashes match.
+ *
+ * Accumulators hold an int64_t for integer inputs and a double for DECIMAL inputs, updated in place without creating
+ * Values. Inputs of other types, e.g. the VARCHARs of a MIN, are kept as Values on the side. The types of the keys and
+ * the inputs are taken from the first insert.
+ *
+ * COUNT counts all inputs, SUM, MIN and MAX skip nulls and are null for a group without non-null inputs. The SUM of
+ * TINYINT, SMALLINT or INTEGER inputs is an INTEGER, of BIGINT inputs a BIGINT and of DECIMAL inputs a DECIMAL.
+ *
+ * AVG accumulates a sum and a count in two words and is a DECIMAL. COUNT DISTINCT and its approximate variants skip
+ * nulls too and are 0 for a group without non-null inputs. Their state word indexes a set of the distinct inputs, a
+ * HyperLogLog or a KllSketch held on the side, so that the groups of the arena keep a fixed size.
+ */
+class AggregationHashTable {
+ public:
+  /**
+   * @param agg_types the types of the aggregates, at most 64
+   * @param percentiles the fractions of the ApproxPercentileAggregate aggregates, one per aggregate, 0.5 if missing
+   */
+  explicit AggregationHashTable(const std::vector<AggregationType> &agg_types,
+                                const std::vector<double> &percentiles = {});
+
+  DISALLOW_COPY_AND_MOVE(AggregationHashTable);
+
+  /**
+   * Finds or creates the group of a key and combines the inputs of its aggregates into it.
+   * @param group_bys the group-by values
+   * @param aggregates the inputs of the aggregates
+   */
+  void InsertCombine(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates);
+
+  /**
+   * Combines the inputs of the aggregates into the group of a key if it exists, without creating it otherwise.
+   * @param group_bys the group-by values
+   * @param aggregates the inputs of the aggregates
+   * @param[out] hash the hash of the key if it has no group; keys of the same group have the same hash
+   * @return false if the key has no group
+   */
+  bool CombineIfPresent(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates, uint64_t *hash);
+
+  /**
+   * Inserts the rows of column vectors, reading fixed-size values straight from their arrays.
+   * @param group_bys the group-by values, one vector per group-by
+   * @param aggregates the inputs of the aggregates, one vector per aggregate
+   * @param size the number of rows
+   */
+  void InsertCombineBatch(const std::vector<ColumnVector> &group_bys, const std::vector<ColumnVector> &aggregates,
+                          size_t size);
+
+  /**
+   * @param agg_type the type of an aggregate
+   * @param input_type the type of its inputs
+   * @return the type of the values of the aggregate
+   */
+  static TypeId GetResultType(AggregationType agg_type, TypeId input_type);
+
+  /** Removes all groups. */
+  void Clear();
+
+  /** @return the number of groups */
+  size_t GetGroupCount() const { return group_count_; }
+
+  /** @return the bytes allocated by the table */
+  size_t GetMemoryUsage() const;
+
+  /** An iterator through the groups, in the order they were created. */
+  class Iterator {
+   public:
+    Iterator(const AggregationHashTable *table, size_t offset) : table_(table), offset_(offset) {}
+
+    /** @return the group-by values of the group */
+    AggregateKey Key() const;
+
+    /** @return the aggregate values of the group */
+    AggregateValue Val() const;
+
+    /** @return the iterator after it is incremented */
+    Iterator &operator++();
+
+    /** @return true if both iterators are identical */
+    bool operator==(const Iterator &other) const { return offset_ == other.offset_; }
+
+    /** @return true if both iterators are different */
+    bool operator!=(const Iterator &other) const { return offset_ != other.offset_; }
+
+   private:
+    const AggregationHashTable *table_;
+    /** The offset of the group in the arena. */
+    size_t offset_;
+  };
+
+  /** @return iterator to the first group */
+  Iterator Begin() const { return Iterator(this, 0); }
+
+  /** @return iterator past the last group */
+  Iterator End() const { return Iterator(this, arena_.size()); }
+
+ private:
+  /** The kind of accumulator of an aggregate, given by the type of its inputs. */
+  enum class StateKind : uint8_t { Integer, Decimal, Boxed };
+
+  /** A slot of the hash table: the hash of a key and the offset of its group in the arena plus one, 0 if empty. */
+  struct Slot {
+    uint64_t hash_;
+    uint64_t group_;
+  };
+
+  /** Words of a group before its accumulators: the size of its key in bytes and the aggregates with a value. */
+  static constexpr size_t HEADER_WORDS = 2;
+  static constexpr size_t INITIAL_SLOTS = 64;
+  /** The bytes accounted for an entry of a COUNT DISTINCT set besides the input itself. */
+  static constexpr size_t DISTINCT_ENTRY_BYTES = 64;
+  /** Returned by FindOrInsert for a key without a group. */
+  static constexpr size_t NO_GROUP = SIZE_MAX;
+
+  /** Fixes the types of the keys and inputs on the first insert. */
+  void InitTypes(const std::vector<TypeId> &key_types, const std::vector<TypeId> &input_types);
+
+  /** Appends the normalized form of a key value to key_. */
+  void AppendKeyValue(const Value &value, TypeId type);
+
+  /** Fixes the types on the first insert and puts the normalized key of the group-by values into key_. */
+  void MakeKey(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates);
+
+  /** Combines the inputs of the aggregates into a group. */
+  void Combine(size_t group, const std::vector<Value> &aggregates);
+
+  /** @return the offset of the group of the key in key_, created if missing and insert is true, else NO_GROUP */
+  size_t FindOrInsert(bool insert);
+
+  /** Doubles the number of slots. */
+  void Grow();
+
+  /** Combines a non-null input into an accumulator. */
+  void Accumulate(size_t group, uint32_t agg_idx, int64_t input);
+  void Accumulate(size_t group, uint32_t agg_idx, double input);
+  void Accumulate(size_t group, uint32_t agg_idx, const Value &input);
+
+  /** Adds the bytes of a non-null input to the distinct set or the HyperLogLog of a COUNT DISTINCT. */
+  void AccumulateDistinct(size_t group, uint32_t agg_idx, const char *data, size_t size);
+
+  /** Adds a non-null input to the KllSketch of a percentile. */
+  void AccumulatePercentile(size_t group, uint32_t agg_idx, double input);
+
+  /** @return the first state word of an aggregate of a group */
+  uint64_t &StateOf(size_t group, uint32_t agg_idx) { return arena_[group + HEADER_WORDS + state_offsets_[agg_idx]]; }
+
+  /** Combines an array of fixed-size inputs, one per row of the current batch, with T's null sentinel skipped. */
+  template <typename T>
+  void AccumulateColumn(uint32_t agg_idx, const T *inputs, T null_input, size_t size);
+
+  /** @return the hash of a normalized key */
+  static uint64_t HashKey(const char *key, size_t size);
+
+  /** @return the words of a group with a key of key_size bytes */
+  size_t GroupWords(size_t key_size) const { return HEADER_WORDS + state_words_ + (key_size + 7) / 8; }
+
+  const std::vector<AggregationType> agg_types_;
+  std::vector<double> percentiles_;
+  /** The offset of the state of each aggregate among the state words of a group, and their number. */
+  std::vector<size_t> state_offsets_;
+  size_t state_words_{0};
+  std::vector<TypeId> key_types_;
+  std::vector<TypeId> input_types_;
+  std::vector<StateKind> state_kinds_;
+  bool types_known_{false};
+
+  std::vector<Slot> slots_;
+  std::vector<uint64_t> arena_;
+  size_t group_count_{0};
+  /** The Values of Boxed accumulators, indexed by the accumulator. */
+  std::vector<Value> boxed_;
+  /** The states of the distinct counts and percentiles, indexed by the accumulator, and the bytes they hold. */
+  std::vector<std::unordered_set<std::string>> distinct_sets_;
+  std::vector<HyperLogLog> hlls_;
+  std::vector<KllSketch> klls_;
+  size_t side_bytes_{0};
+
+  /** Scratch space: the key being looked up and the groups of the rows of the current batch. */
+  std::vector<char> key_;
+  std::vector<size_t> row_groups_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_expression.h
+//
+// Identification: src/include/execution/compiled_expression.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * CompiledExpression is an expression tree flattened into a postfix program, built once per query by an executor's
+ * Init().
+ *
+ * Columns are resolved to the byte offset and type of their schema at compile time, so running the program reads the
+ * raw tuple data instead of calling Tuple::GetValue(), and intermediates live on a small stack of 64-bit slots instead
+ * of Values. Only the final result of Evaluate*() is boxed into a Value; Matches*() returns the result of a predicate
+ * without boxing it, a null result being false.
+ *
+ * The compiler handles column, constant, aggregate and comparison expressions over the numeric types. Compile*()
+ * returns false for anything else, and the caller keeps evaluating the expression tree.
+ */
+class CompiledExpression {
+ public:
+  /** The deepest expression that can be compiled. */
+  static constexpr uint32_t MAX_STACK_DEPTH = 16;
+
+  /**
+   * Compiles an expression evaluated against tuples of a schema, or of two schemas for a join.
+   * @param expr the expression
+   * @param left_schema the schema of the tuple, or of the left tuple of a join (column tuple index 0)
+   * @param right_schema the schema of the right tuple of a join (column tuple index 1), nullptr for a single tuple
+   * @return true if the expression was compiled
+   */
+  bool Compile(const AbstractExpression *expr, const Schema *left_schema, const Schema *right_schema = nullptr);
+
+  /** Compiles an expression evaluated against the group-bys and aggregates of an aggregation. */
+  bool CompileAggregate(const AbstractExpression *expr);
+
+  /** @return true if the last Compile*() succeeded */
+  bool IsCompiled() const { return compiled_; }
+
+  /** @return the value of the expression for a tuple */
+  Value Evaluate(const Tuple *tuple) const { return Box(Run(tuple, nullptr, nullptr, nullptr)); }
+
+  /** @return the value of the expression for a pair of joined tuples */
+  Value EvaluateJoin(const Tuple *left_tuple, const Tuple *right_tuple) const {
+    return Box(Run(left_tuple, right_tuple, nullptr, nullptr));
+  }
+
+  /** @return the value of the expression for a group */
+  Value EvaluateAggregate(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) const {
+    return Box(Run(nullptr, nullptr, &group_bys, &aggregates));
+  }
+
+  /** @return true if the predicate is true for a tuple */
+  bool Matches(const Tuple *tuple) const { return IsTrue(Run(tuple, nullptr, nullptr, nullptr)); }
+
+  /** @return true if the predicate is true for a pair of joined tuples */
+  bool MatchesJoin(const Tuple *left_tuple, const Tuple *right_tuple) const {
+    return IsTrue(Run(left_tuple, right_tuple, nullptr, nullptr));
+  }
+
+  /** @return true if the predicate is true for a group */
+  bool MatchesAggregate(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) const {
+    return IsTrue(Run(nullptr, nullptr, &group_bys, &aggregates));
+  }
+
+ private:
+  /** A value on the stack: an integral value, or a double if the instruction that pushed it says so. */
+  struct Slot {
+    union {
+      int64_t int_;
+      double double_;
+    };
+    bool is_null_;
+  };
+
+  enum class OpCode : uint8_t {
+    /** Pushes the column of a tuple at offset_, of type type_. */
+    LoadColumn,
+    /** Pushes constant_. */
+    LoadConstant,
+    /** Pushes the group-by (tuple_idx_ 0) or the aggregate (tuple_idx_ 1) at index offset_. */
+    LoadAggregate,
+    /** Converts the integral slot at the top of the stack to a double. */
+    Widen,
+    /** Pops two integral slots and pushes the result of comp_type_ on them. */
+    CompareInt,
+    /** Pops two double slots and pushes the result of comp_type_ on them. */
+    CompareDouble
+  };
+
+  struct Instruction {
+    OpCode op_;
+    TypeId type_{TypeId::INVALID};
+    ComparisonType comp_type_{ComparisonType::Equal};
+    uint32_t tuple_idx_{0};
+    uint32_t offset_{0};
+    Slot constant_{};
+  };
+
+  /** Emits the instructions of expr. @return the type of the value it pushes, INVALID if it cannot be compiled */
+  TypeId Emit(const AbstractExpression *expr, bool aggregate, uint32_t depth);
+
+  /** Runs the program. Inputs the program does not read may be nullptr. */
+  Slot Run(const Tuple *left_tuple, const Tuple *right_tuple, const std::vector<Value> *group_bys,
+           const std::vector<Value> *aggregates) const;
+
+  /** @return the result of the program as a Value of result_type_ */
+  Value Box(const Slot &slot) const;
+
+  static bool IsTrue(const Slot &slot) { return !slot.is_null_ && slot.int_ != 0; }
+
+  /** @return a value of a numeric type as a slot */
+  static Slot FromValue(const Value &value);
+
+  bool compiled_{false};
+  std::vector<Instruction> program_;
+  /** The type of the value the program computes. */
+  TypeId result_type_{TypeId::INVALID};
+  const Schema *schemas_[2]{nullptr, nullptr};
+};
+
+}  // namespace bustub
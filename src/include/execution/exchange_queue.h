@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_queue.h
+//
+// Identification: src/include/execution/exchange_queue.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <mutex>  // NOLINT
+
+#include "common/macros.h"
+#include "execution/vector_batch.h"
+
+namespace bustub {
+
+/**
+ * ExchangeQueue passes batches from the worker threads of a parallel operator to the thread that consumes its output.
+ *
+ * The queue is bounded, so fast producers wait for the consumer instead of buffering the whole result. A consumer that
+ * stops early, e.g. under a LIMIT, closes the queue to release the producers.
+ */
+class ExchangeQueue {
+ public:
+  /**
+   * Creates an exchange queue.
+   * @param producer_count the number of producers that will call FinishProducer()
+   * @param capacity the number of batches the queue holds before Push() blocks
+   */
+  ExchangeQueue(size_t producer_count, size_t capacity) : capacity_(capacity), producers_left_(producer_count) {}
+
+  DISALLOW_COPY_AND_MOVE(ExchangeQueue);
+
+  /**
+   * Adds a batch, waiting while the queue is full.
+   * @return false if the queue was closed, in which case the producer should stop
+   */
+  bool Push(VectorBatch &&batch);
+
+  /** Signals that a producer will not push any more batches. */
+  void FinishProducer();
+
+  /**
+   * Takes the oldest batch, waiting while the queue is empty.
+   * @return false once all producers finished and the queue is empty, or the queue was closed
+   */
+  bool Pop(VectorBatch *batch);
+
+  /** Drops the queued batches and makes all current and future calls of Push() and Pop() return false. */
+  void Close();
+
+ private:
+  std::mutex latch_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<VectorBatch> batches_;
+  const size_t capacity_;
+  size_t producers_left_;
+  bool closed_{false};
+};
+
+}  // namespace bustub
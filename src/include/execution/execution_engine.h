@@ -16,10 +16,12 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/catalog.h"
+#include "common/worker_pool.h"
 #include "concurrency/transaction_manager.h"
 #include "execution/executor_context.h"
 #include "execution/executor_factory.h"
 #include "execution/plans/abstract_plan.h"
+#include "optimizer/optimizer.h"
 #include "storage/table/tuple.h"
 namespace bustub {
 class ExecutionEngine {
@@ -31,19 +33,37 @@ class ExecutionEngine {
 
   bool Execute(const AbstractPlanNode *plan, std::vector<Tuple> *result_set, Transaction *txn,
                ExecutorContext *exec_ctx) {
+    // parallel subtrees run on the threads of the engine
+    exec_ctx->SetWorkerPool(&worker_pool_);
+
+    // rewrite the plan, the optimizer owns the new plan nodes until the query is done
+    Optimizer optimizer(exec_ctx->GetWorkerCount());
+    plan = optimizer.Optimize(plan);
+
     // construct executor
     auto executor = ExecutorFactory::CreateExecutor(exec_ctx, plan);
 
     // prepare
     executor->Init();
 
-    // execute
+    // execute, a batch at a time if the whole plan supports it, except for a scan at the root: its rows are returned as
+    // tuples, which Next() copies straight out of the pages while NextBatch() first copies every row it reads into
+    // column vectors and then builds the tuples back from them. Batches pay off for parents that consume the columns.
     try {
-      Tuple tuple;
-      RID rid;
-      while (executor->Next(&tuple, &rid)) {
-        if (result_set != nullptr) {
-          result_set->push_back(tuple);
+      if (executor->SupportsBatch() && plan->GetType() != PlanType::SeqScan) {
+        VectorBatch batch;
+        while (executor->NextBatch(&batch)) {
+          for (size_t i = 0; result_set != nullptr && i < batch.GetSize(); i++) {
+            result_set->push_back(batch.GetTuple(i, executor->GetOutputSchema()));
+          }
+        }
+      } else {
+        Tuple tuple;
+        RID rid;
+        while (executor->Next(&tuple, &rid)) {
+          if (result_set != nullptr) {
+            result_set->push_back(tuple);
+          }
         }
       }
     } catch (Exception &e) {
@@ -57,6 +77,8 @@ class ExecutionEngine {
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] TransactionManager *txn_mgr_;
   [[maybe_unused]] Catalog *catalog_;
+  /** The threads that run the instances of parallel subtrees, kept across queries. */
+  WorkerPool worker_pool_;
 };
 
 }  // namespace bustub
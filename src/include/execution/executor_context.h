@@ -21,6 +21,10 @@
 #include "storage/page/tmp_tuple_page.h"
 
 namespace bustub {
+
+class ParallelState;
+class WorkerPool;
+
 /**
  * ExecutorContext stores all the context necessary to run an executor.
  */
@@ -38,6 +42,28 @@ class ExecutorContext {
                   LockManager *lock_mgr)
       : transaction_(transaction), catalog_{catalog}, bpm_{bpm}, txn_mgr_(txn_mgr), lock_mgr_(lock_mgr) {}
 
+  /**
+   * Creates the context of one instance of a plan subtree that runs in parallel with others. The instances split the
+   * memory budget of the parent and share everything else.
+   * @param parent the context of the query
+   * @param parallel_state the state shared by the instances
+   * @param instance_idx the index of this instance
+   * @param instance_count the number of instances
+   */
+  ExecutorContext(const ExecutorContext &parent, ParallelState *parallel_state, size_t instance_idx,
+                  size_t instance_count)
+      : transaction_(parent.transaction_),
+        catalog_{parent.catalog_},
+        bpm_{parent.bpm_},
+        txn_mgr_(parent.txn_mgr_),
+        lock_mgr_(parent.lock_mgr_),
+        memory_budget_(parent.memory_budget_ / instance_count),
+        vectorized_(parent.vectorized_),
+        worker_count_(parent.worker_count_),
+        worker_pool_(parent.worker_pool_),
+        parallel_state_(parallel_state),
+        instance_idx_(instance_idx) {}
+
   DISALLOW_COPY_AND_MOVE(ExecutorContext);
 
   ~ExecutorContext() = default;
@@ -60,12 +86,48 @@ class ExecutorContext {
   /** @return the transaction manager */
   TransactionManager *GetTransactionManager() { return txn_mgr_; }
 
+  /** @return the number of bytes of tuples an executor may keep in memory before it spills to temporary pages */
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
+  /** Sets the memory budget of the executors of this query. */
+  void SetMemoryBudget(size_t memory_budget) { memory_budget_ = memory_budget; }
+
+  /** @return true if executors may pass tuples to each other in batches with NextBatch() */
+  bool IsVectorized() const { return vectorized_; }
+
+  /** Enables or disables batch-at-a-time execution for this query. */
+  void SetVectorized(bool vectorized) { vectorized_ = vectorized; }
+
+  /** @return the number of threads a parallel operator of this query may use */
+  size_t GetWorkerCount() const { return worker_count_; }
+
+  /** Sets the number of threads a parallel operator of this query may use, 1 to run the query on one thread. */
+  void SetWorkerCount(size_t worker_count) { worker_count_ = worker_count; }
+
+  /** @return the pool that runs the parallel parts of the query, nullptr if none was set */
+  WorkerPool *GetWorkerPool() const { return worker_pool_; }
+
+  /** Sets the pool that runs the parallel parts of the query. */
+  void SetWorkerPool(WorkerPool *worker_pool) { worker_pool_ = worker_pool; }
+
+  /** @return the state shared with the other instances of a subtree that runs in parallel, nullptr if it does not */
+  ParallelState *GetParallelState() const { return parallel_state_; }
+
+  /** @return the index of this instance among the instances of a subtree that runs in parallel */
+  size_t GetInstanceIdx() const { return instance_idx_; }
+
  private:
   Transaction *transaction_;
   Catalog *catalog_;
   BufferPoolManager *bpm_;
   TransactionManager *txn_mgr_;
   LockManager *lock_mgr_;
+  size_t memory_budget_{DEFAULT_QUERY_MEMORY};
+  bool vectorized_{true};
+  size_t worker_count_{1};
+  WorkerPool *worker_pool_{nullptr};
+  ParallelState *parallel_state_{nullptr};
+  size_t instance_idx_{0};
 };
 
 }  // namespace bustub
@@ -13,11 +13,13 @@
 #pragma once
 
 #include "execution/executor_context.h"
+#include "execution/vector_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 /**
  * AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
+ * Executors may also implement NextBatch() to pass tuples to their parent a VectorBatch at a time.
  */
 class AbstractExecutor {
  public:
@@ -44,25 +46,40 @@ class AbstractExecutor {
    */
   virtual bool Next(Tuple *tuple, RID *rid) = 0;
 
+  /**
+   * Produces the next batch of tuples from this executor. Only called if SupportsBatch() returns true, and never mixed
+   * with calls to Next() after Init().
+   * @param[out] batch up to VECTOR_SIZE tuples with the columns of the output schema, all materialized
+   * @return true if at least one tuple was produced, false if there are no more tuples
+   */
+  virtual bool NextBatch(VectorBatch *batch) { return false; }
+
+  /** @return true if NextBatch() is implemented by this executor and, if it pulls batches, by its children */
+  virtual bool SupportsBatch() { return false; }
+
+  /**
+   * Produces the next batch of tuples with NextBatch() if the executor supports it, or else with up to VECTOR_SIZE
+   * calls to Next(). For parents that move tuples around in batches whatever their child is, e.g. exchanges.
+   */
+  bool PullBatch(VectorBatch *batch) {
+    if (SupportsBatch()) {
+      return NextBatch(batch);
+    }
+    batch->Reset(GetOutputSchema());
+    Tuple tuple;
+    RID rid;
+    while (batch->GetSize() < VECTOR_SIZE && Next(&tuple, &rid)) {
+      batch->AppendTuple(tuple, GetOutputSchema());
+    }
+    return batch->GetSize() > 0;
+  }
+
   /** @return the schema of the tuples that this executor produces */
   virtual const Schema *GetOutputSchema() = 0;
 
   /** @return the executor context in which this executor runs */
   ExecutorContext *GetExecutorContext() { return exec_ctx_; }
 
-  Tuple ProjectTuple(const Tuple &tuple, const Schema &origin, const Schema &output) {
-    auto count = output.GetColumnCount();
-    std::vector<Value> values;
-    for (uint32_t i = 0; i < count; ++i) {
-      Column col = output.GetColumn(i);
-      std::string col_name = col.GetName();
-      auto idx = origin.GetColIdx(col_name);
-      values.push_back(tuple.GetValue(&origin, idx));
-    }
-    Tuple res = Tuple(values, &output);
-    return res;
-  }
-
  protected:
   ExecutorContext *exec_ctx_;
 };
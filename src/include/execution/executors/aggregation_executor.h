@@ -13,148 +13,37 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
-#include "common/util/hash_util.h"
-#include "container/hash/hash_function.h"
+#include "execution/aggregation_hash_table.h"
+#include "execution/compiled_expression.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/expressions/aggregate_value_expression.h"
 #include "execution/plans/aggregation_plan.h"
+#include "storage/table/tmp_tuple_run.h"
 #include "storage/table/tuple.h"
 #include "type/value_factory.h"
 
 namespace bustub {
-/**
- * A simplified hash table that has all the necessary functionality for aggregations.
- */
-class SimpleAggregationHashTable {
- public:
-  /**
-   * Create a new simplified aggregation hash table.
-   * @param agg_exprs the aggregation expressions
-   * @param agg_types the types of aggregations
-   */
-  SimpleAggregationHashTable(const std::vector<const AbstractExpression *> &agg_exprs,
-                             const std::vector<AggregationType> &agg_types)
-      : agg_exprs_{agg_exprs}, agg_types_{agg_types} {}
-
-  /** @return the initial aggregrate value for this aggregation executor */
-  AggregateValue GenerateInitialAggregateValue() {
-    std::vector<Value> values;
-    for (const auto &agg_type : agg_types_) {
-      switch (agg_type) {
-        case AggregationType::CountAggregate:
-          // Count starts at zero.
-          values.emplace_back(ValueFactory::GetIntegerValue(0));
-          break;
-        case AggregationType::SumAggregate:
-          // Sum starts at zero.
-          values.emplace_back(ValueFactory::GetIntegerValue(0));
-          break;
-        case AggregationType::MinAggregate:
-          // Min starts at INT_MAX.
-          values.emplace_back(ValueFactory::GetIntegerValue(BUSTUB_INT32_MAX));
-          break;
-        case AggregationType::MaxAggregate:
-          // Max starts at INT_MIN.
-          values.emplace_back(ValueFactory::GetIntegerValue(BUSTUB_INT32_MIN));
-          break;
-      }
-    }
-    return {values};
-  }
-
-  /** Combines the input into the aggregation result. */
-  void CombineAggregateValues(AggregateValue *result, const AggregateValue &input) {
-    for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
-      switch (agg_types_[i]) {
-        case AggregationType::CountAggregate:
-          // Count increases by one.
-          result->aggregates_[i] = result->aggregates_[i].Add(ValueFactory::GetIntegerValue(1));
-          break;
-        case AggregationType::SumAggregate:
-          // Sum increases by addition.
-          result->aggregates_[i] = result->aggregates_[i].Add(input.aggregates_[i]);
-          break;
-        case AggregationType::MinAggregate:
-          // Min is just the min.
-          result->aggregates_[i] = result->aggregates_[i].Min(input.aggregates_[i]);
-          break;
-        case AggregationType::MaxAggregate:
-          // Max is just the max.
-          result->aggregates_[i] = result->aggregates_[i].Max(input.aggregates_[i]);
-          break;
-      }
-    }
-  }
-
-  /**
-   * Inserts a value into the hash table and then combines it with the current aggregation.
-   * @param agg_key the key to be inserted
-   * @param agg_val the value to be inserted
-   */
-  void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
-    if (ht.count(agg_key) == 0) {
-      ht.insert({agg_key, GenerateInitialAggregateValue()});
-    }
-    CombineAggregateValues(&ht[agg_key], agg_val);
-  }
-
-  /**
-   * An iterator through the simplified aggregation hash table.
-   */
-  class Iterator {
-   public:
-    /** Creates an iterator for the aggregate map. */
-    explicit Iterator(std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter) : iter_(iter) {}
-
-    /** @return the key of the iterator */
-    const AggregateKey &Key() { return iter_->first; }
-
-    /** @return the value of the iterator */
-    const AggregateValue &Val() { return iter_->second; }
-
-    /** @return the iterator before it is incremented */
-    Iterator &operator++() {
-      ++iter_;
-      return *this;
-    }
-
-    /** @return true if both iterators are identical */
-    bool operator==(const Iterator &other) { return this->iter_ == other.iter_; }
-
-    /** @return true if both iterators are different */
-    bool operator!=(const Iterator &other) { return this->iter_ != other.iter_; }
-
-   private:
-    /** Aggregates map. */
-    std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter_;
-  };
-
-  /** @return iterator to the start of the hash table */
-  Iterator Begin() { return Iterator{ht.cbegin()}; }
-
-  /** @return iterator to the end of the hash table */
-  Iterator End() { return Iterator{ht.cend()}; }
-
- private:
-  /** The hash table is just a map from aggregate keys to aggregate values. */
-  std::unordered_map<AggregateKey, AggregateValue> ht{};
-  /** The aggregate expressions that we have. */
-  const std::vector<const AbstractExpression *> &agg_exprs_;
-  /** The types of aggregations that we have. */
-  const std::vector<AggregationType> &agg_types_;
-};
-
 /**
  * AggregationExecutor executes an aggregation operation (e.g. COUNT, SUM, MIN, MAX) on the tuples of a child executor.
+ * Init() drains the child into an AggregationHashTable, a batch at a time when the child and the expressions allow it.
+ *
+ * Once the hash table outgrows the memory budget of the ExecutorContext, it stops creating groups: rows of groups
+ * already in memory are still combined into them, the other rows are hash partitioned by group key into FANOUT
+ * TmpTupleRuns. The groups in memory are returned first, then the spilled runs are aggregated one at a time, and a
+ * run whose groups still do not fit is partitioned again with a different hash, up to MAX_LEVEL times.
  */
 class AggregationExecutor : public AbstractExecutor {
  public:
+  /** Number of runs the rows of new groups are spilled to. */
+  static constexpr uint32_t FANOUT = 8;
+  /** Number of times a spilled run can be partitioned again. */
+  static constexpr uint32_t MAX_LEVEL = 3;
+
   /**
    * Creates a new aggregation executor.
    * @param exec_ctx the context that the aggregation should be performed in
@@ -173,6 +62,13 @@ class AggregationExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(VectorBatch *batch) override;
+
+  bool SupportsBatch() override;
+
+  /** @return the number of runs spilled to temporary pages so far */
+  size_t GetSpilledRunCount() const { return spilled_run_count_; }
+
   /** @return the tuple as an AggregateKey */
   AggregateKey MakeKey(const Tuple *tuple) {
     std::vector<Value> keys;
@@ -191,16 +87,55 @@ class AggregationExecutor : public AbstractExecutor {
     return {vals};
   }
 
-  virtual ~AggregationExecutor();
-
  private:
+  /** @return true if the child is read a batch at a time, with the group-bys and aggregates evaluated per batch */
+  bool ConsumesBatches();
+
+  /** Compiles the group-bys and aggregates against the child schema, and the having clause. */
+  void CompilePrograms();
+
+  /** Produces the output values of the next group that satisfies the having clause. @return false if none is left */
+  bool NextGroup(std::vector<Value> *values);
+
+  /** Combines a row into the hash table, or spills it if its group is not in memory and the table is full. */
+  void Consume(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates);
+
+  /** Starts spilling the rows of new groups if the hash table is over the memory budget. */
+  void CheckMemory();
+
+  /** Queues the runs spilled by the current pass. */
+  void FinishPass();
+
+  /** Aggregates the next queued run into the hash table. @return false if no run is left */
+  bool StartNextPass();
+
+  /** A spilled run waiting to be aggregated. */
+  struct SpilledRun {
+    std::unique_ptr<TmpTupleRun> run_;
+    uint32_t level_;
+  };
+
   /** The aggregation plan node. */
   const AggregationPlanNode *plan_;
   /** The child executor whose tuples we are aggregating. */
   std::unique_ptr<AbstractExecutor> child_;
-  /** Simple aggregation hash table. */
-  SimpleAggregationHashTable *aht_;
-  /** Simple aggregation hash table iterator. */
-  SimpleAggregationHashTable::Iterator *aht_iterator_;
+  /** The groups and the states of their aggregates. */
+  AggregationHashTable aht_;
+  /** The next group to be returned. */
+  AggregationHashTable::Iterator aht_iterator_;
+  /** The compiled group-bys, aggregates and having clause; one that is not compiled is evaluated as a tree. */
+  std::vector<CompiledExpression> group_by_programs_;
+  std::vector<CompiledExpression> aggregate_programs_;
+  CompiledExpression having_program_;
+
+  /** The partitioning level of the current pass, 0 while the child is aggregated. */
+  uint32_t level_{0};
+  /** The runs of the current pass, empty until the hash table is full. */
+  std::vector<std::unique_ptr<TmpTupleRun>> runs_;
+  /** Spilled runs left to aggregate. */
+  std::vector<SpilledRun> pending_;
+  /** The group-by values followed by the aggregate inputs, the format of spilled rows. */
+  std::unique_ptr<Schema> spill_schema_;
+  size_t spilled_run_count_{0};
 };
 }  // namespace bustub
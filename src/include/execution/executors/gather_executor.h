@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_executor.h
+//
+// Identification: src/include/execution/executors/gather_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <future>  // NOLINT
+#include <memory>
+#include <vector>
+
+#include "common/worker_pool.h"
+#include "execution/exchange_queue.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/parallel_state.h"
+#include "execution/plans/gather_plan.h"
+
+namespace bustub {
+/**
+ * GatherExecutor runs GetInstanceCount() instances of its child subtree on the worker pool of the ExecutorContext and
+ * merges their batches through an ExchangeQueue.
+ *
+ * Each instance gets its own executors and ExecutorContext, built by Init(), and the instances share a ParallelState.
+ * The executors of an instance are destroyed by the task that ran them.
+ * An exception thrown by an instance is rethrown by Next() or NextBatch() once the other instances are done.
+ */
+class GatherExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new gather executor.
+   * @param exec_ctx the executor context
+   * @param plan the gather plan to be executed
+   */
+  GatherExecutor(ExecutorContext *exec_ctx, const GatherPlanNode *plan);
+
+  ~GatherExecutor() override;
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  bool NextBatch(VectorBatch *batch) override;
+
+  bool SupportsBatch() override { return exec_ctx_->IsVectorized(); }
+
+ private:
+  /** Runs an instance to completion or until the exchange is closed, pushing its output into the exchange. */
+  void RunInstance(size_t instance_idx);
+
+  /** Waits for the instances, rethrowing the first exception one of them threw. */
+  void WaitForInstances();
+
+  /** Releases the instances blocked on the exchange and destroys them. */
+  void StopInstances();
+
+  /** The gather plan node to be executed. */
+  const GatherPlanNode *plan_;
+  /** The pool the instances run on if the context has none. */
+  std::unique_ptr<WorkerPool> own_pool_;
+
+  std::unique_ptr<ParallelState> parallel_state_;
+  std::vector<std::unique_ptr<ExecutorContext>> instance_contexts_;
+  std::vector<std::unique_ptr<AbstractExecutor>> instances_;
+  std::vector<std::future<void>> tasks_;
+  std::unique_ptr<ExchangeQueue> exchange_;
+
+  /** The batch Next() returns tuples from. */
+  VectorBatch batch_;
+  size_t batch_row_{0};
+};
+}  // namespace bustub
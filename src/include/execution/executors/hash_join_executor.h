@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.h
+//
+// Identification: src/include/execution/executors/hash_join_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/projection_map.h"
+#include "storage/table/tmp_tuple_run.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * HashJoinExecutor joins two children on an equality predicate with a hybrid hash join.
+ *
+ * Init() reads both children in lockstep until one of them runs out. The exhausted child is the smaller input, so its
+ * tuples are put into the hash table (build side) while the tuples already read from the other child (probe side) are
+ * kept in a buffer. Next() probes the hash table with the buffered tuples first and then streams the rest of the probe
+ * side.
+ *
+ * The build side is hash partitioned. When the build tuples held in memory exceed the memory budget of the
+ * ExecutorContext, the largest partition is spilled to a TmpTupleRun and so are the probe tuples that fall into it.
+ * Partitions that stay in memory are joined while the probe side streams by, the spilled pairs afterwards, one pair at
+ * a time. A spilled pair that still does not fit is partitioned again with a different hash, up to MAX_LEVEL times.
+ */
+class HashJoinExecutor : public AbstractExecutor {
+ public:
+  /** Number of partitions of the build side. */
+  static constexpr uint32_t FANOUT = 8;
+  /** Number of times a spilled partition can be partitioned again. */
+  static constexpr uint32_t MAX_LEVEL = 3;
+
+  /**
+   * Creates a new hash join executor.
+   * @param exec_ctx the executor context
+   * @param plan the hash join plan to be executed
+   * @param left_executor the child executor that produces tuples for the left side of the join
+   * @param right_executor the child executor that produces tuples for the right side of the join
+   */
+  HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                   std::unique_ptr<AbstractExecutor> &&right_executor);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /** @return true if the hash table was built on the left child */
+  bool IsBuildLeft() const { return build_left_; }
+
+  /** @return the number of partitions spilled to temporary pages so far */
+  size_t GetSpilledPartitionCount() const { return spilled_partition_count_; }
+
+ private:
+  /** A partition of the build side and, once it is spilled, of the probe side. */
+  struct Partition {
+    std::vector<Tuple> tuples_;
+    size_t size_{0};
+    std::unique_ptr<TmpTupleRun> build_run_;
+    std::unique_ptr<TmpTupleRun> probe_run_;
+  };
+
+  /** A spilled partition pair waiting to be joined. */
+  struct SpilledPair {
+    std::unique_ptr<TmpTupleRun> build_run_;
+    std::unique_ptr<TmpTupleRun> probe_run_;
+    uint32_t level_;
+  };
+
+  /** Partitions the build tuples returned by next_build_tuple and builds the hash table on the in-memory ones. */
+  void Build(const std::function<bool(Tuple *)> &next_build_tuple, uint32_t level);
+
+  /** Moves the largest in-memory partition to temporary pages. @return false if no partition is left in memory */
+  bool SpillLargestPartition();
+
+  /** Queues the spilled partitions of the current pass and starts joining the next spilled pair. */
+  bool StartNextPass();
+
+  /** @return the next tuple of the probe side of the current pass */
+  bool NextProbeTuple(Tuple *tuple);
+
+  /** @return the join key of a build (is_build = true) or a probe tuple */
+  HashJoinKey MakeKey(const Tuple &tuple, bool is_build);
+
+  /** @return the partition of a key at the current level */
+  uint32_t PartitionOf(const HashJoinKey &key) const;
+
+  /** Appends a tuple to a run, throwing if the buffer pool is out of frames. */
+  static void AppendToRun(TmpTupleRun *run, const Tuple &tuple);
+
+  /** @return the bytes of memory accounted for a tuple held in memory */
+  static size_t MemoryOf(const Tuple &tuple) { return sizeof(Tuple) + tuple.GetLength(); }
+
+  /** The hash join plan node to be executed. */
+  const HashJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+  /** True if the left child is the build side. */
+  bool build_left_{true};
+
+  /** The partitioning level of the current pass, 0 while the children are joined. */
+  uint32_t level_{0};
+  std::vector<Partition> partitions_;
+  /** The bytes of build tuples held in memory by the current pass. */
+  size_t memory_used_{0};
+  /** The build tuples of the in-memory partitions grouped by join key. */
+  std::unordered_map<HashJoinKey, std::vector<Tuple>> hash_table_;
+
+  /** Probe side tuples read while looking for the smaller input, kept in memory or spilled if they are too large. */
+  std::vector<Tuple> probe_buffer_;
+  size_t probe_buffer_idx_{0};
+  std::unique_ptr<TmpTupleRun> probe_prefix_run_;
+  /** True once the probe child returned false. */
+  bool probe_done_{false};
+
+  /** Spilled pairs left to join, and the pair joined by the current pass if it is not the first one. */
+  std::vector<SpilledPair> pending_;
+  SpilledPair current_pair_;
+  size_t spilled_partition_count_{0};
+
+  /** Builds the output tuples, if every output column is a column of an input. */
+  ProjectionMap projection_;
+  bool use_projection_{false};
+
+  /** The current probe tuple and the build tuples it still has to be joined with. */
+  Tuple probe_tuple_;
+  const std::vector<Tuple> *matches_{nullptr};
+  size_t match_idx_{0};
+};
+}  // namespace bustub
@@ -44,5 +44,8 @@ class LimitExecutor : public AbstractExecutor {
   const LimitPlanNode *plan_;
   /** The child executor to obtain value from. */
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The number of tuples skipped for the offset and returned so far. */
+  size_t skipped_{0};
+  size_t emitted_{0};
 };
 }  // namespace bustub
@@ -22,16 +22,23 @@
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/nested_index_join_plan.h"
-#include "storage/table/tmp_tuple.h"
+#include "execution/projection_map.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * IndexJoinExecutor executes index join operations.
+ *
+ * The outer tuples are read in batches of BATCH_SIZE. The index keys of a batch are sorted and deduplicated and then
+ * looked up in key order with Index::ScanKeys, so consecutive probes land on the same or neighbouring leaf pages,
+ * which are still in the buffer pool. The output keeps the order of the outer tuples.
  */
 class NestIndexJoinExecutor : public AbstractExecutor {
  public:
+  /** Number of outer tuples whose keys are looked up together. */
+  static constexpr size_t BATCH_SIZE = 256;
+
   /**
    * Creates a new nested index join executor.
    * @param exec_ctx the context that the hash join should be performed in
@@ -48,7 +55,24 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   bool Next(Tuple *tuple, RID *rid) override;
 
  private:
+  /** Reads the next batch of outer tuples and looks up their keys. @return false if the outer side is exhausted */
+  bool NextBatch();
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
+  /** The child executor that produces the outer tuples. */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  TableMetadata *inner_table_;
+  IndexInfo *index_info_;
+
+  /** The current batch of outer tuples and the inner rids matching each of them. */
+  std::vector<Tuple> outer_tuples_;
+  std::vector<std::vector<RID>> inner_rids_;
+  size_t outer_idx_{0};
+  size_t rid_idx_{0};
+
+  /** Builds the output tuples, if every output column is a column of an input. */
+  ProjectionMap projection_;
+  bool use_projection_{false};
 };
 }  // namespace bustub
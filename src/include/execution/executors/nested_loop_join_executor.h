@@ -15,15 +15,21 @@
 #include <memory>
 #include <utility>
 
+#include "common/arena.h"
+#include "execution/compiled_expression.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/nested_loop_join_plan.h"
+#include "execution/projection_map.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 /**
  * NestedLoopJoinExecutor joins two tables using nested loop.
  * The child executor can either be a sequential scan
+ *
+ * The tuples returned by Next() are allocated in an arena of the executor, and are valid until Next() or Init() is
+ * called again. The children's tuples are used the same way: the outer one is kept until the next one is read.
  */
 class NestedLoopJoinExecutor : public AbstractExecutor {
  public:
@@ -46,6 +52,9 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
   bool Next(Tuple *tuple, RID *rid) override;
 
  private:
+  /** @return true if the current outer tuple and an inner tuple satisfy the join predicate */
+  bool PredicateMatches(const Tuple &inner_tuple);
+
   /** The NestedLoop plan node to be executed. */
   const NestedLoopJoinPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> left_executor;
@@ -53,5 +62,11 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
   //  nullptr if not any more outer tuple
   Tuple currentOut;
   bool out_is_end;
+  /** The join predicate compiled against the output schemas of both children. */
+  CompiledExpression predicate_program_;
+  /** Builds the output tuples out of the columns of the same names in the outer or else the inner tuple. */
+  ProjectionMap projection_;
+  /** The memory of the tuple returned by Next(). */
+  Arena arena_;
 };
 }  // namespace bustub
@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// repartition_executor.h
+//
+// Identification: src/include/execution/executors/repartition_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "execution/exchange_queue.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/parallel_state.h"
+#include "execution/plans/repartition_plan.h"
+
+namespace bustub {
+/**
+ * RepartitionExecutor redistributes the tuples of its child by the hash of the plan's keys.
+ *
+ * Within a subtree run in parallel, the instances of a repartition share a RepartitionState. The first instance to
+ * be initialized starts one producer per instance on the worker pool; each producer runs its own instance of the
+ * child subtree and pushes the tuples of partition i into queue i, which instance i reads from.
+ *
+ * Outside of a parallel subtree the executor has a child executor and passes its tuples through.
+ */
+class RepartitionExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new repartition executor.
+   * @param exec_ctx the executor context
+   * @param plan the repartition plan to be executed
+   * @param child_executor the child executor to pass tuples through from, nullptr in a parallel subtree
+   */
+  RepartitionExecutor(ExecutorContext *exec_ctx, const RepartitionPlanNode *plan,
+                      std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  ~RepartitionExecutor() override;
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  bool NextBatch(VectorBatch *batch) override;
+
+  bool SupportsBatch() override {
+    return child_executor_ != nullptr ? child_executor_->SupportsBatch() : exec_ctx_->IsVectorized();
+  }
+
+ private:
+  /** The producers and partitions shared by the instances of a repartition. */
+  class RepartitionState {
+   public:
+    /**
+     * Creates the instances of the child subtree, one per partition.
+     * @param exec_ctx the context of the instance that creates the state
+     * @param plan the repartition plan
+     */
+    RepartitionState(ExecutorContext *exec_ctx, const RepartitionPlanNode *plan);
+
+    /** Releases the producers and waits for them. */
+    ~RepartitionState();
+
+    DISALLOW_COPY_AND_MOVE(RepartitionState);
+
+    /** Starts the producers on the worker pool, once. */
+    void Start();
+
+    /** @return the queue of a partition */
+    ExchangeQueue *GetPartition(size_t partition_idx) { return partitions_[partition_idx].get(); }
+
+    /** Waits for the producers, rethrowing the first exception one of them threw. */
+    void Finish();
+
+   private:
+    /** Runs an instance of the child subtree, splitting its batches among the partitions. */
+    void Produce(size_t instance_idx);
+
+    const RepartitionPlanNode *plan_;
+    WorkerPool *pool_;
+    std::once_flag started_;
+    std::unique_ptr<ParallelState> parallel_state_;
+    std::vector<std::unique_ptr<ExecutorContext>> instance_contexts_;
+    std::vector<std::unique_ptr<AbstractExecutor>> instances_;
+    std::vector<std::unique_ptr<ExchangeQueue>> partitions_;
+    std::vector<std::shared_future<void>> producers_;
+  };
+
+  /** The repartition plan node to be executed. */
+  const RepartitionPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  RepartitionState *state_{nullptr};
+
+  /** The batch Next() returns tuples from in a parallel subtree. */
+  VectorBatch batch_;
+  size_t batch_row_{0};
+};
+}  // namespace bustub
@@ -14,15 +14,46 @@
 
 #include <vector>
 
+#include "common/arena.h"
+#include "execution/compiled_expression.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/morsel_dispenser.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/projection_map.h"
+#include "storage/page/compressed_page.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * SeqScanExecutor executes a sequential scan over a table.
+ *
+ * NextBatch() reads the table a page at a time without copying the tuples out of the page. Only the columns used by
+ * the predicate or the output schema are copied into the column vectors of a batch, the predicate is evaluated on the
+ * whole batch and the batch is compacted to the matching tuples before it is projected. A predicate comparing an
+ * INTEGER, BIGINT or DECIMAL column with a constant is evaluated by FilterKernels instead of the expression.
+ * NextBatch() serves parents that consume the columns: the engine runs a scan at the root of a plan with Next(), whose
+ * output is tuples anyway.
+ *
+ * A predicate comparing a fixed-size column with a constant is also checked against the zone map of each page before
+ * the page is read: a page whose range of the column rules out a match is skipped, in both Next() and NextBatch().
+ *
+ * Next() evaluates the predicate on the tuples in the page too, and copies only the matching ones out of it, into an
+ * arena of the executor that is reset by the next call. The tuple returned is thus a view that stays valid until
+ * Next() or Init() is called again; a parent that keeps it longer copies it, which makes a tuple that owns its data.
+ *
+ * On a PAX table only the columns read by the predicate or the output schema are decoded. NextBatch() copies runs of
+ * live slots of fixed-size columns straight out of their minipages, and Next() leaves the other columns null in the
+ * tuple the predicate is evaluated on.
+ *
+ * A COMPRESSED table is read the same way, NextBatch() decoding only the selected slots. A predicate comparing a
+ * column other than a DECIMAL with a constant by a comparison other than NotEqual is applied to the codes of each
+ * page before anything is decoded, so the batch is filled with the matching tuples only.
+ *
+ * In a subtree run in parallel by a gather, the instances of a scan share a MorselDispenser over the table's page
+ * directory and each one scans the morsels it claims, so every tuple is returned by exactly one instance.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -37,12 +68,107 @@ class SeqScanExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(VectorBatch *batch) override;
+
+  bool SupportsBatch() override;
+
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
  private:
+  /** A position in a list of table pages: the next page, and the next tuple in it if a batch stopped mid-page. */
+  struct ScanCursor {
+    std::vector<page_id_t> page_ids_;
+    size_t page_idx_{0};
+    RID rid_;
+    bool rid_valid_{false};
+  };
+
+  /**
+   * The buffers of a scan: the tuples read, the result of the predicate on them and the matching rows, and the slots
+   * of a compressed page to decode.
+   */
+  struct ScanState {
+    VectorBatch scan_batch_;
+    ColumnVector predicate_result_;
+    std::vector<uint32_t> selection_;
+    std::vector<uint64_t> filter_bitmask_;
+    std::vector<uint32_t> slots_;
+  };
+
+  /** Reads up to VECTOR_SIZE tuples from the pages of a cursor. @return false if the pages are exhausted */
+  bool FillScanBatch(ScanCursor *cursor, ScanState *state) const;
+
+  /** FillScanBatch() of a PAX table. */
+  bool FillPaxScanBatch(ScanCursor *cursor, ScanState *state) const;
+
+  /** FillScanBatch() of a COMPRESSED table. */
+  bool FillCompressedScanBatch(ScanCursor *cursor, ScanState *state) const;
+
+  /** Selects the slots in [from, to) of a compressed page that match the predicate. @return their number */
+  uint32_t SelectEncoded(CompressedPage *page, uint32_t from, uint32_t to, uint32_t *selection) const;
+
+  /** Next() of a PAX or COMPRESSED table, whose pages are PaxPages or CompressedPages. */
+  template <typename PageType>
+  bool NextColumnar(Tuple *tuple, RID *rid);
+
+  /** Applies the predicate to the tuples read into a scan state and copies the output columns into a batch. */
+  void FilterAndProject(ScanState *state, VectorBatch *batch) const;
+
+  /** Decides whether FilterKernels and zone maps can be used for the predicate, and prepares its operands. */
+  void InitFilterKernel();
+
+  /** Sets the selection of a scan state to the rows that match the predicate, using FilterKernels. */
+  void EvaluateFilterKernel(ScanState *state) const;
+
+  /** Points cursor_ at the next morsel of a parallel scan. @return false if there is none left */
+  bool NextMorsel();
+
+  /** @return the output columns of a tuple of the table, allocated in arena_ */
+  Tuple ProjectIntoArena(const Tuple &view);
+
+  /** @return false if the zone map of a page shows that none of its tuples matches the predicate */
+  bool PageMayMatch(page_id_t page_id) const;
+
+  /** @return true if a tuple of the table matches the predicate */
+  bool PredicateMatches(const Tuple &tuple) const;
+
   /** The sequential scan plan node to be executed. */
   const SeqScanPlanNode *plan_;
   TableHeap *tableHeap;
-  TableIterator iterator;
+
+  const Schema *table_schema_{nullptr};
+  /** The predicate compiled against the table schema, used by Next(). */
+  CompiledExpression predicate_program_;
+  /** The column of the table that each output column is taken from. */
+  std::vector<uint32_t> output_col_idxs_;
+  /** True if the output schema is the table schema, so a tuple is output as is, or else the map of the columns. */
+  bool identity_projection_{false};
+  ProjectionMap projection_;
+  /** True if the table has the PAX or the COMPRESSED layout. */
+  bool pax_{false};
+  bool compressed_{false};
+  /** The values of a row of a PAX or COMPRESSED table, null in the columns that are not read. */
+  std::vector<Value> columnar_values_;
+  /** The columns of the table read by the predicate or the output schema. */
+  std::vector<uint32_t> read_col_idxs_;
+  /** The pages left to scan, snapshot by Init() or claimed from the dispenser, and the buffers of NextBatch(). */
+  ScanCursor cursor_;
+  ScanState state_;
+  /** The memory of the tuple returned by Next(). */
+  Arena arena_;
+
+  /** True if the predicate is (column filter_comp_type_ filter_constant_) for a column FilterKernels can compare. */
+  bool use_filter_kernel_{false};
+  /** True if the predicate has that form for a fixed-size column, so that pages can be skipped by their zone maps. */
+  bool use_zone_map_{false};
+  /** True if the predicate has that form for a column of a COMPRESSED table whose codes can be filtered on. */
+  bool use_encoded_filter_{false};
+  uint32_t filter_col_idx_{0};
+  ComparisonType filter_comp_type_{ComparisonType::Equal};
+  /** The constant, cast to the type of the column. */
+  Value filter_constant_;
+
+  /** The morsels shared with the other instances of a parallel scan, owned by the ParallelState. */
+  MorselDispenser *dispenser_{nullptr};
 };
 }  // namespace bustub
@@ -0,0 +1,175 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.h
+//
+// Identification: src/include/execution/executors/sort_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/sort_plan.h"
+#include "storage/table/tmp_tuple_run.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * LoserTree repeatedly picks the smallest current key of k sorted streams with about log2(k) comparisons per pick.
+ * Each inner node remembers the loser of the match played there, so after the winner's stream advances only the
+ * matches on the path from its leaf to the root have to be replayed. Ties go to the stream with the smaller index.
+ */
+class LoserTree {
+ public:
+  /** @param num_streams the number of streams to merge, all exhausted until their first key is set */
+  explicit LoserTree(size_t num_streams)
+      : keys_(num_streams), done_(num_streams, true), tree_(std::max<size_t>(num_streams, 1), 0) {}
+
+  /** Sets the current key of a stream. The key must stay valid until the stream is advanced again. */
+  void SetKey(size_t stream, std::string_view key) {
+    keys_[stream] = key;
+    done_[stream] = false;
+  }
+
+  /** Marks a stream as exhausted. */
+  void SetDone(size_t stream) { done_[stream] = true; }
+
+  /** Plays all matches. Must be called once the first key of every stream has been set. */
+  void Build();
+
+  /** Replays the matches of the last winner after its key was changed with SetKey() or SetDone(). */
+  void Replay();
+
+  /** @return the stream with the smallest current key */
+  size_t Winner() const { return tree_[0]; }
+
+  /** @return true if all streams are exhausted */
+  bool IsEmpty() const { return keys_.empty() || done_[tree_[0]]; }
+
+ private:
+  /** @return true if stream a wins against stream b */
+  bool Beats(size_t a, size_t b) const {
+    if (done_[a] || done_[b]) {
+      return !done_[a] && (done_[b] || a < b);
+    }
+    int cmp = keys_[a].compare(keys_[b]);
+    return cmp < 0 || (cmp == 0 && a < b);
+  }
+
+  std::vector<std::string_view> keys_;
+  std::vector<bool> done_;
+  /** tree_[0] is the overall winner, tree_[1..k-1] the losers of the inner nodes; leaves are the indexes k..2k-1. */
+  std::vector<size_t> tree_;
+};
+
+/**
+ * SortExecutor returns the tuples of its child ordered by the sort keys of the plan.
+ *
+ * Every tuple is paired with a normalized key: the sort key values encoded so that comparing two keys with memcmp
+ * gives the order of the tuples, see EncodeKey(). When all tuples fit into the memory budget of the ExecutorContext
+ * they are sorted in memory. Otherwise each time the budget is used up the tuples read so far are sorted and written
+ * to a run of temporary pages together with their keys. The runs are then merged with a LoserTree, at most
+ * GetMergeFanIn() at a time, until the last merge can stream its output to the parent.
+ */
+class SortExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new sort executor.
+   * @param exec_ctx the executor context
+   * @param plan the sort plan to be executed
+   * @param child_executor the child executor that produces the tuples to be sorted
+   */
+  SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * Appends the normalized key of a tuple to out.
+   *
+   * Each sort key starts with a byte that orders nulls first, followed by the value: integers big-endian with the sign
+   * bit flipped, decimals by their IEEE-754 bits with the sign handled the same way, strings with every 0x00 byte
+   * escaped as 0x00 0xFF and ended by 0x00 0x00. All bytes of a descending key are inverted.
+   */
+  static void EncodeKey(const Tuple &tuple, const Schema *schema,
+                        const std::vector<std::pair<OrderByType, const AbstractExpression *>> &order_bys,
+                        std::string *out);
+
+  /** @return the number of sorted runs written to temporary pages, 0 if the input was sorted in memory */
+  size_t GetRunCount() const { return run_count_; }
+
+  /** @return the number of merge passes before the final one that streams the output */
+  size_t GetMergePassCount() const { return merge_pass_count_; }
+
+ private:
+  /** A run being merged and its current record. */
+  struct RunReader {
+    std::unique_ptr<TmpTupleRun> run_;
+    Tuple record_;
+  };
+
+  /** Sorts the buffered tuples and writes them to a new run. */
+  void SpillBuffer();
+
+  /** Merges groups of runs until at most GetMergeFanIn() are left. */
+  void MergeRuns();
+
+  /** Starts merging runs_ with the loser tree. */
+  void StartMerge();
+
+  /** Moves the reader of a stream to its next record and updates its key in the loser tree. */
+  void AdvanceReader(size_t stream);
+
+  /** @return the number of runs merged at once, bounded by the size of the buffer pool */
+  size_t GetMergeFanIn() const;
+
+  /** Sorts order_ by the keys of the buffered tuples. */
+  void SortBuffer();
+
+  /** Appends a record (key and tuple) to a run, throwing if the buffer pool is out of frames. */
+  void AppendRecord(TmpTupleRun *run, std::string_view key, const Tuple &tuple);
+
+  /** @return the key stored in a record */
+  static std::string_view RecordKey(const Tuple &record);
+
+  /** Copies the tuple stored in a record into tuple. */
+  static void RecordTuple(const Tuple &record, Tuple *tuple);
+
+  /** The sort plan node to be executed. */
+  const SortPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** Tuples held in memory, their keys and their positions in sorted order. */
+  std::vector<Tuple> tuples_;
+  std::vector<std::string> keys_;
+  std::vector<uint32_t> order_;
+  size_t memory_used_{0};
+  size_t next_idx_{0};
+
+  /** The sorted runs, in the order they were written, and their readers during the final merge. */
+  std::vector<std::unique_ptr<TmpTupleRun>> runs_;
+  std::vector<RunReader> readers_;
+  LoserTree loser_tree_{0};
+  /** Scratch space to build records in. */
+  std::vector<char> record_buffer_;
+
+  size_t run_count_{0};
+  size_t merge_pass_count_{0};
+};
+}  // namespace bustub
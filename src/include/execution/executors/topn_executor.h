@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_executor.h
+//
+// Identification: src/include/execution/executors/topn_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/topn_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * TopNExecutor returns the first n tuples of its child in sort order while holding at most n tuples in memory.
+ *
+ * Init() streams the child through a max-heap of the n smallest tuples seen so far, keyed by the normalized keys of
+ * SortExecutor::EncodeKey(). A tuple that does not beat the largest one in the heap is dropped after a single memcmp.
+ */
+class TopNExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new top-n executor.
+   * @param exec_ctx the executor context
+   * @param plan the top-n plan to be executed
+   * @param child_executor the child executor that produces the tuples
+   */
+  TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+ private:
+  /** A heap entry; seq_ is the position in the child's output, so equal keys keep the child's order. */
+  struct HeapEntry {
+    std::string key_;
+    uint64_t seq_;
+    /** The slot of tuples_ holding the tuple. */
+    size_t slot_;
+
+    bool operator<(const HeapEntry &other) const {
+      int cmp = key_.compare(other.key_);
+      return cmp < 0 || (cmp == 0 && seq_ < other.seq_);
+    }
+  };
+
+  /** The top-n plan node to be executed. */
+  const TopNPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The heap, and after Init() the entries in sort order. */
+  std::vector<HeapEntry> heap_;
+  /** The tuples of the heap entries. Entries move around the heap, tuples stay in their slot. */
+  std::vector<Tuple> tuples_;
+  size_t next_idx_{0};
+};
+}  // namespace bustub
@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "execution/vector_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -58,6 +59,18 @@ class AbstractExpression {
    */
   virtual Value EvaluateAggregate(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) const = 0;
 
+  /** @return true if this expression and all of its children implement EvaluateBatch() */
+  virtual bool SupportsBatch() const { return false; }
+
+  /**
+   * Evaluates the expression for every tuple of a batch, like Evaluate() does for a single tuple.
+   * @param batch the tuples, with a column per column of the schema the expression refers to
+   * @param[out] result the values, one per tuple of the batch
+   */
+  virtual void EvaluateBatch(const VectorBatch &batch, ColumnVector *result) const {
+    BUSTUB_ASSERT(false, "This expression cannot be evaluated on batches.");
+  }
+
   /** @return the child_idx'th child of this expression */
   const AbstractExpression *GetChildAt(uint32_t child_idx) const { return children_[child_idx]; }
 
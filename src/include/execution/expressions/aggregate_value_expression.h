@@ -47,6 +47,9 @@ class AggregateValueExpression : public AbstractExpression {
   }
   bool isGroupByTerm() const { return is_group_by_term_; }
 
+  /** @return the index of the group-by or aggregate this expression refers to */
+  uint32_t GetTermIdx() const { return term_idx_; }
+
  private:
   bool is_group_by_term_;
   uint32_t term_idx_;
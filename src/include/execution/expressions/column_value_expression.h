@@ -45,6 +45,12 @@ class ColumnValueExpression : public AbstractExpression {
     BUSTUB_ASSERT(false, "Aggregation should only refer to group-by and aggregates.");
   }
 
+  bool SupportsBatch() const override { return true; }
+
+  void EvaluateBatch(const VectorBatch &batch, ColumnVector *result) const override {
+    *result = batch.GetColumn(col_idx_);
+  }
+
   uint32_t GetTupleIdx() const { return tuple_idx_; }
   uint32_t GetColIdx() const { return col_idx_; }
 
@@ -53,7 +53,89 @@ class ComparisonExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
   }
 
+  bool SupportsBatch() const override { return GetChildAt(0)->SupportsBatch() && GetChildAt(1)->SupportsBatch(); }
+
+  void EvaluateBatch(const VectorBatch &batch, ColumnVector *result) const override {
+    ColumnVector lhs;
+    ColumnVector rhs;
+    GetChildAt(0)->EvaluateBatch(batch, &lhs);
+    GetChildAt(1)->EvaluateBatch(batch, &rhs);
+    result->Reset(TypeId::BOOLEAN);
+    result->Resize(batch.GetSize());
+    auto out = result->GetMutableData<int8_t>();
+    if (lhs.GetType() == rhs.GetType()) {
+      switch (lhs.GetType()) {
+        case TypeId::TINYINT:
+          return CompareBatch<int8_t>(lhs, rhs, BUSTUB_INT8_NULL, out);
+        case TypeId::SMALLINT:
+          return CompareBatch<int16_t>(lhs, rhs, BUSTUB_INT16_NULL, out);
+        case TypeId::INTEGER:
+          return CompareBatch<int32_t>(lhs, rhs, BUSTUB_INT32_NULL, out);
+        case TypeId::BIGINT:
+          return CompareBatch<int64_t>(lhs, rhs, BUSTUB_INT64_NULL, out);
+        case TypeId::DECIMAL:
+          return CompareBatch<double>(lhs, rhs, BUSTUB_DECIMAL_NULL, out);
+        case TypeId::TIMESTAMP:
+          return CompareBatch<uint64_t>(lhs, rhs, BUSTUB_TIMESTAMP_NULL, out);
+        default:
+          break;
+      }
+    }
+    // Mixed types and strings go through Value, like Evaluate().
+    for (size_t i = 0; i < batch.GetSize(); i++) {
+      out[i] = ValueFactory::GetBooleanValue(PerformComparison(lhs.GetValue(i), rhs.GetValue(i))).GetAs<int8_t>();
+    }
+  }
+
+  /** @return the type of comparison performed by this expression */
+  ComparisonType GetComparisonType() const { return comp_type_; }
+
  private:
+  /** Compares two vectors of fixed-size values of the same type. A comparison with a null is null. */
+  template <typename T>
+  void CompareBatch(const ColumnVector &lhs, const ColumnVector &rhs, T null_value, int8_t *out) const {
+    const T *l = lhs.GetData<T>();
+    const T *r = rhs.GetData<T>();
+    size_t size = lhs.GetSize();
+    switch (comp_type_) {
+      case ComparisonType::Equal:
+        for (size_t i = 0; i < size; i++) {
+          out[i] = static_cast<int8_t>(l[i] == r[i]);
+        }
+        break;
+      case ComparisonType::NotEqual:
+        for (size_t i = 0; i < size; i++) {
+          out[i] = static_cast<int8_t>(l[i] != r[i]);
+        }
+        break;
+      case ComparisonType::LessThan:
+        for (size_t i = 0; i < size; i++) {
+          out[i] = static_cast<int8_t>(l[i] < r[i]);
+        }
+        break;
+      case ComparisonType::LessThanOrEqual:
+        for (size_t i = 0; i < size; i++) {
+          out[i] = static_cast<int8_t>(l[i] <= r[i]);
+        }
+        break;
+      case ComparisonType::GreaterThan:
+        for (size_t i = 0; i < size; i++) {
+          out[i] = static_cast<int8_t>(l[i] > r[i]);
+        }
+        break;
+      case ComparisonType::GreaterThanOrEqual:
+        for (size_t i = 0; i < size; i++) {
+          out[i] = static_cast<int8_t>(l[i] >= r[i]);
+        }
+        break;
+    }
+    for (size_t i = 0; i < size; i++) {
+      if (l[i] == null_value || r[i] == null_value) {
+        out[i] = BUSTUB_BOOLEAN_NULL;
+      }
+    }
+  }
+
   CmpBool PerformComparison(const Value &lhs, const Value &rhs) const {
     switch (comp_type_) {
       case ComparisonType::Equal:
@@ -36,6 +36,16 @@ class ConstantValueExpression : public AbstractExpression {
     return val_;
   }
 
+  bool SupportsBatch() const override { return true; }
+
+  void EvaluateBatch(const VectorBatch &batch, ColumnVector *result) const override {
+    result->Reset(val_.GetTypeId());
+    result->Fill(val_, batch.GetSize());
+  }
+
+  /** @return the constant */
+  const Value &GetValue() const { return val_; }
+
  private:
   Value val_;
 };
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// filter_kernels.h
+//
+// Identification: src/include/execution/filter_kernels.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "execution/expressions/comparison_expression.h"
+
+namespace bustub {
+
+/**
+ * FilterKernels compares a column vector against a constant and produces a bitmask, bit i of word i / 64 being set
+ * if row i matches. Nulls never match.
+ *
+ * On x86 CPUs that support AVX2, which is checked at run time, the comparisons run 256 bits at a time, so the same
+ * binary works without -march=native. Otherwise they fall back to the scalar loops, which also handle the tail of the
+ * vector.
+ */
+class FilterKernels {
+ public:
+  /** @return the number of 64-bit words in the bitmask of a vector of size values */
+  static size_t BitmaskWords(size_t size) { return (size + 63) / 64; }
+
+  /**
+   * Compares every value of a vector against a constant.
+   * @param values the values, nulls being the null sentinel of the type
+   * @param size the number of values
+   * @param comp_type the comparison, e.g. LessThan means values[i] < constant
+   * @param constant the constant, which must not be null
+   * @param[out] bitmask BitmaskWords(size) words that receive the result
+   */
+  static void CompareConstant(const int32_t *values, size_t size, ComparisonType comp_type, int32_t constant,
+                              uint64_t *bitmask);
+  static void CompareConstant(const int64_t *values, size_t size, ComparisonType comp_type, int64_t constant,
+                              uint64_t *bitmask);
+  static void CompareConstant(const double *values, size_t size, ComparisonType comp_type, double constant,
+                              uint64_t *bitmask);
+
+  /** The scalar version of CompareConstant(), exposed to test the vectorized one against. */
+  template <typename T>
+  static void CompareConstantScalar(const T *values, size_t size, ComparisonType comp_type, T constant, T null_value,
+                                    uint64_t *bitmask);
+
+  /** Replaces the content of selection with the positions of the bits set in a bitmask of size bits. */
+  static void BitmaskToSelection(const uint64_t *bitmask, size_t size, std::vector<uint32_t> *selection);
+
+  /** @return true if CompareConstant() uses AVX2, i.e. the CPU supports it */
+  static bool IsVectorized();
+};
+
+}  // namespace bustub
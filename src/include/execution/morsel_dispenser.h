@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_dispenser.h
+//
+// Identification: src/include/execution/morsel_dispenser.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * MorselDispenser hands out the pages of a table to the workers of a parallel scan, a morsel of consecutive pages at
+ * a time. Workers that finish their morsel early simply claim the next one, so the work stays balanced however the
+ * predicate and the pages are skewed.
+ */
+class MorselDispenser {
+ public:
+  /** A range of pages to scan. */
+  struct Morsel {
+    const page_id_t *page_ids_{nullptr};
+    size_t size_{0};
+  };
+
+  /**
+   * Creates a dispenser over the pages of a table.
+   * @param page_ids the pages to scan, e.g. from TableHeap::GetPageIds()
+   * @param morsel_size the number of pages in a morsel
+   */
+  MorselDispenser(std::vector<page_id_t> page_ids, size_t morsel_size)
+      : page_ids_(std::move(page_ids)), morsel_size_(morsel_size) {}
+
+  DISALLOW_COPY_AND_MOVE(MorselDispenser);
+
+  /**
+   * Claims the next morsel. Can be called by any number of threads at once.
+   * @param[out] morsel the pages claimed
+   * @return false if all pages were handed out
+   */
+  bool Next(Morsel *morsel) {
+    size_t begin = next_.fetch_add(morsel_size_);
+    if (begin >= page_ids_.size()) {
+      return false;
+    }
+    morsel->page_ids_ = page_ids_.data() + begin;
+    morsel->size_ = std::min(morsel_size_, page_ids_.size() - begin);
+    return true;
+  }
+
+ private:
+  const std::vector<page_id_t> page_ids_;
+  const size_t morsel_size_;
+  /** The first page of the next morsel. */
+  std::atomic<size_t> next_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_state.h
+//
+// Identification: src/include/execution/parallel_state.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+
+#include "common/macros.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * ParallelState is shared by the instances of a plan subtree that run in parallel, e.g. under a GatherExecutor.
+ *
+ * Every instance has its own executors, built from the same plan nodes. The executors of a plan node find the state
+ * they share, such as the MorselDispenser of a scan, with GetOrCreate(): the first one to ask creates it.
+ */
+class ParallelState {
+ public:
+  /** @param instance_count the number of instances of the subtree */
+  explicit ParallelState(size_t instance_count) : instance_count_(instance_count) {}
+
+  DISALLOW_COPY_AND_MOVE(ParallelState);
+
+  /** @return the number of instances of the subtree */
+  size_t GetInstanceCount() const { return instance_count_; }
+
+  /**
+   * @param plan the plan node the state belongs to
+   * @param create creates the state if no instance did yet
+   * @return the state of a plan node, owned by this ParallelState
+   */
+  template <typename T>
+  T *GetOrCreate(const AbstractPlanNode *plan, const std::function<std::unique_ptr<T>()> &create) {
+    std::lock_guard<std::mutex> guard(latch_);
+    std::shared_ptr<void> &state = states_[plan];
+    if (state == nullptr) {
+      state = std::shared_ptr<T>(create());
+    }
+    return static_cast<T *>(state.get());
+  }
+
+ private:
+  const size_t instance_count_;
+  std::mutex latch_;
+  std::unordered_map<const AbstractPlanNode *, std::shared_ptr<void>> states_;
+};
+
+}  // namespace bustub
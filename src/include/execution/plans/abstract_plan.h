@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -20,7 +21,22 @@
 namespace bustub {
 
 /** PlanType represents the types of plans that we have in our system. */
-enum class PlanType { SeqScan, IndexScan, Insert, Update, Delete, Aggregation, Limit, NestedLoopJoin, NestedIndexJoin };
+enum class PlanType {
+  SeqScan,
+  IndexScan,
+  Insert,
+  Update,
+  Delete,
+  Aggregation,
+  Limit,
+  NestedLoopJoin,
+  NestedIndexJoin,
+  HashJoin,
+  Sort,
+  TopN,
+  Gather,
+  Repartition
+};
 
 /**
  * AbstractPlanNode represents all the possible types of plan nodes in our system.
@@ -36,7 +52,7 @@ class AbstractPlanNode {
    * @param children the children of this plan node
    */
   AbstractPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children)
-      : output_schema_(output_schema), children_(std::move(children)) {}
+      : children_(std::move(children)), output_schema_(output_schema) {}
 
   /** Virtual destructor. */
   virtual ~AbstractPlanNode() = default;
@@ -53,13 +69,33 @@ class AbstractPlanNode {
   /** @return the type of this plan node */
   virtual PlanType GetType() const = 0;
 
+  /**
+   * Copies this plan node, e.g. to rewrite a plan without touching the original.
+   * @param children the children of the copy
+   * @return the copy, which shares the output schema and expressions of this plan node
+   */
+  virtual std::unique_ptr<AbstractPlanNode> CloneWithChildren(
+      std::vector<const AbstractPlanNode *> &&children) const = 0;
+
+ protected:
+  /** The children of this plan node. */
+  std::vector<const AbstractPlanNode *> children_;
+
  private:
   /**
    * The schema for the output of this plan node. In the volcano model, every plan node will spit out tuples,
    * and this tells you what schema this plan node's tuples will have.
    */
   const Schema *output_schema_;
-  /** The children of this plan node. */
-  std::vector<const AbstractPlanNode *> children_;
 };
+
+/** Implements AbstractPlanNode::CloneWithChildren() for the plan node class cname. */
+#define BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(cname)                                                                    \
+  std::unique_ptr<AbstractPlanNode> CloneWithChildren(std::vector<const AbstractPlanNode *> &&children)                \
+      const override {                                                                                                 \
+    auto plan_node = std::make_unique<cname>(*this);                                                                   \
+    plan_node->children_ = std::move(children);                                                                        \
+    return plan_node;                                                                                                  \
+  }
+
 }  // namespace bustub
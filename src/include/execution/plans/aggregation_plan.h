@@ -21,8 +21,20 @@
 
 namespace bustub {
 
-/** AggregationType enumerates all the possible aggregation functions in our system. */
-enum class AggregationType { CountAggregate, SumAggregate, MinAggregate, MaxAggregate };
+/**
+ * AggregationType enumerates all the possible aggregation functions in our system.
+ * ApproxCountDistinctAggregate is estimated with a HyperLogLog, ApproxPercentileAggregate with a KLL sketch.
+ */
+enum class AggregationType {
+  CountAggregate,
+  SumAggregate,
+  MinAggregate,
+  MaxAggregate,
+  AvgAggregate,
+  CountDistinctAggregate,
+  ApproxCountDistinctAggregate,
+  ApproxPercentileAggregate
+};
 
 /**
  * AggregationPlanNode represents the various SQL aggregation functions.
@@ -39,18 +51,24 @@ class AggregationPlanNode : public AbstractPlanNode {
    * @param group_bys the group by clause of the aggregation
    * @param aggregates the expressions that we are aggregating
    * @param agg_types the types that we are aggregating
+   * @param percentiles the fraction of each ApproxPercentileAggregate in [0, 1], e.g. 0.5 for the median; one per
+   * aggregate, ignored for the other types
    */
   AggregationPlanNode(const Schema *output_schema, const AbstractPlanNode *child, const AbstractExpression *having,
                       std::vector<const AbstractExpression *> &&group_bys,
-                      std::vector<const AbstractExpression *> &&aggregates, std::vector<AggregationType> &&agg_types)
+                      std::vector<const AbstractExpression *> &&aggregates, std::vector<AggregationType> &&agg_types,
+                      std::vector<double> &&percentiles = {})
       : AbstractPlanNode(output_schema, {child}),
         having_(having),
         group_bys_(std::move(group_bys)),
         aggregates_(std::move(aggregates)),
-        agg_types_(std::move(agg_types)) {}
+        agg_types_(std::move(agg_types)),
+        percentiles_(std::move(percentiles)) {}
 
   PlanType GetType() const override { return PlanType::Aggregation; }
 
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(AggregationPlanNode);
+
   /** @return the child of this aggregation plan node */
   const AbstractPlanNode *GetChildPlan() const {
     BUSTUB_ASSERT(GetChildren().size() == 1, "Aggregation expected to only have one child.");
@@ -75,11 +93,15 @@ class AggregationPlanNode : public AbstractPlanNode {
   /** @return the aggregate types */
   const std::vector<AggregationType> &GetAggregateTypes() const { return agg_types_; }
 
+  /** @return the fractions of the percentile aggregates, empty if there are none */
+  const std::vector<double> &GetPercentiles() const { return percentiles_; }
+
  private:
   const AbstractExpression *having_;
   std::vector<const AbstractExpression *> group_bys_;
   std::vector<const AbstractExpression *> aggregates_;
   std::vector<AggregationType> agg_types_;
+  std::vector<double> percentiles_;
 };
 
 struct AggregateKey {
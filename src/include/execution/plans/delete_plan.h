@@ -34,6 +34,8 @@ class DeletePlanNode : public AbstractPlanNode {
 
   PlanType GetType() const override { return PlanType::Delete; }
 
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(DeletePlanNode);
+
   /** @return the identifier of the table that should be deleted from */
   table_oid_t TableOid() const { return table_oid_; }
 
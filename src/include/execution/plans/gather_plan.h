@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_plan.h
+//
+// Identification: src/include/execution/plans/gather_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+/**
+ * GatherPlanNode runs several instances of its child subtree in parallel and merges their output, in no particular
+ * order. The instances split the work through the state they share, e.g. the scans below claim morsels of the same
+ * table, so the gather returns each tuple of the subtree once.
+ */
+class GatherPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new gather plan node.
+   * @param output_schema the output schema, the one of the child
+   * @param child the subtree to run in parallel
+   * @param instance_count the number of instances of the subtree
+   */
+  GatherPlanNode(const Schema *output_schema, const AbstractPlanNode *child, size_t instance_count)
+      : AbstractPlanNode(output_schema, {child}), instance_count_(instance_count) {}
+
+  PlanType GetType() const override { return PlanType::Gather; }
+
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(GatherPlanNode);
+
+  /** @return the subtree to run in parallel */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Gather should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  /** @return the number of instances of the subtree */
+  size_t GetInstanceCount() const { return instance_count_; }
+
+ private:
+  size_t instance_count_;
+};
+}  // namespace bustub
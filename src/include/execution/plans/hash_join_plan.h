@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_plan.h
+//
+// Identification: src/include/execution/plans/hash_join_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * HashJoinPlanNode joins the tuples of two children on an equality predicate.
+ * The predicate must be a ComparisonExpression of type Equal between a column of the left child (tuple index 0) and
+ * a column of the right child (tuple index 1), in either order.
+ */
+class HashJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new hash join plan node.
+   * @param output_schema the output format of this hash join node
+   * @param children the left and the right child plans
+   * @param predicate the equi-join predicate, e.g. left.colA = right.col1
+   */
+  HashJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                   const AbstractExpression *predicate)
+      : AbstractPlanNode(output_schema, std::move(children)), predicate_(predicate) {
+    auto comparison = dynamic_cast<const ComparisonExpression *>(predicate);
+    BUSTUB_ASSERT(comparison != nullptr && comparison->GetComparisonType() == ComparisonType::Equal,
+                  "Hash joins need an equality predicate.");
+    auto lhs = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0));
+    auto rhs = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1));
+    BUSTUB_ASSERT(lhs != nullptr && rhs != nullptr && lhs->GetTupleIdx() != rhs->GetTupleIdx(),
+                  "Hash joins compare a column of each side.");
+    left_key_ = lhs->GetTupleIdx() == 0 ? lhs : rhs;
+    right_key_ = lhs->GetTupleIdx() == 0 ? rhs : lhs;
+  }
+
+  PlanType GetType() const override { return PlanType::HashJoin; }
+
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(HashJoinPlanNode);
+
+  /** @return the predicate to be used in the hash join */
+  const AbstractExpression *Predicate() const { return predicate_; }
+
+  /** @return the join key of the left side, to be evaluated against a left tuple */
+  const AbstractExpression *LeftJoinKey() const { return left_key_; }
+
+  /** @return the join key of the right side, to be evaluated against a right tuple */
+  const AbstractExpression *RightJoinKey() const { return right_key_; }
+
+  /** @return the left plan node of the hash join */
+  const AbstractPlanNode *GetLeftPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Hash joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return the right plan node of the hash join */
+  const AbstractPlanNode *GetRightPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Hash joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+ private:
+  /** The join predicate. */
+  const AbstractExpression *predicate_;
+  /** The column of the left child compared by the predicate. */
+  const AbstractExpression *left_key_;
+  /** The column of the right child compared by the predicate. */
+  const AbstractExpression *right_key_;
+};
+
+struct HashJoinKey {
+  Value key_;
+
+  /**
+   * Compares two join keys for equality.
+   * @param other the other join key to be compared with
+   * @return true if both join keys are equal, false otherwise
+   */
+  bool operator==(const HashJoinKey &other) const { return key_.CompareEquals(other.key_) == CmpBool::CmpTrue; }
+};
+}  // namespace bustub
+
+namespace std {
+
+/**
+ * Implements std::hash on HashJoinKey.
+ */
+template <>
+struct hash<bustub::HashJoinKey> {
+  std::size_t operator()(const bustub::HashJoinKey &join_key) const {
+    return join_key.key_.IsNull() ? 0 : bustub::HashUtil::HashValue(&join_key.key_);
+  }
+};
+
+}  // namespace std
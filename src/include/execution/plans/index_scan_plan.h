@@ -34,6 +34,8 @@ class IndexScanPlanNode : public AbstractPlanNode {
 
   PlanType GetType() const override { return PlanType::IndexScan; }
 
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(IndexScanPlanNode);
+
   /** @return the predicate to test tuples against; tuples should only be returned if they evaluate to true */
   const AbstractExpression *GetPredicate() const { return predicate_; }
 
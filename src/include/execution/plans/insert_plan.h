@@ -45,6 +45,8 @@ class InsertPlanNode : public AbstractPlanNode {
 
   PlanType GetType() const override { return PlanType::Insert; }
 
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(InsertPlanNode);
+
   /** @return the identifier of the table that should be inserted into */
   table_oid_t TableOid() const { return table_oid_; }
 
@@ -32,6 +32,8 @@ class LimitPlanNode : public AbstractPlanNode {
 
   PlanType GetType() const override { return PlanType::Limit; }
 
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(LimitPlanNode);
+
   size_t GetLimit() const { return limit_; }
 
   size_t GetOffset() const { return offset_; }
@@ -17,6 +17,8 @@
 #include <vector>
 
 #include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
 #include "execution/plans/abstract_plan.h"
 #include "storage/table/tuple.h"
 
@@ -37,13 +39,24 @@ class NestedIndexJoinPlanNode : public AbstractPlanNode {
         inner_table_oid_(inner_table_oid),
         index_name_(std::move(index_name)),
         outer_table_schema_(outer_table_schema),
-        inner_table_schema_(inner_table_schema) {}
+        inner_table_schema_(inner_table_schema) {
+    auto comparison = dynamic_cast<const ComparisonExpression *>(predicate);
+    BUSTUB_ASSERT(comparison != nullptr && comparison->GetComparisonType() == ComparisonType::Equal,
+                  "Nested index joins need an equality predicate.");
+    auto lhs = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0));
+    outer_key_ = lhs != nullptr && lhs->GetTupleIdx() == 0 ? comparison->GetChildAt(0) : comparison->GetChildAt(1);
+  }
 
   PlanType GetType() const override { return PlanType::NestedIndexJoin; }
 
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(NestedIndexJoinPlanNode);
+
   /** @return the predicate to be used in the nested index join */
   const AbstractExpression *Predicate() const { return predicate_; }
 
+  /** @return the side of the predicate to be evaluated against an outer tuple to get the key of the index */
+  const AbstractExpression *OuterJoinKey() const { return outer_key_; }
+
   /** @return the plan node for the outer table of the nested index join */
   const AbstractPlanNode *GetChildPlan() const { return GetChildAt(0); }
 
@@ -66,5 +79,7 @@ class NestedIndexJoinPlanNode : public AbstractPlanNode {
   const std::string index_name_;
   const Schema *outer_table_schema_;
   const Schema *inner_table_schema_;
+  /** The side of the predicate that refers to the outer table. */
+  const AbstractExpression *outer_key_;
 };
 }  // namespace bustub
@@ -38,6 +38,8 @@ class NestedLoopJoinPlanNode : public AbstractPlanNode {
 
   PlanType GetType() const override { return PlanType::NestedLoopJoin; }
 
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(NestedLoopJoinPlanNode);
+
   /** @return the predicate to be used in the nested loop join */
   const AbstractExpression *Predicate() const { return predicate_; }
 
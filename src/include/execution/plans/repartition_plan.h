@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// repartition_plan.h
+//
+// Identification: src/include/execution/plans/repartition_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+/**
+ * RepartitionPlanNode redistributes the tuples of its child by the hash of some keys, within a subtree run in
+ * parallel by a gather. All instances of the child feed all instances of the repartition, and instance i returns
+ * the tuples whose keys hash to partition i, so tuples with equal keys end up in the same instance. An aggregation
+ * grouped by those keys above it then needs no merge.
+ *
+ * Outside of a gather there is a single partition and the repartition passes its child's tuples through.
+ */
+class RepartitionPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new repartition plan node.
+   * @param output_schema the output schema, the one of the child
+   * @param child the child plan
+   * @param hash_keys the keys to partition by, evaluated against the child's tuples
+   */
+  RepartitionPlanNode(const Schema *output_schema, const AbstractPlanNode *child,
+                      std::vector<const AbstractExpression *> &&hash_keys)
+      : AbstractPlanNode(output_schema, {child}), hash_keys_(std::move(hash_keys)) {}
+
+  PlanType GetType() const override { return PlanType::Repartition; }
+
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(RepartitionPlanNode);
+
+  /** @return the child plan */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Repartition should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  /** @return the keys to partition by */
+  const std::vector<const AbstractExpression *> &GetHashKeys() const { return hash_keys_; }
+
+ private:
+  std::vector<const AbstractExpression *> hash_keys_;
+};
+}  // namespace bustub
@@ -33,6 +33,8 @@ class SeqScanPlanNode : public AbstractPlanNode {
 
   PlanType GetType() const override { return PlanType::SeqScan; }
 
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(SeqScanPlanNode);
+
   /** @return the predicate to test tuples against; tuples should only be returned if they evaluate to true */
   const AbstractExpression *GetPredicate() const { return predicate_; }
 
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_plan.h
+//
+// Identification: src/include/execution/plans/sort_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/** OrderByType is the direction of a sort key. */
+enum class OrderByType { Ascending, Descending };
+
+/**
+ * SortPlanNode orders the tuples of its child by a list of sort keys, e.g. ORDER BY colB ASC, colA DESC.
+ * The tuples of the child are returned unchanged, so the output schema must be the schema of the child.
+ * Nulls sort before all other values in ascending order and after them in descending order.
+ */
+class SortPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new sort plan node.
+   * @param output_schema the output format of this plan node, the same as the child's
+   * @param child the child plan to sort the tuples of
+   * @param order_bys the sort keys, most significant first, each evaluated against a tuple of the child
+   */
+  SortPlanNode(const Schema *output_schema, const AbstractPlanNode *child,
+               std::vector<std::pair<OrderByType, const AbstractExpression *>> &&order_bys)
+      : AbstractPlanNode(output_schema, {child}), order_bys_(std::move(order_bys)) {}
+
+  PlanType GetType() const override { return PlanType::Sort; }
+
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(SortPlanNode);
+
+  /** @return the child plan node of the sort */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Sort should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  /** @return the sort keys, most significant first */
+  const std::vector<std::pair<OrderByType, const AbstractExpression *>> &GetOrderBys() const { return order_bys_; }
+
+ private:
+  std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys_;
+};
+}  // namespace bustub
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_plan.h
+//
+// Identification: src/include/execution/plans/topn_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/sort_plan.h"
+
+namespace bustub {
+
+/**
+ * TopNPlanNode returns the first n tuples of its child in the order of the sort keys, i.e. a SortPlanNode followed by
+ * a LimitPlanNode without offset. The tuples of the child are returned unchanged.
+ */
+class TopNPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new top-n plan node.
+   * @param output_schema the output format of this plan node, the same as the child's
+   * @param child the child plan to take the tuples from
+   * @param order_bys the sort keys, most significant first, each evaluated against a tuple of the child
+   * @param n the number of tuples to return
+   */
+  TopNPlanNode(const Schema *output_schema, const AbstractPlanNode *child,
+               std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys, size_t n)
+      : AbstractPlanNode(output_schema, {child}), order_bys_(std::move(order_bys)), n_(n) {}
+
+  PlanType GetType() const override { return PlanType::TopN; }
+
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(TopNPlanNode);
+
+  /** @return the child plan node of the top-n */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "TopN should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  /** @return the sort keys, most significant first */
+  const std::vector<std::pair<OrderByType, const AbstractExpression *>> &GetOrderBys() const { return order_bys_; }
+
+  /** @return the number of tuples to return */
+  size_t GetN() const { return n_; }
+
+ private:
+  std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys_;
+  size_t n_;
+};
+}  // namespace bustub
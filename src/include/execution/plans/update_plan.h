@@ -49,6 +49,8 @@ class UpdatePlanNode : public AbstractPlanNode {
 
   PlanType GetType() const override { return PlanType::Update; }
 
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(UpdatePlanNode);
+
   /** @return the identifier of the table that should be updated */
   table_oid_t TableOid() const { return table_oid_; }
 
@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// projection_map.h
+//
+// Identification: src/include/execution/projection_map.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <initializer_list>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/arena.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * ProjectionMap builds output tuples out of the columns of one or more input tuples, e.g. the two sides of a join.
+ *
+ * The input column of each output column is resolved once, by Init*(), so Project() does not look columns up by name.
+ * When every output column has the type of its input column, the inputs are not COMPACT and the output is PLAIN, see
+ * TupleFormat, Project() copies the column bytes between the tuple layouts without making Values: adjacent fixed-size
+ * columns are copied by one memcpy, and a VARCHAR is copied with its length prefix into the variable-size part of the
+ * output tuple.
+ */
+class ProjectionMap {
+ public:
+  /**
+   * Maps each output column to the column of the same name in the first input that has one, which must exist.
+   * @param output the schema of the output tuples
+   * @param inputs the schemas of the input tuples, in the order they are passed to Project()
+   */
+  void InitByName(const Schema *output, std::initializer_list<const Schema *> inputs);
+
+  /**
+   * Maps each output column to the input column read by its ColumnValueExpression, whose tuple index is the input.
+   * @return false if an output column is computed by another expression, in which case the map cannot be used
+   */
+  bool InitFromExpressions(const Schema *output, std::initializer_list<const Schema *> inputs);
+
+  /**
+   * @param inputs the input tuples, in the order of the schemas given to Init*()
+   * @param arena the arena to allocate the output tuple in, which makes it a view, or nullptr to make it own its data
+   * @return the output tuple
+   */
+  Tuple Project(std::initializer_list<const Tuple *> inputs, Arena *arena = nullptr) const;
+
+ private:
+  /** Where an output column is read from. */
+  struct Source {
+    uint32_t input_idx_;
+    uint32_t col_idx_;
+  };
+
+  /** A run of fixed-size bytes copied from an input tuple into the output tuple. */
+  struct CopyRun {
+    uint32_t input_idx_;
+    uint32_t src_offset_;
+    uint32_t dst_offset_;
+    uint32_t length_;
+  };
+
+  /** Resolves the copy runs once the sources are known. */
+  void Plan();
+
+  const Schema *output_{nullptr};
+  std::vector<const Schema *> inputs_;
+  std::vector<Source> sources_;
+  /** True if the bytes of the input columns can be copied as they are. */
+  bool raw_{false};
+  /** The fixed-size columns, merged where they are adjacent in both layouts. */
+  std::vector<CopyRun> fixed_runs_;
+  /** The output columns that are VARCHARs. */
+  std::vector<uint32_t> varlen_cols_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vector_batch.h
+//
+// Identification: src/include/execution/vector_batch.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * ColumnVector holds the values of one column for the tuples of a VectorBatch.
+ *
+ * Fixed-size values are stored back to back in their serialized form, so a column of INTEGERs is an int32_t array
+ * that kernels can loop over with GetData<int32_t>(). Nulls are the null sentinels of the type, as in a Tuple.
+ * VARCHAR values are stored as Values.
+ */
+class ColumnVector {
+ public:
+  ColumnVector() = default;
+
+  /** Creates an empty column vector of the given type. */
+  explicit ColumnVector(TypeId type) { Reset(type); }
+
+  /** Removes all values and changes the type of the vector, keeping the memory. */
+  void Reset(TypeId type);
+
+  /** @return the type of the values */
+  TypeId GetType() const { return type_; }
+
+  /** @return the number of values */
+  size_t GetSize() const { return size_; }
+
+  /** @return true if the values are stored inline as a fixed-size array */
+  bool IsInlined() const { return type_ != TypeId::VARCHAR; }
+
+  /** Appends a value, which must be of the type of the vector. */
+  void Append(const Value &value);
+
+  /** Appends the value of a column of a tuple, copying the raw bytes of fixed-size values. */
+  void AppendFrom(const Tuple &tuple, const Schema *schema, uint32_t col_idx);
+
+  /** Appends count fixed-size values serialized back to back, e.g. a run of slots of a PAX minipage. */
+  void AppendRaw(const char *data, size_t count);
+
+  /** Replaces the content with count copies of a value. */
+  void Fill(const Value &value, size_t count);
+
+  /** Sets the number of fixed-size values, e.g. before a kernel writes them with GetMutableData(). */
+  void Resize(size_t size);
+
+  /** @return the value at row */
+  Value GetValue(size_t row) const;
+
+  /** @return the fixed-size values as an array of T, which must match the type of the vector */
+  template <typename T>
+  const T *GetData() const {
+    return reinterpret_cast<const T *>(data_.data());
+  }
+
+  /** @return the fixed-size values as a mutable array of T */
+  template <typename T>
+  T *GetMutableData() {
+    return reinterpret_cast<T *>(data_.data());
+  }
+
+  /** Keeps the values at the rows of a selection vector, which must be increasing. */
+  void Select(const std::vector<uint32_t> &selection);
+
+ private:
+  TypeId type_{TypeId::INVALID};
+  /** The size of an inlined value. */
+  uint32_t width_{0};
+  size_t size_{0};
+  std::vector<char> data_;
+  std::vector<Value> varlen_;
+};
+
+/**
+ * VectorBatch is a batch of up to VECTOR_SIZE tuples stored column by column, passed between executors by
+ * AbstractExecutor::NextBatch().
+ *
+ * A batch has one ColumnVector per column of a schema. A producer may leave the vectors of columns nobody reads
+ * empty; a column is materialized if its vector holds GetSize() values.
+ */
+class VectorBatch {
+ public:
+  /** Prepares an empty batch with one empty vector per column of a schema. */
+  void Reset(const Schema *schema);
+
+  /** @return the vector of a column */
+  ColumnVector &GetColumn(uint32_t col_idx) { return columns_[col_idx]; }
+
+  /** @return the vector of a column */
+  const ColumnVector &GetColumn(uint32_t col_idx) const { return columns_[col_idx]; }
+
+  /** @return the number of columns */
+  uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
+
+  /** @return the number of tuples */
+  size_t GetSize() const { return size_; }
+
+  /** Sets the number of tuples after the vectors were filled. */
+  void SetSize(size_t size) { size_ = size; }
+
+  /** Keeps the tuples at the rows of an increasing selection vector in every materialized column. */
+  void Select(const std::vector<uint32_t> &selection);
+
+  /** Appends a tuple of the schema the batch was reset with, materializing all columns. */
+  void AppendTuple(const Tuple &tuple, const Schema *schema);
+
+  /** @return the tuple at row, built from all columns of the batch, which must all be materialized */
+  Tuple GetTuple(size_t row, const Schema *schema) const;
+
+ private:
+  std::vector<ColumnVector> columns_;
+  size_t size_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// optimizer.h
+//
+// Identification: src/include/optimizer/optimizer.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/macros.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/aggregation_plan.h"
+
+namespace bustub {
+
+/**
+ * Optimizer rewrites plans into equivalent plans that are cheaper to execute.
+ *
+ * The input plan is never modified. Nodes on the path from the root to a rewritten node are copied with
+ * AbstractPlanNode::CloneWithChildren(), all other nodes are shared with the input. The plan nodes created by the
+ * rewrite are owned by the optimizer, so it must outlive the executors of the plan it returns.
+ *
+ * With more than one worker, sequential scans are run in parallel under a GatherPlanNode where their order and RIDs
+ * do not matter. An aggregation of a sequential scan is split in two phases instead: every instance aggregates the
+ * morsels it scans into a partial aggregation, whose groups are repartitioned by key to the instances of the final
+ * aggregation, or gathered into a single one if there is no GROUP BY. Only COUNT, SUM, MIN and MAX are split this way.
+ */
+class Optimizer {
+ public:
+  /** @param worker_count the number of instances a parallel subtree is run with, 1 to keep the plan serial */
+  explicit Optimizer(size_t worker_count = 1) : worker_count_(worker_count) {}
+
+  DISALLOW_COPY_AND_MOVE(Optimizer);
+
+  /**
+   * Applies all rewrite rules to a plan.
+   * @param plan the plan to rewrite
+   * @return the rewritten plan, which may be plan itself
+   */
+  const AbstractPlanNode *Optimize(const AbstractPlanNode *plan);
+
+ private:
+  /** Replaces a LimitPlanNode over a SortPlanNode with a TopNPlanNode, keeping the limit only for its offset. */
+  const AbstractPlanNode *OptimizeSortLimitAsTopN(const AbstractPlanNode *plan);
+
+  /**
+   * Puts the sequential scans of a plan under gathers.
+   * @param plan the plan to rewrite
+   * @param may_parallelize false if the parent of plan needs the RIDs of its tuples or scans it many times
+   */
+  const AbstractPlanNode *ParallelizeScans(const AbstractPlanNode *plan, bool may_parallelize);
+
+  /** @return true if the aggregates of a plan can be computed from partial aggregates of the same types */
+  static bool IsCombinable(const AggregationPlanNode *plan);
+
+  /** @return the two-phase form of an aggregation of a sequential scan */
+  const AbstractPlanNode *ParallelizeAggregation(const AggregationPlanNode *plan);
+
+  /** Takes ownership of a plan node created by a rewrite. */
+  const AbstractPlanNode *Own(std::unique_ptr<AbstractPlanNode> &&plan);
+
+  const size_t worker_count_;
+  std::vector<std::unique_ptr<AbstractPlanNode>> plans_;
+  /** The expressions and schemas of the plan nodes created by a rewrite. */
+  std::vector<std::unique_ptr<AbstractExpression>> exprs_;
+  std::vector<std::unique_ptr<Schema>> schemas_;
+};
+
+}  // namespace bustub
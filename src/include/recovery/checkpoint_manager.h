@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <thread>  // NOLINT
+
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/transaction_manager.h"
 #include "recovery/log_manager.h"
@@ -19,7 +21,13 @@
 namespace bustub {
 
 /**
- * CheckpointManager creates consistent checkpoints by blocking all other transactions temporarily.
+ * CheckpointManager takes fuzzy checkpoints, which do not block transactions.
+ *
+ * BeginCheckpoint logs a BEGIN_CHECKPOINT record followed by an END_CHECKPOINT record with the dirty page table, makes
+ * both durable, and starts writing out the dirty pages in the background. A table too large for one record is split,
+ * with CHECKPOINT_DIRTY_PAGES records before the END_CHECKPOINT. EndCheckpoint waits for the background
+ * writes. Recovery only has to redo from the minimum recLSN of the last checkpoint. Without a master record it still
+ * reads the log from the start, which rebuilds the transaction table, so no active transaction table is logged.
  */
 class CheckpointManager {
  public:
@@ -27,17 +35,24 @@ class CheckpointManager {
                     BufferPoolManager *buffer_pool_manager)
       : transaction_manager_(transaction_manager),
         log_manager_(log_manager),
-        buffer_pool_manager_(buffer_pool_manager) {}
+        buffer_pool_manager_(buffer_pool_manager),
+        flush_thread_(nullptr) {}
 
-  ~CheckpointManager() = default;
+  ~CheckpointManager() { EndCheckpoint(); }
 
   void BeginCheckpoint();
   void EndCheckpoint();
 
  private:
+  /** Writes out the given pages, each under its read latch so that no half-applied change reaches the disk. */
+  void FlushPages(const std::vector<std::pair<page_id_t, lsn_t>> &dirty_page_table);
+
   TransactionManager *transaction_manager_ __attribute__((__unused__));
-  LogManager *log_manager_ __attribute__((__unused__));
-  BufferPoolManager *buffer_pool_manager_ __attribute__((__unused__));
+  LogManager *log_manager_;
+  BufferPoolManager *buffer_pool_manager_;
+
+  /** Writes out the dirty pages of the current checkpoint. */
+  std::thread *flush_thread_;
 };
 
 }  // namespace bustub
@@ -16,7 +16,9 @@
 #include <condition_variable>  // NOLINT
 #include <future>              // NOLINT
 #include <mutex>               // NOLINT
+#include <thread>              // NOLINT
 
+#include "common/util/compression_util.h"
 #include "recovery/log_record.h"
 #include "storage/disk/disk_manager.h"
 
@@ -25,13 +27,36 @@ namespace bustub {
 /**
  * LogManager maintains a separate thread that is awakened whenever the log buffer is full or whenever a timeout
  * happens. When the thread is awakened, the log buffer's content is written into the disk log file.
+ *
+ * The log is double buffered: appenders keep filling log_buffer_ while the flush thread writes flush_buffer_ out.
+ * Committing transactions only request a flush and wait for their commit LSN to become persistent, so every commit
+ * that arrives while a write is in flight is made durable by the next single write (group commit).
+ *
+ * Appending does not take latch_. A thread reserves its LSN and its byte range in log_buffer_ with a single CAS on
+ * reservation_, copies the record in parallel with other appenders and then publishes the bytes in copied_bytes_.
+ * Before swapping the buffers the flush thread seals reservation_ and waits until every reserved byte is copied.
+ *
+ * With compression enabled, every flushed buffer that shrinks is written as one compressed block (see log_record.h).
  */
 class LogManager {
  public:
-  explicit LogManager(DiskManager *disk_manager)
-      : next_lsn_(0), persistent_lsn_(INVALID_LSN), disk_manager_(disk_manager) {
+  /**
+   * @param disk_manager the disk manager holding the log file
+   * @param compress_log true to compress the log buffers before writing them
+   */
+  explicit LogManager(DiskManager *disk_manager, bool compress_log = false)
+      : reservation_(0),
+        persistent_lsn_(INVALID_LSN),
+        compress_log_(compress_log),
+        flush_thread_(nullptr),
+        disk_manager_(disk_manager) {
     log_buffer_ = new char[LOG_BUFFER_SIZE];
     flush_buffer_ = new char[LOG_BUFFER_SIZE];
+    if (compress_log_) {
+      for (auto &compress_buffer : compress_buffers_) {
+        compress_buffer = new char[COMPRESSED_BLOCK_HEADER_SIZE + CompressionUtil::MaxCompressedSize(LOG_BUFFER_SIZE)];
+      }
+    }
   }
 
   ~LogManager() {
@@ -39,6 +64,10 @@ class LogManager {
     delete[] flush_buffer_;
     log_buffer_ = nullptr;
     flush_buffer_ = nullptr;
+    for (auto &compress_buffer : compress_buffers_) {
+      delete[] compress_buffer;
+      compress_buffer = nullptr;
+    }
   }
 
   void RunFlushThread();
@@ -46,29 +75,79 @@ class LogManager {
 
   lsn_t AppendLogRecord(LogRecord *log_record);
 
-  inline lsn_t GetNextLSN() { return next_lsn_; }
+  /**
+   * Wakes up the flush thread and blocks until every log record up to and including lsn is persistent.
+   * Concurrent callers are served by the same disk write.
+   * @param lsn the log sequence number that must be made durable
+   */
+  void Flush(lsn_t lsn);
+
+  inline lsn_t GetNextLSN() { return ReservedLSN(reservation_); }
   inline lsn_t GetPersistentLSN() { return persistent_lsn_; }
   inline void SetPersistentLSN(lsn_t lsn) { persistent_lsn_ = lsn; }
   inline char *GetLogBuffer() { return log_buffer_; }
 
  private:
-  // TODO(students): you may add your own member variables
+  /** Body of the flush thread: flush on request, when the buffer fills up, or every log_timeout. */
+  void FlushLoop();
+
+  /**
+   * Seals log_buffer_, waits for in-progress copies, swaps it with flush_buffer_ and writes the latter to disk.
+   * The latch is released meanwhile so that appenders can keep filling the new log buffer.
+   * @param guard the held latch_
+   */
+  void SwapAndFlush(std::unique_lock<std::mutex> *guard);
+
+  /** Writes flush_buffer_ to disk, compressed if that is enabled and pays off. */
+  void WriteFlushBuffer(int size);
+
+  /** Serializes log_record into storage, which must have at least log_record->GetSize() bytes available. */
+  void SerializeLogRecord(LogRecord *log_record, char *storage);
+
+  /** Blocks until the flush thread has made room for size more bytes in log_buffer_. */
+  void WaitForSpace(int size);
 
-  /** The atomic counter which records the next log sequence number. */
-  std::atomic<lsn_t> next_lsn_;
+  /** Layout of reservation_: | sealed (1 bit) | next lsn (31 bits) | bytes reserved in log_buffer_ (32 bits) | */
+  static constexpr uint64_t SEALED_MASK = 1ULL << 63;
+  static constexpr uint64_t OFFSET_MASK = (1ULL << 32) - 1;
+
+  static inline uint64_t MakeReservation(lsn_t lsn, int offset) {
+    return (static_cast<uint64_t>(lsn) << 32) | static_cast<uint32_t>(offset);
+  }
+  static inline lsn_t ReservedLSN(uint64_t reservation) {
+    return static_cast<lsn_t>((reservation & ~SEALED_MASK) >> 32);
+  }
+  static inline int ReservedOffset(uint64_t reservation) { return static_cast<int>(reservation & OFFSET_MASK); }
+  static inline bool IsSealed(uint64_t reservation) { return (reservation & SEALED_MASK) != 0; }
+
+  /** The next log sequence number and the used part of log_buffer_, reserved together by appenders. */
+  std::atomic<uint64_t> reservation_;
+  /** Number of reserved bytes in log_buffer_ whose records have been completely copied. */
+  std::atomic<int> copied_bytes_{0};
   /** The log records before and including the persistent lsn have been written to disk. */
   std::atomic<lsn_t> persistent_lsn_;
 
   char *log_buffer_;
   char *flush_buffer_;
-
+  /** Whether flushed buffers are compressed. */
+  bool compress_log_;
+  /** Compressed blocks alternate between two buffers, like the log buffers do for the disk manager. */
+  char *compress_buffers_[2]{nullptr, nullptr};
+  int next_compress_buffer_{0};
+  /** True if someone is waiting for the flush thread (commit, full buffer or page eviction). */
+  bool need_flush_{false};
+
+  /** Protects need_flush_ and the condition variables. Not taken on the append fast path. */
   std::mutex latch_;
 
-  std::thread *flush_thread_ __attribute__((__unused__));
+  std::thread *flush_thread_;
 
+  /** Wakes up the flush thread. */
   std::condition_variable cv_;
+  /** Signalled after every buffer swap and every completed write. */
+  std::condition_variable flushed_cv_;
 
-  DiskManager *disk_manager_ __attribute__((__unused__));
+  DiskManager *disk_manager_;
 };
 
 }  // namespace bustub
@@ -14,6 +14,8 @@
 
 #include <cassert>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "storage/table/tuple.h"
@@ -32,6 +34,32 @@ enum class LogRecordType {
   ABORT,
   /** Creating a new page in the table heap. */
   NEWPAGE,
+  /** Start of a fuzzy checkpoint. */
+  BEGIN_CHECKPOINT,
+  /** End of a fuzzy checkpoint, carrying the dirty page table. */
+  END_CHECKPOINT,
+  /** Update that only logs the changed byte ranges of the tuple. */
+  DELTA_UPDATE,
+  /** Part of a dirty page table too large for one record. The END_CHECKPOINT that follows carries the last part. */
+  CHECKPOINT_DIRTY_PAGES,
+};
+
+/**
+ * A flushed log buffer may be written as one compressed block instead of the raw records. The block starts with a
+ * negative marker where a raw record would start with its (positive) size.
+ *-------------------------------------------------------------------------------
+ * | COMPRESSED_BLOCK_MARKER | compressed_size | raw_size | compressed records |
+ *-------------------------------------------------------------------------------
+ */
+static constexpr int32_t COMPRESSED_BLOCK_MARKER = -1;
+static constexpr int COMPRESSED_BLOCK_HEADER_SIZE = 3 * sizeof(int32_t);
+
+/** A byte range that differs between the old and the new version of an updated tuple. */
+struct TupleDelta {
+  /** Offset of the range, which is the same in both versions. */
+  uint32_t offset_;
+  std::string old_bytes_;
+  std::string new_bytes_;
 };
 
 /**
@@ -53,10 +81,18 @@ enum class LogRecordType {
  *-----------------------------------------------------------------------------------
  * | HEADER | tuple_rid | tuple_size | old_tuple_data | tuple_size | new_tuple_data |
  *-----------------------------------------------------------------------------------
+ * For delta update type log record, every range is (offset, old_len, new_len, old_bytes, new_bytes)
+ *---------------------------------------------------------------------------
+ * | HEADER | tuple_rid | old_tuple_size | new_tuple_size | num_ranges | ranges |
+ *---------------------------------------------------------------------------
  * For new page type log record
  *--------------------------
  * | HEADER | prev_page_id |
  *--------------------------
+ * For end checkpoint and checkpoint dirty pages type log records (begin checkpoint only has the HEADER)
+ *---------------------------------------------------
+ * | HEADER | num_dirty_pages | (page_id, rec_lsn)... |
+ *---------------------------------------------------
  */
 class LogRecord {
   friend class LogManager;
@@ -85,7 +121,7 @@ class LogRecord {
     size_ = HEADER_SIZE + sizeof(RID) + sizeof(int32_t) + tuple.GetLength();
   }
 
-  // constructor for UPDATE type
+  // constructor for UPDATE/DELTA_UPDATE type, DELTA_UPDATE falls back to UPDATE if the ranges are not smaller
   LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type, const RID &update_rid,
             const Tuple &old_tuple, const Tuple &new_tuple)
       : txn_id_(txn_id),
@@ -96,6 +132,19 @@ class LogRecord {
         new_tuple_(new_tuple) {
     // calculate log record size
     size_ = HEADER_SIZE + sizeof(RID) + old_tuple.GetLength() + new_tuple.GetLength() + 2 * sizeof(int32_t);
+    if (log_record_type == LogRecordType::DELTA_UPDATE) {
+      ComputeDeltas(old_tuple, new_tuple);
+      int32_t delta_size = HEADER_SIZE + sizeof(RID) + 3 * sizeof(uint32_t);
+      for (const auto &delta : deltas_) {
+        delta_size += 3 * sizeof(uint32_t) + delta.old_bytes_.size() + delta.new_bytes_.size();
+      }
+      if (delta_size < size_) {
+        size_ = delta_size;
+      } else {
+        log_record_type_ = LogRecordType::UPDATE;
+        deltas_.clear();
+      }
+    }
   }
 
   // constructor for NEWPAGE type
@@ -110,8 +159,23 @@ class LogRecord {
     size_ = HEADER_SIZE + sizeof(page_id_t) * 2;
   }
 
+  // constructor for END_CHECKPOINT/CHECKPOINT_DIRTY_PAGES type
+  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type,
+            std::vector<std::pair<page_id_t, lsn_t>> dirty_page_table)
+      : txn_id_(txn_id),
+        prev_lsn_(prev_lsn),
+        log_record_type_(log_record_type),
+        dirty_page_table_(std::move(dirty_page_table)) {
+    size_ = HEADER_SIZE + sizeof(int32_t) + dirty_page_table_.size() * (sizeof(page_id_t) + sizeof(lsn_t));
+  }
+
   ~LogRecord() = default;
 
+  /** @return the number of dirty page table entries that fit in one record appended to the log buffer */
+  static constexpr size_t MaxDirtyPagesPerRecord() {
+    return (LOG_BUFFER_SIZE - HEADER_SIZE - sizeof(int32_t)) / (sizeof(page_id_t) + sizeof(lsn_t));
+  }
+
   inline Tuple &GetDeleteTuple() { return delete_tuple_; }
 
   inline RID &GetDeleteRID() { return delete_rid_; }
@@ -126,8 +190,20 @@ class LogRecord {
 
   inline RID &GetUpdateRID() { return update_rid_; }
 
+  inline std::vector<TupleDelta> &GetDeltas() { return deltas_; }
+
+  /**
+   * Rebuilds one version of a DELTA_UPDATE tuple from the other one.
+   * @param tuple the old version when redoing, the new version when undoing
+   * @param redo true to build the new version, false to build the old version
+   * @return the other version of the tuple
+   */
+  Tuple ApplyDeltas(const Tuple &tuple, bool redo) const;
+
   inline page_id_t GetNewPageRecord() { return prev_page_id_; }
 
+  inline std::vector<std::pair<page_id_t, lsn_t>> &GetDirtyPageTable() { return dirty_page_table_; }
+
   inline int32_t GetSize() { return size_; }
 
   inline lsn_t GetLSN() { return lsn_; }
@@ -173,10 +249,21 @@ class LogRecord {
   Tuple old_tuple_;
   Tuple new_tuple_;
 
+  // case3b: for delta update operation, the changed ranges in increasing offset order
+  uint32_t old_tuple_size_{0};
+  uint32_t new_tuple_size_{0};
+  std::vector<TupleDelta> deltas_;
+
   // case4: for new page operation
   page_id_t prev_page_id_{INVALID_PAGE_ID};
   page_id_t page_id_{INVALID_PAGE_ID};
+
+  // case5: for end checkpoint and checkpoint dirty pages operations
+  std::vector<std::pair<page_id_t, lsn_t>> dirty_page_table_;
   static const int HEADER_SIZE = 20;
+
+  /** Fills old_tuple_size_, new_tuple_size_ and deltas_. */
+  void ComputeDeltas(const Tuple &old_tuple, const Tuple &new_tuple);
 };  // namespace bustub
 
 }  // namespace bustub
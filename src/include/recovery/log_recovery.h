@@ -13,8 +13,13 @@
 #pragma once
 
 #include <algorithm>
-#include <mutex>  // NOLINT
+#include <deque>
+#include <functional>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/lock_manager.h"
@@ -24,12 +29,32 @@ namespace bustub {
 
 /**
  * Read log file from disk, redo and undo.
+ *
+ * Redo first scans the whole log once (analysis), deserializing every record and grouping the records that modify a
+ * page by page id. The pages are then replayed independently by a pool of workers; the records of one page are always
+ * applied by one worker in LSN order. Undo groups the changes of the loser transactions by page the same way and rolls
+ * each page back newest change first. Undoing the change with LSN l stamps the page with UndoLSN(l), an LSN past the
+ * end of the log that grows as undo proceeds: if recovery crashes after writing the page out, the next recovery
+ * neither redoes the undone changes nor undoes them twice.
+ *
+ * When the log contains a fuzzy checkpoint, redo starts from the minimum recLSN of its dirty page table; pages that
+ * were clean at the checkpoint are only redone from the checkpoint on.
  */
 class LogRecovery {
  public:
-  LogRecovery(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager)
+  /**
+   * @param disk_manager the disk manager holding the log file
+   * @param buffer_pool_manager the buffer pool to replay the log into
+   * @param num_workers number of redo/undo workers, 0 means one per hardware thread
+   */
+  LogRecovery(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, size_t num_workers = 0)
       : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), offset_(0) {
     log_buffer_ = new char[LOG_BUFFER_SIZE];
+    if (num_workers == 0) {
+      num_workers = std::max(1U, std::thread::hardware_concurrency());
+    }
+    // Every worker pins one page at a time; leave the rest of the pool for eviction.
+    num_workers_ = std::max<size_t>(1, std::min(num_workers, buffer_pool_manager->GetPoolSize() / 2));
   }
 
   ~LogRecovery() {
@@ -41,16 +66,62 @@ class LogRecovery {
   void Undo();
   bool DeserializeLogRecord(const char *data, LogRecord *log_record);
 
+  /** @return the LSN redo started from: the minimum recLSN of the last checkpoint, or 0 without a checkpoint */
+  inline lsn_t GetRedoLSN() { return redo_lsn_; }
+
  private:
-  DiskManager *disk_manager_ __attribute__((__unused__));
-  BufferPoolManager *buffer_pool_manager_ __attribute__((__unused__));
+  /** Reads the log from the beginning, fills records_, page_records_, active_txn_ and lsn_mapping_. */
+  void Analyze();
+
+  /**
+   * Analyzes the complete records at the start of log_buffer_.
+   * @param size number of valid bytes in log_buffer_
+   * @param[in,out] checkpoint_lsn LSN of the last BEGIN_CHECKPOINT record
+   * @return the number of bytes taken by the analyzed records
+   */
+  int AnalyzeRecords(int size, lsn_t *checkpoint_lsn);
+
+  /** Drops the records that a checkpoint proves to be on disk already. */
+  void ApplyCheckpoint(lsn_t checkpoint_lsn, const std::vector<std::pair<page_id_t, lsn_t>> &dirty_page_table);
+
+  /** Replays the records of one page, skipping those that the page on disk already reflects. */
+  void RedoPage(page_id_t page_id, const std::vector<LogRecord *> &records);
+
+  /** Rolls back the changes of loser transactions to one page, newest first, skipping those already undone. */
+  void UndoPage(page_id_t page_id, const std::vector<LogRecord *> &records);
+
+  /** @return the page LSN that marks the change with the given LSN as undone */
+  inline lsn_t UndoLSN(lsn_t lsn) const { return 2 * max_lsn_ + 1 - lsn; }
+
+  /** Fetches a page, retrying while all frames are pinned by the other workers. */
+  Page *FetchPage(page_id_t page_id);
+
+  /** Runs task(0) ... task(num_tasks - 1) on up to num_workers_ threads. */
+  void RunInParallel(size_t num_tasks, const std::function<void(size_t)> &task);
+
+  DiskManager *disk_manager_;
+  BufferPoolManager *buffer_pool_manager_;
+  size_t num_workers_;
 
   /** Maintain active transactions and its corresponding latest lsn. */
   std::unordered_map<txn_id_t, lsn_t> active_txn_;
-  /** Mapping the log sequence number to log file offset for undos. */
-  std::unordered_map<lsn_t, int> lsn_mapping_;
+  /** Mapping the log sequence number to its deserialized record for undos. */
+  std::unordered_map<lsn_t, LogRecord *> lsn_mapping_;
+
+  /** Every record of the log, in log order. A deque keeps the records in place while it grows. */
+  std::deque<LogRecord> records_;
+  /** The records that modify each page, in LSN order. NEWPAGE records also appear under their previous page. */
+  std::unordered_map<page_id_t, std::vector<LogRecord *>> page_records_;
+  /** The dirty page table of the checkpoint being read, gathered from its CHECKPOINT_DIRTY_PAGES records. */
+  std::vector<std::pair<page_id_t, lsn_t>> checkpoint_dirty_pages_;
+
+  /** Redo starts from this LSN. */
+  lsn_t redo_lsn_{0};
+  /** The largest LSN in the log. */
+  lsn_t max_lsn_{INVALID_LSN};
 
-  int offset_ __attribute__((__unused__));
+  /** Offset in the log file of the first record in log_buffer_. */
+  int offset_;
   char *log_buffer_;
 };
 
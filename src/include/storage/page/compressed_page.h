@@ -0,0 +1,260 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page.h
+//
+// Identification: src/include/storage/page/compressed_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/page/page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * Compressed page format, where each column is stored as an array of bit-packed codes:
+ *  ----------------------------------------------------------------------------------------------------------
+ *  | HEADER | COLUMN HEADERS | SLOT STATES | SEGMENT 0 | ... | SEGMENT n-1 | DICTIONARIES | ... FREE SPACE ... |
+ *  ----------------------------------------------------------------------------------------------------------
+ *
+ *  Header format (size in bytes):
+ *  -------------------------------------------------------------------------------------------------------
+ *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| Capacity (4)| TupleCount (4)| ColumnCount (4)|
+ *  -------------------------------------------------------------------------------------------------------
+ *
+ * The first four fields are those of TablePage, so the chain of a table can be walked without knowing its layout.
+ * The segment of a column is a null bitmap followed by the codes of its values, bit_width bits each:
+ *  - integer and BOOLEAN columns are frame-of-reference encoded, a code being the value minus the smallest value of
+ *    the column in the page,
+ *  - VARCHAR columns are dictionary encoded, a code being the index of the value in the sorted distinct values of the
+ *    column in the page, so codes compare like the values,
+ *  - DECIMAL columns are stored as is, in 64-bit codes.
+ *
+ * A tuple whose values fit the frames and dictionaries of the page is appended by writing its codes. Otherwise the
+ * whole page is decoded and encoded again with the tuple, with frames and dictionaries wide enough for it, and the
+ * tuple does not fit if the page then has no room left for it. Slots keep their number across encodings and are never
+ * reused. The format is meant for cold or read-mostly tables, whose pages are written a few times and scanned many:
+ * SelectRange() filters a column on its codes without decoding it, and DecodeFixed() decodes only the slots selected.
+ * Compressed pages are not logged; a table is created with this layout only when logging is off.
+ */
+class CompressedPage : public Page {
+ public:
+  /** @return true if the values of a tuple fit in an empty page */
+  static bool FitsInEmptyPage(const Tuple &tuple, const Schema *schema);
+
+  /** @return true if SelectRange() can filter a column of a type on its codes */
+  static bool SupportsSelectRange(TypeId type) { return type != TypeId::DECIMAL && type != TypeId::INVALID; }
+
+  /**
+   * Initialize the CompressedPage header.
+   * @param page_id the page ID of this page
+   * @param prev_page_id the previous table page ID
+   * @param schema the schema of the table
+   */
+  void Init(page_id_t page_id, page_id_t prev_page_id, const Schema *schema);
+
+  /** @return the page ID of this page */
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /** @return the page ID of the next table page */
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  /** Set the page id of the next page in the table. */
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /** @return the number of slots handed out, live or not */
+  uint32_t GetTupleCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_COUNT); }
+
+  /**
+   * Insert a tuple into the page, encoding the page again if the tuple does not fit its frames and dictionaries.
+   * @param tuple tuple to insert, of the schema of the table
+   * @param schema the schema of the table
+   * @param[out] rid rid of the inserted tuple
+   * @return true if the insert is successful (i.e. the page has room for the tuple once encoded with it)
+   */
+  bool InsertTuple(const Tuple &tuple, const Schema *schema, RID *rid);
+
+  /** Mark a tuple as deleted. @return true if the tuple exists */
+  bool MarkDelete(const RID &rid);
+
+  /**
+   * Update a tuple in place, encoding the page again if the new values do not fit its frames and dictionaries.
+   * @param new_tuple new value of the tuple
+   * @param[out] old_tuple old value of the tuple
+   * @param rid rid of the tuple
+   * @param schema the schema of the table
+   * @return true if the tuple exists and the page has room for the new values
+   */
+  bool UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid, const Schema *schema);
+
+  /** To be called on commit or abort. Frees the slot of a tuple for good. */
+  void ApplyDelete(const RID &rid);
+
+  /** To be called on abort. Rollback a delete, i.e. this reverses a MarkDelete. */
+  void RollbackDelete(const RID &rid);
+
+  /**
+   * Read a tuple from the page, decoding its values.
+   * @param rid rid of the tuple to read
+   * @param schema the schema of the table
+   * @param[out] tuple the tuple that was read, which owns its data
+   * @return true if the read is successful (i.e. the tuple exists)
+   */
+  bool GetTuple(const RID &rid, const Schema *schema, Tuple *tuple);
+
+  /** @return true if a slot holds a tuple that is not deleted */
+  bool IsLive(uint32_t slot) { return GetSlotState(slot) == SlotState::LIVE; }
+
+  /** @return the value of a column of the tuple in a slot */
+  Value GetValue(const Schema *schema, uint32_t slot, uint32_t col_idx);
+
+  /**
+   * Decodes the values of a fixed-size column in some slots, serialized back to back as in a tuple.
+   * @param schema the schema of the table
+   * @param col_idx the index of the column
+   * @param slots the slots to decode
+   * @param count the number of slots
+   * @param[out] out count values of the fixed length of the column, nulls being the null sentinels of their type
+   */
+  void DecodeFixed(const Schema *schema, uint32_t col_idx, const uint32_t *slots, size_t count, char *out);
+
+  /**
+   * Selects the live slots whose value of a column is in a range, comparing codes without decoding them. A null value
+   * is never in the range.
+   * @param schema the schema of the table
+   * @param col_idx the index of a column whose type SupportsSelectRange()
+   * @param low the lower bound, of the type of the column, nullptr if there is none
+   * @param low_inclusive true if the lower bound is in the range
+   * @param high the upper bound, of the type of the column, nullptr if there is none
+   * @param high_inclusive true if the upper bound is in the range
+   * @param from the first slot to filter
+   * @param to the slot after the last one to filter, at most the tuple count
+   * @param[out] selection the slots selected, room for to - from of them
+   * @return the number of slots selected
+   */
+  uint32_t SelectRange(const Schema *schema, uint32_t col_idx, const Value *low, bool low_inclusive, const Value *high,
+                       bool high_inclusive, uint32_t from, uint32_t to, uint32_t *selection);
+
+  /** @return the rid of the first tuple in this page */
+  bool GetFirstTupleRid(RID *first_rid);
+
+  /** @return the rid of the next tuple after cur_rid */
+  bool GetNextTupleRid(const RID &cur_rid, RID *next_rid);
+
+ private:
+  static_assert(sizeof(page_id_t) == 4);
+
+  /** The state of a slot: holding a tuple, holding a tuple marked as deleted, or freed. */
+  enum class SlotState : uint8_t { LIVE = 1, DELETED, FREE };
+
+  /** How the values of a column are encoded in a page. */
+  struct ColumnHeader {
+    /** The frame of reference of an integer column, the value of code 0. */
+    int64_t base_;
+    /** The offset of the segment of the column. */
+    uint32_t offset_;
+    /** The offset of the entry offsets of the dictionary of a VARCHAR column, and the number of its entries. */
+    uint32_t dictionary_offset_;
+    uint32_t dictionary_size_;
+    /** The bits of a code, 64 if codes are not packed. */
+    uint8_t bit_width_;
+    uint8_t padding_[3];
+  };
+  static_assert(sizeof(ColumnHeader) == 24);
+
+  static constexpr size_t SIZE_COMPRESSED_PAGE_HEADER = 28;
+  static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
+  static constexpr size_t OFFSET_CAPACITY = 16;
+  static constexpr size_t OFFSET_TUPLE_COUNT = 20;
+  static constexpr size_t OFFSET_COLUMN_COUNT = 24;
+  /** Segments start at multiples of this. */
+  static constexpr uint32_t ALIGNMENT = 8;
+  /** Codes wider than this are not packed, so that a code is always read with one unaligned 64-bit load. */
+  static constexpr uint32_t MAX_PACKED_WIDTH = 56;
+
+  uint32_t GetCapacity() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_CAPACITY); }
+
+  void SetCapacity(uint32_t capacity) { memcpy(GetData() + OFFSET_CAPACITY, &capacity, sizeof(uint32_t)); }
+
+  void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
+
+  ColumnHeader GetColumnHeader(uint32_t col_idx) {
+    ColumnHeader header;
+    memcpy(&header, GetData() + SIZE_COMPRESSED_PAGE_HEADER + col_idx * sizeof(ColumnHeader), sizeof(ColumnHeader));
+    return header;
+  }
+
+  void SetColumnHeader(uint32_t col_idx, const ColumnHeader &header) {
+    memcpy(GetData() + SIZE_COMPRESSED_PAGE_HEADER + col_idx * sizeof(ColumnHeader), &header, sizeof(ColumnHeader));
+  }
+
+  /** @return the offset of the slot states, which follow the column headers */
+  uint32_t SlotStatesOffset() {
+    return SIZE_COMPRESSED_PAGE_HEADER +
+           *reinterpret_cast<uint32_t *>(GetData() + OFFSET_COLUMN_COUNT) * sizeof(ColumnHeader);
+  }
+
+  SlotState GetSlotState(uint32_t slot) { return static_cast<SlotState>(GetData()[SlotStatesOffset() + slot]); }
+
+  void SetSlotState(uint32_t slot, SlotState state) { GetData()[SlotStatesOffset() + slot] = static_cast<char>(state); }
+
+  /** @return true if rid is a slot of this page that holds a tuple in the given state */
+  bool HasSlot(const RID &rid, SlotState state) {
+    return rid.GetSlotNum() < GetTupleCount() && GetSlotState(rid.GetSlotNum()) == state;
+  }
+
+  /** @return the null bitmap of a column, whose bit i is set if the value of slot i is null */
+  char *GetNulls(const ColumnHeader &header) { return GetData() + header.offset_; }
+
+  /** @return the codes of a column, which follow its null bitmap */
+  char *GetCodes(const ColumnHeader &header) { return GetData() + header.offset_ + (GetCapacity() + 7) / 8; }
+
+  /** @return the entry of a dictionary, a VARCHAR serialized as in a tuple */
+  const char *GetDictionaryEntry(const ColumnHeader &header, uint64_t code) {
+    uint32_t entry_offset;
+    memcpy(&entry_offset, GetData() + header.dictionary_offset_ + code * sizeof(uint32_t), sizeof(uint32_t));
+    return GetData() + entry_offset;
+  }
+
+  /** @return the index of the first entry of a dictionary not less than value, or greater if upper */
+  uint32_t SearchDictionary(const ColumnHeader &header, const Value &value, bool upper);
+
+  /** @return the code of a value in a column, false if it is outside the frame or dictionary of the column */
+  bool GetCode(const ColumnHeader &header, const Value &value, uint64_t *code);
+
+  /** Writes the values of a tuple into a slot. @return false, writing nothing, if a value has no code */
+  bool WriteRow(const Schema *schema, uint32_t slot, const std::vector<Value> &values);
+
+  /** Decodes every slot of the page, the values of a freed slot being null. */
+  void DecodeRows(const Schema *schema, std::vector<std::vector<Value>> *rows, std::vector<SlotState> *states);
+
+  /**
+   * Picks the encoding of every column for the given slots: frames, dictionaries and code widths.
+   * @param schema the schema of the table
+   * @param rows the values of the slots
+   * @param[out] headers the headers of the columns, without offsets
+   * @param[out] dictionaries the sorted distinct values of each VARCHAR column
+   * @return the number of slots a page encoded this way has room for
+   */
+  static uint32_t PlanEncoding(const Schema *schema, const std::vector<std::vector<Value>> &rows,
+                               std::vector<ColumnHeader> *headers, std::vector<std::vector<Value>> *dictionaries);
+
+  /** Encodes the page with the given slots. @return false, leaving the page as is, if they do not fit */
+  bool Encode(const Schema *schema, const std::vector<std::vector<Value>> &rows, const std::vector<SlotState> &states);
+};
+
+}  // namespace bustub
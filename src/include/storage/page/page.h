@@ -78,8 +78,8 @@ class Page {
       assert(lockStatus == wlock && lockStatus);
       tid.reset();
     }
-    rwlatch_.WUnlock();
     lockStatus = unlock;
+    rwlatch_.WUnlock();
   }
 
   /** Acquire the page read latch. */
@@ -90,8 +90,8 @@ class Page {
 
   /** Release the page read latch. */
   inline void RUnlatch() {
-    rwlatch_.RUnlock();
     lockStatus = unlock;
+    rwlatch_.RUnlock();
   }
 
   /** @return the page LSN. */
@@ -124,6 +124,8 @@ class Page {
   int pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
   bool is_dirty_ = false;
+  /** No log record below this LSN has modified the page since it was last written out (ARIES recLSN). */
+  lsn_t rec_lsn_ = INVALID_LSN;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
   //  for test
@@ -0,0 +1,190 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.h
+//
+// Identification: src/include/storage/page/pax_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/page/page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * PAX page format, where the values of each column are stored together in a minipage:
+ *  ------------------------------------------------------------------------------------------------------
+ *  | HEADER | SLOT STATES | MINIPAGE 0 | ... | MINIPAGE n-1 | ... FREE SPACE ... | ... VARCHAR PAYLOADS ... |
+ *  ------------------------------------------------------------------------------------------------------
+ *                                                                               ^
+ *                                                                               free space pointer
+ *
+ *  Header format (size in bytes):
+ *  -------------------------------------------------------------------------------------------------------------
+ *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| Capacity (4)| TupleCount (4)| FreeSpacePointer (4)|
+ *  -------------------------------------------------------------------------------------------------------------
+ *
+ * The first four fields are those of TablePage, so the chain of a table can be walked without knowing its layout.
+ * A page has room for Capacity tuples, fixed by the schema of the table. Minipage i holds the values of column i for
+ * every slot, back to back: fixed-size values serialized as in a tuple, nulls being the null sentinels of their type,
+ * and VARCHARs as the offset in the page of their payload, a length followed by the bytes. A scan thus reads only the
+ * minipages of the columns it needs, and a run of slots of a fixed-size column is a plain array.
+ *
+ * Each slot has a state byte. Slots are handed out in order and never reused, so a tuple deleted by ApplyDelete()
+ * leaves a hole. PAX pages are not logged; a table is created with this layout only when logging is off.
+ */
+class PaxPage : public Page {
+ public:
+  /** @return the number of tuples of a schema that a page has room for */
+  static uint32_t Capacity(const Schema *schema);
+
+  /** @return true if the VARCHAR payloads of a tuple fit in an empty page */
+  static bool FitsInEmptyPage(const Tuple &tuple, const Schema *schema);
+
+  /**
+   * Initialize the PaxPage header.
+   * @param page_id the page ID of this page
+   * @param prev_page_id the previous table page ID
+   * @param schema the schema of the table
+   */
+  void Init(page_id_t page_id, page_id_t prev_page_id, const Schema *schema);
+
+  /** @return the page ID of this page */
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /** @return the page ID of the next table page */
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  /** Set the page id of the next page in the table. */
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /** @return the number of slots handed out, live or not */
+  uint32_t GetTupleCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_COUNT); }
+
+  /**
+   * Insert a tuple into the page.
+   * @param tuple tuple to insert, of the schema of the table
+   * @param schema the schema of the table
+   * @param[out] rid rid of the inserted tuple
+   * @return true if the insert is successful (i.e. there is a free slot and enough space)
+   */
+  bool InsertTuple(const Tuple &tuple, const Schema *schema, RID *rid);
+
+  /** Mark a tuple as deleted. @return true if the tuple exists */
+  bool MarkDelete(const RID &rid);
+
+  /**
+   * Update a tuple in place.
+   * @param new_tuple new value of the tuple
+   * @param[out] old_tuple old value of the tuple
+   * @param rid rid of the tuple
+   * @param schema the schema of the table
+   * @return true if the tuple exists and the payloads of its new VARCHARs fit in the page
+   */
+  bool UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid, const Schema *schema);
+
+  /** To be called on commit or abort. Frees the slot of a tuple for good. */
+  void ApplyDelete(const RID &rid);
+
+  /** To be called on abort. Rollback a delete, i.e. this reverses a MarkDelete. */
+  void RollbackDelete(const RID &rid);
+
+  /**
+   * Read a tuple from the page, putting its values back together.
+   * @param rid rid of the tuple to read
+   * @param schema the schema of the table
+   * @param[out] tuple the tuple that was read, which owns its data
+   * @return true if the read is successful (i.e. the tuple exists)
+   */
+  bool GetTuple(const RID &rid, const Schema *schema, Tuple *tuple);
+
+  /** @return true if a slot holds a tuple that is not deleted */
+  bool IsLive(uint32_t slot) { return GetSlotState(slot) == SlotState::LIVE; }
+
+  /** @return the value of a column of the tuple in a slot */
+  Value GetValue(const Schema *schema, uint32_t slot, uint32_t col_idx);
+
+  /** @return the minipage of a fixed-size column, the value of slot i being at i * the fixed length of the column */
+  const char *GetColumnData(const Schema *schema, uint32_t col_idx) {
+    return GetData() + MinipageOffset(schema, col_idx);
+  }
+
+  /** @return the rid of the first tuple in this page */
+  bool GetFirstTupleRid(RID *first_rid);
+
+  /** @return the rid of the next tuple after cur_rid */
+  bool GetNextTupleRid(const RID &cur_rid, RID *next_rid);
+
+ private:
+  static_assert(sizeof(page_id_t) == 4);
+
+  /** The state of a slot: holding a tuple, holding a tuple marked as deleted, or freed. */
+  enum class SlotState : uint8_t { LIVE = 1, DELETED, FREE };
+
+  static constexpr size_t SIZE_PAX_PAGE_HEADER = 28;
+  static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
+  static constexpr size_t OFFSET_CAPACITY = 16;
+  static constexpr size_t OFFSET_TUPLE_COUNT = 20;
+  static constexpr size_t OFFSET_FREE_SPACE = 24;
+  /** The bytes of VARCHAR payloads that a page makes room for per VARCHAR column and tuple. */
+  static constexpr uint32_t VARLEN_RESERVE = 16;
+  /** Minipages start at multiples of this, so that fixed-size values are aligned. */
+  static constexpr uint32_t ALIGNMENT = 8;
+
+  /** @return the size of a value of a column in its minipage */
+  static uint32_t ValueWidth(const Column &column) {
+    return column.IsInlined() ? column.GetFixedLength() : sizeof(uint32_t);
+  }
+
+  /** @return the bytes of the VARCHAR payloads of a tuple */
+  static uint32_t VarlenSize(const Tuple &tuple, const Schema *schema);
+
+  /** @return the offset of the minipage of a column in a page of a given capacity */
+  static uint32_t MinipageOffset(const Schema *schema, uint32_t capacity, uint32_t col_idx);
+
+  uint32_t MinipageOffset(const Schema *schema, uint32_t col_idx) {
+    return MinipageOffset(schema, GetCapacity(), col_idx);
+  }
+
+  uint32_t GetCapacity() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_CAPACITY); }
+
+  void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
+
+  uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
+
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
+
+  SlotState GetSlotState(uint32_t slot) {
+    return static_cast<SlotState>(GetData()[SIZE_PAX_PAGE_HEADER + slot]);
+  }
+
+  void SetSlotState(uint32_t slot, SlotState state) {
+    GetData()[SIZE_PAX_PAGE_HEADER + slot] = static_cast<char>(state);
+  }
+
+  /** @return true if rid is a slot of this page that holds a tuple in the given state */
+  bool HasSlot(const RID &rid, SlotState state) {
+    return rid.GetSlotNum() < GetTupleCount() && GetSlotState(rid.GetSlotNum()) == state;
+  }
+
+  /** Writes the values of a tuple into a slot, its VARCHARs into payloads of varlen_size bytes in all. */
+  void WriteTuple(const Tuple &tuple, const Schema *schema, uint32_t slot, uint32_t varlen_size);
+};
+
+}  // namespace bustub
@@ -112,6 +112,14 @@ class TablePage : public Page {
   /** To be called on abort. Rollback a delete, i.e. this reverses a MarkDelete. */
   void RollbackDelete(const RID &rid, Transaction *txn, LogManager *log_manager);
 
+  /**
+   * Puts a tuple back into its slot, which must be empty. Recovery uses this to undo an ApplyDelete; it is not logged.
+   * @param tuple the deleted tuple
+   * @param rid rid the tuple had before it was deleted
+   * @return true if the tuple was restored, false if the slot is taken or the tuple does not fit
+   */
+  bool RestoreTuple(const Tuple &tuple, const RID &rid);
+
   /**
    * Read a tuple from a table.
    * @param rid rid of the tuple to read
@@ -122,6 +130,17 @@ class TablePage : public Page {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager);
 
+  /**
+   * Read a tuple from a table without copying it. The tuple points into this page, so it is only valid while the page
+   * stays pinned and latched.
+   * @param rid rid of the tuple to read
+   * @param[out] tuple the tuple that was read, which does not own its data
+   * @param txn transaction performing the read
+   * @param lock_manager the lock manager
+   * @return true if the read is successful (i.e. the tuple exists)
+   */
+  bool GetTupleView(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager);
+
   /** @return the rid of the first tuple in this page */
 
   /**
@@ -1,16 +1,17 @@
 #pragma once
 
+#include <cstring>
+
 #include "storage/page/page.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
-// To pass the test cases for this class, you must follow the existing TmpTuplePage format and implement the
-// existing functions exactly as they are! It may be helpful to look at TablePage.
-// Remember that this task is optional, you get full credit if you finish the next task.
-
 /**
+ * TmpTuplePage holds tuples that executors spill out of memory. Tuples are only appended and read back, never
+ * updated or deleted, so unlike TablePage there is no slot array.
+ *
  * TmpTuplePage format:
  *
  * Sizes are in bytes.
@@ -20,14 +21,56 @@ namespace bustub {
  */
 class TmpTuplePage : public Page {
  public:
-  void Init(page_id_t page_id, uint32_t page_size) {}
+  /** Initializes an empty page. */
+  void Init(page_id_t page_id, uint32_t page_size) {
+    memcpy(GetData(), &page_id, sizeof(page_id_t));
+    SetLSN(INVALID_LSN);
+    SetFreeSpacePointer(page_size);
+  }
+
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
 
-  page_id_t GetTablePageId() { return INVALID_PAGE_ID; }
+  /** @return the length of the largest tuple that fits in an empty page of page_size bytes */
+  static constexpr uint32_t MaxTupleLength(uint32_t page_size) { return page_size - SIZE_HEADER - sizeof(uint32_t); }
 
-  bool Insert(const Tuple &tuple, TmpTuple *out) { return false; }
+  /** @return the offset of the most recently inserted tuple, or the page size if the page is empty */
+  uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
+
+  /**
+   * Inserts a tuple at the end of the free space.
+   * @param tuple the tuple to insert
+   * @param[out] out the location of the inserted tuple
+   * @return false if the page does not have enough free space
+   */
+  bool Insert(const Tuple &tuple, TmpTuple *out) {
+    uint32_t size = sizeof(uint32_t) + tuple.GetLength();
+    uint32_t free_space_pointer = GetFreeSpacePointer();
+    if (free_space_pointer < SIZE_HEADER + size) {
+      return false;
+    }
+    free_space_pointer -= size;
+    tuple.SerializeTo(GetData() + free_space_pointer);
+    SetFreeSpacePointer(free_space_pointer);
+    *out = TmpTuple(GetTablePageId(), free_space_pointer);
+    return true;
+  }
+
+  /** Reads back the tuple that was inserted at offset. */
+  void Get(size_t offset, Tuple *tuple) { tuple->DeserializeFrom(GetData() + offset); }
+
+  /** @return the size of the entry (size field and data) at offset */
+  uint32_t GetEntrySize(size_t offset) {
+    return sizeof(uint32_t) + *reinterpret_cast<uint32_t *>(GetData() + offset);
+  }
 
  private:
   static_assert(sizeof(page_id_t) == 4);
+  static constexpr size_t OFFSET_FREE_SPACE = sizeof(page_id_t) + sizeof(lsn_t);
+  static constexpr size_t SIZE_HEADER = OFFSET_FREE_SPACE + sizeof(uint32_t);
+
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
 };
 
 }  // namespace bustub
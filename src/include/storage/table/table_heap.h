@@ -12,17 +12,42 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
+#include "storage/page/compressed_page.h"
+#include "storage/page/pax_page.h"
 #include "storage/page/table_page.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
 
 namespace bustub {
 
+/**
+ * The page format of a table: slotted pages of whole tuples (TablePage), column minipages (PaxPage), or encoded
+ * columns (CompressedPage).
+ */
+enum class TableLayout { ROW, PAX, COMPRESSED };
+
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
+ *
+ * Next to the page chain, the heap keeps a directory of its page ids in chain order so that a parallel scan can hand
+ * out ranges of pages without walking the chain. Pages are only ever appended to a table.
+ *
+ * The pages of a PAX table are PaxPages, which need the schema of the table to read and write tuples. They are not
+ * logged, and since their slots are never reused only the last page of the chain is tried by an insert. The same goes
+ * for the CompressedPages of a COMPRESSED table, meant for cold or read-mostly data.
+ *
+ * A heap given the schema of its table keeps a ZoneMap of each page it creates, widened by every tuple it inserts or
+ * updates, so that a scan can skip the pages whose ranges rule out its predicate. Zone maps are kept in memory only:
+ * the pages of a table opened from disk have none, and are always scanned.
  */
 class TableHeap {
   friend class TableIterator;
@@ -36,9 +61,11 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param first_page_id the id of the first page
+   * @param layout the page format of the table
+   * @param schema the schema of the table, needed by the columnar layouts and by zone maps
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            page_id_t first_page_id);
+            page_id_t first_page_id, TableLayout layout = TableLayout::ROW, const Schema *schema = nullptr);
 
   /**
    * Create a table heap with a transaction. (create table)
@@ -46,9 +73,11 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param txn the creating transaction
+   * @param layout the page format of the table
+   * @param schema the schema of the table, needed by the columnar layouts and by zone maps
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            Transaction *txn);
+            Transaction *txn, TableLayout layout = TableLayout::ROW, const Schema *schema = nullptr);
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
@@ -108,11 +137,55 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /** @return the ids of the pages of this table in chain order */
+  std::vector<page_id_t> GetPageIds();
+
+  /** @return the page format of this table */
+  inline TableLayout GetLayout() const { return layout_; }
+
+  /**
+   * Reads the range of a fixed-size column among the tuples written to a page, from the zone map of the page.
+   * @param page_id the id of a page of this table
+   * @param col_idx the index of the column
+   * @param[out] min the smallest value, null if every value of the column in the page is null
+   * @param[out] max the largest value, null if every value of the column in the page is null
+   * @return false if the page has no zone map
+   */
+  bool GetColumnRange(page_id_t page_id, uint32_t col_idx, Value *min, Value *max);
+
  private:
+  /** InsertTuple() of a PAX or COMPRESSED table, whose pages are PaxPages or CompressedPages. */
+  template <typename PageType>
+  bool InsertColumnarTuple(const Tuple &tuple, RID *rid, Transaction *txn);
+
+  /** GetFirstTupleRid() of a page of this table, whatever its layout. */
+  bool GetFirstTupleRid(TablePage *page, RID *first_rid);
+
+  /** GetNextTupleRid() of a page of this table, whatever its layout. */
+  bool GetNextTupleRid(TablePage *page, const RID &cur_rid, RID *next_rid);
+
+  /** Adds a page appended after prev_page_id to the directory, unless a walk of the chain already found it. */
+  void AppendToDirectory(page_id_t prev_page_id, page_id_t page_id);
+
+  /** Creates the empty zone map of a page created by this heap, if the schema is known. */
+  void CreateZoneMap(page_id_t page_id);
+
+  /** Widens the zone map of a page, if it has one, to a tuple written to it. */
+  void UpdateZoneMap(page_id_t page_id, const Tuple &tuple);
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  TableLayout layout_;
+  /** A copy of the schema of the table, nullptr if it was not given. */
+  std::unique_ptr<Schema> schema_;
+  /** The page ids in chain order. Empty until the chain of a table opened from disk is walked for the first time. */
+  std::vector<page_id_t> page_directory_;
+  std::mutex directory_latch_;
+  /** The zone maps of the pages created by this heap. */
+  std::unordered_map<page_id_t, ZoneMap> zone_maps_;
+  std::mutex zone_map_latch_;
 };
 
 }  // namespace bustub
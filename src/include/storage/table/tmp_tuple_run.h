@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_run.h
+//
+// Identification: src/include/storage/table/tmp_tuple_run.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TmpTupleRun is an append-only sequence of tuples spilled to TmpTuplePages, e.g. a hash join partition.
+ *
+ * At most one page is pinned while appending and one while reading, so a run can grow far beyond the buffer pool.
+ * Tuples are read back in the order they were appended. The pages are deleted when the run is cleared or destroyed.
+ */
+class TmpTupleRun {
+ public:
+  /** @param bpm the buffer pool that holds the pages of the run */
+  explicit TmpTupleRun(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  ~TmpTupleRun() { Clear(); }
+
+  DISALLOW_COPY_AND_MOVE(TmpTupleRun);
+
+  /**
+   * Appends a tuple to the run.
+   * @return false if the buffer pool could not provide a new page
+   * @throws Exception OUT_OF_RANGE if the tuple is longer than a page can hold
+   */
+  bool Append(const Tuple &tuple);
+
+  /** Unpins the page being appended to. Must be called before reading the run. */
+  void FinishAppend();
+
+  /**
+   * Reads the next tuple of the run.
+   * @return false if all tuples have been read
+   */
+  bool Next(Tuple *tuple);
+
+  /** Restarts reading from the first tuple. */
+  void Rewind();
+
+  /** Deletes all pages of the run. */
+  void Clear();
+
+  /** @return the number of tuples in the run */
+  size_t GetTupleCount() const { return tuple_count_; }
+
+  /** @return the total size of the tuples in the run */
+  size_t GetSize() const { return size_; }
+
+ private:
+  BufferPoolManager *bpm_;
+  std::vector<page_id_t> page_ids_;
+  size_t tuple_count_{0};
+  size_t size_{0};
+  /** The page being appended to, pinned. */
+  TmpTuplePage *append_page_{nullptr};
+  /** The page being read, pinned, its entry offsets in append order and the position in them. */
+  TmpTuplePage *read_page_{nullptr};
+  size_t read_page_idx_{0};
+  std::vector<uint32_t> read_offsets_;
+  size_t read_offset_idx_{0};
+};
+
+}  // namespace bustub
@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/arena.h"
 #include "common/rid.h"
 #include "type/value.h"
 
@@ -26,10 +27,20 @@ namespace bustub {
  * ---------------------------------------------------------------------
  * | FIXED-SIZE or VARIED-SIZED OFFSET | PAYLOAD OF VARIED-SIZED FIELD |
  * ---------------------------------------------------------------------
+ *
+ * preceded by a null bitmap unless the format of the schema is TupleFormat::PLAIN, see Schema.
+ *
+ * A tuple either owns its data or is a view of data owned by someone else: a pinned table page, see
+ * TablePage::GetTupleView(), or an Arena. A view is only valid as long as that memory is, so copying a tuple always
+ * makes a deep copy that owns its data, while moving it keeps a view a view.
  */
 class Tuple {
   friend class TablePage;
 
+  friend class PaxPage;
+
+  friend class CompressedPage;
+
   friend class TableHeap;
 
   friend class TableIterator;
@@ -44,12 +55,28 @@ class Tuple {
   // constructor for creating a new tuple based on input value
   Tuple(std::vector<Value> values, const Schema *schema);
 
+  // constructor for creating a view of a new tuple allocated in an arena
+  Tuple(const std::vector<Value> &values, const Schema *schema, Arena *arena);
+
+  // constructor for an uninitialized tuple of size bytes, written through GetData(), which is a view if allocated in
+  // an arena and owns its data if arena is nullptr
+  Tuple(uint32_t size, Arena *arena);
+
   // copy constructor, deep copy
   Tuple(const Tuple &other);
 
+  // copy constructor, deep copy into an arena, which makes a view
+  Tuple(const Tuple &other, Arena *arena);
+
+  // move constructor, takes over the data or the view of other
+  Tuple(Tuple &&other) noexcept;
+
   // assign operator, deep copy
   Tuple &operator=(const Tuple &other);
 
+  // move assign operator, takes over the data or the view of other
+  Tuple &operator=(Tuple &&other) noexcept;
+
   ~Tuple() {
     if (allocated_) {
       delete[] data_;
@@ -79,8 +106,11 @@ class Tuple {
   // Generates a key tuple given schemas and attributes
   Tuple KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs);
 
-  // Is the column value null ?
+  // Is the column value null ? A bit test if the tuple has a null bitmap.
   inline bool IsNull(const Schema *schema, uint32_t column_idx) const {
+    if (schema->GetNullBitmapSize() > 0) {
+      return ((data_[column_idx / 8] >> (column_idx % 8)) & 1) != 0;
+    }
     Value value = GetValue(schema, column_idx);
     return value.IsNull();
   }
@@ -92,6 +122,12 @@ class Tuple {
   // Get the starting storage address of specific column
   const char *GetDataPtr(const Schema *schema, uint32_t column_idx) const;
 
+  // Get the size of a tuple of the values
+  static uint32_t SerializedSize(const std::vector<Value> &values, const Schema *schema);
+
+  // Serialize the values into data_, which has room for them
+  void SerializeValues(const std::vector<Value> &values, const Schema *schema);
+
   bool allocated_{false};  // is allocated?
   RID rid_{};              // if pointing to the table heap, the rid is valid
   uint32_t size_{0};
@@ -0,0 +1,49 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.h
+//
+// Identification: src/include/storage/table/zone_map.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * ZoneMap holds the smallest and the largest value of each fixed-size column among the tuples written to a page.
+ *
+ * The range only ever grows: deleting or updating a tuple leaves its old values in it. It thus covers every tuple the
+ * page may hold, and a scan can skip the page if no value of the range can satisfy its predicate. Null values are left
+ * out, a column with no other value having a null range.
+ */
+class ZoneMap {
+ public:
+  /** @param schema the schema of the tuples of the page */
+  explicit ZoneMap(const Schema *schema);
+
+  /** Widens the ranges to the values of a tuple written to the page. */
+  void Update(const Tuple &tuple, const Schema *schema);
+
+  /** @return the smallest value of a column, null if the column has no value that is not null or is not fixed-size */
+  const Value &GetMin(uint32_t col_idx) const { return min_[col_idx]; }
+
+  /** @return the largest value of a column, null if the column has no value that is not null or is not fixed-size */
+  const Value &GetMax(uint32_t col_idx) const { return max_[col_idx]; }
+
+ private:
+  std::vector<Value> min_;
+  std::vector<Value> max_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,176 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// optimizer.cpp
+//
+// Identification: src/optimizer/optimizer.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/optimizer.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "common/config.h"
+#include "execution/aggregation_hash_table.h"
+#include "execution/expressions/aggregate_value_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/gather_plan.h"
+#include "execution/plans/limit_plan.h"
+#include "execution/plans/repartition_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
+
+namespace bustub {
+
+const AbstractPlanNode *Optimizer::Optimize(const AbstractPlanNode *plan) {
+  plan = OptimizeSortLimitAsTopN(plan);
+  // Parallel instances do not take tuple locks on the shared transaction, which TablePage only does with logging on.
+  if (worker_count_ > 1 && !enable_logging) {
+    plan = ParallelizeScans(plan, true);
+  }
+  return plan;
+}
+
+const AbstractPlanNode *Optimizer::OptimizeSortLimitAsTopN(const AbstractPlanNode *plan) {
+  std::vector<const AbstractPlanNode *> children;
+  bool children_changed = false;
+  for (const auto *child : plan->GetChildren()) {
+    children.push_back(OptimizeSortLimitAsTopN(child));
+    children_changed = children_changed || children.back() != child;
+  }
+  if (children_changed) {
+    plan = Own(plan->CloneWithChildren(std::move(children)));
+  }
+
+  if (plan->GetType() != PlanType::Limit) {
+    return plan;
+  }
+  auto limit_plan = dynamic_cast<const LimitPlanNode *>(plan);
+  if (limit_plan->GetChildPlan()->GetType() != PlanType::Sort) {
+    return plan;
+  }
+  auto sort_plan = dynamic_cast<const SortPlanNode *>(limit_plan->GetChildPlan());
+  // The offset tuples have to be found by the top-n as well before the limit skips them.
+  const AbstractPlanNode *topn_plan =
+      Own(std::make_unique<TopNPlanNode>(sort_plan->OutputSchema(), sort_plan->GetChildPlan(), sort_plan->GetOrderBys(),
+                                         limit_plan->GetLimit() + limit_plan->GetOffset()));
+  if (limit_plan->GetOffset() == 0) {
+    return topn_plan;
+  }
+  return Own(limit_plan->CloneWithChildren({topn_plan}));
+}
+
+const AbstractPlanNode *Optimizer::ParallelizeScans(const AbstractPlanNode *plan, bool may_parallelize) {
+  switch (plan->GetType()) {
+    case PlanType::SeqScan:
+      return may_parallelize ? Own(std::make_unique<GatherPlanNode>(plan->OutputSchema(), plan, worker_count_)) : plan;
+    case PlanType::Aggregation:
+      if (may_parallelize && plan->GetChildAt(0)->GetType() == PlanType::SeqScan &&
+          IsCombinable(dynamic_cast<const AggregationPlanNode *>(plan))) {
+        return ParallelizeAggregation(dynamic_cast<const AggregationPlanNode *>(plan));
+      }
+      break;
+    case PlanType::Gather:
+      return plan;
+    default:
+      break;
+  }
+
+  std::vector<const AbstractPlanNode *> children;
+  bool children_changed = false;
+  for (uint32_t i = 0; i < plan->GetChildren().size(); i++) {
+    const AbstractPlanNode *child = plan->GetChildAt(i);
+    // Updates and deletes need the RIDs of their child's tuples, which a gather does not return, and the inner side of
+    // a nested loop join is scanned again for every outer tuple.
+    bool child_may_parallelize = plan->GetType() != PlanType::Update && plan->GetType() != PlanType::Delete &&
+                                 !(plan->GetType() == PlanType::NestedLoopJoin && i == 1);
+    children.push_back(ParallelizeScans(child, child_may_parallelize));
+    children_changed = children_changed || children.back() != child;
+  }
+  if (children_changed) {
+    plan = Own(plan->CloneWithChildren(std::move(children)));
+  }
+  return plan;
+}
+
+bool Optimizer::IsCombinable(const AggregationPlanNode *plan) {
+  // The partial states of AVG, distinct counts and percentiles are not values that a final aggregation can combine.
+  const auto &agg_types = plan->GetAggregateTypes();
+  return std::all_of(agg_types.begin(), agg_types.end(), [](AggregationType agg_type) {
+    return agg_type == AggregationType::CountAggregate || agg_type == AggregationType::SumAggregate ||
+           agg_type == AggregationType::MinAggregate || agg_type == AggregationType::MaxAggregate;
+  });
+}
+
+const AbstractPlanNode *Optimizer::ParallelizeAggregation(const AggregationPlanNode *plan) {
+  // The partial aggregation outputs its group-bys followed by its aggregates.
+  const auto &group_bys = plan->GetGroupBys();
+  const auto &aggregates = plan->GetAggregates();
+  const auto &agg_types = plan->GetAggregateTypes();
+  std::vector<Column> partial_columns;
+  for (uint32_t i = 0; i < group_bys.size(); i++) {
+    TypeId type = group_bys[i]->GetReturnType();
+    exprs_.emplace_back(std::make_unique<AggregateValueExpression>(true, i, type));
+    std::string name = "group_by_" + std::to_string(i);
+    if (type == TypeId::VARCHAR) {
+      partial_columns.emplace_back(name, type, 0, exprs_.back().get());
+    } else {
+      partial_columns.emplace_back(name, type, exprs_.back().get());
+    }
+  }
+  for (uint32_t i = 0; i < aggregates.size(); i++) {
+    TypeId type = AggregationHashTable::GetResultType(agg_types[i], aggregates[i]->GetReturnType());
+    exprs_.emplace_back(std::make_unique<AggregateValueExpression>(false, i, type));
+    std::string name = "aggregate_" + std::to_string(i);
+    if (type == TypeId::VARCHAR) {
+      partial_columns.emplace_back(name, type, 0, exprs_.back().get());
+    } else {
+      partial_columns.emplace_back(name, type, exprs_.back().get());
+    }
+  }
+  schemas_.emplace_back(std::make_unique<Schema>(partial_columns));
+  const Schema *partial_schema = schemas_.back().get();
+  const AbstractPlanNode *partial = Own(std::make_unique<AggregationPlanNode>(
+      partial_schema, plan->GetChildPlan(), nullptr, std::vector<const AbstractExpression *>(group_bys),
+      std::vector<const AbstractExpression *>(aggregates), std::vector<AggregationType>(agg_types)));
+
+  // The final aggregation combines the partial states: the counts are added up, the other aggregates combine as is.
+  std::vector<const AbstractExpression *> final_group_bys;
+  std::vector<const AbstractExpression *> final_aggregates;
+  std::vector<AggregationType> final_agg_types;
+  for (uint32_t i = 0; i < partial_schema->GetColumnCount(); i++) {
+    exprs_.emplace_back(std::make_unique<ColumnValueExpression>(0, i, partial_schema->GetColumn(i).GetType()));
+    if (i < group_bys.size()) {
+      final_group_bys.push_back(exprs_.back().get());
+      continue;
+    }
+    AggregationType agg_type = agg_types[i - group_bys.size()];
+    final_aggregates.push_back(exprs_.back().get());
+    final_agg_types.push_back(agg_type == AggregationType::CountAggregate ? AggregationType::SumAggregate : agg_type);
+  }
+  if (group_bys.empty()) {
+    const AbstractPlanNode *gather = Own(std::make_unique<GatherPlanNode>(partial_schema, partial, worker_count_));
+    return Own(std::make_unique<AggregationPlanNode>(plan->OutputSchema(), gather, plan->GetHaving(),
+                                                     std::move(final_group_bys), std::move(final_aggregates),
+                                                     std::move(final_agg_types)));
+  }
+  const AbstractPlanNode *repartition = Own(std::make_unique<RepartitionPlanNode>(
+      partial_schema, partial, std::vector<const AbstractExpression *>(final_group_bys)));
+  const AbstractPlanNode *final_plan = Own(std::make_unique<AggregationPlanNode>(
+      plan->OutputSchema(), repartition, plan->GetHaving(), std::move(final_group_bys), std::move(final_aggregates),
+      std::move(final_agg_types)));
+  return Own(std::make_unique<GatherPlanNode>(plan->OutputSchema(), final_plan, worker_count_));
+}
+
+const AbstractPlanNode *Optimizer::Own(std::unique_ptr<AbstractPlanNode> &&plan) {
+  plans_.push_back(std::move(plan));
+  return plans_.back().get();
+}
+
+}  // namespace bustub
@@ -22,33 +22,216 @@ namespace bustub {
  *
  * This thread runs forever until system shutdown/StopFlushThread
  */
-void LogManager::RunFlushThread() {}
+void LogManager::RunFlushThread() {
+  if (enable_logging) {
+    return;
+  }
+  enable_logging = true;
+  flush_thread_ = new std::thread(&LogManager::FlushLoop, this);
+}
 
 /*
  * Stop and join the flush thread, set enable_logging = false
  */
-void LogManager::StopFlushThread() {}
+void LogManager::StopFlushThread() {
+  if (flush_thread_ == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    enable_logging = false;
+  }
+  cv_.notify_one();
+  flush_thread_->join();
+  delete flush_thread_;
+  flush_thread_ = nullptr;
+}
+
+void LogManager::FlushLoop() {
+  std::unique_lock<std::mutex> guard(latch_);
+  while (enable_logging) {
+    cv_.wait_for(guard, log_timeout, [&] { return need_flush_ || !enable_logging; });
+    SwapAndFlush(&guard);
+  }
+  // Whatever was appended before shutdown still has to reach the disk.
+  SwapAndFlush(&guard);
+  flushed_cv_.notify_all();
+}
+
+void LogManager::SwapAndFlush(std::unique_lock<std::mutex> *guard) {
+  need_flush_ = false;
+  uint64_t reservation = reservation_.load();
+  if (ReservedOffset(reservation) == 0) {
+    flushed_cv_.notify_all();
+    return;
+  }
+  guard->unlock();
+
+  // Seal the buffer so that no new reservations land in it, then wait for the appenders that already reserved space.
+  reservation = reservation_.fetch_or(SEALED_MASK);
+  int flush_size = ReservedOffset(reservation);
+  lsn_t next_lsn = ReservedLSN(reservation);
+  while (copied_bytes_.load(std::memory_order_acquire) != flush_size) {
+    std::this_thread::yield();
+  }
+  std::swap(log_buffer_, flush_buffer_);
+  copied_bytes_.store(0, std::memory_order_relaxed);
+  // Unsealing publishes the new log_buffer_ to appenders.
+  reservation_.store(MakeReservation(next_lsn, 0), std::memory_order_release);
+
+  // Appenders that were waiting for space can continue while we write.
+  guard->lock();
+  flushed_cv_.notify_all();
+  guard->unlock();
+
+  WriteFlushBuffer(flush_size);
+
+  guard->lock();
+  persistent_lsn_ = next_lsn - 1;
+  flushed_cv_.notify_all();
+}
+
+void LogManager::WriteFlushBuffer(int size) {
+  if (compress_log_) {
+    char *block = compress_buffers_[next_compress_buffer_];
+    auto compressed_size = static_cast<int32_t>(
+        CompressionUtil::Compress(flush_buffer_, size, block + COMPRESSED_BLOCK_HEADER_SIZE));
+    if (compressed_size + COMPRESSED_BLOCK_HEADER_SIZE < size) {
+      memcpy(block, &COMPRESSED_BLOCK_MARKER, sizeof(int32_t));
+      memcpy(block + sizeof(int32_t), &compressed_size, sizeof(int32_t));
+      memcpy(block + 2 * sizeof(int32_t), &size, sizeof(int32_t));
+      disk_manager_->WriteLog(block, COMPRESSED_BLOCK_HEADER_SIZE + compressed_size);
+      next_compress_buffer_ ^= 1;
+      return;
+    }
+  }
+  disk_manager_->WriteLog(flush_buffer_, size);
+}
+
+void LogManager::Flush(lsn_t lsn) {
+  std::unique_lock<std::mutex> guard(latch_);
+  // Nothing beyond the last assigned LSN can ever become persistent.
+  lsn = std::min(lsn, static_cast<lsn_t>(GetNextLSN() - 1));
+  if (lsn == INVALID_LSN || persistent_lsn_ >= lsn) {
+    return;
+  }
+  need_flush_ = true;
+  cv_.notify_one();
+  flushed_cv_.wait(guard, [&] { return persistent_lsn_ >= lsn || !enable_logging; });
+}
+
+void LogManager::WaitForSpace(int size) {
+  std::unique_lock<std::mutex> guard(latch_);
+  need_flush_ = true;
+  cv_.notify_one();
+  flushed_cv_.wait(guard, [&] {
+    uint64_t reservation = reservation_.load();
+    return !IsSealed(reservation) && ReservedOffset(reservation) + size <= LOG_BUFFER_SIZE;
+  });
+}
 
 /*
  * append a log record into log buffer
  * you MUST set the log record's lsn within this method
  * @return: lsn that is assigned to this log record
- *
- *
- * example below
- * // First, serialize the must have fields(20 bytes in total)
- * log_record.lsn_ = next_lsn_++;
- * memcpy(log_buffer_ + offset_, &log_record, 20);
- * int pos = offset_ + 20;
- *
- * if (log_record.log_record_type_ == LogRecordType::INSERT) {
- *    memcpy(log_buffer_ + pos, &log_record.insert_rid_, sizeof(RID));
- *    pos += sizeof(RID);
- *    // we have provided serialize function for tuple class
- *    log_record.insert_tuple_.SerializeTo(log_buffer_ + pos);
- *  }
- *
  */
-lsn_t LogManager::AppendLogRecord(LogRecord *log_record) { return INVALID_LSN; }
+lsn_t LogManager::AppendLogRecord(LogRecord *log_record) {
+  int size = log_record->GetSize();
+  BUSTUB_ASSERT(size <= LOG_BUFFER_SIZE, "Log record does not fit into the log buffer.");
+  // Reserve the LSN and the byte range together, so that LSNs appear in the log in increasing order.
+  uint64_t reservation = reservation_.load(std::memory_order_acquire);
+  while (true) {
+    if (IsSealed(reservation)) {
+      // The flush thread is about to swap the buffers, which only takes as long as the pending copies.
+      std::this_thread::yield();
+      reservation = reservation_.load(std::memory_order_acquire);
+      continue;
+    }
+    if (ReservedOffset(reservation) + size > LOG_BUFFER_SIZE) {
+      // The log buffer is full: hand it to the flush thread and wait for the swap.
+      WaitForSpace(size);
+      reservation = reservation_.load(std::memory_order_acquire);
+      continue;
+    }
+    uint64_t next = MakeReservation(ReservedLSN(reservation) + 1, ReservedOffset(reservation) + size);
+    if (reservation_.compare_exchange_weak(reservation, next, std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+      break;
+    }
+  }
+
+  // The flush thread does not swap log_buffer_ until the bytes reserved above are published below.
+  log_record->lsn_ = ReservedLSN(reservation);
+  SerializeLogRecord(log_record, log_buffer_ + ReservedOffset(reservation));
+  copied_bytes_.fetch_add(size, std::memory_order_release);
+  return log_record->lsn_;
+}
+
+void LogManager::SerializeLogRecord(LogRecord *log_record, char *storage) {
+  // The header fields are laid out contiguously at the start of LogRecord.
+  memcpy(storage, log_record, LogRecord::HEADER_SIZE);
+  int pos = LogRecord::HEADER_SIZE;
+
+  switch (log_record->log_record_type_) {
+    case LogRecordType::INSERT:
+      memcpy(storage + pos, &log_record->insert_rid_, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->insert_tuple_.SerializeTo(storage + pos);
+      break;
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      memcpy(storage + pos, &log_record->delete_rid_, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->delete_tuple_.SerializeTo(storage + pos);
+      break;
+    case LogRecordType::UPDATE:
+      memcpy(storage + pos, &log_record->update_rid_, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->old_tuple_.SerializeTo(storage + pos);
+      pos += sizeof(int32_t) + log_record->old_tuple_.GetLength();
+      log_record->new_tuple_.SerializeTo(storage + pos);
+      break;
+    case LogRecordType::DELTA_UPDATE: {
+      memcpy(storage + pos, &log_record->update_rid_, sizeof(RID));
+      pos += sizeof(RID);
+      auto num_ranges = static_cast<uint32_t>(log_record->deltas_.size());
+      uint32_t sizes[] = {log_record->old_tuple_size_, log_record->new_tuple_size_, num_ranges};
+      memcpy(storage + pos, sizes, sizeof(sizes));
+      pos += sizeof(sizes);
+      for (const auto &delta : log_record->deltas_) {
+        uint32_t range[] = {delta.offset_, static_cast<uint32_t>(delta.old_bytes_.size()),
+                            static_cast<uint32_t>(delta.new_bytes_.size())};
+        memcpy(storage + pos, range, sizeof(range));
+        pos += sizeof(range);
+        memcpy(storage + pos, delta.old_bytes_.data(), delta.old_bytes_.size());
+        pos += delta.old_bytes_.size();
+        memcpy(storage + pos, delta.new_bytes_.data(), delta.new_bytes_.size());
+        pos += delta.new_bytes_.size();
+      }
+      break;
+    }
+    case LogRecordType::NEWPAGE:
+      memcpy(storage + pos, &log_record->prev_page_id_, sizeof(page_id_t));
+      pos += sizeof(page_id_t);
+      memcpy(storage + pos, &log_record->page_id_, sizeof(page_id_t));
+      break;
+    case LogRecordType::CHECKPOINT_DIRTY_PAGES:
+    case LogRecordType::END_CHECKPOINT: {
+      auto num_dirty_pages = static_cast<int32_t>(log_record->dirty_page_table_.size());
+      memcpy(storage + pos, &num_dirty_pages, sizeof(int32_t));
+      pos += sizeof(int32_t);
+      for (const auto &[page_id, rec_lsn] : log_record->dirty_page_table_) {
+        memcpy(storage + pos, &page_id, sizeof(page_id_t));
+        memcpy(storage + pos + sizeof(page_id_t), &rec_lsn, sizeof(lsn_t));
+        pos += sizeof(page_id_t) + sizeof(lsn_t);
+      }
+      break;
+    }
+    default:
+      // BEGIN/COMMIT/ABORT/BEGIN_CHECKPOINT only carry the header.
+      break;
+  }
+}
 
 }  // namespace bustub
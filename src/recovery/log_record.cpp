@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_record.cpp
+//
+// Identification: src/recovery/log_record.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "recovery/log_record.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void LogRecord::ComputeDeltas(const Tuple &old_tuple, const Tuple &new_tuple) {
+  const char *old_data = old_tuple.GetData();
+  const char *new_data = new_tuple.GetData();
+  old_tuple_size_ = old_tuple.GetLength();
+  new_tuple_size_ = new_tuple.GetLength();
+  deltas_.clear();
+
+  if (old_tuple_size_ != new_tuple_size_) {
+    // The bytes behind a resized column move, so only strip the common prefix and suffix.
+    uint32_t min_size = std::min(old_tuple_size_, new_tuple_size_);
+    uint32_t prefix = 0;
+    while (prefix < min_size && old_data[prefix] == new_data[prefix]) {
+      prefix++;
+    }
+    uint32_t suffix = 0;
+    while (suffix < min_size - prefix &&
+           old_data[old_tuple_size_ - 1 - suffix] == new_data[new_tuple_size_ - 1 - suffix]) {
+      suffix++;
+    }
+    deltas_.push_back({prefix, std::string(old_data + prefix, old_tuple_size_ - prefix - suffix),
+                       std::string(new_data + prefix, new_tuple_size_ - prefix - suffix)});
+    return;
+  }
+
+  // Log every run of changed bytes. Runs that are closer than the cost of a range are merged.
+  const uint32_t range_header_size = 3 * sizeof(uint32_t);
+  uint32_t pos = 0;
+  while (pos < old_tuple_size_) {
+    if (old_data[pos] == new_data[pos]) {
+      pos++;
+      continue;
+    }
+    uint32_t begin = pos;
+    uint32_t end = pos + 1;
+    for (uint32_t i = end; i < old_tuple_size_ && i - end < range_header_size; i++) {
+      if (old_data[i] != new_data[i]) {
+        end = i + 1;
+      }
+    }
+    deltas_.push_back({begin, std::string(old_data + begin, end - begin), std::string(new_data + begin, end - begin)});
+    pos = end;
+  }
+}
+
+Tuple LogRecord::ApplyDeltas(const Tuple &tuple, bool redo) const {
+  BUSTUB_ASSERT(tuple.GetLength() == (redo ? old_tuple_size_ : new_tuple_size_), "Deltas applied to the wrong tuple.");
+  uint32_t size = redo ? new_tuple_size_ : old_tuple_size_;
+  std::vector<char> storage(sizeof(int32_t) + size);
+  memcpy(storage.data(), &size, sizeof(int32_t));
+  char *data = storage.data() + sizeof(int32_t);
+
+  // Offsets agree in both versions up to each range, so the bytes in between are copied unchanged.
+  uint32_t pos = 0;
+  uint32_t tuple_pos = 0;
+  for (const auto &delta : deltas_) {
+    const std::string &from = redo ? delta.old_bytes_ : delta.new_bytes_;
+    const std::string &to = redo ? delta.new_bytes_ : delta.old_bytes_;
+    uint32_t unchanged = delta.offset_ - pos;
+    memcpy(data + pos, tuple.GetData() + tuple_pos, unchanged);
+    memcpy(data + delta.offset_, to.data(), to.size());
+    pos = delta.offset_ + to.size();
+    tuple_pos += unchanged + from.size();
+  }
+  memcpy(data + pos, tuple.GetData() + tuple_pos, size - pos);
+
+  Tuple result;
+  result.DeserializeFrom(storage.data());
+  return result;
+}
+
+}  // namespace bustub
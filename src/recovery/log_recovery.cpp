@@ -12,6 +12,10 @@
 
 #include "recovery/log_recovery.h"
 
+#include <atomic>
+#include <utility>
+
+#include "common/util/compression_util.h"
 #include "storage/page/table_page.h"
 
 namespace bustub {
@@ -20,7 +24,86 @@ namespace bustub {
  * @return: true means deserialize succeed, otherwise can't deserialize cause
  * incomplete log record
  */
-bool LogRecovery::DeserializeLogRecord(const char *data, LogRecord *log_record) { return false; }
+bool LogRecovery::DeserializeLogRecord(const char *data, LogRecord *log_record) {
+  memcpy(&log_record->size_, data, sizeof(int32_t));
+  if (log_record->size_ < LogRecord::HEADER_SIZE) {
+    return false;
+  }
+  memcpy(&log_record->lsn_, data + 4, sizeof(lsn_t));
+  memcpy(&log_record->txn_id_, data + 8, sizeof(txn_id_t));
+  memcpy(&log_record->prev_lsn_, data + 12, sizeof(lsn_t));
+  memcpy(&log_record->log_record_type_, data + 16, sizeof(LogRecordType));
+  int pos = LogRecord::HEADER_SIZE;
+
+  switch (log_record->log_record_type_) {
+    case LogRecordType::INSERT:
+      memcpy(&log_record->insert_rid_, data + pos, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->insert_tuple_.DeserializeFrom(data + pos);
+      break;
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      memcpy(&log_record->delete_rid_, data + pos, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->delete_tuple_.DeserializeFrom(data + pos);
+      break;
+    case LogRecordType::UPDATE:
+      memcpy(&log_record->update_rid_, data + pos, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->old_tuple_.DeserializeFrom(data + pos);
+      pos += sizeof(int32_t) + log_record->old_tuple_.GetLength();
+      log_record->new_tuple_.DeserializeFrom(data + pos);
+      break;
+    case LogRecordType::DELTA_UPDATE: {
+      memcpy(&log_record->update_rid_, data + pos, sizeof(RID));
+      pos += sizeof(RID);
+      uint32_t sizes[3];
+      memcpy(sizes, data + pos, sizeof(sizes));
+      pos += sizeof(sizes);
+      log_record->old_tuple_size_ = sizes[0];
+      log_record->new_tuple_size_ = sizes[1];
+      log_record->deltas_.resize(sizes[2]);
+      for (auto &delta : log_record->deltas_) {
+        uint32_t range[3];
+        memcpy(range, data + pos, sizeof(range));
+        pos += sizeof(range);
+        delta.offset_ = range[0];
+        delta.old_bytes_.assign(data + pos, range[1]);
+        pos += range[1];
+        delta.new_bytes_.assign(data + pos, range[2]);
+        pos += range[2];
+      }
+      break;
+    }
+    case LogRecordType::NEWPAGE:
+      memcpy(&log_record->prev_page_id_, data + pos, sizeof(page_id_t));
+      pos += sizeof(page_id_t);
+      memcpy(&log_record->page_id_, data + pos, sizeof(page_id_t));
+      break;
+    case LogRecordType::CHECKPOINT_DIRTY_PAGES:
+    case LogRecordType::END_CHECKPOINT: {
+      int32_t num_dirty_pages;
+      memcpy(&num_dirty_pages, data + pos, sizeof(int32_t));
+      pos += sizeof(int32_t);
+      log_record->dirty_page_table_.resize(num_dirty_pages);
+      for (auto &[page_id, rec_lsn] : log_record->dirty_page_table_) {
+        memcpy(&page_id, data + pos, sizeof(page_id_t));
+        memcpy(&rec_lsn, data + pos + sizeof(page_id_t), sizeof(lsn_t));
+        pos += sizeof(page_id_t) + sizeof(lsn_t);
+      }
+      break;
+    }
+    case LogRecordType::BEGIN:
+    case LogRecordType::COMMIT:
+    case LogRecordType::ABORT:
+    case LogRecordType::BEGIN_CHECKPOINT:
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
 
 /*
  *redo phase on TABLE PAGE level(table/table_page.h)
@@ -29,12 +112,339 @@ bool LogRecovery::DeserializeLogRecord(const char *data, LogRecord *log_record)
  *LSN with log_record's sequence number, and also build active_txn_ table &
  *lsn_mapping_ table
  */
-void LogRecovery::Redo() {}
+void LogRecovery::Redo() {
+  Analyze();
+
+  // Pages are independent of each other. Hand out the busiest pages first so that one long page does not end up last.
+  std::vector<std::pair<page_id_t, const std::vector<LogRecord *> *>> pages;
+  pages.reserve(page_records_.size());
+  for (const auto &entry : page_records_) {
+    pages.emplace_back(entry.first, &entry.second);
+  }
+  std::sort(pages.begin(), pages.end(),
+            [](const auto &lhs, const auto &rhs) { return lhs.second->size() > rhs.second->size(); });
+  RunInParallel(pages.size(), [&](size_t i) { RedoPage(pages[i].first, *pages[i].second); });
+}
 
 /*
  *undo phase on TABLE PAGE level(table/table_page.h)
  *iterate through active txn map and undo each operation
  */
-void LogRecovery::Undo() {}
+void LogRecovery::Undo() {
+  // Every change of a loser transaction is confined to one page, so undo runs page by page like redo does, each page
+  // rolling back its newest change first.
+  std::unordered_map<page_id_t, std::vector<LogRecord *>> undo_records;
+  for (const auto &entry : active_txn_) {
+    for (lsn_t lsn = entry.second; lsn != INVALID_LSN;) {
+      LogRecord *log_record = lsn_mapping_.at(lsn);
+      lsn = log_record->prev_lsn_;
+      switch (log_record->log_record_type_) {
+        case LogRecordType::INSERT:
+          undo_records[log_record->insert_rid_.GetPageId()].push_back(log_record);
+          break;
+        case LogRecordType::MARKDELETE:
+        case LogRecordType::APPLYDELETE:
+        case LogRecordType::ROLLBACKDELETE:
+          undo_records[log_record->delete_rid_.GetPageId()].push_back(log_record);
+          break;
+        case LogRecordType::UPDATE:
+        case LogRecordType::DELTA_UPDATE:
+          undo_records[log_record->update_rid_.GetPageId()].push_back(log_record);
+          break;
+        default:
+          // BEGIN has nothing to undo and a new page stays part of the table heap.
+          break;
+      }
+    }
+  }
+  std::vector<std::pair<page_id_t, std::vector<LogRecord *> *>> pages;
+  pages.reserve(undo_records.size());
+  for (auto &entry : undo_records) {
+    std::sort(entry.second.begin(), entry.second.end(),
+              [](const LogRecord *lhs, const LogRecord *rhs) { return lhs->lsn_ > rhs->lsn_; });
+    pages.emplace_back(entry.first, &entry.second);
+  }
+  RunInParallel(pages.size(), [&](size_t i) { UndoPage(pages[i].first, *pages[i].second); });
+
+  active_txn_.clear();
+  lsn_mapping_.clear();
+  page_records_.clear();
+  records_.clear();
+}
+
+void LogRecovery::Analyze() {
+  active_txn_.clear();
+  lsn_mapping_.clear();
+  page_records_.clear();
+  records_.clear();
+  checkpoint_dirty_pages_.clear();
+
+  redo_lsn_ = 0;
+  max_lsn_ = INVALID_LSN;
+  lsn_t checkpoint_lsn = INVALID_LSN;
+  offset_ = 0;
+  while (disk_manager_->ReadLog(log_buffer_, LOG_BUFFER_SIZE, offset_)) {
+    int32_t marker;
+    memcpy(&marker, log_buffer_, sizeof(int32_t));
+    int consumed;
+    if (marker == COMPRESSED_BLOCK_MARKER) {
+      int32_t compressed_size;
+      int32_t raw_size;
+      memcpy(&compressed_size, log_buffer_ + sizeof(int32_t), sizeof(int32_t));
+      memcpy(&raw_size, log_buffer_ + 2 * sizeof(int32_t), sizeof(int32_t));
+      std::vector<char> block(compressed_size);
+      // A block that was torn by the crash does not decompress.
+      if (raw_size > LOG_BUFFER_SIZE ||
+          !disk_manager_->ReadLog(block.data(), compressed_size, offset_ + COMPRESSED_BLOCK_HEADER_SIZE) ||
+          !CompressionUtil::Decompress(block.data(), compressed_size, log_buffer_, raw_size)) {
+        break;
+      }
+      // A compressed block holds complete records only.
+      if (AnalyzeRecords(raw_size, &checkpoint_lsn) != raw_size) {
+        break;
+      }
+      consumed = COMPRESSED_BLOCK_HEADER_SIZE + compressed_size;
+    } else {
+      consumed = AnalyzeRecords(LOG_BUFFER_SIZE, &checkpoint_lsn);
+    }
+    // Nothing complete left to read.
+    if (consumed == 0) {
+      break;
+    }
+    offset_ += consumed;
+  }
+}
+
+int LogRecovery::AnalyzeRecords(int size, lsn_t *checkpoint_lsn) {
+  int pos = 0;
+  while (pos + LogRecord::HEADER_SIZE <= size) {
+    int32_t record_size;
+    memcpy(&record_size, log_buffer_ + pos, sizeof(int32_t));
+    // Either the end of the log, a compressed block, or a record that continues in the next read.
+    if (record_size <= 0 || pos + record_size > size) {
+      break;
+    }
+    LogRecord *log_record = &records_.emplace_back();
+    if (!DeserializeLogRecord(log_buffer_ + pos, log_record)) {
+      records_.pop_back();
+      break;
+    }
+    pos += record_size;
+
+    max_lsn_ = std::max(max_lsn_, log_record->lsn_);
+    lsn_mapping_[log_record->lsn_] = log_record;
+    switch (log_record->log_record_type_) {
+      case LogRecordType::COMMIT:
+      case LogRecordType::ABORT:
+        active_txn_.erase(log_record->txn_id_);
+        break;
+      case LogRecordType::BEGIN_CHECKPOINT:
+        *checkpoint_lsn = log_record->lsn_;
+        checkpoint_dirty_pages_.clear();
+        break;
+      case LogRecordType::CHECKPOINT_DIRTY_PAGES:
+        checkpoint_dirty_pages_.insert(checkpoint_dirty_pages_.end(), log_record->dirty_page_table_.begin(),
+                                       log_record->dirty_page_table_.end());
+        break;
+      case LogRecordType::END_CHECKPOINT:
+        checkpoint_dirty_pages_.insert(checkpoint_dirty_pages_.end(), log_record->dirty_page_table_.begin(),
+                                       log_record->dirty_page_table_.end());
+        if (*checkpoint_lsn != INVALID_LSN) {
+          ApplyCheckpoint(*checkpoint_lsn, checkpoint_dirty_pages_);
+        }
+        checkpoint_dirty_pages_.clear();
+        break;
+      case LogRecordType::INSERT:
+        page_records_[log_record->insert_rid_.GetPageId()].push_back(log_record);
+        active_txn_[log_record->txn_id_] = log_record->lsn_;
+        break;
+      case LogRecordType::MARKDELETE:
+      case LogRecordType::APPLYDELETE:
+      case LogRecordType::ROLLBACKDELETE:
+        page_records_[log_record->delete_rid_.GetPageId()].push_back(log_record);
+        active_txn_[log_record->txn_id_] = log_record->lsn_;
+        break;
+      case LogRecordType::UPDATE:
+      case LogRecordType::DELTA_UPDATE:
+        page_records_[log_record->update_rid_.GetPageId()].push_back(log_record);
+        active_txn_[log_record->txn_id_] = log_record->lsn_;
+        break;
+      case LogRecordType::NEWPAGE:
+        // The previous page gets linked to the new one.
+        page_records_[log_record->page_id_].push_back(log_record);
+        if (log_record->prev_page_id_ != INVALID_PAGE_ID) {
+          page_records_[log_record->prev_page_id_].push_back(log_record);
+        }
+        active_txn_[log_record->txn_id_] = log_record->lsn_;
+        break;
+      default:
+        active_txn_[log_record->txn_id_] = log_record->lsn_;
+        break;
+    }
+  }
+  return pos;
+}
+
+void LogRecovery::ApplyCheckpoint(lsn_t checkpoint_lsn,
+                                  const std::vector<std::pair<page_id_t, lsn_t>> &dirty_page_table) {
+  std::unordered_map<page_id_t, lsn_t> rec_lsns(dirty_page_table.begin(), dirty_page_table.end());
+  redo_lsn_ = checkpoint_lsn;
+  for (const auto &[page_id, rec_lsn] : dirty_page_table) {
+    redo_lsn_ = std::min(redo_lsn_, rec_lsn);
+  }
+  for (auto it = page_records_.begin(); it != page_records_.end();) {
+    // A page that was clean when the checkpoint began has everything logged before it on disk. Records written while
+    // the checkpoint was in progress are kept either way.
+    auto rec_lsn = rec_lsns.find(it->first);
+    lsn_t first_lsn = rec_lsn == rec_lsns.end() ? checkpoint_lsn : rec_lsn->second;
+    auto &records = it->second;
+    records.erase(records.begin(), std::find_if(records.begin(), records.end(), [&](LogRecord *log_record) {
+                    return log_record->lsn_ >= first_lsn;
+                  }));
+    it = records.empty() ? page_records_.erase(it) : std::next(it);
+  }
+}
+
+void LogRecovery::RedoPage(page_id_t page_id, const std::vector<LogRecord *> &records) {
+  Page *page = FetchPage(page_id);
+  auto *table_page = reinterpret_cast<TablePage *>(page);
+  bool is_dirty = false;
+  page->WLatch();
+  // A page that never reached the disk reads as zeros, so its LSN field would claim that LSN 0 was applied.
+  lsn_t page_lsn = std::all_of(page->GetData(), page->GetData() + PAGE_SIZE,
+                               [](char c) { return c == 0; })
+                       ? INVALID_LSN
+                       : page->GetLSN();
+  for (LogRecord *log_record : records) {
+    if (log_record->log_record_type_ == LogRecordType::NEWPAGE && log_record->page_id_ != page_id) {
+      // The link to the next page is not covered by the page LSN, but setting it again is harmless.
+      if (table_page->GetNextPageId() != log_record->page_id_) {
+        table_page->SetNextPageId(log_record->page_id_);
+        is_dirty = true;
+      }
+      continue;
+    }
+    // The page on disk already contains this change.
+    if (page_lsn >= log_record->lsn_) {
+      continue;
+    }
+    switch (log_record->log_record_type_) {
+      case LogRecordType::NEWPAGE:
+        table_page->Init(page_id, PAGE_SIZE, log_record->prev_page_id_, nullptr, nullptr);
+        break;
+      case LogRecordType::INSERT: {
+        RID rid;
+        table_page->InsertTuple(log_record->insert_tuple_, &rid, nullptr, nullptr, nullptr);
+        BUSTUB_ASSERT(rid == log_record->insert_rid_, "Redo must insert into the logged slot.");
+        break;
+      }
+      case LogRecordType::MARKDELETE:
+        table_page->MarkDelete(log_record->delete_rid_, nullptr, nullptr, nullptr);
+        break;
+      case LogRecordType::APPLYDELETE:
+        table_page->ApplyDelete(log_record->delete_rid_, nullptr, nullptr);
+        break;
+      case LogRecordType::ROLLBACKDELETE:
+        table_page->RollbackDelete(log_record->delete_rid_, nullptr, nullptr);
+        break;
+      case LogRecordType::UPDATE: {
+        Tuple old_tuple;
+        table_page->UpdateTuple(log_record->new_tuple_, &old_tuple, log_record->update_rid_, nullptr, nullptr,
+                                nullptr);
+        break;
+      }
+      case LogRecordType::DELTA_UPDATE: {
+        // Physiological redo: the page holds the old version, which the deltas turn into the new one.
+        Tuple old_tuple;
+        table_page->GetTuple(log_record->update_rid_, &old_tuple, nullptr, nullptr);
+        table_page->UpdateTuple(log_record->ApplyDeltas(old_tuple, true), &old_tuple, log_record->update_rid_, nullptr,
+                                nullptr, nullptr);
+        break;
+      }
+      default:
+        break;
+    }
+    page_lsn = log_record->lsn_;
+    table_page->SetLSN(page_lsn);
+    is_dirty = true;
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, is_dirty);
+}
+
+void LogRecovery::UndoPage(page_id_t page_id, const std::vector<LogRecord *> &records) {
+  Page *page = FetchPage(page_id);
+  auto *table_page = reinterpret_cast<TablePage *>(page);
+  bool is_dirty = false;
+  page->WLatch();
+  for (LogRecord *log_record : records) {
+    // The page was written out after this change was undone, by a recovery that crashed.
+    lsn_t undo_lsn = UndoLSN(log_record->lsn_);
+    if (page->GetLSN() >= undo_lsn) {
+      continue;
+    }
+    switch (log_record->log_record_type_) {
+      case LogRecordType::INSERT:
+        table_page->ApplyDelete(log_record->insert_rid_, nullptr, nullptr);
+        break;
+      case LogRecordType::MARKDELETE:
+        table_page->RollbackDelete(log_record->delete_rid_, nullptr, nullptr);
+        break;
+      case LogRecordType::APPLYDELETE: {
+        // Later records of the page refer to the tuple by its RID, so it goes back into the same slot.
+        bool restored = table_page->RestoreTuple(log_record->delete_tuple_, log_record->delete_rid_);
+        BUSTUB_ASSERT(restored, "Undo must restore a deleted tuple into its slot.");
+        break;
+      }
+      case LogRecordType::ROLLBACKDELETE:
+        table_page->MarkDelete(log_record->delete_rid_, nullptr, nullptr, nullptr);
+        break;
+      case LogRecordType::UPDATE: {
+        Tuple new_tuple;
+        table_page->UpdateTuple(log_record->old_tuple_, &new_tuple, log_record->update_rid_, nullptr, nullptr,
+                                nullptr);
+        break;
+      }
+      case LogRecordType::DELTA_UPDATE: {
+        Tuple new_tuple;
+        table_page->GetTuple(log_record->update_rid_, &new_tuple, nullptr, nullptr);
+        table_page->UpdateTuple(log_record->ApplyDeltas(new_tuple, false), &new_tuple, log_record->update_rid_,
+                                nullptr, nullptr, nullptr);
+        break;
+      }
+      default:
+        break;
+    }
+    table_page->SetLSN(undo_lsn);
+    is_dirty = true;
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, is_dirty);
+}
+
+Page *LogRecovery::FetchPage(page_id_t page_id) {
+  Page *page;
+  while ((page = buffer_pool_manager_->FetchPage(page_id)) == nullptr) {
+    std::this_thread::yield();
+  }
+  return page;
+}
+
+void LogRecovery::RunInParallel(size_t num_tasks, const std::function<void(size_t)> &task) {
+  std::atomic<size_t> next_task{0};
+  auto worker = [&] {
+    for (size_t i = next_task++; i < num_tasks; i = next_task++) {
+      task(i);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < std::min(num_workers_, num_tasks); i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
 
 }  // namespace bustub
@@ -56,13 +56,44 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
   }
   const LeafPage *leafPage = current_node.toLeafPage();
   auto index = leafPage->KeyIndex(key, comparator_);
-  if (index == -1) {
+  // KeyIndex returns the first key that is not less than key
+  if (index == -1 || comparator_(leafPage->KeyAt(index), key) != 0) {
     return false;
   }
   result->push_back(leafPage->GetItem(index).second);
   return true;
 }
 
+/*
+ * Batched point query. The keys must be sorted in increasing order, so every
+ * key up to the largest key of the current leaf page can only be in that leaf
+ * and the tree is only descended again for keys beyond it.
+ * results[i] receives the value associated with keys[i], if any.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                               Transaction *transaction) {
+  results->resize(keys.size());
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  size_t i = 0;
+  while (i < keys.size()) {
+    NodeWrapType leaf = findLeaf(keys[i]);
+    const LeafPage *leafPage = leaf.toLeafPage();
+    bool is_last_leaf = leafPage->GetNextPageId() == INVALID_PAGE_ID;
+    int size = leafPage->GetSize();
+    do {
+      auto index = leafPage->KeyIndex(keys[i], comparator_);
+      if (index != -1 && comparator_(leafPage->KeyAt(index), keys[i]) == 0) {
+        (*results)[i].push_back(leafPage->GetItem(index).second);
+      }
+      i++;
+    } while (i < keys.size() &&
+             (is_last_leaf || (size > 0 && comparator_(keys[i], leafPage->KeyAt(size - 1)) <= 0)));
+  }
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
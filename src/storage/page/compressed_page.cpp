@@ -0,0 +1,526 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page.cpp
+//
+// Identification: src/storage/page/compressed_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/compressed_page.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return value rounded up to a multiple of alignment */
+uint32_t AlignUp(uint32_t value, uint32_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+/** @return the largest code of a width */
+uint64_t MaxCode(uint8_t bit_width) { return bit_width == 64 ? ~uint64_t{0} : (uint64_t{1} << bit_width) - 1; }
+
+/** @return the code of a slot, read with one unaligned load unless codes are not packed */
+uint64_t ReadCode(const char *codes, uint8_t bit_width, uint32_t slot) {
+  uint64_t word;
+  if (bit_width == 64) {
+    memcpy(&word, codes + static_cast<uint64_t>(slot) * sizeof(uint64_t), sizeof(uint64_t));
+    return word;
+  }
+  uint64_t bit = static_cast<uint64_t>(slot) * bit_width;
+  memcpy(&word, codes + bit / 8, sizeof(uint64_t));
+  return (word >> (bit % 8)) & MaxCode(bit_width);
+}
+
+void WriteCode(char *codes, uint8_t bit_width, uint32_t slot, uint64_t code) {
+  if (bit_width == 64) {
+    memcpy(codes + static_cast<uint64_t>(slot) * sizeof(uint64_t), &code, sizeof(uint64_t));
+    return;
+  }
+  uint64_t bit = static_cast<uint64_t>(slot) * bit_width;
+  uint64_t word;
+  memcpy(&word, codes + bit / 8, sizeof(uint64_t));
+  uint64_t mask = MaxCode(bit_width) << (bit % 8);
+  word = (word & ~mask) | (code << (bit % 8));
+  memcpy(codes + bit / 8, &word, sizeof(uint64_t));
+}
+
+bool IsNullBit(const char *nulls, uint32_t slot) { return ((nulls[slot / 8] >> (slot % 8)) & 1) != 0; }
+
+void SetNullBit(char *nulls, uint32_t slot, bool is_null) {
+  auto bit = static_cast<char>(1 << (slot % 8));
+  nulls[slot / 8] = static_cast<char>(is_null ? nulls[slot / 8] | bit : nulls[slot / 8] & ~bit);
+}
+
+/** @return the value of an integer or BOOLEAN column as an int64_t */
+int64_t ToInteger(const Value &value) {
+  switch (value.GetTypeId()) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      return value.GetAs<int8_t>();
+    case TypeId::SMALLINT:
+      return value.GetAs<int16_t>();
+    case TypeId::INTEGER:
+      return value.GetAs<int32_t>();
+    default:
+      return value.GetAs<int64_t>();
+  }
+}
+
+/** @return the value of a type whose ToInteger() is integer */
+Value FromInteger(TypeId type, int64_t integer) {
+  switch (type) {
+    case TypeId::BOOLEAN:
+      return ValueFactory::GetBooleanValue(static_cast<int8_t>(integer));
+    case TypeId::TINYINT:
+      return ValueFactory::GetTinyIntValue(static_cast<int8_t>(integer));
+    case TypeId::SMALLINT:
+      return ValueFactory::GetSmallIntValue(static_cast<int16_t>(integer));
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(static_cast<int32_t>(integer));
+    default:
+      return ValueFactory::GetBigIntValue(integer);
+  }
+}
+
+/** Decodes the codes of some slots into values of type T, base + code. */
+template <typename T>
+void DecodeIntegers(const char *nulls, const char *codes, uint8_t bit_width, uint64_t base, const uint32_t *slots,
+                    size_t count, T null_value, char *out) {
+  for (size_t i = 0; i < count; i++) {
+    uint32_t slot = slots[i];
+    T value = IsNullBit(nulls, slot) ? null_value : static_cast<T>(base + ReadCode(codes, bit_width, slot));
+    memcpy(out + i * sizeof(T), &value, sizeof(T));
+  }
+}
+
+std::vector<Value> GetValues(const Tuple &tuple, const Schema *schema) {
+  std::vector<Value> values;
+  values.reserve(schema->GetColumnCount());
+  for (uint32_t col_idx = 0; col_idx < schema->GetColumnCount(); col_idx++) {
+    values.push_back(tuple.GetValue(schema, col_idx));
+  }
+  return values;
+}
+
+}  // namespace
+
+uint32_t CompressedPage::PlanEncoding(const Schema *schema, const std::vector<std::vector<Value>> &rows,
+                                      std::vector<ColumnHeader> *headers,
+                                      std::vector<std::vector<Value>> *dictionaries) {
+  uint32_t column_count = schema->GetColumnCount();
+  headers->assign(column_count, ColumnHeader{});
+  dictionaries->assign(column_count, {});
+  uint32_t dictionary_bytes = 0;
+  // A slot takes its state byte, and a null bit and a code per column.
+  uint64_t row_bits = 8;
+  for (uint32_t col_idx = 0; col_idx < column_count; col_idx++) {
+    ColumnHeader &header = (*headers)[col_idx];
+    uint64_t max_code = 0;
+    switch (schema->GetColumn(col_idx).GetType()) {
+      case TypeId::VARCHAR: {
+        std::vector<Value> &dictionary = (*dictionaries)[col_idx];
+        for (const auto &row : rows) {
+          if (!row[col_idx].IsNull()) {
+            dictionary.push_back(row[col_idx]);
+          }
+        }
+        std::sort(dictionary.begin(), dictionary.end(), [](const Value &lhs, const Value &rhs) {
+          return lhs.CompareLessThan(rhs) == CmpBool::CmpTrue;
+        });
+        auto end = std::unique(dictionary.begin(), dictionary.end(), [](const Value &lhs, const Value &rhs) {
+          return lhs.CompareEquals(rhs) == CmpBool::CmpTrue;
+        });
+        dictionary.erase(end, dictionary.end());
+        header.dictionary_size_ = dictionary.size();
+        max_code = dictionary.empty() ? 0 : dictionary.size() - 1;
+        for (const auto &value : dictionary) {
+          dictionary_bytes += 2 * sizeof(uint32_t) + value.GetLength();
+        }
+        break;
+      }
+      case TypeId::DECIMAL:
+        max_code = ~uint64_t{0};
+        break;
+      default: {
+        bool has_value = false;
+        int64_t min = 0;
+        int64_t max = 0;
+        for (const auto &row : rows) {
+          if (row[col_idx].IsNull()) {
+            continue;
+          }
+          int64_t integer = ToInteger(row[col_idx]);
+          min = has_value ? std::min(min, integer) : integer;
+          max = has_value ? std::max(max, integer) : integer;
+          has_value = true;
+        }
+        header.base_ = min;
+        max_code = static_cast<uint64_t>(max) - static_cast<uint64_t>(min);
+        break;
+      }
+    }
+    header.bit_width_ = max_code == 0 ? 0 : 64 - __builtin_clzll(max_code);
+    if (header.bit_width_ > MAX_PACKED_WIDTH) {
+      header.bit_width_ = 64;
+    }
+    row_bits += 1 + header.bit_width_;
+  }
+  // Every segment may need padding to be aligned, a byte to round up each of its arrays, and a word after its codes.
+  uint32_t fixed_size = SIZE_COMPRESSED_PAGE_HEADER + column_count * sizeof(ColumnHeader) + dictionary_bytes +
+                        (column_count + 1) * ALIGNMENT + column_count * (2 + sizeof(uint64_t));
+  if (fixed_size >= PAGE_SIZE) {
+    return 0;
+  }
+  return static_cast<uint32_t>((PAGE_SIZE - fixed_size) * 8 / row_bits);
+}
+
+bool CompressedPage::Encode(const Schema *schema, const std::vector<std::vector<Value>> &rows,
+                            const std::vector<SlotState> &states) {
+  std::vector<ColumnHeader> headers;
+  std::vector<std::vector<Value>> dictionaries;
+  uint32_t capacity = PlanEncoding(schema, rows, &headers, &dictionaries);
+  if (capacity < rows.size()) {
+    return false;
+  }
+  // The page ids and the LSN are kept, the rest is rewritten.
+  memset(GetData() + OFFSET_CAPACITY, 0, PAGE_SIZE - OFFSET_CAPACITY);
+  uint32_t column_count = schema->GetColumnCount();
+  SetCapacity(capacity);
+  SetTupleCount(rows.size());
+  memcpy(GetData() + OFFSET_COLUMN_COUNT, &column_count, sizeof(uint32_t));
+  uint32_t offset = AlignUp(SlotStatesOffset() + capacity, ALIGNMENT);
+  for (auto &header : headers) {
+    header.offset_ = offset;
+    uint64_t code_bytes = (static_cast<uint64_t>(capacity) * header.bit_width_ + 7) / 8 + sizeof(uint64_t);
+    offset = AlignUp(offset + (capacity + 7) / 8 + code_bytes, ALIGNMENT);
+  }
+  for (uint32_t col_idx = 0; col_idx < column_count; col_idx++) {
+    ColumnHeader &header = headers[col_idx];
+    header.dictionary_offset_ = offset;
+    offset += header.dictionary_size_ * sizeof(uint32_t);
+    for (uint32_t code = 0; code < header.dictionary_size_; code++) {
+      memcpy(GetData() + header.dictionary_offset_ + code * sizeof(uint32_t), &offset, sizeof(uint32_t));
+      dictionaries[col_idx][code].SerializeTo(GetData() + offset);
+      offset += sizeof(uint32_t) + dictionaries[col_idx][code].GetLength();
+    }
+    SetColumnHeader(col_idx, header);
+  }
+  BUSTUB_ASSERT(offset <= PAGE_SIZE, "The encoding was planned to fit in the page.");
+  for (uint32_t slot = 0; slot < rows.size(); slot++) {
+    SetSlotState(slot, states[slot]);
+    // Every value has a code, the frames and dictionaries being made of them.
+    WriteRow(schema, slot, rows[slot]);
+  }
+  return true;
+}
+
+bool CompressedPage::FitsInEmptyPage(const Tuple &tuple, const Schema *schema) {
+  std::vector<ColumnHeader> headers;
+  std::vector<std::vector<Value>> dictionaries;
+  return PlanEncoding(schema, {GetValues(tuple, schema)}, &headers, &dictionaries) >= 1;
+}
+
+void CompressedPage::Init(page_id_t page_id, page_id_t prev_page_id, const Schema *schema) {
+  memset(GetData(), 0, PAGE_SIZE);
+  memcpy(GetData(), &page_id, sizeof(page_id));
+  SetLSN(INVALID_LSN);
+  memcpy(GetData() + OFFSET_PREV_PAGE_ID, &prev_page_id, sizeof(page_id_t));
+  SetNextPageId(INVALID_PAGE_ID);
+  // An empty page always fits.
+  Encode(schema, {}, {});
+}
+
+uint32_t CompressedPage::SearchDictionary(const ColumnHeader &header, const Value &value, bool upper) {
+  uint32_t low = 0;
+  uint32_t high = header.dictionary_size_;
+  while (low < high) {
+    uint32_t mid = low + (high - low) / 2;
+    Value entry = Value::DeserializeFrom(GetDictionaryEntry(header, mid), TypeId::VARCHAR);
+    CmpBool before = upper ? entry.CompareLessThanEquals(value) : entry.CompareLessThan(value);
+    if (before == CmpBool::CmpTrue) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+bool CompressedPage::GetCode(const ColumnHeader &header, const Value &value, uint64_t *code) {
+  switch (value.GetTypeId()) {
+    case TypeId::VARCHAR: {
+      uint32_t idx = SearchDictionary(header, value, false);
+      if (idx == header.dictionary_size_ ||
+          Value::DeserializeFrom(GetDictionaryEntry(header, idx), TypeId::VARCHAR).CompareEquals(value) !=
+              CmpBool::CmpTrue) {
+        return false;
+      }
+      *code = idx;
+      return true;
+    }
+    case TypeId::DECIMAL: {
+      double decimal = value.GetAs<double>();
+      memcpy(code, &decimal, sizeof(double));
+      return true;
+    }
+    default: {
+      int64_t integer = ToInteger(value);
+      if (integer < header.base_) {
+        return false;
+      }
+      *code = static_cast<uint64_t>(integer) - static_cast<uint64_t>(header.base_);
+      return *code <= MaxCode(header.bit_width_);
+    }
+  }
+}
+
+bool CompressedPage::WriteRow(const Schema *schema, uint32_t slot, const std::vector<Value> &values) {
+  uint32_t column_count = schema->GetColumnCount();
+  std::vector<uint64_t> codes(column_count);
+  for (uint32_t col_idx = 0; col_idx < column_count; col_idx++) {
+    if (!values[col_idx].IsNull() && !GetCode(GetColumnHeader(col_idx), values[col_idx], &codes[col_idx])) {
+      return false;
+    }
+  }
+  for (uint32_t col_idx = 0; col_idx < column_count; col_idx++) {
+    ColumnHeader header = GetColumnHeader(col_idx);
+    SetNullBit(GetNulls(header), slot, values[col_idx].IsNull());
+    if (!values[col_idx].IsNull() && header.bit_width_ > 0) {
+      WriteCode(GetCodes(header), header.bit_width_, slot, codes[col_idx]);
+    }
+  }
+  return true;
+}
+
+void CompressedPage::DecodeRows(const Schema *schema, std::vector<std::vector<Value>> *rows,
+                                std::vector<SlotState> *states) {
+  uint32_t tuple_count = GetTupleCount();
+  rows->clear();
+  states->clear();
+  for (uint32_t slot = 0; slot < tuple_count; slot++) {
+    SlotState state = GetSlotState(slot);
+    states->push_back(state);
+    std::vector<Value> row;
+    for (uint32_t col_idx = 0; col_idx < schema->GetColumnCount(); col_idx++) {
+      // A freed slot keeps its number but not its values, which would only widen the frames.
+      row.push_back(state == SlotState::FREE ? ValueFactory::GetNullValueByType(schema->GetColumn(col_idx).GetType())
+                                             : GetValue(schema, slot, col_idx));
+    }
+    rows->push_back(std::move(row));
+  }
+}
+
+bool CompressedPage::InsertTuple(const Tuple &tuple, const Schema *schema, RID *rid) {
+  uint32_t slot = GetTupleCount();
+  std::vector<Value> values = GetValues(tuple, schema);
+  if (slot < GetCapacity() && WriteRow(schema, slot, values)) {
+    SetSlotState(slot, SlotState::LIVE);
+    SetTupleCount(slot + 1);
+  } else {
+    // The tuple is out of the frames or dictionaries of the page, which is encoded again with it.
+    std::vector<std::vector<Value>> rows;
+    std::vector<SlotState> states;
+    DecodeRows(schema, &rows, &states);
+    rows.push_back(std::move(values));
+    states.push_back(SlotState::LIVE);
+    if (!Encode(schema, rows, states)) {
+      return false;
+    }
+  }
+  rid->Set(GetTablePageId(), slot);
+  return true;
+}
+
+bool CompressedPage::MarkDelete(const RID &rid) {
+  if (!HasSlot(rid, SlotState::LIVE)) {
+    return false;
+  }
+  SetSlotState(rid.GetSlotNum(), SlotState::DELETED);
+  return true;
+}
+
+bool CompressedPage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid, const Schema *schema) {
+  if (!GetTuple(rid, schema, old_tuple)) {
+    return false;
+  }
+  std::vector<Value> values = GetValues(new_tuple, schema);
+  if (WriteRow(schema, rid.GetSlotNum(), values)) {
+    return true;
+  }
+  std::vector<std::vector<Value>> rows;
+  std::vector<SlotState> states;
+  DecodeRows(schema, &rows, &states);
+  rows[rid.GetSlotNum()] = std::move(values);
+  return Encode(schema, rows, states);
+}
+
+void CompressedPage::ApplyDelete(const RID &rid) {
+  BUSTUB_ASSERT(rid.GetSlotNum() < GetTupleCount(), "Cannot have more slots than tuples.");
+  SetSlotState(rid.GetSlotNum(), SlotState::FREE);
+}
+
+void CompressedPage::RollbackDelete(const RID &rid) {
+  BUSTUB_ASSERT(HasSlot(rid, SlotState::DELETED), "Only a deleted tuple can be rolled back.");
+  SetSlotState(rid.GetSlotNum(), SlotState::LIVE);
+}
+
+bool CompressedPage::GetTuple(const RID &rid, const Schema *schema, Tuple *tuple) {
+  if (!HasSlot(rid, SlotState::LIVE)) {
+    return false;
+  }
+  std::vector<Value> values;
+  values.reserve(schema->GetColumnCount());
+  for (uint32_t col_idx = 0; col_idx < schema->GetColumnCount(); col_idx++) {
+    values.push_back(GetValue(schema, rid.GetSlotNum(), col_idx));
+  }
+  // rid may be the rid of tuple itself, as in TableIterator, so it is read before tuple is overwritten.
+  Tuple result(values, schema);
+  result.rid_ = rid;
+  *tuple = std::move(result);
+  return true;
+}
+
+Value CompressedPage::GetValue(const Schema *schema, uint32_t slot, uint32_t col_idx) {
+  TypeId type = schema->GetColumn(col_idx).GetType();
+  ColumnHeader header = GetColumnHeader(col_idx);
+  if (IsNullBit(GetNulls(header), slot)) {
+    return ValueFactory::GetNullValueByType(type);
+  }
+  uint64_t code = ReadCode(GetCodes(header), header.bit_width_, slot);
+  switch (type) {
+    case TypeId::VARCHAR:
+      return Value::DeserializeFrom(GetDictionaryEntry(header, code), TypeId::VARCHAR);
+    case TypeId::DECIMAL: {
+      double decimal;
+      memcpy(&decimal, &code, sizeof(double));
+      return ValueFactory::GetDecimalValue(decimal);
+    }
+    default:
+      return FromInteger(type, static_cast<int64_t>(static_cast<uint64_t>(header.base_) + code));
+  }
+}
+
+void CompressedPage::DecodeFixed(const Schema *schema, uint32_t col_idx, const uint32_t *slots, size_t count,
+                                 char *out) {
+  ColumnHeader header = GetColumnHeader(col_idx);
+  const char *nulls = GetNulls(header);
+  const char *codes = GetCodes(header);
+  auto base = static_cast<uint64_t>(header.base_);
+  uint8_t bit_width = header.bit_width_;
+  switch (schema->GetColumn(col_idx).GetType()) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      DecodeIntegers<int8_t>(nulls, codes, bit_width, base, slots, count, BUSTUB_INT8_NULL, out);
+      break;
+    case TypeId::SMALLINT:
+      DecodeIntegers<int16_t>(nulls, codes, bit_width, base, slots, count, BUSTUB_INT16_NULL, out);
+      break;
+    case TypeId::INTEGER:
+      DecodeIntegers<int32_t>(nulls, codes, bit_width, base, slots, count, BUSTUB_INT32_NULL, out);
+      break;
+    case TypeId::DECIMAL: {
+      // The code of a DECIMAL is its bits, with a base of 0.
+      uint64_t null_bits;
+      memcpy(&null_bits, &BUSTUB_DECIMAL_NULL, sizeof(double));
+      DecodeIntegers<uint64_t>(nulls, codes, bit_width, 0, slots, count, null_bits, out);
+      break;
+    }
+    default:
+      DecodeIntegers<int64_t>(nulls, codes, bit_width, base, slots, count, BUSTUB_INT64_NULL, out);
+      break;
+  }
+}
+
+uint32_t CompressedPage::SelectRange(const Schema *schema, uint32_t col_idx, const Value *low, bool low_inclusive,
+                                     const Value *high, bool high_inclusive, uint32_t from, uint32_t to,
+                                     uint32_t *selection) {
+  ColumnHeader header = GetColumnHeader(col_idx);
+  // The range of values is turned into a range of codes, [low_code, high_code].
+  uint64_t low_code = 0;
+  uint64_t high_code = MaxCode(header.bit_width_);
+  if (schema->GetColumn(col_idx).GetType() == TypeId::VARCHAR) {
+    uint32_t begin = low == nullptr ? 0 : SearchDictionary(header, *low, !low_inclusive);
+    uint32_t end = high == nullptr ? header.dictionary_size_ : SearchDictionary(header, *high, high_inclusive);
+    if (begin >= end) {
+      return 0;
+    }
+    low_code = begin;
+    high_code = end - 1;
+  } else {
+    if (low != nullptr) {
+      int64_t bound = ToInteger(*low);
+      if (!low_inclusive) {
+        if (bound == std::numeric_limits<int64_t>::max()) {
+          return 0;
+        }
+        bound++;
+      }
+      if (bound > header.base_) {
+        low_code = static_cast<uint64_t>(bound) - static_cast<uint64_t>(header.base_);
+      }
+    }
+    if (high != nullptr) {
+      int64_t bound = ToInteger(*high);
+      if (!high_inclusive) {
+        if (bound == std::numeric_limits<int64_t>::min()) {
+          return 0;
+        }
+        bound--;
+      }
+      if (bound < header.base_) {
+        return 0;
+      }
+      high_code = std::min(high_code, static_cast<uint64_t>(bound) - static_cast<uint64_t>(header.base_));
+    }
+    if (low_code > high_code) {
+      return 0;
+    }
+  }
+  const char *nulls = GetNulls(header);
+  const char *codes = GetCodes(header);
+  uint64_t code_span = high_code - low_code;
+  uint32_t count = 0;
+  for (uint32_t slot = from; slot < to; slot++) {
+    // Codes are compared as unsigned offsets from low_code, one comparison per slot; every slot is written and only
+    // the selected ones are counted.
+    selection[count] = slot;
+    count += static_cast<uint32_t>(IsLive(slot) && !IsNullBit(nulls, slot) &&
+                                   ReadCode(codes, header.bit_width_, slot) - low_code <= code_span);
+  }
+  return count;
+}
+
+bool CompressedPage::GetFirstTupleRid(RID *first_rid) {
+  for (uint32_t slot = 0; slot < GetTupleCount(); slot++) {
+    if (IsLive(slot)) {
+      first_rid->Set(GetTablePageId(), slot);
+      return true;
+    }
+  }
+  first_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+bool CompressedPage::GetNextTupleRid(const RID &cur_rid, RID *next_rid) {
+  BUSTUB_ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
+  for (uint32_t slot = cur_rid.GetSlotNum() + 1; slot < GetTupleCount(); slot++) {
+    if (IsLive(slot)) {
+      next_rid->Set(GetTablePageId(), slot);
+      return true;
+    }
+  }
+  next_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+}  // namespace bustub
@@ -0,0 +1,185 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.cpp
+//
+// Identification: src/storage/page/pax_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/pax_page.h"
+
+#include <utility>
+
+#include "type/limits.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return value rounded up to a multiple of alignment */
+uint32_t AlignUp(uint32_t value, uint32_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+}  // namespace
+
+uint32_t PaxPage::Capacity(const Schema *schema) {
+  uint32_t row_size = 1;
+  for (const auto &column : schema->GetColumns()) {
+    row_size += ValueWidth(column) + (column.IsInlined() ? 0 : VARLEN_RESERVE);
+  }
+  // Every minipage may need padding to be aligned.
+  uint32_t padding = (schema->GetColumnCount() + 1) * ALIGNMENT;
+  return (PAGE_SIZE - SIZE_PAX_PAGE_HEADER - padding) / row_size;
+}
+
+uint32_t PaxPage::VarlenSize(const Tuple &tuple, const Schema *schema) {
+  uint32_t size = 0;
+  for (uint32_t col_idx : schema->GetUnlinedColumns()) {
+    Value value = tuple.GetValue(schema, col_idx);
+    size += sizeof(uint32_t) + (value.IsNull() ? 0 : value.GetLength());
+  }
+  return size;
+}
+
+bool PaxPage::FitsInEmptyPage(const Tuple &tuple, const Schema *schema) {
+  uint32_t capacity = Capacity(schema);
+  return VarlenSize(tuple, schema) <= PAGE_SIZE - MinipageOffset(schema, capacity, schema->GetColumnCount());
+}
+
+uint32_t PaxPage::MinipageOffset(const Schema *schema, uint32_t capacity, uint32_t col_idx) {
+  uint32_t offset = AlignUp(SIZE_PAX_PAGE_HEADER + capacity, ALIGNMENT);
+  for (uint32_t i = 0; i < col_idx; i++) {
+    offset = AlignUp(offset + capacity * ValueWidth(schema->GetColumn(i)), ALIGNMENT);
+  }
+  return offset;
+}
+
+void PaxPage::Init(page_id_t page_id, page_id_t prev_page_id, const Schema *schema) {
+  memset(GetData(), 0, PAGE_SIZE);
+  memcpy(GetData(), &page_id, sizeof(page_id));
+  SetLSN(INVALID_LSN);
+  memcpy(GetData() + OFFSET_PREV_PAGE_ID, &prev_page_id, sizeof(page_id_t));
+  SetNextPageId(INVALID_PAGE_ID);
+  uint32_t capacity = Capacity(schema);
+  memcpy(GetData() + OFFSET_CAPACITY, &capacity, sizeof(uint32_t));
+  SetTupleCount(0);
+  SetFreeSpacePointer(PAGE_SIZE);
+}
+
+bool PaxPage::InsertTuple(const Tuple &tuple, const Schema *schema, RID *rid) {
+  uint32_t slot = GetTupleCount();
+  if (slot == GetCapacity()) {
+    return false;
+  }
+  uint32_t varlen_size = VarlenSize(tuple, schema);
+  if (GetFreeSpacePointer() - varlen_size < MinipageOffset(schema, schema->GetColumnCount())) {
+    return false;
+  }
+  WriteTuple(tuple, schema, slot, varlen_size);
+  SetSlotState(slot, SlotState::LIVE);
+  SetTupleCount(slot + 1);
+  rid->Set(GetTablePageId(), slot);
+  return true;
+}
+
+void PaxPage::WriteTuple(const Tuple &tuple, const Schema *schema, uint32_t slot, uint32_t varlen_size) {
+  uint32_t payload_offset = GetFreeSpacePointer() - varlen_size;
+  SetFreeSpacePointer(payload_offset);
+  for (uint32_t col_idx = 0; col_idx < schema->GetColumnCount(); col_idx++) {
+    const Column &column = schema->GetColumn(col_idx);
+    char *value_data = GetData() + MinipageOffset(schema, col_idx) + slot * ValueWidth(column);
+    Value value = tuple.GetValue(schema, col_idx);
+    if (column.IsInlined()) {
+      value.SerializeTo(value_data);
+      continue;
+    }
+    memcpy(value_data, &payload_offset, sizeof(uint32_t));
+    value.SerializeTo(GetData() + payload_offset);
+    payload_offset += sizeof(uint32_t) + (value.IsNull() ? 0 : value.GetLength());
+  }
+}
+
+bool PaxPage::MarkDelete(const RID &rid) {
+  if (!HasSlot(rid, SlotState::LIVE)) {
+    return false;
+  }
+  SetSlotState(rid.GetSlotNum(), SlotState::DELETED);
+  return true;
+}
+
+bool PaxPage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid, const Schema *schema) {
+  if (!HasSlot(rid, SlotState::LIVE)) {
+    return false;
+  }
+  // The new payloads are written next to the old ones, which are not reclaimed.
+  uint32_t varlen_size = VarlenSize(new_tuple, schema);
+  if (GetFreeSpacePointer() - varlen_size < MinipageOffset(schema, schema->GetColumnCount())) {
+    return false;
+  }
+  GetTuple(rid, schema, old_tuple);
+  WriteTuple(new_tuple, schema, rid.GetSlotNum(), varlen_size);
+  return true;
+}
+
+void PaxPage::ApplyDelete(const RID &rid) {
+  BUSTUB_ASSERT(rid.GetSlotNum() < GetTupleCount(), "Cannot have more slots than tuples.");
+  SetSlotState(rid.GetSlotNum(), SlotState::FREE);
+}
+
+void PaxPage::RollbackDelete(const RID &rid) {
+  BUSTUB_ASSERT(HasSlot(rid, SlotState::DELETED), "Only a deleted tuple can be rolled back.");
+  SetSlotState(rid.GetSlotNum(), SlotState::LIVE);
+}
+
+bool PaxPage::GetTuple(const RID &rid, const Schema *schema, Tuple *tuple) {
+  if (!HasSlot(rid, SlotState::LIVE)) {
+    return false;
+  }
+  std::vector<Value> values;
+  values.reserve(schema->GetColumnCount());
+  for (uint32_t col_idx = 0; col_idx < schema->GetColumnCount(); col_idx++) {
+    values.push_back(GetValue(schema, rid.GetSlotNum(), col_idx));
+  }
+  // rid may be the rid of tuple itself, as in TableIterator, so it is read before tuple is overwritten.
+  Tuple result(values, schema);
+  result.rid_ = rid;
+  *tuple = std::move(result);
+  return true;
+}
+
+Value PaxPage::GetValue(const Schema *schema, uint32_t slot, uint32_t col_idx) {
+  const Column &column = schema->GetColumn(col_idx);
+  const char *value_data = GetData() + MinipageOffset(schema, col_idx) + slot * ValueWidth(column);
+  if (column.IsInlined()) {
+    return Value::DeserializeFrom(value_data, column.GetType());
+  }
+  return Value::DeserializeFrom(GetData() + *reinterpret_cast<const uint32_t *>(value_data), column.GetType());
+}
+
+bool PaxPage::GetFirstTupleRid(RID *first_rid) {
+  for (uint32_t slot = 0; slot < GetTupleCount(); slot++) {
+    if (IsLive(slot)) {
+      first_rid->Set(GetTablePageId(), slot);
+      return true;
+    }
+  }
+  first_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+bool PaxPage::GetNextTupleRid(const RID &cur_rid, RID *next_rid) {
+  BUSTUB_ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
+  for (uint32_t slot = cur_rid.GetSlotNum() + 1; slot < GetTupleCount(); slot++) {
+    if (IsLive(slot)) {
+      next_rid->Set(GetTablePageId(), slot);
+      return true;
+    }
+  }
+  next_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+}  // namespace bustub
@@ -171,7 +171,9 @@ bool TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID
     } else if (!txn->IsExclusiveLocked(rid) && !lock_manager->LockExclusive(txn, rid)) {
       return false;
     }
-    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::UPDATE, rid, *old_tuple, new_tuple);
+    // Only the changed bytes are logged, unless logging both tuples is smaller.
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::DELTA_UPDATE, rid, *old_tuple,
+                         new_tuple);
     lsn_t lsn = log_manager->AppendLogRecord(&log_record);
     SetLSN(lsn);
     txn->SetPrevLSN(lsn);
@@ -265,7 +267,43 @@ void TablePage::RollbackDelete(const RID &rid, Transaction *txn, LogManager *log
   }
 }
 
+bool TablePage::RestoreTuple(const Tuple &tuple, const RID &rid) {
+  BUSTUB_ASSERT(tuple.size_ > 0, "Cannot have empty tuples.");
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num < GetTupleCount() && GetTupleSize(slot_num) != 0) {
+    return false;
+  }
+  // Slots past the tuple count are claimed along with the tuple's slot, and stay empty.
+  uint32_t new_slots = slot_num < GetTupleCount() ? 0 : slot_num + 1 - GetTupleCount();
+  if (GetFreeSpaceRemaining() < tuple.size_ + new_slots * SIZE_TUPLE) {
+    return false;
+  }
+  for (uint32_t i = GetTupleCount(); i < slot_num; i++) {
+    SetTupleOffsetAtSlot(i, 0);
+    SetTupleSize(i, 0);
+  }
+  SetTupleCount(GetTupleCount() + new_slots);
+
+  SetFreeSpacePointer(GetFreeSpacePointer() - tuple.size_);
+  memcpy(GetData() + GetFreeSpacePointer(), tuple.data_, tuple.size_);
+  SetTupleOffsetAtSlot(slot_num, GetFreeSpacePointer());
+  SetTupleSize(slot_num, tuple.size_);
+  return true;
+}
+
 bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) {
+  if (!GetTupleView(rid, tuple, txn, lock_manager)) {
+    return false;
+  }
+  // Copy the tuple data into our result.
+  char *data = new char[tuple->size_];
+  memcpy(data, tuple->data_, tuple->size_);
+  tuple->data_ = data;
+  tuple->allocated_ = true;
+  return true;
+}
+
+bool TablePage::GetTupleView(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) {
   // Get the current slot number.
   uint32_t slot_num = rid.GetSlotNum();
   // If somehow we have more slots than tuples, abort the transaction.
@@ -292,16 +330,15 @@ bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
     }
   }
 
-  // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result.
+  // At this point, we have at least a shared lock on the RID. Point our result at the tuple data.
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
   tuple->size_ = tuple_size;
   if (tuple->allocated_) {
     delete[] tuple->data_;
   }
-  tuple->data_ = new char[tuple->size_];
-  memcpy(tuple->data_, GetData() + tuple_offset, tuple->size_);
+  tuple->data_ = GetData() + tuple_offset;
   tuple->rid_ = rid;
-  tuple->allocated_ = true;
+  tuple->allocated_ = false;
   return true;
 }
 
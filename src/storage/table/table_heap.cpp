@@ -18,25 +18,55 @@
 namespace bustub {
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     page_id_t first_page_id)
+                     page_id_t first_page_id, TableLayout layout, const Schema *schema)
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id),
+      layout_(layout) {
+  BUSTUB_ASSERT(layout_ == TableLayout::ROW || schema != nullptr, "A columnar table needs its schema.");
+  if (schema != nullptr) {
+    schema_ = std::make_unique<Schema>(*schema);
+  }
+}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     Transaction *txn)
-    : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager), log_manager_(log_manager) {
+                     Transaction *txn, TableLayout layout, const Schema *schema)
+    : buffer_pool_manager_(buffer_pool_manager),
+      lock_manager_(lock_manager),
+      log_manager_(log_manager),
+      layout_(layout) {
   // Initialize the first table page.
-  auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(&first_page_id_));
+  Page *first_page = buffer_pool_manager_->NewPage(&first_page_id_);
   BUSTUB_ASSERT(first_page != nullptr, "Couldn't create a page for the table heap.");
+  BUSTUB_ASSERT(layout_ == TableLayout::ROW || schema != nullptr, "A columnar table needs its schema.");
+  if (schema != nullptr) {
+    schema_ = std::make_unique<Schema>(*schema);
+  }
   first_page->WLatch();
-  first_page->Init(first_page_id_, PAGE_SIZE, INVALID_LSN, log_manager_, txn);
+  switch (layout_) {
+    case TableLayout::PAX:
+      static_cast<PaxPage *>(first_page)->Init(first_page_id_, INVALID_PAGE_ID, schema_.get());
+      break;
+    case TableLayout::COMPRESSED:
+      static_cast<CompressedPage *>(first_page)->Init(first_page_id_, INVALID_PAGE_ID, schema_.get());
+      break;
+    default:
+      static_cast<TablePage *>(first_page)->Init(first_page_id_, PAGE_SIZE, INVALID_LSN, log_manager_, txn);
+  }
   first_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  page_directory_.push_back(first_page_id_);
+  CreateZoneMap(first_page_id_);
 }
 
 bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
+  if (layout_ == TableLayout::PAX) {
+    return InsertColumnarTuple<PaxPage>(tuple, rid, txn);
+  }
+  if (layout_ == TableLayout::COMPRESSED) {
+    return InsertColumnarTuple<CompressedPage>(tuple, rid, txn);
+  }
   if (tuple.size_ + 32 > PAGE_SIZE) {  // larger than one page size
     txn->SetState(TransactionState::ABORTED);
     return false;
@@ -76,11 +106,14 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
       new_page->WLatch();
       cur_page->SetNextPageId(next_page_id);
       new_page->Init(next_page_id, PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
+      AppendToDirectory(cur_page->GetTablePageId(), next_page_id);
+      CreateZoneMap(next_page_id);
       cur_page->WUnlatch();
       buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
       cur_page = new_page;
     }
   }
+  UpdateZoneMap(cur_page->GetTablePageId(), tuple);
   // This line has caused most of us to double-take and "whoa double unlatch".
   // We are not, in fact, double unlatching. See the invariant above.
   cur_page->WUnlatch();
@@ -90,6 +123,54 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
   return true;
 }
 
+template <typename PageType>
+bool TableHeap::InsertColumnarTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
+  if (!PageType::FitsInEmptyPage(tuple, schema_.get())) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  // Slots are never reused, so only the last page can have room.
+  page_id_t page_id = GetPageIds().back();
+  auto cur_page = static_cast<PageType *>(buffer_pool_manager_->FetchPage(page_id));
+  if (cur_page == nullptr) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  cur_page->WLatch();
+  // INVARIANT: cur_page is WLatched if you leave the loop normally, as in InsertTuple().
+  while (!cur_page->InsertTuple(tuple, schema_.get(), rid)) {
+    auto next_page_id = cur_page->GetNextPageId();
+    if (next_page_id != INVALID_PAGE_ID) {
+      // Another insert appended a page since the directory was read.
+      cur_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
+      cur_page = static_cast<PageType *>(buffer_pool_manager_->FetchPage(next_page_id));
+      cur_page->WLatch();
+      continue;
+    }
+    auto new_page = static_cast<PageType *>(buffer_pool_manager_->NewPage(&next_page_id));
+    if (new_page == nullptr) {
+      cur_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    new_page->WLatch();
+    cur_page->SetNextPageId(next_page_id);
+    new_page->Init(next_page_id, cur_page->GetTablePageId(), schema_.get());
+    AppendToDirectory(cur_page->GetTablePageId(), next_page_id);
+    CreateZoneMap(next_page_id);
+    cur_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
+    cur_page = new_page;
+  }
+  UpdateZoneMap(cur_page->GetTablePageId(), tuple);
+  cur_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
+  txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
+  return true;
+}
+
 bool TableHeap::MarkDelete(const RID &rid, Transaction *txn) {
   // TODO(Amadou): remove empty page
   // Find the page which contains the tuple.
@@ -101,7 +182,16 @@ bool TableHeap::MarkDelete(const RID &rid, Transaction *txn) {
   }
   // Otherwise, mark the tuple as deleted.
   page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  switch (layout_) {
+    case TableLayout::PAX:
+      reinterpret_cast<PaxPage *>(page)->MarkDelete(rid);
+      break;
+    case TableLayout::COMPRESSED:
+      reinterpret_cast<CompressedPage *>(page)->MarkDelete(rid);
+      break;
+    default:
+      page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  }
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
   // Update the transaction's write set.
@@ -120,7 +210,20 @@ bool TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn
   // Update the tuple; but first save the old value for rollbacks.
   Tuple old_tuple;
   page->WLatch();
-  bool is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  bool is_updated;
+  switch (layout_) {
+    case TableLayout::PAX:
+      is_updated = reinterpret_cast<PaxPage *>(page)->UpdateTuple(tuple, &old_tuple, rid, schema_.get());
+      break;
+    case TableLayout::COMPRESSED:
+      is_updated = reinterpret_cast<CompressedPage *>(page)->UpdateTuple(tuple, &old_tuple, rid, schema_.get());
+      break;
+    default:
+      is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  }
+  if (is_updated) {
+    UpdateZoneMap(rid.GetPageId(), tuple);
+  }
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
   // Update the transaction's write set.
@@ -136,7 +239,16 @@ void TableHeap::ApplyDelete(const RID &rid, Transaction *txn) {
   BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
   // Delete the tuple from the page.
   page->WLatch();
-  page->ApplyDelete(rid, txn, log_manager_);
+  switch (layout_) {
+    case TableLayout::PAX:
+      reinterpret_cast<PaxPage *>(page)->ApplyDelete(rid);
+      break;
+    case TableLayout::COMPRESSED:
+      reinterpret_cast<CompressedPage *>(page)->ApplyDelete(rid);
+      break;
+    default:
+      page->ApplyDelete(rid, txn, log_manager_);
+  }
   lock_manager_->Unlock(txn, rid);
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
@@ -148,7 +260,16 @@ void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
   BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
   // Rollback the delete.
   page->WLatch();
-  page->RollbackDelete(rid, txn, log_manager_);
+  switch (layout_) {
+    case TableLayout::PAX:
+      reinterpret_cast<PaxPage *>(page)->RollbackDelete(rid);
+      break;
+    case TableLayout::COMPRESSED:
+      reinterpret_cast<CompressedPage *>(page)->RollbackDelete(rid);
+      break;
+    default:
+      page->RollbackDelete(rid, txn, log_manager_);
+  }
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
 }
@@ -163,7 +284,17 @@ bool TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn) {
   }
   // Read the tuple from the page.
   page->RLatch();
-  bool res = page->GetTuple(rid, tuple, txn, lock_manager_);
+  bool res;
+  switch (layout_) {
+    case TableLayout::PAX:
+      res = reinterpret_cast<PaxPage *>(page)->GetTuple(rid, schema_.get(), tuple);
+      break;
+    case TableLayout::COMPRESSED:
+      res = reinterpret_cast<CompressedPage *>(page)->GetTuple(rid, schema_.get(), tuple);
+      break;
+    default:
+      res = page->GetTuple(rid, tuple, txn, lock_manager_);
+  }
   page->RUnlatch();
   buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
   return res;
@@ -178,7 +309,7 @@ TableIterator TableHeap::Begin(Transaction *txn) {
     auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
     page->RLatch();
     // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
-    auto found_tuple = page->GetFirstTupleRid(&rid);
+    auto found_tuple = GetFirstTupleRid(page, &rid);
     page->RUnlatch();
     buffer_pool_manager_->UnpinPage(page_id, false);
     if (found_tuple) {
@@ -189,6 +320,79 @@ TableIterator TableHeap::Begin(Transaction *txn) {
   return TableIterator(this, rid, txn);
 }
 
+bool TableHeap::GetFirstTupleRid(TablePage *page, RID *first_rid) {
+  switch (layout_) {
+    case TableLayout::PAX:
+      return reinterpret_cast<PaxPage *>(page)->GetFirstTupleRid(first_rid);
+    case TableLayout::COMPRESSED:
+      return reinterpret_cast<CompressedPage *>(page)->GetFirstTupleRid(first_rid);
+    default:
+      return page->GetFirstTupleRid(first_rid);
+  }
+}
+
+bool TableHeap::GetNextTupleRid(TablePage *page, const RID &cur_rid, RID *next_rid) {
+  switch (layout_) {
+    case TableLayout::PAX:
+      return reinterpret_cast<PaxPage *>(page)->GetNextTupleRid(cur_rid, next_rid);
+    case TableLayout::COMPRESSED:
+      return reinterpret_cast<CompressedPage *>(page)->GetNextTupleRid(cur_rid, next_rid);
+    default:
+      return page->GetNextTupleRid(cur_rid, next_rid);
+  }
+}
+
+bool TableHeap::GetColumnRange(page_id_t page_id, uint32_t col_idx, Value *min, Value *max) {
+  std::lock_guard<std::mutex> guard(zone_map_latch_);
+  auto it = zone_maps_.find(page_id);
+  if (it == zone_maps_.end()) {
+    return false;
+  }
+  *min = it->second.GetMin(col_idx);
+  *max = it->second.GetMax(col_idx);
+  return true;
+}
+
+void TableHeap::CreateZoneMap(page_id_t page_id) {
+  if (schema_ == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(zone_map_latch_);
+  zone_maps_.emplace(page_id, ZoneMap(schema_.get()));
+}
+
+void TableHeap::UpdateZoneMap(page_id_t page_id, const Tuple &tuple) {
+  std::lock_guard<std::mutex> guard(zone_map_latch_);
+  auto it = zone_maps_.find(page_id);
+  if (it != zone_maps_.end()) {
+    it->second.Update(tuple, schema_.get());
+  }
+}
+
 TableIterator TableHeap::End() { return TableIterator(this, RID(INVALID_PAGE_ID, 0), nullptr); }
 
+std::vector<page_id_t> TableHeap::GetPageIds() {
+  std::lock_guard<std::mutex> guard(directory_latch_);
+  if (page_directory_.empty()) {
+    for (page_id_t page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+      page_directory_.push_back(page_id);
+      auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+      BUSTUB_ASSERT(page != nullptr, "Couldn't fetch a page of the table heap.");
+      page->RLatch();
+      page_id_t next_page_id = page->GetNextPageId();
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+  }
+  return page_directory_;
+}
+
+void TableHeap::AppendToDirectory(page_id_t prev_page_id, page_id_t page_id) {
+  std::lock_guard<std::mutex> guard(directory_latch_);
+  if (!page_directory_.empty() && page_directory_.back() == prev_page_id) {
+    page_directory_.push_back(page_id);
+  }
+}
+
 }  // namespace bustub
@@ -39,16 +39,16 @@ TableIterator &TableIterator::operator++() {
   cur_page->RLatch();
   assert(cur_page != nullptr);  // all pages are pinned
 
+  // Every layout has the next page id where a TablePage has it, only the slots differ.
   RID next_tuple_rid;
-  if (!cur_page->GetNextTupleRid(tuple_->rid_,
-                                 &next_tuple_rid)) {  // end of this page
+  if (!table_heap_->GetNextTupleRid(cur_page, tuple_->rid_, &next_tuple_rid)) {  // end of this page
     while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
       auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
       cur_page->RUnlatch();
       buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
       cur_page = next_page;
       cur_page->RLatch();
-      if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
+      if (table_heap_->GetFirstTupleRid(cur_page, &next_tuple_rid)) {
         break;
       }
     }
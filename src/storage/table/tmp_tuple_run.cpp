@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_run.cpp
+//
+// Identification: src/storage/table/tmp_tuple_run.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tmp_tuple_run.h"
+
+#include <algorithm>
+#include <string>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+bool TmpTupleRun::Append(const Tuple &tuple) {
+  // Spilled tuples are not split across pages.
+  if (tuple.GetLength() > TmpTuplePage::MaxTupleLength(PAGE_SIZE)) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "Cannot spill a tuple of " + std::to_string(tuple.GetLength()) +
+                                                     " bytes: it does not fit in a page.");
+  }
+  TmpTuple out(INVALID_PAGE_ID, 0);
+  if (append_page_ == nullptr || !append_page_->Insert(tuple, &out)) {
+    FinishAppend();
+    page_id_t page_id;
+    append_page_ = reinterpret_cast<TmpTuplePage *>(bpm_->NewPage(&page_id));
+    if (append_page_ == nullptr) {
+      return false;
+    }
+    append_page_->Init(page_id, PAGE_SIZE);
+    page_ids_.push_back(page_id);
+    if (!append_page_->Insert(tuple, &out)) {
+      return false;
+    }
+  }
+  tuple_count_++;
+  size_ += tuple.GetLength();
+  return true;
+}
+
+void TmpTupleRun::FinishAppend() {
+  if (append_page_ != nullptr) {
+    bpm_->UnpinPage(append_page_->GetTablePageId(), true);
+    append_page_ = nullptr;
+  }
+}
+
+bool TmpTupleRun::Next(Tuple *tuple) {
+  while (read_page_ == nullptr || read_offset_idx_ == read_offsets_.size()) {
+    if (read_page_ != nullptr) {
+      bpm_->UnpinPage(read_page_->GetTablePageId(), false);
+      read_page_ = nullptr;
+      read_page_idx_++;
+    }
+    if (read_page_idx_ == page_ids_.size()) {
+      return false;
+    }
+    read_page_ = reinterpret_cast<TmpTuplePage *>(bpm_->FetchPage(page_ids_[read_page_idx_]));
+    BUSTUB_ASSERT(read_page_ != nullptr, "Out of buffer pool frames while reading a spilled run.");
+    // Entries are laid out from the end of the page backwards, so walk them forward and reverse.
+    read_offsets_.clear();
+    read_offset_idx_ = 0;
+    for (uint32_t offset = read_page_->GetFreeSpacePointer(); offset < PAGE_SIZE;
+         offset += read_page_->GetEntrySize(offset)) {
+      read_offsets_.push_back(offset);
+    }
+    std::reverse(read_offsets_.begin(), read_offsets_.end());
+  }
+  read_page_->Get(read_offsets_[read_offset_idx_++], tuple);
+  return true;
+}
+
+void TmpTupleRun::Rewind() {
+  if (read_page_ != nullptr) {
+    bpm_->UnpinPage(read_page_->GetTablePageId(), false);
+    read_page_ = nullptr;
+  }
+  read_page_idx_ = 0;
+  read_offsets_.clear();
+  read_offset_idx_ = 0;
+}
+
+void TmpTupleRun::Clear() {
+  FinishAppend();
+  Rewind();
+  for (auto page_id : page_ids_) {
+    bpm_->DeletePage(page_id);
+  }
+  page_ids_.clear();
+  tuple_count_ = 0;
+  size_ = 0;
+}
+
+}  // namespace bustub
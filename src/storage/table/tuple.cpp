@@ -17,73 +17,142 @@
 #include <vector>
 
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
-// TODO(Amadou): It does not look like nulls are supported. Add a null bitmap?
 Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true) {
   assert(values.size() == schema->GetColumnCount());
+  size_ = SerializedSize(values, schema);
+  data_ = new char[size_];
+  SerializeValues(values, schema);
+}
+
+Tuple::Tuple(const std::vector<Value> &values, const Schema *schema, Arena *arena) {
+  assert(values.size() == schema->GetColumnCount());
+  size_ = SerializedSize(values, schema);
+  data_ = arena->Allocate(size_);
+  SerializeValues(values, schema);
+}
 
-  // 1. Calculate the size of the tuple.
+Tuple::Tuple(uint32_t size, Arena *arena) : allocated_(arena == nullptr), size_(size) {
+  data_ = allocated_ ? new char[size_] : arena->Allocate(size_);
+}
+
+uint32_t Tuple::SerializedSize(const std::vector<Value> &values, const Schema *schema) {
   uint32_t tuple_size = schema->GetLength();
+  bool compact = !schema->HasFixedOffsets();
+  if (compact) {
+    // A null column takes no space at all.
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      if (values[i].IsNull()) {
+        tuple_size -= schema->GetColumn(i).GetFixedLength();
+      }
+    }
+  }
   for (auto &i : schema->GetUnlinedColumns()) {
-    tuple_size += (values[i].GetLength() + sizeof(uint32_t));
+    if (compact && values[i].IsNull()) {
+      continue;
+    }
+    // A null varchar is its length prefix only.
+    tuple_size += (values[i].IsNull() ? 0 : values[i].GetLength()) + sizeof(uint32_t);
   }
+  return tuple_size;
+}
 
-  // 2. Allocate memory.
-  size_ = tuple_size;
-  data_ = new char[size_];
+void Tuple::SerializeValues(const std::vector<Value> &values, const Schema *schema) {
   std::memset(data_, 0, size_);
-
-  // 3. Serialize each attribute based on the input value.
+  bool compact = !schema->HasFixedOffsets();
   uint32_t column_count = schema->GetColumnCount();
+  // The varchar payloads follow the fixed-size part, which a compact tuple shortens by its null columns.
   uint32_t offset = schema->GetLength();
+  if (schema->GetNullBitmapSize() > 0) {
+    for (uint32_t i = 0; i < column_count; i++) {
+      if (values[i].IsNull()) {
+        data_[i / 8] = static_cast<char>(data_[i / 8] | (1 << (i % 8)));
+        offset -= compact ? schema->GetColumn(i).GetFixedLength() : 0;
+      }
+    }
+  }
 
+  uint32_t compact_offset = schema->GetNullBitmapSize();
   for (uint32_t i = 0; i < column_count; i++) {
     const auto &col = schema->GetColumn(i);
+    uint32_t col_offset = col.GetOffset();
+    if (compact) {
+      if (values[i].IsNull()) {
+        continue;
+      }
+      col_offset = compact_offset;
+      compact_offset += col.GetFixedLength();
+    }
     if (!col.IsInlined()) {
       // Serialize relative offset, where the actual varchar data is stored.
-      *reinterpret_cast<uint32_t *>(data_ + col.GetOffset()) = offset;
+      *reinterpret_cast<uint32_t *>(data_ + col_offset) = offset;
       // Serialize varchar value, in place (size+data).
       values[i].SerializeTo(data_ + offset);
-      offset += (values[i].GetLength() + sizeof(uint32_t));
+      offset += (values[i].IsNull() ? 0 : values[i].GetLength()) + sizeof(uint32_t);
     } else {
-      values[i].SerializeTo(data_ + col.GetOffset());
+      values[i].SerializeTo(data_ + col_offset);
     }
   }
 }
 
-Tuple::Tuple(const Tuple &other) : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_) {
+Tuple::Tuple(const Tuple &other) : allocated_(other.data_ != nullptr), rid_(other.rid_), size_(other.size_) {
   if (allocated_) {
-    delete[] data_;
-  }
-  if (allocated_) {
-    // Deep copy.
+    // Deep copy, of a view too.
     data_ = new char[size_];
     memcpy(data_, other.data_, size_);
-  } else {
-    // Shallow copy.
-    data_ = other.data_;
   }
 }
 
+Tuple::Tuple(const Tuple &other, Arena *arena) : rid_(other.rid_), size_(other.size_) {
+  if (other.data_ != nullptr) {
+    data_ = arena->Allocate(size_);
+    memcpy(data_, other.data_, size_);
+  }
+}
+
+Tuple::Tuple(Tuple &&other) noexcept
+    : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_), data_(other.data_) {
+  other.allocated_ = false;
+  other.size_ = 0;
+  other.data_ = nullptr;
+}
+
 Tuple &Tuple::operator=(const Tuple &other) {
+  if (this == &other) {
+    return *this;
+  }
   if (allocated_) {
     delete[] data_;
   }
-  allocated_ = other.allocated_;
+  allocated_ = other.data_ != nullptr;
   rid_ = other.rid_;
   size_ = other.size_;
-
+  data_ = nullptr;
   if (allocated_) {
-    // Deep copy.
+    // Deep copy, of a view too.
     data_ = new char[size_];
     memcpy(data_, other.data_, size_);
-  } else {
-    // Shallow copy.
-    data_ = other.data_;
   }
+  return *this;
+}
 
+Tuple &Tuple::operator=(Tuple &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  if (allocated_) {
+    delete[] data_;
+  }
+  allocated_ = other.allocated_;
+  rid_ = other.rid_;
+  size_ = other.size_;
+  data_ = other.data_;
+  other.allocated_ = false;
+  other.size_ = 0;
+  other.data_ = nullptr;
   return *this;
 }
 
@@ -91,6 +160,9 @@ Value Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const {
   assert(schema);
   assert(data_);
   const TypeId column_type = schema->GetColumn(column_idx).GetType();
+  if (schema->GetNullBitmapSize() > 0 && IsNull(schema, column_idx)) {
+    return ValueFactory::GetNullValueByType(column_type);
+  }
   const char *data_ptr = GetDataPtr(schema, column_idx);
   // the third parameter "is_inlined" is unused
   return Value::DeserializeFrom(data_ptr, column_type);
@@ -109,13 +181,22 @@ const char *Tuple::GetDataPtr(const Schema *schema, const uint32_t column_idx) c
   assert(schema);
   assert(data_);
   const auto &col = schema->GetColumn(column_idx);
+  uint32_t col_offset = col.GetOffset();
+  if (!schema->HasFixedOffsets()) {
+    // The column is moved forward by the null columns before it.
+    for (uint32_t i = 0; i < column_idx; i++) {
+      if (IsNull(schema, i)) {
+        col_offset -= schema->GetColumn(i).GetFixedLength();
+      }
+    }
+  }
   bool is_inlined = col.IsInlined();
   // For inline type, data is stored where it is.
   if (is_inlined) {
-    return (data_ + col.GetOffset());
+    return (data_ + col_offset);
   }
   // We read the relative offset from the tuple data.
-  int32_t offset = *reinterpret_cast<int32_t *>(data_ + col.GetOffset());
+  int32_t offset = *reinterpret_cast<int32_t *>(data_ + col_offset);
   // And return the beginning address of the real data for the VARCHAR type.
   return (data_ + offset);
 }
@@ -0,0 +1,44 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.cpp
+//
+// Identification: src/storage/table/zone_map.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/zone_map.h"
+
+#include "type/value_factory.h"
+
+namespace bustub {
+
+ZoneMap::ZoneMap(const Schema *schema) {
+  for (const auto &column : schema->GetColumns()) {
+    min_.push_back(ValueFactory::GetNullValueByType(column.GetType()));
+    max_.push_back(ValueFactory::GetNullValueByType(column.GetType()));
+  }
+}
+
+void ZoneMap::Update(const Tuple &tuple, const Schema *schema) {
+  for (uint32_t col_idx = 0; col_idx < schema->GetColumnCount(); col_idx++) {
+    if (!schema->GetColumn(col_idx).IsInlined()) {
+      continue;
+    }
+    Value value = tuple.GetValue(schema, col_idx);
+    if (value.IsNull()) {
+      continue;
+    }
+    if (min_[col_idx].IsNull() || value.CompareLessThan(min_[col_idx]) == CmpBool::CmpTrue) {
+      min_[col_idx] = value;
+    }
+    if (max_[col_idx].IsNull() || value.CompareGreaterThan(max_[col_idx]) == CmpBool::CmpTrue) {
+      max_[col_idx] = value;
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena_test.cpp
+//
+// Identification: test/common/arena_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "common/arena.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ArenaTest, AllocateTest) {
+  Arena arena(1024);
+  // Allocations are aligned and do not overlap.
+  std::vector<char *> allocations;
+  for (size_t size = 1; size <= 100; size++) {
+    char *data = arena.Allocate(size);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % 8, 0);
+    std::memset(data, static_cast<int>(size), size);
+    allocations.push_back(data);
+  }
+  for (size_t size = 1; size <= 100; size++) {
+    for (size_t i = 0; i < size; i++) {
+      EXPECT_EQ(allocations[size - 1][i], static_cast<char>(size));
+    }
+  }
+  // An allocation larger than a chunk gets a chunk of its own.
+  size_t memory_usage = arena.GetMemoryUsage();
+  std::memset(arena.Allocate(4096), 0, 4096);
+  EXPECT_EQ(arena.GetMemoryUsage(), memory_usage + 4096);
+}
+
+// NOLINTNEXTLINE
+TEST(ArenaTest, ResetTest) {
+  Arena arena(1024);
+  char *first = arena.Allocate(16);
+  for (int i = 0; i < 100; i++) {
+    arena.Allocate(100);
+  }
+  size_t memory_usage = arena.GetMemoryUsage();
+
+  // The chunks are reused after a reset, from the first one.
+  for (int round = 0; round < 10; round++) {
+    arena.Reset();
+    EXPECT_EQ(arena.Allocate(16), first);
+    for (int i = 0; i < 100; i++) {
+      arena.Allocate(100);
+    }
+    EXPECT_EQ(arena.GetMemoryUsage(), memory_usage);
+  }
+}
+
+}  // namespace bustub
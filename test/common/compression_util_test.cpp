@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compression_util_test.cpp
+//
+// Identification: test/common/compression_util_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/util/compression_util.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/** Compresses input, checks the size bound, decompresses and compares. @return the compressed size */
+size_t RoundTrip(const std::string &input) {
+  std::vector<char> compressed(CompressionUtil::MaxCompressedSize(input.size()));
+  size_t compressed_size = CompressionUtil::Compress(input.data(), input.size(), compressed.data());
+  EXPECT_LE(compressed_size, compressed.size());
+  std::string output(input.size(), '\0');
+  EXPECT_TRUE(CompressionUtil::Decompress(compressed.data(), compressed_size, output.data(), output.size()));
+  EXPECT_EQ(input, output);
+  return compressed_size;
+}
+
+// NOLINTNEXTLINE
+TEST(CompressionUtilTest, RoundTripTest) {
+  RoundTrip("");
+  RoundTrip("abc");
+  RoundTrip(std::string(100000, 'x'));
+  RoundTrip(std::string(14, 'y') + std::string(300, 'z') + "end");
+
+  std::mt19937 generator(15445);
+  std::string random(100000, '\0');
+  for (auto &c : random) {
+    c = static_cast<char>(generator());
+  }
+  RoundTrip(random);
+
+  // Log-like data: records with a few changing fields compress well.
+  std::string records;
+  for (int i = 0; i < 5000; i++) {
+    records += "record header " + std::to_string(i) + " payload payload payload " + std::to_string(i % 7);
+  }
+  EXPECT_LT(RoundTrip(records), records.size() / 3);
+}
+
+// NOLINTNEXTLINE
+TEST(CompressionUtilTest, CorruptBlockTest) {
+  std::string input(1000, 'a');
+  std::vector<char> compressed(CompressionUtil::MaxCompressedSize(input.size()));
+  size_t compressed_size = CompressionUtil::Compress(input.data(), input.size(), compressed.data());
+  std::string output(input.size(), '\0');
+  // Truncated blocks and wrong sizes are reported instead of overrunning the output.
+  EXPECT_FALSE(CompressionUtil::Decompress(compressed.data(), compressed_size - 2, output.data(), output.size()));
+  EXPECT_FALSE(CompressionUtil::Decompress(compressed.data(), compressed_size, output.data(), output.size() - 1));
+}
+
+}  // namespace bustub
@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregate_sketch_test.cpp
+//
+// Identification: test/execution/aggregate_sketch_test.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "execution/aggregate_sketch.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/** @return a well mixed hash of i, the finalizer of MurmurHash3 */
+static uint64_t Mix(uint64_t i) {
+  i ^= i >> 33;
+  i *= 0xff51afd7ed558ccdULL;
+  i ^= i >> 33;
+  i *= 0xc4ceb9fe1a85ec53ULL;
+  i ^= i >> 33;
+  return i;
+}
+
+// NOLINTNEXTLINE
+TEST(AggregateSketchTest, HyperLogLogTest) {
+  // Exact while sparse, whatever the number of duplicates.
+  HyperLogLog small;
+  for (uint64_t i = 0; i < 1000; i++) {
+    small.Add(Mix(i % HyperLogLog::SPARSE_LIMIT));
+  }
+  EXPECT_EQ(small.Estimate(), HyperLogLog::SPARSE_LIMIT);
+  EXPECT_LE(small.GetMemoryUsage(), HyperLogLog::SPARSE_LIMIT * sizeof(uint64_t));
+
+  // Within four standard errors once dense, with a fixed size.
+  for (uint64_t distinct : {100, 1000, 10000, 1000000}) {
+    HyperLogLog hll;
+    for (uint64_t i = 0; i < distinct; i++) {
+      hll.Add(Mix(i));
+      hll.Add(Mix(i));
+    }
+    double error = std::abs(static_cast<double>(hll.Estimate()) - distinct) / distinct;
+    EXPECT_LT(error, 4 * 1.04 / std::sqrt(HyperLogLog::REGISTER_COUNT)) << distinct << " distinct hashes";
+    EXPECT_LE(hll.GetMemoryUsage(), HyperLogLog::REGISTER_COUNT);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(AggregateSketchTest, KllSketchTest) {
+  // Exact below the capacity of a single level.
+  KllSketch small;
+  for (int i = 10; i >= 0; i--) {
+    small.Add(i);
+  }
+  EXPECT_EQ(small.Quantile(0), 0);
+  EXPECT_EQ(small.Quantile(0.5), 5);
+  EXPECT_EQ(small.Quantile(1), 10);
+
+  // The rank of every estimated quantile is within a few percent of the input count, with far fewer values held.
+  const size_t count = 1000000;
+  std::mt19937 generator(15445);
+  std::vector<double> values(count);
+  for (size_t i = 0; i < count; i++) {
+    values[i] = static_cast<double>(i);
+  }
+  std::shuffle(values.begin(), values.end(), generator);
+  KllSketch kll;
+  for (double value : values) {
+    kll.Add(value);
+  }
+  for (double fraction : {0.0, 0.01, 0.25, 0.5, 0.75, 0.99, 1.0}) {
+    // Value i has rank i, so the rank error is the value error.
+    double error = std::abs(kll.Quantile(fraction) - fraction * (count - 1)) / count;
+    EXPECT_LT(error, 0.03) << "quantile " << fraction;
+  }
+  EXPECT_LT(kll.GetMemoryUsage(), count * sizeof(double) / 100);
+}
+
+}  // namespace bustub
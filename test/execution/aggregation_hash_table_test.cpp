@@ -0,0 +1,309 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_hash_table_test.cpp
+//
+// Identification: test/execution/aggregation_hash_table_test.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/exception.h"
+#include "execution/aggregation_hash_table.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** The aggregates of a group computed the obvious way. */
+struct ReferenceGroup {
+  int32_t count_{0};
+  int64_t sum_{0};
+  int64_t min_{0};
+  int64_t max_{0};
+  bool has_value_{false};
+};
+
+// NOLINTNEXTLINE
+TEST(AggregationHashTableTest, ReferenceTest) {
+  // SELECT a, COUNT(b), SUM(b), MIN(b), MAX(b) GROUP BY a, with nulls in both columns and enough groups to grow
+  AggregationHashTable table({AggregationType::CountAggregate, AggregationType::SumAggregate,
+                              AggregationType::MinAggregate, AggregationType::MaxAggregate});
+  std::mt19937 generator(15445);
+  std::uniform_int_distribution<int32_t> key_dist(0, 5000);
+  std::uniform_int_distribution<int64_t> input_dist(-1000, 1000);
+  std::map<int32_t, ReferenceGroup> reference;
+  const size_t batches = 40;
+  for (size_t batch = 0; batch < batches; batch++) {
+    std::vector<ColumnVector> keys{ColumnVector(TypeId::INTEGER)};
+    std::vector<ColumnVector> inputs(4, ColumnVector(TypeId::BIGINT));
+    for (size_t row = 0; row < VECTOR_SIZE; row++) {
+      int32_t key = key_dist(generator);
+      int64_t input = input_dist(generator);
+      Value key_value =
+          key == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(key);
+      Value input_value =
+          input % 10 == 0 ? ValueFactory::GetNullValueByType(TypeId::BIGINT) : ValueFactory::GetBigIntValue(input);
+      // Nulls are one group, kept apart from the others with the sentinel.
+      ReferenceGroup &group = reference[key == 0 ? BUSTUB_INT32_NULL : key];
+      group.count_++;
+      if (!input_value.IsNull()) {
+        group.sum_ += input;
+        group.min_ = group.has_value_ ? std::min(group.min_, input) : input;
+        group.max_ = group.has_value_ ? std::max(group.max_, input) : input;
+        group.has_value_ = true;
+      }
+      // Every other batch goes through the Value interface.
+      if (batch % 2 == 0) {
+        table.InsertCombine({key_value}, std::vector<Value>(4, input_value));
+        continue;
+      }
+      keys[0].Append(key_value);
+      for (auto &column : inputs) {
+        column.Append(input_value);
+      }
+    }
+    if (batch % 2 == 1) {
+      table.InsertCombineBatch(keys, inputs, VECTOR_SIZE);
+    }
+  }
+
+  ASSERT_EQ(table.GetGroupCount(), reference.size());
+  size_t groups = 0;
+  for (auto iter = table.Begin(); iter != table.End(); ++iter) {
+    Value key = iter.Key().group_bys_[0];
+    std::vector<Value> values = iter.Val().aggregates_;
+    const ReferenceGroup &expected = reference.at(key.IsNull() ? BUSTUB_INT32_NULL : key.GetAs<int32_t>());
+    EXPECT_EQ(values[0].GetAs<int32_t>(), expected.count_);
+    ASSERT_EQ(values[1].GetTypeId(), TypeId::BIGINT);
+    if (!expected.has_value_) {
+      EXPECT_TRUE(values[1].IsNull() && values[2].IsNull() && values[3].IsNull());
+      continue;
+    }
+    EXPECT_EQ(values[1].GetAs<int64_t>(), expected.sum_);
+    EXPECT_EQ(values[2].GetAs<int64_t>(), expected.min_);
+    EXPECT_EQ(values[3].GetAs<int64_t>(), expected.max_);
+    groups++;
+  }
+  EXPECT_GT(groups, 0);
+
+  table.Clear();
+  EXPECT_EQ(table.GetGroupCount(), 0);
+  EXPECT_TRUE(table.Begin() == table.End());
+}
+
+// NOLINTNEXTLINE
+TEST(AggregationHashTableTest, MixedTypesTest) {
+  // SELECT name, price, COUNT(*), MIN(name), SUM(price), SUM(qty) GROUP BY name, price
+  AggregationHashTable table({AggregationType::CountAggregate, AggregationType::MinAggregate,
+                              AggregationType::SumAggregate, AggregationType::SumAggregate});
+  auto insert = [&](const Value &name, double price, const Value &qty) {
+    Value price_value = ValueFactory::GetDecimalValue(price);
+    table.InsertCombine({name, price_value}, {name, name, price_value, qty});
+  };
+  Value apple = ValueFactory::GetVarcharValue("apple");
+  Value pear = ValueFactory::GetVarcharValue("pear");
+  Value null_name = ValueFactory::GetNullValueByType(TypeId::VARCHAR);
+  insert(apple, 0.0, ValueFactory::GetIntegerValue(1));
+  insert(apple, -0.0, ValueFactory::GetIntegerValue(2));
+  insert(apple, 1.5, ValueFactory::GetIntegerValue(3));
+  insert(pear, 1.5, ValueFactory::GetNullValueByType(TypeId::INTEGER));
+  insert(null_name, 1.5, ValueFactory::GetIntegerValue(4));
+  insert(null_name, 1.5, ValueFactory::GetIntegerValue(5));
+
+  std::map<std::string, std::vector<Value>> groups;
+  for (auto iter = table.Begin(); iter != table.End(); ++iter) {
+    std::vector<Value> key = iter.Key().group_bys_;
+    std::string name = key[0].IsNull() ? "<null>" : key[0].ToString();
+    groups[name + "," + key[1].ToString()] = iter.Val().aggregates_;
+  }
+  ASSERT_EQ(groups.size(), 4);
+  // 0.0 and -0.0 are the same price.
+  EXPECT_EQ(groups.at("apple,0.000000")[0].GetAs<int32_t>(), 2);
+  EXPECT_EQ(groups.at("apple,0.000000")[3].GetAs<int32_t>(), 3);
+  EXPECT_EQ(groups.at("apple,1.500000")[1].ToString(), "apple");
+  EXPECT_EQ(groups.at("apple,1.500000")[2].GetAs<double>(), 1.5);
+  EXPECT_EQ(groups.at("pear,1.500000")[3].GetTypeId(), TypeId::INTEGER);
+  EXPECT_TRUE(groups.at("pear,1.500000")[3].IsNull());
+  EXPECT_TRUE(groups.at("<null>,1.500000")[1].IsNull());
+  EXPECT_EQ(groups.at("<null>,1.500000")[2].GetAs<double>(), 3.0);
+  EXPECT_EQ(groups.at("<null>,1.500000")[3].GetAs<int32_t>(), 9);
+}
+
+// NOLINTNEXTLINE
+TEST(AggregationHashTableTest, ExtendedAggregatesTest) {
+  // SELECT a, AVG(b), COUNT(DISTINCT b % 37), COUNT(DISTINCT name), APPROX_COUNT_DISTINCT(b), APPROX_PERCENTILE(b, 0.9)
+  // GROUP BY a, with nulls in b
+  std::vector<AggregationType> agg_types{AggregationType::AvgAggregate, AggregationType::CountDistinctAggregate,
+                                         AggregationType::CountDistinctAggregate,
+                                         AggregationType::ApproxCountDistinctAggregate,
+                                         AggregationType::ApproxPercentileAggregate};
+  AggregationHashTable table(agg_types, {0, 0, 0, 0, 0.9});
+  const int32_t groups = 10;
+  const int32_t rows = 200000;
+  std::vector<int64_t> sums(groups, 0);
+  std::vector<int64_t> counts(groups, 0);
+  std::vector<ColumnVector> keys{ColumnVector(TypeId::INTEGER)};
+  std::vector<ColumnVector> inputs{ColumnVector(TypeId::INTEGER), ColumnVector(TypeId::INTEGER),
+                                   ColumnVector(TypeId::VARCHAR), ColumnVector(TypeId::INTEGER),
+                                   ColumnVector(TypeId::INTEGER)};
+  for (int32_t i = 0; i < rows; i++) {
+    int32_t key = i % groups;
+    Value b = i % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i);
+    Value b_mod = b.IsNull() ? b : ValueFactory::GetIntegerValue(i % 37);
+    std::vector<Value> row{b, b_mod, ValueFactory::GetVarcharValue("name" + std::to_string(i % 13)), b, b};
+    if (!b.IsNull()) {
+      sums[key] += i;
+      counts[key]++;
+    }
+    // Every other key goes through the Value interface.
+    if (key % 2 == 0) {
+      table.InsertCombine({ValueFactory::GetIntegerValue(key)}, row);
+      continue;
+    }
+    keys[0].Append(ValueFactory::GetIntegerValue(key));
+    for (size_t j = 0; j < row.size(); j++) {
+      inputs[j].Append(row[j]);
+    }
+    if (keys[0].GetSize() == VECTOR_SIZE || i == rows - 1) {
+      table.InsertCombineBatch(keys, inputs, keys[0].GetSize());
+      keys[0].Reset(TypeId::INTEGER);
+      for (auto &column : inputs) {
+        column.Reset(column.GetType());
+      }
+    }
+  }
+
+  ASSERT_EQ(table.GetGroupCount(), groups);
+  for (auto iter = table.Begin(); iter != table.End(); ++iter) {
+    int32_t key = iter.Key().group_bys_[0].GetAs<int32_t>();
+    std::vector<Value> values = iter.Val().aggregates_;
+    ASSERT_EQ(values[0].GetTypeId(), TypeId::DECIMAL);
+    EXPECT_DOUBLE_EQ(values[0].GetAs<double>(), static_cast<double>(sums[key]) / counts[key]);
+    // Every residue of 37 and 13 shows up in every group.
+    EXPECT_EQ(values[1].GetAs<int32_t>(), 37);
+    EXPECT_EQ(values[2].GetAs<int32_t>(), 13);
+    double distinct_error = std::abs(values[3].GetAs<int32_t>() - counts[key]) / static_cast<double>(counts[key]);
+    EXPECT_LT(distinct_error, 0.1);
+    // The inputs of a group are close to uniform over [0, rows).
+    double percentile_error = std::abs(values[4].GetAs<double>() - 0.9 * rows) / rows;
+    EXPECT_LT(percentile_error, 0.03);
+  }
+
+  // Nulls only: the averages and percentiles are null, the distinct counts 0.
+  table.Clear();
+  Value null_value = ValueFactory::GetNullValueByType(TypeId::INTEGER);
+  table.InsertCombine({ValueFactory::GetIntegerValue(0)}, std::vector<Value>(5, null_value));
+  std::vector<Value> values = table.Begin().Val().aggregates_;
+  EXPECT_TRUE(values[0].IsNull() && values[4].IsNull());
+  EXPECT_EQ(values[1].GetAs<int32_t>(), 0);
+  EXPECT_EQ(values[3].GetAs<int32_t>(), 0);
+
+  // AVG needs numbers.
+  AggregationHashTable varchar_avg({AggregationType::AvgAggregate});
+  EXPECT_THROW(varchar_avg.InsertCombine({}, {ValueFactory::GetVarcharValue("a")}), Exception);
+}
+
+// NOLINTNEXTLINE
+TEST(AggregationHashTableTest, CombineIfPresentTest) {
+  // SELECT a, COUNT(b), SUM(b) GROUP BY a, with a table that is not allowed to create groups for odd keys
+  AggregationHashTable table({AggregationType::CountAggregate, AggregationType::SumAggregate});
+  std::map<uint64_t, std::vector<int32_t>> missing_by_hash;
+  for (int32_t i = 0; i < 1000; i++) {
+    int32_t key = i % 100;
+    std::vector<Value> group_bys{ValueFactory::GetIntegerValue(key)};
+    std::vector<Value> inputs{ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(i)};
+    if (key % 2 == 0) {
+      table.InsertCombine(group_bys, inputs);
+      continue;
+    }
+    uint64_t hash;
+    ASSERT_FALSE(table.CombineIfPresent(group_bys, inputs, &hash));
+    missing_by_hash[hash].push_back(key);
+  }
+  // Even keys now have a group and are combined into it, odd keys hash the same every time.
+  uint64_t hash = 0;
+  ASSERT_TRUE(table.CombineIfPresent({ValueFactory::GetIntegerValue(0)},
+                                     {ValueFactory::GetIntegerValue(1), ValueFactory::GetIntegerValue(1)}, &hash));
+  ASSERT_EQ(table.GetGroupCount(), 50);
+  ASSERT_EQ(missing_by_hash.size(), 50);
+  for (const auto &[missing_hash, keys] : missing_by_hash) {
+    EXPECT_EQ(keys.size(), 10);
+    EXPECT_TRUE(std::all_of(keys.begin(), keys.end(), [&](int32_t key) { return key == keys[0]; }));
+  }
+  for (auto iter = table.Begin(); iter != table.End(); ++iter) {
+    int32_t key = iter.Key().group_bys_[0].GetAs<int32_t>();
+    std::vector<Value> values = iter.Val().aggregates_;
+    EXPECT_EQ(values[0].GetAs<int32_t>(), key == 0 ? 11 : 10);
+    EXPECT_EQ(values[1].GetAs<int32_t>(), 10 * key + 4500 + (key == 0 ? 1 : 0));
+  }
+}
+
+// A benchmark: ReferenceTest checks the results, so it only runs with --gtest_also_run_disabled_tests.
+// NOLINTNEXTLINE
+TEST(AggregationHashTableTest, DISABLED_ThroughputTest) {
+  // SELECT a, COUNT(b), SUM(b) GROUP BY a, against a std::unordered_map of boxed Values, with 1K and 1M groups.
+  for (int32_t group_count : {1000, 1000000}) {
+    const size_t rows = 1 << 20;
+    std::mt19937 generator(15445);
+    std::uniform_int_distribution<int32_t> key_dist(0, group_count - 1);
+    std::vector<ColumnVector> keys{ColumnVector(TypeId::INTEGER)};
+    std::vector<ColumnVector> inputs(2, ColumnVector(TypeId::INTEGER));
+    std::vector<std::vector<ColumnVector>> key_batches;
+    std::vector<std::vector<ColumnVector>> input_batches;
+    for (size_t row = 0; row < rows; row++) {
+      keys[0].Append(ValueFactory::GetIntegerValue(key_dist(generator)));
+      inputs[0].Append(ValueFactory::GetIntegerValue(1));
+      inputs[1].Append(ValueFactory::GetIntegerValue(1));
+      if (keys[0].GetSize() == VECTOR_SIZE) {
+        key_batches.push_back(keys);
+        input_batches.push_back(inputs);
+        keys[0].Reset(TypeId::INTEGER);
+        inputs[0].Reset(TypeId::INTEGER);
+        inputs[1].Reset(TypeId::INTEGER);
+      }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    AggregationHashTable table({AggregationType::CountAggregate, AggregationType::SumAggregate});
+    for (size_t i = 0; i < key_batches.size(); i++) {
+      table.InsertCombineBatch(key_batches[i], input_batches[i], VECTOR_SIZE);
+    }
+    std::chrono::duration<double> flat = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    std::unordered_map<AggregateKey, AggregateValue> boxed;
+    for (size_t i = 0; i < key_batches.size(); i++) {
+      for (size_t row = 0; row < VECTOR_SIZE; row++) {
+        AggregateKey key{{key_batches[i][0].GetValue(row)}};
+        auto iter = boxed.find(key);
+        if (iter == boxed.end()) {
+          iter = boxed.insert({key, {{ValueFactory::GetIntegerValue(0), ValueFactory::GetIntegerValue(0)}}}).first;
+        }
+        iter->second.aggregates_[0] = iter->second.aggregates_[0].Add(ValueFactory::GetIntegerValue(1));
+        iter->second.aggregates_[1] = iter->second.aggregates_[1].Add(input_batches[i][1].GetValue(row));
+      }
+    }
+    std::chrono::duration<double> unordered = std::chrono::steady_clock::now() - start;
+
+    ASSERT_EQ(table.GetGroupCount(), boxed.size());
+    size_t aggregated = key_batches.size() * VECTOR_SIZE;
+    printf("%d groups: flat %.0f rows/s, unordered_map %.0f rows/s, %zu bytes\n", group_count,
+           aggregated / flat.count(), aggregated / unordered.count(), table.GetMemoryUsage());
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,185 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_expression_test.cpp
+//
+// Identification: test/execution/compiled_expression_test.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "execution/compiled_expression.h"
+#include "execution/expressions/aggregate_value_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+class CompiledExpressionTest : public ::testing::Test {
+ protected:
+  const AbstractExpression *MakeColumn(uint32_t tuple_idx, uint32_t col_idx, TypeId type) {
+    exprs_.emplace_back(std::make_unique<ColumnValueExpression>(tuple_idx, col_idx, type));
+    return exprs_.back().get();
+  }
+
+  const AbstractExpression *MakeConstant(const Value &value) {
+    exprs_.emplace_back(std::make_unique<ConstantValueExpression>(value));
+    return exprs_.back().get();
+  }
+
+  const AbstractExpression *MakeComparison(const AbstractExpression *lhs, const AbstractExpression *rhs,
+                                           ComparisonType comp_type) {
+    exprs_.emplace_back(std::make_unique<ComparisonExpression>(lhs, rhs, comp_type));
+    return exprs_.back().get();
+  }
+
+  const AbstractExpression *MakeTerm(bool is_group_by, uint32_t term_idx, TypeId type) {
+    exprs_.emplace_back(std::make_unique<AggregateValueExpression>(is_group_by, term_idx, type));
+    return exprs_.back().get();
+  }
+
+  /** Checks that a compiled expression agrees with the expression tree on a tuple. */
+  static void ExpectSame(const AbstractExpression *expr, const CompiledExpression &program, const Tuple &tuple,
+                         const Schema *schema) {
+    Value expected = expr->Evaluate(&tuple, schema);
+    Value actual = program.Evaluate(&tuple);
+    ASSERT_EQ(expected.GetTypeId(), actual.GetTypeId());
+    ASSERT_EQ(expected.IsNull(), actual.IsNull());
+    if (!expected.IsNull()) {
+      ASSERT_EQ(expected.CompareEquals(actual), CmpBool::CmpTrue) << expected.ToString() << " " << actual.ToString();
+    }
+    if (expected.GetTypeId() == TypeId::BOOLEAN) {
+      ASSERT_EQ(program.Matches(&tuple), !expected.IsNull() && expected.GetAs<bool>());
+    }
+  }
+
+  std::vector<std::unique_ptr<AbstractExpression>> exprs_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(CompiledExpressionTest, TupleTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT), Column("c", TypeId::DECIMAL),
+                 Column("d", TypeId::SMALLINT), Column("e", TypeId::VARCHAR, 8)});
+  auto a = MakeColumn(0, 0, TypeId::INTEGER);
+  auto b = MakeColumn(0, 1, TypeId::BIGINT);
+  auto c = MakeColumn(0, 2, TypeId::DECIMAL);
+  auto d = MakeColumn(0, 3, TypeId::SMALLINT);
+  auto e = MakeColumn(0, 4, TypeId::VARCHAR);
+
+  std::vector<const AbstractExpression *> exprs{a, b, c, d};
+  std::vector<const AbstractExpression *> operands{a, b, c, d, MakeConstant(ValueFactory::GetIntegerValue(3)),
+                                                   MakeConstant(ValueFactory::GetDecimalValue(2.5)),
+                                                   MakeConstant(ValueFactory::GetBigIntValue(-1))};
+  for (auto lhs : operands) {
+    for (auto rhs : operands) {
+      for (auto comp_type : {ComparisonType::Equal, ComparisonType::NotEqual, ComparisonType::LessThan,
+                             ComparisonType::LessThanOrEqual, ComparisonType::GreaterThan,
+                             ComparisonType::GreaterThanOrEqual}) {
+        exprs.push_back(MakeComparison(lhs, rhs, comp_type));
+      }
+    }
+  }
+
+  std::mt19937 generator(15445);
+  std::uniform_int_distribution<int> dist(-4, 4);
+  for (int i = 0; i < 200; i++) {
+    // 4 stands for null.
+    auto pick = [&](Value value, TypeId type) {
+      return dist(generator) == 4 ? ValueFactory::GetNullValueByType(type) : value;
+    };
+    Tuple tuple({pick(ValueFactory::GetIntegerValue(dist(generator)), TypeId::INTEGER),
+                 pick(ValueFactory::GetBigIntValue(dist(generator)), TypeId::BIGINT),
+                 pick(ValueFactory::GetDecimalValue(dist(generator) / 2.0), TypeId::DECIMAL),
+                 pick(ValueFactory::GetSmallIntValue(static_cast<int16_t>(dist(generator))), TypeId::SMALLINT),
+                 ValueFactory::GetVarcharValue("e")},
+                &schema);
+    for (auto expr : exprs) {
+      CompiledExpression program;
+      ASSERT_TRUE(program.Compile(expr, &schema));
+      ExpectSame(expr, program, tuple, &schema);
+    }
+  }
+
+  // VARCHAR columns and join columns without a right schema are left to the expression tree.
+  CompiledExpression program;
+  EXPECT_FALSE(program.Compile(MakeComparison(e, MakeConstant(ValueFactory::GetVarcharValue("e")),
+                                              ComparisonType::Equal),
+                               &schema));
+  EXPECT_FALSE(program.Compile(MakeColumn(1, 0, TypeId::INTEGER), &schema));
+  EXPECT_FALSE(program.IsCompiled());
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompiledExpressionTest, JoinAndAggregateTest) {
+  Schema left_schema({Column("a", TypeId::INTEGER), Column("b", TypeId::INTEGER)});
+  Schema right_schema({Column("x", TypeId::SMALLINT)});
+  auto predicate = MakeComparison(MakeColumn(0, 1, TypeId::INTEGER), MakeColumn(1, 0, TypeId::SMALLINT),
+                                  ComparisonType::Equal);
+  CompiledExpression join_program;
+  ASSERT_TRUE(join_program.Compile(predicate, &left_schema, &right_schema));
+  Tuple left({ValueFactory::GetIntegerValue(1), ValueFactory::GetIntegerValue(7)}, &left_schema);
+  Tuple match({ValueFactory::GetSmallIntValue(7)}, &right_schema);
+  Tuple no_match({ValueFactory::GetSmallIntValue(8)}, &right_schema);
+  EXPECT_TRUE(join_program.MatchesJoin(&left, &match));
+  EXPECT_FALSE(join_program.MatchesJoin(&left, &no_match));
+
+  // HAVING count > 2, with the count stored as a BIGINT while the expression says INTEGER.
+  auto having = MakeComparison(MakeTerm(false, 0, TypeId::INTEGER),
+                               MakeConstant(ValueFactory::GetIntegerValue(2)), ComparisonType::GreaterThan);
+  CompiledExpression having_program;
+  ASSERT_TRUE(having_program.CompileAggregate(having));
+  EXPECT_FALSE(having_program.Compile(having, &left_schema));
+  ASSERT_TRUE(having_program.CompileAggregate(having));
+  EXPECT_TRUE(having_program.MatchesAggregate({}, {ValueFactory::GetBigIntValue(3)}));
+  EXPECT_FALSE(having_program.MatchesAggregate({}, {ValueFactory::GetIntegerValue(2)}));
+  EXPECT_FALSE(having_program.MatchesAggregate({}, {ValueFactory::GetNullValueByType(TypeId::INTEGER)}));
+}
+
+// Times a predicate through the expression tree and through its program; TupleTest covers their agreement.
+// NOLINTNEXTLINE
+TEST_F(CompiledExpressionTest, DISABLED_ThroughputTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::DECIMAL)});
+  auto predicate = MakeComparison(MakeColumn(0, 1, TypeId::DECIMAL), MakeColumn(0, 0, TypeId::INTEGER),
+                                  ComparisonType::LessThan);
+  CompiledExpression program;
+  ASSERT_TRUE(program.Compile(predicate, &schema));
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 1000; i++) {
+    tuples.emplace_back(std::vector<Value>{ValueFactory::GetIntegerValue(i % 100), ValueFactory::GetDecimalValue(i)},
+                        &schema);
+  }
+
+  const int iterations = 200;
+  size_t tree_matches = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    for (const auto &tuple : tuples) {
+      tree_matches += predicate->Evaluate(&tuple, &schema).GetAs<bool>() ? 1 : 0;
+    }
+  }
+  std::chrono::duration<double> tree = std::chrono::steady_clock::now() - start;
+  size_t compiled_matches = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    for (const auto &tuple : tuples) {
+      compiled_matches += program.Matches(&tuple) ? 1 : 0;
+    }
+  }
+  std::chrono::duration<double> compiled = std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(tree_matches, compiled_matches);
+  printf("expression tree: %.0f tuples/s, compiled: %.0f tuples/s\n", iterations * tuples.size() / tree.count(),
+         iterations * tuples.size() / compiled.count());
+}
+
+}  // namespace bustub
@@ -10,7 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <functional>
+#include <random>
 #include <memory>
 #include <string>
 #include <unordered_set>
@@ -18,6 +22,7 @@
 #include <vector>
 
 #include "execution/plans/delete_plan.h"
+#include "execution/plans/gather_plan.h"
 #include "execution/plans/limit_plan.h"
 
 #include "buffer/buffer_pool_manager.h"
@@ -26,15 +31,24 @@
 #include "execution/execution_engine.h"
 #include "execution/executor_context.h"
 #include "execution/executors/aggregation_executor.h"
+#include "execution/executors/hash_join_executor.h"
 #include "execution/executors/insert_executor.h"
+#include "execution/executors/nested_index_join_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
+#include "execution/executors/sort_executor.h"
 #include "execution/expressions/aggregate_value_expression.h"
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
 #include "execution/expressions/constant_value_expression.h"
+#include "execution/plans/repartition_plan.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
 #include "gtest/gtest.h"
+#include "optimizer/optimizer.h"
 #include "storage/b_plus_tree_test_util.h"  // NOLINT
+#include "storage/page/table_page.h"
+#include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
 #include "type/value_factory.h"
 
@@ -77,6 +91,197 @@ class ExecutorTest : public ::testing::Test {
   /** @return the executor context in our test class */
   ExecutorContext *GetExecutorContext() { return exec_ctx_.get(); }
   ExecutionEngine *GetExecutionEngine() { return execution_engine_.get(); }
+
+  /**
+   * Runs a plan as ExecutionEngine::Execute() does, except that a scan at the root runs a batch at a time in a
+   * vectorized context, which the engine leaves to Next(), so that tests cover both paths of the scan.
+   */
+  void ExecutePlan(const AbstractPlanNode *plan, std::vector<Tuple> *result_set) {
+    if (plan->GetType() != PlanType::SeqScan || !GetExecutorContext()->IsVectorized()) {
+      GetExecutionEngine()->Execute(plan, result_set, GetTxn(), GetExecutorContext());
+      return;
+    }
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), plan);
+    executor->Init();
+    VectorBatch batch;
+    while (executor->NextBatch(&batch)) {
+      for (size_t i = 0; i < batch.GetSize(); i++) {
+        result_set->push_back(batch.GetTuple(i, executor->GetOutputSchema()));
+      }
+    }
+  }
+  /**
+   * SELECT a, b, c FROM sort_table ORDER BY b DESC, c ASC over num_rows rows, once in memory and once with a budget
+   * that makes the sort spill more runs than the buffer pool has frames. Checks that both agree and are in order, and
+   * prints rows/s for each if report_time is set.
+   */
+  void CheckExternalSort(int32_t num_rows, bool report_time) {
+    std::vector<Column> columns{Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT),
+                                Column("c", TypeId::VARCHAR, 32)};
+    Schema table_schema(columns);
+    auto table_info = GetCatalog()->CreateTable(GetTxn(), "sort_table", table_schema);
+    std::mt19937 generator(15445);
+    std::uniform_int_distribution<int64_t> b_dist(-500, 500);
+    std::uniform_int_distribution<int32_t> c_dist(0, 99);
+    for (int32_t i = 0; i < num_rows; i++) {
+      // Every 97th b is null, and the strings share prefixes so that their lengths matter.
+      Value b = i % 97 == 0 ? ValueFactory::GetNullValueByType(TypeId::BIGINT)
+                            : ValueFactory::GetBigIntValue(b_dist(generator));
+      std::string c = "row" + std::to_string(c_dist(generator));
+      Tuple tuple({ValueFactory::GetIntegerValue(i), b, ValueFactory::GetVarcharValue(c)}, &table_schema);
+      RID rid;
+      ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+    }
+
+    auto &schema = table_info->schema_;
+    auto scan_a = MakeColumnValueExpression(schema, 0, "a");
+    auto scan_b = MakeColumnValueExpression(schema, 0, "b");
+    auto scan_c = MakeColumnValueExpression(schema, 0, "c");
+    auto scan_schema = MakeOutputSchema({{"a", scan_a}, {"b", scan_b}, {"c", scan_c}});
+    SeqScanPlanNode scan_plan(scan_schema, nullptr, table_info->oid_);
+    auto b = MakeColumnValueExpression(*scan_schema, 0, "b");
+    auto c = MakeColumnValueExpression(*scan_schema, 0, "c");
+    SortPlanNode sort_plan(scan_schema, &scan_plan, {{OrderByType::Descending, b}, {OrderByType::Ascending, c}});
+
+    auto sort = [&](size_t memory_budget, size_t *run_count, size_t *merge_pass_count) {
+      GetExecutorContext()->SetMemoryBudget(memory_budget);
+      auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &sort_plan);
+      auto start = std::chrono::steady_clock::now();
+      executor->Init();
+      std::vector<Tuple> result_set;
+      Tuple tuple;
+      RID rid;
+      while (executor->Next(&tuple, &rid)) {
+        result_set.push_back(tuple);
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      *run_count = dynamic_cast<SortExecutor *>(executor.get())->GetRunCount();
+      *merge_pass_count = dynamic_cast<SortExecutor *>(executor.get())->GetMergePassCount();
+      if (report_time) {
+        printf("sorted %zu rows with a %zu byte budget: %zu runs, %zu merge passes, %.0f rows/s\n", result_set.size(),
+               memory_budget, *run_count, *merge_pass_count, result_set.size() / elapsed.count());
+      }
+      return result_set;
+    };
+
+    size_t run_count;
+    size_t merge_pass_count;
+    auto in_memory = sort(DEFAULT_QUERY_MEMORY, &run_count, &merge_pass_count);
+    EXPECT_EQ(run_count, 0);
+    auto external = sort(16 * 1024, &run_count, &merge_pass_count);
+    EXPECT_GT(run_count, GetBPM()->GetPoolSize());
+    EXPECT_GE(merge_pass_count, 1);
+
+    // Both sorts agree on every tuple, and the order matches Value comparisons.
+    ASSERT_EQ(in_memory.size(), static_cast<size_t>(num_rows));
+    ASSERT_EQ(external.size(), static_cast<size_t>(num_rows));
+    std::vector<bool> seen(num_rows, false);
+    for (size_t i = 0; i < external.size(); i++) {
+      auto a = external[i].GetValue(scan_schema, 0).GetAs<int32_t>();
+      ASSERT_EQ(a, in_memory[i].GetValue(scan_schema, 0).GetAs<int32_t>());
+      ASSERT_FALSE(seen[a]);
+      seen[a] = true;
+      if (i == 0) {
+        continue;
+      }
+      Value prev_b = external[i - 1].GetValue(scan_schema, 1);
+      Value cur_b = external[i].GetValue(scan_schema, 1);
+      // Nulls come last in descending order.
+      if (prev_b.IsNull()) {
+        ASSERT_TRUE(cur_b.IsNull());
+      } else if (!cur_b.IsNull()) {
+        ASSERT_NE(prev_b.CompareLessThan(cur_b), CmpBool::CmpTrue);
+      }
+      if (prev_b.IsNull() == cur_b.IsNull() && (prev_b.IsNull() || prev_b.CompareEquals(cur_b) == CmpBool::CmpTrue)) {
+        ASSERT_NE(external[i - 1].GetValue(scan_schema, 2).CompareGreaterThan(external[i].GetValue(scan_schema, 2)),
+                  CmpBool::CmpTrue);
+      }
+    }
+  }
+
+  /**
+   * SELECT a, c, d FROM vec_table WHERE b < 30, and
+   * SELECT b, count(a), sum(a), min(a), max(a) FROM vec_table WHERE b < 30 GROUP BY b
+   * over num_rows rows, each run `iterations` times tuple-at-a-time and a batch at a time. Checks that both modes
+   * return the same rows, and prints rows/s for each if report_time is set.
+   */
+  void CheckVectorizedExecution(int32_t num_rows, int iterations, bool report_time) {
+    std::vector<Column> columns{Column("a", TypeId::INTEGER), Column("b", TypeId::INTEGER), Column("c", TypeId::BIGINT),
+                                Column("d", TypeId::VARCHAR, 16)};
+    Schema table_schema(columns);
+    auto table_info = GetCatalog()->CreateTable(GetTxn(), "vec_table", table_schema);
+    std::mt19937 generator(15445);
+    std::uniform_int_distribution<int32_t> b_dist(0, 99);
+    for (int32_t i = 0; i < num_rows; i++) {
+      Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(b_dist(generator)),
+                   ValueFactory::GetBigIntValue(static_cast<int64_t>(i) * 1000),
+                   ValueFactory::GetVarcharValue("d" + std::to_string(i))},
+                  &table_schema);
+      RID rid;
+      ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+    }
+
+    auto &schema = table_info->schema_;
+    auto scan_a = MakeColumnValueExpression(schema, 0, "a");
+    auto scan_b = MakeColumnValueExpression(schema, 0, "b");
+    auto scan_c = MakeColumnValueExpression(schema, 0, "c");
+    auto scan_d = MakeColumnValueExpression(schema, 0, "d");
+    auto predicate = MakeComparisonExpression(scan_b, MakeConstantValueExpression(ValueFactory::GetIntegerValue(30)),
+                                              ComparisonType::LessThan);
+    auto scan_schema = MakeOutputSchema({{"a", scan_a}, {"c", scan_c}, {"d", scan_d}});
+    SeqScanPlanNode scan_plan(scan_schema, predicate, table_info->oid_);
+
+    auto agg_scan_schema = MakeOutputSchema({{"a", scan_a}, {"b", scan_b}});
+    SeqScanPlanNode agg_scan_plan(agg_scan_schema, predicate, table_info->oid_);
+    auto a = MakeColumnValueExpression(*agg_scan_schema, 0, "a");
+    auto b = MakeColumnValueExpression(*agg_scan_schema, 0, "b");
+    auto agg_schema = MakeOutputSchema({{"b", MakeAggregateValueExpression(true, 0)},
+                                        {"countA", MakeAggregateValueExpression(false, 0)},
+                                        {"sumA", MakeAggregateValueExpression(false, 1)},
+                                        {"minA", MakeAggregateValueExpression(false, 2)},
+                                        {"maxA", MakeAggregateValueExpression(false, 3)}});
+    AggregationPlanNode agg_plan(agg_schema, &agg_scan_plan, nullptr, {b}, {a, a, a, a},
+                                 {AggregationType::CountAggregate, AggregationType::SumAggregate,
+                                  AggregationType::MinAggregate, AggregationType::MaxAggregate});
+
+    // Runs a plan `iterations` times and returns its result, sorted on the first column.
+    auto run = [&](const AbstractPlanNode *plan, bool vectorized) {
+      GetExecutorContext()->SetVectorized(vectorized);
+      EXPECT_EQ(ExecutorFactory::CreateExecutor(GetExecutorContext(), plan)->SupportsBatch(), vectorized);
+      std::vector<Tuple> result_set;
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < iterations; i++) {
+        result_set.clear();
+        ExecutePlan(plan, &result_set);
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      if (report_time) {
+        printf("%s %s: %.0f rows/s\n", plan->GetType() == PlanType::SeqScan ? "scan" : "aggregation",
+               vectorized ? "batch-at-a-time" : "tuple-at-a-time", iterations * num_rows / elapsed.count());
+      }
+      const Schema *out_schema = plan->OutputSchema();
+      std::sort(result_set.begin(), result_set.end(), [out_schema](const Tuple &l, const Tuple &r) {
+        return l.GetValue(out_schema, 0).CompareLessThan(r.GetValue(out_schema, 0)) == CmpBool::CmpTrue;
+      });
+      return result_set;
+    };
+
+    for (const AbstractPlanNode *plan : std::vector<const AbstractPlanNode *>{&scan_plan, &agg_plan}) {
+      auto tuples = run(plan, false);
+      auto batches = run(plan, true);
+      ASSERT_FALSE(tuples.empty());
+      ASSERT_EQ(tuples.size(), batches.size());
+      const Schema *out_schema = plan->OutputSchema();
+      for (size_t i = 0; i < tuples.size(); i++) {
+        for (uint32_t col = 0; col < out_schema->GetColumnCount(); col++) {
+          ASSERT_EQ(tuples[i].GetValue(out_schema, col).CompareEquals(batches[i].GetValue(out_schema, col)),
+                    CmpBool::CmpTrue);
+        }
+      }
+    }
+    GetExecutorContext()->SetVectorized(true);
+  }
+
   Transaction *GetTxn() { return txn_; }
   TransactionManager *GetTxnManager() { return txn_mgr_.get(); }
   Catalog *GetCatalog() { return catalog_.get(); }
@@ -435,6 +640,916 @@ TEST_F(ExecutorTest, SimpleNestedLoopJoinTest) {
   }
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SimpleHashJoinTest) {
+  // SELECT test_1.colA, test_1.colB, test_2.col1, test_2.col3 FROM test_1 JOIN test_2 ON test_1.colA = test_2.col1
+  // and the same join with test_2 on the left side.
+  const Schema *out_schema1;
+  const Schema *out_schema2;
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    out_schema1 = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, nullptr, table_info->oid_);
+  }
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col1 = MakeColumnValueExpression(schema, 0, "col1");
+    auto col3 = MakeColumnValueExpression(schema, 0, "col3");
+    out_schema2 = MakeOutputSchema({{"col1", col1}, {"col3", col3}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+
+  for (bool test_1_on_left : {true, false}) {
+    const AbstractPlanNode *left_plan = test_1_on_left ? scan_plan1.get() : scan_plan2.get();
+    const AbstractPlanNode *right_plan = test_1_on_left ? scan_plan2.get() : scan_plan1.get();
+    uint32_t test_1_idx = test_1_on_left ? 0 : 1;
+    auto colA = MakeColumnValueExpression(*out_schema1, test_1_idx, "colA");
+    auto colB = MakeColumnValueExpression(*out_schema1, test_1_idx, "colB");
+    auto col1 = MakeColumnValueExpression(*out_schema2, 1 - test_1_idx, "col1");
+    auto col3 = MakeColumnValueExpression(*out_schema2, 1 - test_1_idx, "col3");
+    auto predicate = MakeComparisonExpression(colA, col1, ComparisonType::Equal);
+    auto out_final = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"col1", col1}, {"col3", col3}});
+    HashJoinPlanNode join_plan(out_final, std::vector<const AbstractPlanNode *>{left_plan, right_plan}, predicate);
+
+    // The hash table is built on test_2, which is the smaller input.
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &join_plan);
+    executor->Init();
+    EXPECT_EQ(dynamic_cast<HashJoinExecutor *>(executor.get())->IsBuildLeft(), !test_1_on_left);
+
+    std::unordered_set<int32_t> seen;
+    Tuple tuple;
+    RID rid;
+    while (executor->Next(&tuple, &rid)) {
+      auto colA_val = tuple.GetValue(out_final, out_final->GetColIdx("colA")).GetAs<int32_t>();
+      auto col1_val = tuple.GetValue(out_final, out_final->GetColIdx("col1")).GetAs<int16_t>();
+      ASSERT_EQ(colA_val, col1_val);
+      ASSERT_TRUE(seen.insert(colA_val).second);
+    }
+    ASSERT_EQ(seen.size(), TEST2_SIZE);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, HashJoinDuplicateKeysTest) {
+  // SELECT l.colA, r.colA FROM test_1 l JOIN test_1 r ON l.colB = r.colB
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto scan_colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto scan_colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto scan_schema = MakeOutputSchema({{"colA", scan_colA}, {"colB", scan_colB}});
+  SeqScanPlanNode left_plan(scan_schema, nullptr, table_info->oid_);
+  SeqScanPlanNode right_plan(scan_schema, nullptr, table_info->oid_);
+
+  auto left_colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto left_colB = MakeColumnValueExpression(*scan_schema, 0, "colB");
+  auto right_colA = MakeColumnValueExpression(*scan_schema, 1, "colA");
+  auto right_colB = MakeColumnValueExpression(*scan_schema, 1, "colB");
+  auto predicate = MakeComparisonExpression(left_colB, right_colB, ComparisonType::Equal);
+  auto out_schema = MakeOutputSchema({{"leftA", left_colA}, {"leftB", left_colB}, {"rightA", right_colA}});
+  HashJoinPlanNode join_plan(out_schema, std::vector<const AbstractPlanNode *>{&left_plan, &right_plan}, predicate);
+
+  // Every pair of tuples with the same colB joins.
+  std::vector<Tuple> tuples;
+  GetExecutionEngine()->Execute(&left_plan, &tuples, GetTxn(), GetExecutorContext());
+  std::vector<size_t> counts(10, 0);
+  for (const auto &tuple : tuples) {
+    counts[tuple.GetValue(scan_schema, 1).GetAs<int32_t>()]++;
+  }
+  size_t expected_size = 0;
+  for (auto count : counts) {
+    expected_size += count * count;
+  }
+
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), expected_size);
+  std::vector<size_t> pairs(TEST1_SIZE, 0);
+  for (const auto &tuple : result_set) {
+    auto leftA = tuple.GetValue(out_schema, 0).GetAs<int32_t>();
+    auto rightA = tuple.GetValue(out_schema, 2).GetAs<int32_t>();
+    ASSERT_EQ(tuples[leftA].GetValue(scan_schema, 1).GetAs<int32_t>(), tuple.GetValue(out_schema, 1).GetAs<int32_t>());
+    ASSERT_EQ(tuples[rightA].GetValue(scan_schema, 1).GetAs<int32_t>(), tuple.GetValue(out_schema, 1).GetAs<int32_t>());
+    pairs[leftA]++;
+  }
+  for (uint32_t i = 0; i < TEST1_SIZE; i++) {
+    ASSERT_EQ(pairs[i], counts[tuples[i].GetValue(scan_schema, 1).GetAs<int32_t>()]);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SpillingHashJoinTest) {
+  // SELECT l.colA, r.colA FROM test_1 l JOIN test_1 r ON l.colA = r.colA, and ON l.colB = r.colB, with a memory
+  // budget far below the size of test_1.
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto scan_colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto scan_colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto scan_schema = MakeOutputSchema({{"colA", scan_colA}, {"colB", scan_colB}});
+  SeqScanPlanNode left_plan(scan_schema, nullptr, table_info->oid_);
+  SeqScanPlanNode right_plan(scan_schema, nullptr, table_info->oid_);
+  auto left_colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto left_colB = MakeColumnValueExpression(*scan_schema, 0, "colB");
+  auto right_colA = MakeColumnValueExpression(*scan_schema, 1, "colA");
+  auto right_colB = MakeColumnValueExpression(*scan_schema, 1, "colB");
+  auto out_schema = MakeOutputSchema({{"leftA", left_colA}, {"leftB", left_colB}, {"rightA", right_colA}});
+
+  GetExecutorContext()->SetMemoryBudget(4 * 1024);
+
+  // Unique keys: partitions split until they fit.
+  {
+    auto predicate = MakeComparisonExpression(left_colA, right_colA, ComparisonType::Equal);
+    HashJoinPlanNode join_plan(out_schema, std::vector<const AbstractPlanNode *>{&left_plan, &right_plan}, predicate);
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &join_plan);
+    executor->Init();
+    std::vector<bool> seen(TEST1_SIZE, false);
+    size_t result_size = 0;
+    Tuple tuple;
+    RID rid;
+    while (executor->Next(&tuple, &rid)) {
+      auto leftA = tuple.GetValue(out_schema, 0).GetAs<int32_t>();
+      ASSERT_EQ(leftA, tuple.GetValue(out_schema, 2).GetAs<int32_t>());
+      ASSERT_FALSE(seen[leftA]);
+      seen[leftA] = true;
+      result_size++;
+    }
+    ASSERT_EQ(result_size, TEST1_SIZE);
+    EXPECT_GT(dynamic_cast<HashJoinExecutor *>(executor.get())->GetSpilledPartitionCount(), HashJoinExecutor::FANOUT);
+  }
+
+  // Ten distinct keys: the partitions cannot be split below the budget and end up joined in memory.
+  {
+    std::vector<Tuple> tuples;
+    GetExecutionEngine()->Execute(&left_plan, &tuples, GetTxn(), GetExecutorContext());
+    std::vector<size_t> counts(10, 0);
+    for (const auto &tuple : tuples) {
+      counts[tuple.GetValue(scan_schema, 1).GetAs<int32_t>()]++;
+    }
+    size_t expected_size = 0;
+    for (auto count : counts) {
+      expected_size += count * count;
+    }
+
+    auto predicate = MakeComparisonExpression(left_colB, right_colB, ComparisonType::Equal);
+    HashJoinPlanNode join_plan(out_schema, std::vector<const AbstractPlanNode *>{&left_plan, &right_plan}, predicate);
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), expected_size);
+    for (const auto &tuple : result_set) {
+      auto rightA = tuple.GetValue(out_schema, 2).GetAs<int32_t>();
+      ASSERT_EQ(tuples[rightA].GetValue(scan_schema, 1).GetAs<int32_t>(),
+                tuple.GetValue(out_schema, 1).GetAs<int32_t>());
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, NestedIndexJoinTest) {
+  // SELECT outer.a, outer.b, test_1.colA, test_1.colD FROM outer JOIN test_1 ON outer.b = test_1.colA
+  // with an index on test_1.colA, for several outer tables.
+  auto inner_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &inner_schema = inner_info->schema_;
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  auto index_info = GetExecutorContext()->GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "index1", "test_1", inner_schema, *key_schema, {0}, 8);
+  std::vector<Tuple> inner_tuples;
+  for (auto iter = inner_info->table_->Begin(GetTxn()); iter != inner_info->table_->End(); ++iter) {
+    index_info->index_->InsertEntry(
+        iter->KeyFromTuple(inner_schema, *index_info->index_->GetKeySchema(), index_info->index_->GetKeyAttrs()),
+        iter->GetRid(), GetTxn());
+    inner_tuples.push_back(*iter);
+  }
+
+  auto check_join = [&](const std::string &outer_table, const std::string &outer_a, const std::string &outer_b) {
+    auto outer_info = GetExecutorContext()->GetCatalog()->GetTable(outer_table);
+    auto scan_a = MakeColumnValueExpression(outer_info->schema_, 0, outer_a);
+    auto scan_b = MakeColumnValueExpression(outer_info->schema_, 0, outer_b);
+    auto outer_schema = MakeOutputSchema({{outer_a, scan_a}, {outer_b, scan_b}});
+    SeqScanPlanNode scan_plan(outer_schema, nullptr, outer_info->oid_);
+    std::vector<Tuple> outer_tuples;
+    GetExecutionEngine()->Execute(&scan_plan, &outer_tuples, GetTxn(), GetExecutorContext());
+
+    auto a = MakeColumnValueExpression(*outer_schema, 0, outer_a);
+    auto b = MakeColumnValueExpression(*outer_schema, 0, outer_b);
+    auto colA = MakeColumnValueExpression(inner_schema, 1, "colA");
+    auto colD = MakeColumnValueExpression(inner_schema, 1, "colD");
+    auto predicate = MakeComparisonExpression(b, colA, ComparisonType::Equal);
+    auto out_schema = MakeOutputSchema({{"a", a}, {"b", b}, {"colA", colA}, {"colD", colD}});
+    NestedIndexJoinPlanNode join_plan(out_schema, std::vector<const AbstractPlanNode *>{&scan_plan}, predicate,
+                                      inner_info->oid_, "index1", outer_schema, &inner_schema);
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+
+    // Every outer tuple whose key is in test_1 matches once, in the order of the outer table.
+    size_t result_idx = 0;
+    for (const auto &outer_tuple : outer_tuples) {
+      auto key = outer_tuple.GetValue(outer_schema, 1).CastAs(TypeId::BIGINT).GetAs<int64_t>();
+      if (key < 0 || key >= TEST1_SIZE) {
+        continue;
+      }
+      ASSERT_LT(result_idx, result_set.size());
+      const Tuple &tuple = result_set[result_idx++];
+      ASSERT_EQ(tuple.GetValue(out_schema, 0).CompareEquals(outer_tuple.GetValue(outer_schema, 0)), CmpBool::CmpTrue);
+      ASSERT_EQ(tuple.GetValue(out_schema, 2).GetAs<int32_t>(), key);
+      ASSERT_EQ(tuple.GetValue(out_schema, 3).GetAs<int32_t>(),
+                inner_tuples[key].GetValue(&inner_schema, inner_schema.GetColIdx("colD")).GetAs<int32_t>());
+    }
+    ASSERT_EQ(result_idx, result_set.size());
+  };
+
+  // Many outer tuples per key, spread over several batches.
+  check_join("test_1", "colA", "colB");
+  // A BIGINT key, some of which are not in test_1.
+  check_join("test_2", "col1", "col3");
+  // Every outer tuple has a match.
+  check_join("test_3", "col1", "col2");
+
+  delete key_schema;
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SimpleSortTest) {
+  // SELECT colA, colB FROM test_1 ORDER BY colB ASC, colA DESC
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto scan_colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto scan_colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto scan_schema = MakeOutputSchema({{"colA", scan_colA}, {"colB", scan_colB}});
+  SeqScanPlanNode scan_plan(scan_schema, nullptr, table_info->oid_);
+  auto colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto colB = MakeColumnValueExpression(*scan_schema, 0, "colB");
+  SortPlanNode sort_plan(scan_schema, &scan_plan, {{OrderByType::Ascending, colB}, {OrderByType::Descending, colA}});
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &sort_plan);
+  executor->Init();
+  std::vector<Tuple> result_set;
+  Tuple tuple;
+  RID rid;
+  while (executor->Next(&tuple, &rid)) {
+    result_set.push_back(tuple);
+  }
+  ASSERT_EQ(result_set.size(), TEST1_SIZE);
+  EXPECT_EQ(dynamic_cast<SortExecutor *>(executor.get())->GetRunCount(), 0);
+  for (size_t i = 1; i < result_set.size(); i++) {
+    auto prev_b = result_set[i - 1].GetValue(scan_schema, 1).GetAs<int32_t>();
+    auto cur_b = result_set[i].GetValue(scan_schema, 1).GetAs<int32_t>();
+    ASSERT_LE(prev_b, cur_b);
+    if (prev_b == cur_b) {
+      ASSERT_GT(result_set[i - 1].GetValue(scan_schema, 0).GetAs<int32_t>(),
+                result_set[i].GetValue(scan_schema, 0).GetAs<int32_t>());
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, ExternalSortTest) { CheckExternalSort(10000, false); }
+
+// Sorts a larger table to report rows/s. Run with --gtest_also_run_disabled_tests.
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_ExternalSortBenchmark) { CheckExternalSort(50000, true); }
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SimpleLimitTest) {
+  // SELECT colA FROM test_1 LIMIT 10 OFFSET 5
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto scan_colA = MakeColumnValueExpression(table_info->schema_, 0, "colA");
+  auto scan_schema = MakeOutputSchema({{"colA", scan_colA}});
+  SeqScanPlanNode scan_plan(scan_schema, nullptr, table_info->oid_);
+
+  LimitPlanNode limit_plan(scan_schema, &scan_plan, 10, 5);
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(&limit_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), 10);
+  for (size_t i = 0; i < result_set.size(); i++) {
+    ASSERT_EQ(result_set[i].GetValue(scan_schema, 0).GetAs<int32_t>(), static_cast<int32_t>(i + 5));
+  }
+
+  // The offset runs past the end of the child.
+  LimitPlanNode past_end_plan(scan_schema, &scan_plan, 10, TEST1_SIZE - 3);
+  result_set.clear();
+  GetExecutionEngine()->Execute(&past_end_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), 3);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, TopNTest) {
+  // SELECT colA, colB FROM test_1 ORDER BY colB DESC, colA ASC LIMIT n OFFSET offset
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto scan_colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto scan_colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto scan_schema = MakeOutputSchema({{"colA", scan_colA}, {"colB", scan_colB}});
+  SeqScanPlanNode scan_plan(scan_schema, nullptr, table_info->oid_);
+  auto colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto colB = MakeColumnValueExpression(*scan_schema, 0, "colB");
+  SortPlanNode sort_plan(scan_schema, &scan_plan, {{OrderByType::Descending, colB}, {OrderByType::Ascending, colA}});
+  std::vector<Tuple> sorted;
+  GetExecutionEngine()->Execute(&sort_plan, &sorted, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(sorted.size(), TEST1_SIZE);
+
+  for (size_t n : std::vector<size_t>{0, 1, 10, TEST1_SIZE + 10}) {
+    TopNPlanNode topn_plan(scan_schema, &scan_plan, sort_plan.GetOrderBys(), n);
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&topn_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), std::min<size_t>(n, TEST1_SIZE));
+    for (size_t i = 0; i < result_set.size(); i++) {
+      ASSERT_EQ(result_set[i].GetValue(scan_schema, 0).GetAs<int32_t>(),
+                sorted[i].GetValue(scan_schema, 0).GetAs<int32_t>());
+    }
+  }
+
+  // The optimizer turns the limit over the sort into a top-n, keeping the limit only for an offset.
+  for (size_t offset : {0, 7}) {
+    LimitPlanNode limit_plan(scan_schema, &sort_plan, 10, offset);
+    Optimizer optimizer;
+    const AbstractPlanNode *optimized = optimizer.Optimize(&limit_plan);
+    if (offset == 0) {
+      ASSERT_EQ(optimized->GetType(), PlanType::TopN);
+      ASSERT_EQ(dynamic_cast<const TopNPlanNode *>(optimized)->GetN(), 10);
+    } else {
+      ASSERT_EQ(optimized->GetType(), PlanType::Limit);
+      ASSERT_EQ(optimized->GetChildAt(0)->GetType(), PlanType::TopN);
+      ASSERT_EQ(dynamic_cast<const TopNPlanNode *>(optimized->GetChildAt(0))->GetN(), 10 + offset);
+    }
+    ASSERT_EQ(limit_plan.GetChildPlan(), &sort_plan);
+
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&limit_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), 10);
+    for (size_t i = 0; i < result_set.size(); i++) {
+      ASSERT_EQ(result_set[i].GetValue(scan_schema, 0).GetAs<int32_t>(),
+                sorted[i + offset].GetValue(scan_schema, 0).GetAs<int32_t>());
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, VectorizedExecutionTest) { CheckVectorizedExecution(10000, 1, false); }
+
+// Compares the throughput of the two execution modes. Run with --gtest_also_run_disabled_tests.
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, DISABLED_VectorizedExecutionBenchmark) { CheckVectorizedExecution(10000, 20, true); }
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, TupleFormatScanTest) {
+  // SELECT a, b, c FROM fmt_table WHERE a < 500 on tables of every tuple format, both tuple-at-a-time and a batch at a
+  // time, with b null in every third row and c in every fifth.
+  const int32_t num_rows = 1000;
+  for (TupleFormat format : {TupleFormat::PLAIN, TupleFormat::NULL_BITMAP, TupleFormat::COMPACT}) {
+    Schema table_schema(
+        {Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT), Column("c", TypeId::VARCHAR, 16)}, format);
+    std::string table_name = "fmt_table" + std::to_string(static_cast<int>(format));
+    auto table_info = GetCatalog()->CreateTable(GetTxn(), table_name, table_schema);
+    for (int32_t i = 0; i < num_rows; i++) {
+      Tuple tuple({ValueFactory::GetIntegerValue(i),
+                   i % 3 == 0 ? ValueFactory::GetNullValueByType(TypeId::BIGINT) : ValueFactory::GetBigIntValue(i),
+                   i % 5 == 0 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                              : ValueFactory::GetVarcharValue("c" + std::to_string(i))},
+                  &table_schema);
+      RID rid;
+      ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+    }
+
+    auto &schema = table_info->schema_;
+    auto scan_a = MakeColumnValueExpression(schema, 0, "a");
+    auto predicate = MakeComparisonExpression(scan_a, MakeConstantValueExpression(ValueFactory::GetIntegerValue(500)),
+                                              ComparisonType::LessThan);
+    auto out_schema = MakeOutputSchema({{"a", scan_a},
+                                        {"b", MakeColumnValueExpression(schema, 0, "b")},
+                                        {"c", MakeColumnValueExpression(schema, 0, "c")}});
+    SeqScanPlanNode scan_plan(out_schema, predicate, table_info->oid_);
+    for (bool vectorized : {false, true}) {
+      GetExecutorContext()->SetVectorized(vectorized);
+      std::vector<Tuple> result_set;
+      ExecutePlan(&scan_plan, &result_set);
+      ASSERT_EQ(result_set.size(), 500);
+      for (const auto &tuple : result_set) {
+        int32_t a = tuple.GetValue(out_schema, 0).GetAs<int32_t>();
+        ASSERT_LT(a, 500);
+        ASSERT_EQ(tuple.IsNull(out_schema, 1), a % 3 == 0);
+        ASSERT_EQ(tuple.IsNull(out_schema, 2), a % 5 == 0);
+        if (a % 3 != 0) {
+          ASSERT_EQ(tuple.GetValue(out_schema, 1).GetAs<int64_t>(), a);
+        }
+        if (a % 5 != 0) {
+          ASSERT_EQ(tuple.GetValue(out_schema, 2).ToString(), "c" + std::to_string(a));
+        }
+      }
+    }
+  }
+  GetExecutorContext()->SetVectorized(true);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, NullVarcharPredicateTest) {
+  // SELECT a FROM null_table WHERE b = 'x' and WHERE b <> 'x', with b null in every third row. The comparisons are
+  // null on those rows, which match neither predicate.
+  Schema table_schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 8)});
+  auto table_info = GetCatalog()->CreateTable(GetTxn(), "null_table", table_schema);
+  const int32_t num_rows = 300;
+  for (int32_t i = 0; i < num_rows; i++) {
+    Value b = i % 3 == 0 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                         : ValueFactory::GetVarcharValue(i % 3 == 1 ? "x" : "y");
+    Tuple tuple({ValueFactory::GetIntegerValue(i), b}, &table_schema);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+
+  auto &schema = table_info->schema_;
+  auto scan_a = MakeColumnValueExpression(schema, 0, "a");
+  auto scan_b = MakeColumnValueExpression(schema, 0, "b");
+  auto out_schema = MakeOutputSchema({{"a", scan_a}});
+  auto x = MakeConstantValueExpression(ValueFactory::GetVarcharValue("x"));
+  for (auto comp_type : {ComparisonType::Equal, ComparisonType::NotEqual}) {
+    SeqScanPlanNode scan_plan(out_schema, MakeComparisonExpression(scan_b, x, comp_type), table_info->oid_);
+    int32_t expected_rem = comp_type == ComparisonType::Equal ? 1 : 2;
+    for (bool vectorized : {false, true}) {
+      GetExecutorContext()->SetVectorized(vectorized);
+      std::vector<Tuple> result_set;
+      ExecutePlan(&scan_plan, &result_set);
+      ASSERT_EQ(result_set.size(), num_rows / 3);
+      for (const auto &tuple : result_set) {
+        ASSERT_EQ(tuple.GetValue(out_schema, 0).GetAs<int32_t>() % 3, expected_rem);
+      }
+    }
+  }
+  GetExecutorContext()->SetVectorized(true);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, PaxScanTest) {
+  // SELECT a, c FROM pax_table WHERE a >= 500 on a PAX table and on a ROW table of the same rows, both tuple-at-a-time
+  // and a batch at a time. b is never read, and c is null in every fifth row.
+  const int32_t num_rows = 3000;
+  Schema table_schema({Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT), Column("c", TypeId::VARCHAR, 16)});
+  for (TableLayout layout : {TableLayout::ROW, TableLayout::PAX}) {
+    std::string table_name = "pax_table" + std::to_string(static_cast<int>(layout));
+    auto table_info = GetCatalog()->CreateTable(GetTxn(), table_name, table_schema, layout);
+    ASSERT_EQ(table_info->table_->GetLayout(), layout);
+    for (int32_t i = 0; i < num_rows; i++) {
+      Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetBigIntValue(i),
+                   i % 5 == 0 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                              : ValueFactory::GetVarcharValue("c" + std::to_string(i))},
+                  &table_schema);
+      RID rid;
+      ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+    }
+
+    auto &schema = table_info->schema_;
+    auto scan_a = MakeColumnValueExpression(schema, 0, "a");
+    auto predicate = MakeComparisonExpression(scan_a, MakeConstantValueExpression(ValueFactory::GetIntegerValue(500)),
+                                              ComparisonType::GreaterThanOrEqual);
+    auto out_schema = MakeOutputSchema({{"a", scan_a}, {"c", MakeColumnValueExpression(schema, 0, "c")}});
+    SeqScanPlanNode scan_plan(out_schema, predicate, table_info->oid_);
+    for (bool vectorized : {false, true}) {
+      GetExecutorContext()->SetVectorized(vectorized);
+      std::vector<Tuple> result_set;
+      ExecutePlan(&scan_plan, &result_set);
+      ASSERT_EQ(result_set.size(), 2500);
+      // A ROW table fills the free space of earlier pages, so only a PAX table returns its rows in insertion order.
+      std::sort(result_set.begin(), result_set.end(), [&](const Tuple &lhs, const Tuple &rhs) {
+        return lhs.GetValue(out_schema, 0).GetAs<int32_t>() < rhs.GetValue(out_schema, 0).GetAs<int32_t>();
+      });
+      for (size_t i = 0; i < result_set.size(); i++) {
+        int32_t a = result_set[i].GetValue(out_schema, 0).GetAs<int32_t>();
+        ASSERT_EQ(a, static_cast<int32_t>(i) + 500);
+        ASSERT_EQ(result_set[i].IsNull(out_schema, 1), a % 5 == 0);
+        if (a % 5 != 0) {
+          ASSERT_EQ(result_set[i].GetValue(out_schema, 1).ToString(), "c" + std::to_string(a));
+        }
+      }
+    }
+  }
+  GetExecutorContext()->SetVectorized(true);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, ZoneMapScanTest) {
+  // SELECT ts FROM zone_table WHERE ts <op> <constant> on an append-only time series, where the zone maps rule out most
+  // pages, and WHERE n = 5 on a column that is always null. One early row is moved to the end by an update.
+  const int64_t num_rows = 5000;
+  const int64_t moved_ts = 100000;
+  Schema table_schema({Column("ts", TypeId::BIGINT), Column("n", TypeId::INTEGER), Column("v", TypeId::VARCHAR, 16)});
+  for (TableLayout layout : {TableLayout::ROW, TableLayout::PAX}) {
+    std::string table_name = "zone_table" + std::to_string(static_cast<int>(layout));
+    auto table_info = GetCatalog()->CreateTable(GetTxn(), table_name, table_schema, layout);
+    auto make_tuple = [&](int64_t ts) {
+      return Tuple({ValueFactory::GetBigIntValue(ts), ValueFactory::GetNullValueByType(TypeId::INTEGER),
+                    ValueFactory::GetVarcharValue("v" + std::to_string(ts % 100))},
+                   &table_schema);
+    };
+    RID moved_rid;
+    for (int64_t i = 0; i < num_rows; i++) {
+      RID rid;
+      ASSERT_TRUE(table_info->table_->InsertTuple(make_tuple(i), &rid, GetTxn()));
+      if (i == 10) {
+        moved_rid = rid;
+      }
+    }
+    ASSERT_TRUE(table_info->table_->UpdateTuple(make_tuple(moved_ts), moved_rid, GetTxn()));
+
+    auto &schema = table_info->schema_;
+    auto scan_ts = MakeColumnValueExpression(schema, 0, "ts");
+    auto out_schema = MakeOutputSchema({{"ts", scan_ts}});
+    auto count_matches = [&](ComparisonType comp_type, int64_t constant) {
+      size_t count = 0;
+      for (int64_t i = 0; i < num_rows; i++) {
+        int64_t ts = i == 10 ? moved_ts : i;
+        count += (comp_type == ComparisonType::Equal && ts == constant) ||
+                         (comp_type == ComparisonType::NotEqual && ts != constant) ||
+                         (comp_type == ComparisonType::LessThan && ts < constant) ||
+                         (comp_type == ComparisonType::LessThanOrEqual && ts <= constant) ||
+                         (comp_type == ComparisonType::GreaterThan && ts > constant) ||
+                         (comp_type == ComparisonType::GreaterThanOrEqual && ts >= constant)
+                     ? 1
+                     : 0;
+      }
+      return count;
+    };
+    std::vector<std::pair<ComparisonType, int64_t>> queries{
+        {ComparisonType::GreaterThanOrEqual, 4990}, {ComparisonType::GreaterThan, num_rows},
+        {ComparisonType::LessThan, 50},             {ComparisonType::LessThanOrEqual, 0},
+        {ComparisonType::Equal, 10},                {ComparisonType::Equal, moved_ts},
+        {ComparisonType::NotEqual, 2500}};
+    for (bool vectorized : {false, true}) {
+      GetExecutorContext()->SetVectorized(vectorized);
+      for (const auto &[comp_type, constant] : queries) {
+        auto predicate =
+            MakeComparisonExpression(scan_ts, MakeConstantValueExpression(ValueFactory::GetBigIntValue(constant)),
+                                     comp_type);
+        SeqScanPlanNode scan_plan(out_schema, predicate, table_info->oid_);
+        std::vector<Tuple> result_set;
+        ExecutePlan(&scan_plan, &result_set);
+        ASSERT_EQ(result_set.size(), count_matches(comp_type, constant)) << static_cast<int>(comp_type) << constant;
+      }
+
+      auto scan_n = MakeColumnValueExpression(schema, 0, "n");
+      auto predicate = MakeComparisonExpression(scan_n, MakeConstantValueExpression(ValueFactory::GetIntegerValue(5)),
+                                                ComparisonType::Equal);
+      SeqScanPlanNode scan_plan(out_schema, predicate, table_info->oid_);
+      std::vector<Tuple> result_set;
+      ExecutePlan(&scan_plan, &result_set);
+      ASSERT_TRUE(result_set.empty());
+    }
+  }
+  GetExecutorContext()->SetVectorized(true);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, CompressedScanTest) {
+  // SELECT ts, city FROM events WHERE <column> <op> <constant> on a COMPRESSED table of an increasing time column, a
+  // low-cardinality VARCHAR that is null in every eleventh row, and two measures. The predicates on ts, city and amount
+  // are applied to the codes of the pages, the one on score to the decoded values.
+  const int64_t num_rows = 6000;
+  const int64_t start = 1600000000000;
+  const std::vector<std::string> cities{"Berlin", "Lisbon", "Oslo", "Pittsburgh", "Quebec"};
+  Schema table_schema({Column("ts", TypeId::BIGINT), Column("city", TypeId::VARCHAR, 16),
+                       Column("amount", TypeId::INTEGER), Column("score", TypeId::DECIMAL)});
+  auto table_info = GetCatalog()->CreateTable(GetTxn(), "events", table_schema, TableLayout::COMPRESSED);
+  auto is_null_city = [](int64_t i) { return i % 11 == 0; };
+  auto amount = [](int64_t i) { return static_cast<int32_t>(i * 37 % 1000); };
+  for (int64_t i = 0; i < num_rows; i++) {
+    Tuple tuple({ValueFactory::GetBigIntValue(start + i * 10),
+                 is_null_city(i) ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                                 : ValueFactory::GetVarcharValue(cities[i % cities.size()]),
+                 ValueFactory::GetIntegerValue(amount(i)), ValueFactory::GetDecimalValue(static_cast<double>(i) / 4)},
+                &table_schema);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+  // A row takes about 100 bits instead of the 34 bytes of the tuple and the 8 of its slot.
+  EXPECT_LT(table_info->table_->GetPageIds().size(), num_rows / 200);
+
+  struct Query {
+    uint32_t col_idx_;
+    ComparisonType comp_type_;
+    Value constant_;
+    std::function<bool(int64_t)> matches_;
+  };
+  std::vector<Query> queries{
+      {0, ComparisonType::GreaterThanOrEqual, ValueFactory::GetBigIntValue(start + 55000),
+       [&](int64_t i) { return i >= 5500; }},
+      {0, ComparisonType::LessThan, ValueFactory::GetBigIntValue(start + 123), [](int64_t i) { return i < 13; }},
+      {1, ComparisonType::Equal, ValueFactory::GetVarcharValue("Oslo"),
+       [&](int64_t i) { return !is_null_city(i) && i % 5 == 2; }},
+      {1, ComparisonType::LessThan, ValueFactory::GetVarcharValue("M"),
+       [&](int64_t i) { return !is_null_city(i) && i % 5 < 2; }},
+      {1, ComparisonType::GreaterThan, ValueFactory::GetVarcharValue("Pittsburgh"),
+       [&](int64_t i) { return !is_null_city(i) && i % 5 == 4; }},
+      {1, ComparisonType::Equal, ValueFactory::GetVarcharValue("Amsterdam"), [](int64_t /*i*/) { return false; }},
+      {2, ComparisonType::LessThanOrEqual, ValueFactory::GetTinyIntValue(10),
+       [&](int64_t i) { return amount(i) <= 10; }},
+      {2, ComparisonType::NotEqual, ValueFactory::GetIntegerValue(500), [&](int64_t i) { return amount(i) != 500; }},
+      {3, ComparisonType::GreaterThan, ValueFactory::GetDecimalValue(1400.0), [](int64_t i) { return i > 5600; }}};
+  auto &schema = table_info->schema_;
+  auto scan_ts = MakeColumnValueExpression(schema, 0, "ts");
+  auto scan_city = MakeColumnValueExpression(schema, 0, "city");
+  auto out_schema = MakeOutputSchema({{"ts", scan_ts}, {"city", scan_city}});
+  for (bool vectorized : {false, true}) {
+    GetExecutorContext()->SetVectorized(vectorized);
+    for (const auto &query : queries) {
+      auto column = MakeColumnValueExpression(schema, 0, schema.GetColumn(query.col_idx_).GetName());
+      auto predicate = MakeComparisonExpression(column, MakeConstantValueExpression(query.constant_), query.comp_type_);
+      SeqScanPlanNode scan_plan(out_schema, predicate, table_info->oid_);
+      std::vector<Tuple> result_set;
+      ExecutePlan(&scan_plan, &result_set);
+
+      // A COMPRESSED table returns its rows in insertion order.
+      size_t next = 0;
+      for (int64_t i = 0; i < num_rows; i++) {
+        if (!query.matches_(i)) {
+          continue;
+        }
+        ASSERT_LT(next, result_set.size()) << query.col_idx_ << " " << static_cast<int>(query.comp_type_);
+        const Tuple &tuple = result_set[next++];
+        ASSERT_EQ(tuple.GetValue(out_schema, 0).GetAs<int64_t>(), start + i * 10);
+        ASSERT_EQ(tuple.IsNull(out_schema, 1), is_null_city(i));
+        if (!is_null_city(i)) {
+          ASSERT_EQ(tuple.GetValue(out_schema, 1).ToString(), cities[i % cities.size()]);
+        }
+      }
+      ASSERT_EQ(next, result_set.size()) << query.col_idx_ << " " << static_cast<int>(query.comp_type_);
+    }
+  }
+  GetExecutorContext()->SetVectorized(true);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, ParallelSeqScanTest) {
+  // SELECT a, b FROM par_table WHERE a < 7000 on 1 and 4 worker threads
+  Schema table_schema({Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT)});
+  auto table_info = GetCatalog()->CreateTable(GetTxn(), "par_table", table_schema);
+  const int32_t num_rows = 10000;
+  for (int32_t i = 0; i < num_rows; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetBigIntValue(static_cast<int64_t>(i) * 3)},
+                &table_schema);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+
+  // The page directory follows the page chain, also when it is rebuilt for a table opened from disk.
+  std::vector<page_id_t> chain;
+  for (page_id_t page_id = table_info->table_->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    chain.push_back(page_id);
+    auto page = static_cast<TablePage *>(GetBPM()->FetchPage(page_id));
+    page_id_t next_page_id = page->GetNextPageId();
+    GetBPM()->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  ASSERT_GT(chain.size(), MORSEL_SIZE);
+  EXPECT_EQ(table_info->table_->GetPageIds(), chain);
+  TableHeap reopened(GetBPM(), nullptr, nullptr, table_info->table_->GetFirstPageId());
+  EXPECT_EQ(reopened.GetPageIds(), chain);
+
+  auto &schema = table_info->schema_;
+  auto scan_a = MakeColumnValueExpression(schema, 0, "a");
+  auto scan_b = MakeColumnValueExpression(schema, 0, "b");
+  auto predicate = MakeComparisonExpression(scan_a, MakeConstantValueExpression(ValueFactory::GetIntegerValue(7000)),
+                                            ComparisonType::LessThan);
+  auto scan_schema = MakeOutputSchema({{"a", scan_a}, {"b", scan_b}});
+  SeqScanPlanNode scan_plan(scan_schema, predicate, table_info->oid_);
+
+  auto run = [&](size_t worker_count) {
+    GetExecutorContext()->SetWorkerCount(worker_count);
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&scan_plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<int32_t> values;
+    for (const auto &tuple : result_set) {
+      int32_t a = tuple.GetValue(scan_schema, 0).GetAs<int32_t>();
+      EXPECT_EQ(tuple.GetValue(scan_schema, 1).GetAs<int64_t>(), static_cast<int64_t>(a) * 3);
+      values.push_back(a);
+    }
+    std::sort(values.begin(), values.end());
+    return values;
+  };
+  auto serial = run(1);
+  auto parallel = run(4);
+  ASSERT_EQ(serial.size(), 7000);
+  ASSERT_EQ(serial, parallel);
+
+  // A consumer that stops early releases the instances blocked on the exchange.
+  GetExecutorContext()->SetWorkerCount(1);
+  GatherPlanNode gather_plan(scan_schema, &scan_plan, 4);
+  for (bool vectorized : {true, false}) {
+    GetExecutorContext()->SetVectorized(vectorized);
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &gather_plan);
+    executor->Init();
+    VectorBatch batch;
+    ASSERT_TRUE(executor->PullBatch(&batch));
+    ASSERT_GT(batch.GetSize(), 0);
+  }
+  GetExecutorContext()->SetVectorized(true);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, ExchangeTest) {
+  // SELECT colB, count(colA), sum(colC) FROM test_1 GROUP BY colB, serially and on 4 instances partitioned by colB
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto colC = MakeColumnValueExpression(schema, 0, "colC");
+  auto scan_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"colC", colC}});
+  SeqScanPlanNode scan_plan(scan_schema, nullptr, table_info->oid_);
+  RepartitionPlanNode repartition_plan(scan_schema, &scan_plan, {MakeColumnValueExpression(*scan_schema, 0, "colB")});
+
+  const AbstractExpression *groupbyB = MakeAggregateValueExpression(true, 0);
+  const AbstractExpression *countA = MakeAggregateValueExpression(false, 0);
+  const AbstractExpression *sumC = MakeAggregateValueExpression(false, 1);
+  auto agg_schema = MakeOutputSchema({{"colB", groupbyB}, {"countA", countA}, {"sumC", sumC}});
+  auto make_agg = [&](const AbstractPlanNode *child) {
+    std::vector<const AbstractExpression *> group_bys{MakeColumnValueExpression(*scan_schema, 0, "colB")};
+    std::vector<const AbstractExpression *> aggregates{MakeColumnValueExpression(*scan_schema, 0, "colA"),
+                                                       MakeColumnValueExpression(*scan_schema, 0, "colC")};
+    std::vector<AggregationType> agg_types{AggregationType::CountAggregate, AggregationType::SumAggregate};
+    return std::make_unique<AggregationPlanNode>(agg_schema, child, nullptr, std::move(group_bys),
+                                                 std::move(aggregates), std::move(agg_types));
+  };
+  auto serial_plan = make_agg(&scan_plan);
+  auto partial_plan = make_agg(&repartition_plan);
+  GatherPlanNode gather_plan(agg_schema, partial_plan.get(), 4);
+
+  auto run = [&](const AbstractPlanNode *plan) {
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<std::string> rows;
+    for (const auto &tuple : result_set) {
+      rows.push_back(tuple.ToString(agg_schema));
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+  auto expected = run(serial_plan.get());
+  ASSERT_EQ(expected.size(), 10);
+  for (bool vectorized : {true, false}) {
+    GetExecutorContext()->SetVectorized(vectorized);
+    EXPECT_EQ(run(&gather_plan), expected);
+  }
+  GetExecutorContext()->SetVectorized(true);
+
+  // Outside of a gather, a repartition passes its child's tuples through.
+  EXPECT_EQ(run(partial_plan.get()), expected);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, ParallelAggregationTest) {
+  // SELECT b, count(a), sum(c), min(c), max(a) FROM agg_table GROUP BY b HAVING count(a) > 206, and
+  // SELECT count(a), sum(c), min(c), max(a) FROM agg_table, on 1 and 4 workers
+  // c is a BIGINT while the output columns are INTEGERs, the return type of the AggregateValueExpressions of this
+  // fixture, so its aggregates are cast to the narrower output columns.
+  Schema table_schema({Column("a", TypeId::INTEGER), Column("b", TypeId::INTEGER), Column("c", TypeId::BIGINT)});
+  auto table_info = GetCatalog()->CreateTable(GetTxn(), "agg_table", table_schema);
+  for (int32_t i = 0; i < 20000; i++) {
+    Value c =
+        i % 13 == 0 ? ValueFactory::GetNullValueByType(TypeId::BIGINT) : ValueFactory::GetBigIntValue(i * 7 % 1000);
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(i % 97), c}, &table_schema);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+  auto &schema = table_info->schema_;
+  auto scan_schema = MakeOutputSchema({{"a", MakeColumnValueExpression(schema, 0, "a")},
+                                       {"b", MakeColumnValueExpression(schema, 0, "b")},
+                                       {"c", MakeColumnValueExpression(schema, 0, "c")}});
+  SeqScanPlanNode scan_plan(scan_schema, nullptr, table_info->oid_);
+  auto a = MakeColumnValueExpression(*scan_schema, 0, "a");
+  auto b = MakeColumnValueExpression(*scan_schema, 0, "b");
+  auto c = MakeColumnValueExpression(*scan_schema, 0, "c");
+  std::vector<AggregationType> agg_types{AggregationType::CountAggregate, AggregationType::SumAggregate,
+                                         AggregationType::MinAggregate, AggregationType::MaxAggregate};
+  const AbstractExpression *groupbyB = MakeAggregateValueExpression(true, 0);
+  std::vector<const AbstractExpression *> agg_terms;
+  for (uint32_t i = 0; i < agg_types.size(); i++) {
+    agg_terms.push_back(MakeAggregateValueExpression(false, i));
+  }
+  auto having = MakeComparisonExpression(agg_terms[0], MakeConstantValueExpression(ValueFactory::GetIntegerValue(206)),
+                                         ComparisonType::GreaterThan);
+  auto group_by_schema = MakeOutputSchema({{"b", groupbyB},
+                                           {"countA", agg_terms[0]},
+                                           {"sumC", agg_terms[1]},
+                                           {"minC", agg_terms[2]},
+                                           {"maxA", agg_terms[3]}});
+  auto global_schema = MakeOutputSchema(
+      {{"countA", agg_terms[0]}, {"sumC", agg_terms[1]}, {"minC", agg_terms[2]}, {"maxA", agg_terms[3]}});
+  AggregationPlanNode group_by_plan(group_by_schema, &scan_plan, having, {b}, {a, c, c, a},
+                                    std::vector<AggregationType>(agg_types));
+  AggregationPlanNode global_plan(global_schema, &scan_plan, nullptr, {}, {a, c, c, a},
+                                  std::vector<AggregationType>(agg_types));
+
+  // The partial aggregations are repartitioned by key, or gathered into a single final aggregation without GROUP BY.
+  {
+    Optimizer optimizer(4);
+    const AbstractPlanNode *plan = optimizer.Optimize(&group_by_plan);
+    ASSERT_EQ(plan->GetType(), PlanType::Gather);
+    ASSERT_EQ(plan->GetChildAt(0)->GetType(), PlanType::Aggregation);
+    ASSERT_EQ(plan->GetChildAt(0)->GetChildAt(0)->GetType(), PlanType::Repartition);
+    ASSERT_EQ(plan->GetChildAt(0)->GetChildAt(0)->GetChildAt(0)->GetType(), PlanType::Aggregation);
+    ASSERT_EQ(plan->GetChildAt(0)->GetChildAt(0)->GetChildAt(0)->GetChildAt(0), &scan_plan);
+    plan = optimizer.Optimize(&global_plan);
+    ASSERT_EQ(plan->GetType(), PlanType::Aggregation);
+    ASSERT_EQ(plan->GetChildAt(0)->GetType(), PlanType::Gather);
+    ASSERT_EQ(plan->GetChildAt(0)->GetChildAt(0)->GetType(), PlanType::Aggregation);
+    // An AVG cannot be combined from partial AVGs, so only its scan runs in parallel.
+    AggregationPlanNode avg_plan(global_schema, &scan_plan, nullptr, {}, {a}, {AggregationType::AvgAggregate});
+    plan = optimizer.Optimize(&avg_plan);
+    ASSERT_EQ(plan->GetType(), PlanType::Aggregation);
+    ASSERT_EQ(plan->GetChildAt(0)->GetType(), PlanType::Gather);
+    ASSERT_EQ(plan->GetChildAt(0)->GetChildAt(0), &scan_plan);
+  }
+
+  auto run = [&](const AggregationPlanNode *plan, size_t worker_count) {
+    GetExecutorContext()->SetWorkerCount(worker_count);
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<std::string> rows;
+    for (const auto &tuple : result_set) {
+      rows.push_back(tuple.ToString(plan->OutputSchema()));
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+  for (bool vectorized : {true, false}) {
+    GetExecutorContext()->SetVectorized(vectorized);
+    auto expected = run(&group_by_plan, 1);
+    ASSERT_GT(expected.size(), 0);
+    ASSERT_LT(expected.size(), 97);
+    EXPECT_EQ(run(&group_by_plan, 4), expected);
+    expected = run(&global_plan, 1);
+    ASSERT_EQ(expected.size(), 1);
+    EXPECT_EQ(run(&global_plan, 4), expected);
+  }
+  GetExecutorContext()->SetVectorized(true);
+  GetExecutorContext()->SetWorkerCount(1);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SpillingAggregationTest) {
+  // SELECT b, c, count(a), sum(a), min(c), max(a) FROM spill_table GROUP BY b, c, with a memory budget far below the
+  // size of the groups
+  Schema table_schema({Column("a", TypeId::INTEGER), Column("b", TypeId::INTEGER), Column("c", TypeId::VARCHAR, 8)});
+  auto table_info = GetCatalog()->CreateTable(GetTxn(), "spill_table", table_schema);
+  for (int32_t i = 0; i < 10000; i++) {
+    Value b =
+        i % 101 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i % 2000);
+    Value c = ValueFactory::GetVarcharValue("key" + std::to_string(i % 3));
+    Tuple tuple({ValueFactory::GetIntegerValue(i), b, c}, &table_schema);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+  auto &schema = table_info->schema_;
+  auto scan_schema = MakeOutputSchema({{"a", MakeColumnValueExpression(schema, 0, "a")},
+                                       {"b", MakeColumnValueExpression(schema, 0, "b")},
+                                       {"c", MakeColumnValueExpression(schema, 0, "c")}});
+  SeqScanPlanNode scan_plan(scan_schema, nullptr, table_info->oid_);
+  auto a = MakeColumnValueExpression(*scan_schema, 0, "a");
+  auto b = MakeColumnValueExpression(*scan_schema, 0, "b");
+  auto c = MakeColumnValueExpression(*scan_schema, 0, "c");
+  AggregateValueExpression group_by_c(true, 1, TypeId::VARCHAR);
+  AggregateValueExpression min_c(false, 2, TypeId::VARCHAR);
+  Schema agg_output_schema({Column("b", TypeId::INTEGER, MakeAggregateValueExpression(true, 0)),
+                            Column("c", TypeId::VARCHAR, 8, &group_by_c),
+                            Column("countA", TypeId::INTEGER, MakeAggregateValueExpression(false, 0)),
+                            Column("sumA", TypeId::INTEGER, MakeAggregateValueExpression(false, 1)),
+                            Column("minC", TypeId::VARCHAR, 8, &min_c),
+                            Column("maxA", TypeId::INTEGER, MakeAggregateValueExpression(false, 3))});
+  const Schema *agg_schema = &agg_output_schema;
+  AggregationPlanNode agg_plan(agg_schema, &scan_plan, nullptr, {b, c}, {a, a, c, a},
+                               {AggregationType::CountAggregate, AggregationType::SumAggregate,
+                                AggregationType::MinAggregate, AggregationType::MaxAggregate});
+
+  auto aggregate = [&](size_t memory_budget, size_t *spilled_run_count) {
+    GetExecutorContext()->SetMemoryBudget(memory_budget);
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &agg_plan);
+    executor->Init();
+    std::vector<std::string> rows;
+    Tuple tuple;
+    RID rid;
+    while (executor->Next(&tuple, &rid)) {
+      rows.push_back(tuple.ToString(agg_schema));
+    }
+    *spilled_run_count = dynamic_cast<AggregationExecutor *>(executor.get())->GetSpilledRunCount();
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+  for (bool vectorized : {true, false}) {
+    GetExecutorContext()->SetVectorized(vectorized);
+    size_t spilled_run_count;
+    auto in_memory = aggregate(DEFAULT_QUERY_MEMORY, &spilled_run_count);
+    EXPECT_EQ(spilled_run_count, 0);
+    auto spilled = aggregate(4 * 1024, &spilled_run_count);
+    EXPECT_GT(spilled_run_count, AggregationExecutor::FANOUT);
+    // Every group is returned once, with the same aggregates.
+    ASSERT_GT(in_memory.size(), 5900);
+    EXPECT_EQ(spilled, in_memory);
+  }
+  GetExecutorContext()->SetVectorized(true);
+  GetExecutorContext()->SetMemoryBudget(DEFAULT_QUERY_MEMORY);
+}
+
 // NOLINTNEXTLINE
 TEST_F(ExecutorTest, SimpleAggregationTest) {
   // SELECT COUNT(colA), SUM(colA), min(colA), max(colA) from test_1;
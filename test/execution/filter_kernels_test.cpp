@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// filter_kernels_test.cpp
+//
+// Identification: test/execution/filter_kernels_test.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "common/config.h"
+#include "execution/filter_kernels.h"
+#include "gtest/gtest.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+const std::vector<ComparisonType> FILTER_TEST_COMPARISONS = {
+    ComparisonType::Equal,       ComparisonType::NotEqual,           ComparisonType::LessThan,
+    ComparisonType::GreaterThan, ComparisonType::GreaterThanOrEqual, ComparisonType::LessThanOrEqual};
+
+/** Checks CompareConstant() against the scalar kernel on vectors with nulls and sizes that are not multiples of 64. */
+template <typename T>
+void CheckAgainstScalar(T null_value) {
+  std::mt19937 generator(15445);
+  std::uniform_int_distribution<int> dist(-50, 50);
+  for (size_t size : std::vector<size_t>{0, 1, 7, 63, 64, 65, 200, 1024, 1027}) {
+    std::vector<T> values(size);
+    for (auto &value : values) {
+      int v = dist(generator);
+      value = v == 50 ? null_value : static_cast<T>(v);
+    }
+    for (auto comp_type : FILTER_TEST_COMPARISONS) {
+      for (T constant : std::vector<T>{-51, -3, 0, 12, 51}) {
+        std::vector<uint64_t> expected(FilterKernels::BitmaskWords(size));
+        std::vector<uint64_t> actual(FilterKernels::BitmaskWords(size));
+        FilterKernels::CompareConstantScalar<T>(values.data(), size, comp_type, constant, null_value, expected.data());
+        FilterKernels::CompareConstant(values.data(), size, comp_type, constant, actual.data());
+        ASSERT_EQ(expected, actual) << "size " << size << ", comparison " << static_cast<int>(comp_type);
+
+        std::vector<uint32_t> selection;
+        FilterKernels::BitmaskToSelection(actual.data(), size, &selection);
+        for (uint32_t row : selection) {
+          EXPECT_NE(values[row], null_value);
+        }
+        if (comp_type == ComparisonType::Equal || comp_type == ComparisonType::NotEqual) {
+          size_t nulls = 0;
+          size_t equal = 0;
+          for (T value : values) {
+            nulls += value == null_value ? 1 : 0;
+            equal += value == constant ? 1 : 0;
+          }
+          EXPECT_EQ(selection.size(), comp_type == ComparisonType::Equal ? equal : size - nulls - equal);
+        }
+      }
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(FilterKernelsTest, IntegerTest) { CheckAgainstScalar<int32_t>(BUSTUB_INT32_NULL); }
+
+// NOLINTNEXTLINE
+TEST(FilterKernelsTest, BigintTest) { CheckAgainstScalar<int64_t>(BUSTUB_INT64_NULL); }
+
+// NOLINTNEXTLINE
+TEST(FilterKernelsTest, DecimalTest) { CheckAgainstScalar<double>(BUSTUB_DECIMAL_NULL); }
+
+// Compares the throughput of the two kernels and asserts nothing, so it only runs with
+// --gtest_also_run_disabled_tests.
+// NOLINTNEXTLINE
+TEST(FilterKernelsTest, DISABLED_ThroughputTest) {
+  const size_t size = VECTOR_SIZE;
+  const int iterations = 20000;
+  std::mt19937 generator(15445);
+  std::uniform_int_distribution<int32_t> dist(0, 99);
+  std::vector<int32_t> values(size);
+  for (auto &value : values) {
+    value = dist(generator);
+  }
+  std::vector<uint64_t> bitmask(FilterKernels::BitmaskWords(size));
+  uint64_t matches = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    FilterKernels::CompareConstantScalar<int32_t>(values.data(), size, ComparisonType::LessThan, 30,
+                                                  BUSTUB_INT32_NULL, bitmask.data());
+    matches += bitmask[i % bitmask.size()];
+  }
+  std::chrono::duration<double> scalar = std::chrono::steady_clock::now() - start;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    FilterKernels::CompareConstant(values.data(), size, ComparisonType::LessThan, 30, bitmask.data());
+    matches += bitmask[i % bitmask.size()];
+  }
+  std::chrono::duration<double> vectorized = std::chrono::steady_clock::now() - start;
+  printf("scalar: %.0f values/s, %s: %.0f values/s (%lu)\n", iterations * size / scalar.count(),
+         FilterKernels::IsVectorized() ? "avx2" : "scalar", iterations * size / vectorized.count(),
+         static_cast<unsigned long>(matches % 2));  // NOLINT
+}
+
+}  // namespace bustub
@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// projection_map_test.cpp
+//
+// Identification: test/execution/projection_map_test.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/projection_map.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** Checks that every column of a tuple equals the expected value. */
+void ExpectValues(const Tuple &tuple, const Schema *schema, const std::vector<Value> &expected) {
+  for (uint32_t i = 0; i < expected.size(); i++) {
+    Value value = tuple.GetValue(schema, i);
+    EXPECT_EQ(value.IsNull(), expected[i].IsNull()) << "column " << i;
+    if (!value.IsNull()) {
+      EXPECT_EQ(value.CompareEquals(expected[i]), CmpBool::CmpTrue) << "column " << i;
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(ProjectionMapTest, ByNameTest) {
+  Schema left{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 16},
+                                  Column{"c", TypeId::BIGINT}, Column{"d", TypeId::DECIMAL}}};
+  Schema right{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"e", TypeId::VARCHAR, 16},
+                                   Column{"f", TypeId::SMALLINT}}};
+  Value null_varchar = ValueFactory::GetNullValueByType(TypeId::VARCHAR);
+  Tuple left_tuple({ValueFactory::GetIntegerValue(1), ValueFactory::GetVarcharValue("left"),
+                    ValueFactory::GetBigIntValue(1LL << 40), ValueFactory::GetDecimalValue(2.5)},
+                   &left);
+  Tuple right_tuple({ValueFactory::GetIntegerValue(2), null_varchar, ValueFactory::GetSmallIntValue(3)}, &right);
+
+  // Columns out of order, from both sides, with "a" taken from the left one.
+  Schema output{std::vector<Column>{Column{"f", TypeId::SMALLINT}, Column{"c", TypeId::BIGINT},
+                                    Column{"d", TypeId::DECIMAL}, Column{"e", TypeId::VARCHAR, 16},
+                                    Column{"b", TypeId::VARCHAR, 16}, Column{"a", TypeId::INTEGER}}};
+  ProjectionMap projection;
+  projection.InitByName(&output, {&left, &right});
+  std::vector<Value> expected{ValueFactory::GetSmallIntValue(3),     ValueFactory::GetBigIntValue(1LL << 40),
+                              ValueFactory::GetDecimalValue(2.5),    null_varchar,
+                              ValueFactory::GetVarcharValue("left"), ValueFactory::GetIntegerValue(1)};
+  Tuple owned = projection.Project({&left_tuple, &right_tuple});
+  EXPECT_TRUE(owned.IsAllocated());
+  ExpectValues(owned, &output, expected);
+  Arena arena;
+  Tuple view = projection.Project({&left_tuple, &right_tuple}, &arena);
+  EXPECT_FALSE(view.IsAllocated());
+  ExpectValues(view, &output, expected);
+
+  // An output column of another type than its input column is converted through a Value.
+  Schema cast_output{std::vector<Column>{Column{"a", TypeId::BIGINT}, Column{"b", TypeId::VARCHAR, 16}}};
+  projection.InitByName(&cast_output, {&left});
+  ExpectValues(projection.Project({&left_tuple}), &cast_output,
+               {ValueFactory::GetIntegerValue(1), ValueFactory::GetVarcharValue("left")});
+}
+
+// NOLINTNEXTLINE
+TEST(ProjectionMapTest, FromExpressionsTest) {
+  Schema left{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::INTEGER}}};
+  Schema right{std::vector<Column>{Column{"a", TypeId::INTEGER}}};
+  Tuple left_tuple({ValueFactory::GetIntegerValue(1), ValueFactory::GetIntegerValue(2)}, &left);
+  Tuple right_tuple({ValueFactory::GetIntegerValue(3)}, &right);
+
+  ColumnValueExpression left_b(0, 1, TypeId::INTEGER);
+  ColumnValueExpression right_a(1, 0, TypeId::INTEGER);
+  Schema output{std::vector<Column>{Column{"x", TypeId::INTEGER, &right_a}, Column{"y", TypeId::INTEGER, &left_b}}};
+  ProjectionMap projection;
+  ASSERT_TRUE(projection.InitFromExpressions(&output, {&left, &right}));
+  ExpectValues(projection.Project({&left_tuple, &right_tuple}), &output,
+               {ValueFactory::GetIntegerValue(3), ValueFactory::GetIntegerValue(2)});
+
+  // A computed column cannot be projected.
+  ConstantValueExpression constant(ValueFactory::GetIntegerValue(4));
+  Schema computed{std::vector<Column>{Column{"x", TypeId::INTEGER, &right_a}, Column{"z", TypeId::INTEGER, &constant}}};
+  EXPECT_FALSE(projection.InitFromExpressions(&computed, {&left, &right}));
+}
+
+}  // namespace bustub
@@ -0,0 +1,357 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_manager_test.cpp
+//
+// Identification: test/recovery/log_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "recovery/log_manager.h"
+#include "recovery/log_recovery.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+class LogManagerTest : public ::testing::Test {
+ protected:
+  // This function is called before every test.
+  void SetUp() override {
+    remove("test.db");
+    remove("test.log");
+  }
+
+  // This function is called after every test.
+  void TearDown() override {
+    remove("test.db");
+    remove("test.log");
+  };
+};
+
+// NOLINTNEXTLINE
+TEST_F(LogManagerTest, CommitIsDurableTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *log_manager = new LogManager(disk_manager);
+  auto *lock_manager = new LockManager();
+  auto *txn_manager = new TransactionManager(lock_manager, log_manager);
+
+  // Make sure the timeout is not what flushes the commit.
+  log_timeout = std::chrono::seconds(15);
+  log_manager->RunFlushThread();
+  ASSERT_TRUE(enable_logging);
+
+  Transaction *txn = txn_manager->Begin();
+  lsn_t begin_lsn = txn->GetPrevLSN();
+  EXPECT_EQ(begin_lsn, 0);
+  EXPECT_EQ(log_manager->GetPersistentLSN(), INVALID_LSN);
+
+  txn_manager->Commit(txn);
+  lsn_t commit_lsn = txn->GetPrevLSN();
+  EXPECT_EQ(commit_lsn, begin_lsn + 1);
+  EXPECT_GE(log_manager->GetPersistentLSN(), commit_lsn);
+
+  // The log file contains the BEGIN record followed by the COMMIT record.
+  char buffer[PAGE_SIZE];
+  ASSERT_TRUE(disk_manager->ReadLog(buffer, PAGE_SIZE, 0));
+  EXPECT_EQ(*reinterpret_cast<int32_t *>(buffer), 20);
+  EXPECT_EQ(*reinterpret_cast<lsn_t *>(buffer + 4), begin_lsn);
+  EXPECT_EQ(*reinterpret_cast<LogRecordType *>(buffer + 16), LogRecordType::BEGIN);
+  EXPECT_EQ(*reinterpret_cast<lsn_t *>(buffer + 20 + 4), commit_lsn);
+  EXPECT_EQ(*reinterpret_cast<lsn_t *>(buffer + 20 + 12), begin_lsn);
+  EXPECT_EQ(*reinterpret_cast<LogRecordType *>(buffer + 20 + 16), LogRecordType::COMMIT);
+
+  log_manager->StopFlushThread();
+  EXPECT_FALSE(enable_logging);
+  log_timeout = std::chrono::seconds(1);
+
+  delete txn;
+  delete txn_manager;
+  delete lock_manager;
+  delete log_manager;
+  disk_manager->ShutDown();
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST_F(LogManagerTest, FullBufferTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *log_manager = new LogManager(disk_manager);
+  log_timeout = std::chrono::seconds(15);
+  log_manager->RunFlushThread();
+
+  // Appending more than a log buffer worth of records must not block forever.
+  const int num_records = 3 * LOG_BUFFER_SIZE / 20;
+  for (int i = 0; i < num_records; i++) {
+    LogRecord log_record(0, i - 1, LogRecordType::BEGIN);
+    EXPECT_EQ(log_manager->AppendLogRecord(&log_record), i);
+  }
+  EXPECT_GE(disk_manager->GetNumFlushes(), 2);
+  log_manager->StopFlushThread();
+  EXPECT_EQ(log_manager->GetPersistentLSN(), num_records - 1);
+  log_timeout = std::chrono::seconds(1);
+
+  delete log_manager;
+  disk_manager->ShutDown();
+  delete disk_manager;
+}
+
+/** Commits from num_threads threads at once, as TransactionManager::Commit does: append a COMMIT record and wait. */
+void CommitConcurrently(LogManager *log_manager, int num_threads, int commits_per_thread) {
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([log_manager, tid, commits_per_thread] {
+      for (int i = 0; i < commits_per_thread; i++) {
+        LogRecord log_record(tid, INVALID_LSN, LogRecordType::COMMIT);
+        lsn_t lsn = log_manager->AppendLogRecord(&log_record);
+        log_manager->Flush(lsn);
+        ASSERT_GE(log_manager->GetPersistentLSN(), lsn);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(LogManagerTest, GroupCommitTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *log_manager = new LogManager(disk_manager);
+  // Only the committers trigger flushes, so every write serves the commits that queued up behind the previous one.
+  log_timeout = std::chrono::seconds(15);
+  log_manager->RunFlushThread();
+
+  const int num_threads = 8;
+  const int commits_per_thread = 500;
+  CommitConcurrently(log_manager, num_threads, commits_per_thread);
+  log_manager->StopFlushThread();
+  log_timeout = std::chrono::seconds(1);
+
+  // Every commit is durable, and concurrent committers share log writes.
+  const int num_commits = num_threads * commits_per_thread;
+  EXPECT_EQ(log_manager->GetPersistentLSN(), num_commits - 1);
+  EXPECT_LT(disk_manager->GetNumFlushes(), num_commits / 2);
+
+  delete log_manager;
+  disk_manager->ShutDown();
+  delete disk_manager;
+}
+
+// Reports commits/sec and log writes per commit for 1 to 16 committers. Run with --gtest_also_run_disabled_tests.
+// NOLINTNEXTLINE
+TEST_F(LogManagerTest, DISABLED_GroupCommitBenchmark) {
+  const int num_commits = 8000;
+  for (int num_threads : {1, 4, 16}) {
+    remove("test.log");
+    auto *disk_manager = new DiskManager("test.db");
+    auto *log_manager = new LogManager(disk_manager);
+    log_manager->RunFlushThread();
+
+    auto start = std::chrono::steady_clock::now();
+    CommitConcurrently(log_manager, num_threads, num_commits / num_threads);
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    log_manager->StopFlushThread();
+    EXPECT_EQ(log_manager->GetPersistentLSN(), num_commits - 1);
+    std::cout << "group commit with " << num_threads << " threads: " << static_cast<int64_t>(num_commits / elapsed)
+              << " commits/sec, " << static_cast<double>(disk_manager->GetNumFlushes()) / num_commits
+              << " log writes per commit" << std::endl;
+
+    delete log_manager;
+    disk_manager->ShutDown();
+    delete disk_manager;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(LogManagerTest, ConcurrentAppendTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *log_manager = new LogManager(disk_manager);
+  log_manager->RunFlushThread();
+
+  // Every thread appends INSERT records with its own tuple size, filled with its thread id, so that torn or
+  // interleaved copies show up when the log is read back. The log buffer fills up several times on the way.
+  const int num_threads = 8;
+  const int records_per_thread = 20000;
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([log_manager, tid] {
+      std::vector<char> storage(sizeof(int32_t) + 8 + 4 * tid, static_cast<char>(tid));
+      *reinterpret_cast<int32_t *>(storage.data()) = static_cast<int32_t>(storage.size() - sizeof(int32_t));
+      Tuple tuple;
+      tuple.DeserializeFrom(storage.data());
+      lsn_t prev_lsn = INVALID_LSN;
+      for (int i = 0; i < records_per_thread; i++) {
+        LogRecord log_record(tid, prev_lsn, LogRecordType::INSERT, RID(tid, i), tuple);
+        lsn_t lsn = log_manager->AppendLogRecord(&log_record);
+        ASSERT_GT(lsn, prev_lsn);
+        prev_lsn = lsn;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  log_manager->StopFlushThread();
+
+  const int num_records = num_threads * records_per_thread;
+  EXPECT_EQ(log_manager->GetNextLSN(), num_records);
+  EXPECT_EQ(log_manager->GetPersistentLSN(), num_records - 1);
+
+  // The records are in LSN order and each one is intact.
+  std::vector<int> next_rid(num_threads, 0);
+  char buffer[PAGE_SIZE];
+  int file_offset = 0;
+  for (lsn_t expected_lsn = 0; expected_lsn < num_records; expected_lsn++) {
+    ASSERT_TRUE(disk_manager->ReadLog(buffer, PAGE_SIZE, file_offset));
+    auto tid = *reinterpret_cast<txn_id_t *>(buffer + 8);
+    ASSERT_GE(tid, 0);
+    ASSERT_LT(tid, num_threads);
+    int tuple_size = 8 + 4 * tid;
+    ASSERT_EQ(*reinterpret_cast<int32_t *>(buffer), 20 + static_cast<int>(sizeof(RID)) + 4 + tuple_size);
+    ASSERT_EQ(*reinterpret_cast<lsn_t *>(buffer + 4), expected_lsn);
+    ASSERT_EQ(*reinterpret_cast<LogRecordType *>(buffer + 16), LogRecordType::INSERT);
+    RID rid;
+    memcpy(&rid, buffer + 20, sizeof(RID));
+    ASSERT_EQ(rid, RID(tid, next_rid[tid]++));
+    ASSERT_EQ(*reinterpret_cast<int32_t *>(buffer + 28), tuple_size);
+    for (int i = 0; i < tuple_size; i++) {
+      ASSERT_EQ(buffer[32 + i], static_cast<char>(tid));
+    }
+    file_offset += *reinterpret_cast<int32_t *>(buffer);
+  }
+  EXPECT_FALSE(disk_manager->ReadLog(buffer, PAGE_SIZE, file_offset));
+
+  delete log_manager;
+  disk_manager->ShutDown();
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST_F(LogManagerTest, DeltaUpdateRecordTest) {
+  std::vector<Column> columns;
+  for (int i = 0; i < 16; i++) {
+    columns.emplace_back("col" + std::to_string(i), TypeId::BIGINT);
+  }
+  columns.emplace_back("name", TypeId::VARCHAR, 64);
+  Schema schema(columns);
+  auto make_tuple = [&](int64_t changed, const std::string &name) {
+    std::vector<Value> values;
+    for (int i = 0; i < 16; i++) {
+      values.emplace_back(TypeId::BIGINT, static_cast<int64_t>(i == 3 ? changed : i));
+    }
+    values.emplace_back(TypeId::VARCHAR, name);
+    return Tuple(values, &schema);
+  };
+  auto check_deltas = [](LogRecord *log_record, const Tuple &old_tuple, const Tuple &new_tuple) {
+    Tuple redone = log_record->ApplyDeltas(old_tuple, true);
+    Tuple undone = log_record->ApplyDeltas(new_tuple, false);
+    ASSERT_EQ(redone.GetLength(), new_tuple.GetLength());
+    ASSERT_EQ(undone.GetLength(), old_tuple.GetLength());
+    EXPECT_EQ(memcmp(redone.GetData(), new_tuple.GetData(), new_tuple.GetLength()), 0);
+    EXPECT_EQ(memcmp(undone.GetData(), old_tuple.GetData(), old_tuple.GetLength()), 0);
+  };
+
+  // One fixed-size column changes: only its bytes are logged.
+  Tuple old_tuple = make_tuple(3, "bustub");
+  Tuple new_tuple = make_tuple(1 << 20, "bustub");
+  LogRecord full(0, INVALID_LSN, LogRecordType::UPDATE, RID(1, 1), old_tuple, new_tuple);
+  LogRecord delta(0, INVALID_LSN, LogRecordType::DELTA_UPDATE, RID(1, 1), old_tuple, new_tuple);
+  EXPECT_EQ(delta.GetLogRecordType(), LogRecordType::DELTA_UPDATE);
+  EXPECT_EQ(delta.GetDeltas().size(), 1);
+  EXPECT_LT(delta.GetSize() * 4, full.GetSize());
+  check_deltas(&delta, old_tuple, new_tuple);
+
+  // The varchar grows, which shifts everything behind it.
+  Tuple longer_tuple = make_tuple(3, "bustub database");
+  LogRecord resized(0, INVALID_LSN, LogRecordType::DELTA_UPDATE, RID(1, 1), old_tuple, longer_tuple);
+  EXPECT_EQ(resized.GetLogRecordType(), LogRecordType::DELTA_UPDATE);
+  check_deltas(&resized, old_tuple, longer_tuple);
+
+  // Completely different tuples are logged in full.
+  std::vector<Value> values;
+  for (int i = 0; i < 16; i++) {
+    values.emplace_back(TypeId::BIGINT, static_cast<int64_t>(-i - 100));
+  }
+  values.emplace_back(TypeId::VARCHAR, std::string("other"));
+  Tuple other_tuple(values, &schema);
+  LogRecord fallback(0, INVALID_LSN, LogRecordType::DELTA_UPDATE, RID(1, 1), old_tuple, other_tuple);
+  EXPECT_EQ(fallback.GetLogRecordType(), LogRecordType::UPDATE);
+
+  // Both formats survive the trip through the log.
+  auto *disk_manager = new DiskManager("test.db");
+  auto *log_manager = new LogManager(disk_manager);
+  log_manager->RunFlushThread();
+  log_manager->AppendLogRecord(&full);
+  log_manager->AppendLogRecord(&delta);
+  log_manager->StopFlushThread();
+
+  std::vector<char> buffer(LOG_BUFFER_SIZE);
+  ASSERT_TRUE(disk_manager->ReadLog(buffer.data(), LOG_BUFFER_SIZE, 0));
+  BufferPoolManager bpm(4, disk_manager);
+  LogRecovery log_recovery(disk_manager, &bpm);
+  LogRecord read_full;
+  LogRecord read_delta;
+  ASSERT_TRUE(log_recovery.DeserializeLogRecord(buffer.data(), &read_full));
+  ASSERT_TRUE(log_recovery.DeserializeLogRecord(buffer.data() + full.GetSize(), &read_delta));
+  EXPECT_EQ(read_full.GetLogRecordType(), LogRecordType::UPDATE);
+  EXPECT_EQ(memcmp(read_full.GetUpdateTuple().GetData(), new_tuple.GetData(), new_tuple.GetLength()), 0);
+  EXPECT_EQ(read_delta.GetLogRecordType(), LogRecordType::DELTA_UPDATE);
+  EXPECT_EQ(read_delta.GetSize(), delta.GetSize());
+  check_deltas(&read_delta, old_tuple, new_tuple);
+
+  delete log_manager;
+  disk_manager->ShutDown();
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST_F(LogManagerTest, CompressedLogTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *log_manager = new LogManager(disk_manager, true);
+  log_manager->RunFlushThread();
+
+  std::vector<char> storage(sizeof(int32_t) + 64, 'x');
+  *reinterpret_cast<int32_t *>(storage.data()) = 64;
+  Tuple tuple;
+  tuple.DeserializeFrom(storage.data());
+  const int num_records = 3 * LOG_BUFFER_SIZE / 100;
+  int raw_size = 0;
+  for (int i = 0; i < num_records; i++) {
+    LogRecord log_record(i % 4, INVALID_LSN, LogRecordType::INSERT, RID(i / 50, i % 50), tuple);
+    log_manager->AppendLogRecord(&log_record);
+    raw_size += log_record.GetSize();
+  }
+  log_manager->StopFlushThread();
+  EXPECT_EQ(log_manager->GetPersistentLSN(), num_records - 1);
+
+  // The log is made of compressed blocks that are much smaller than the records.
+  int32_t block_header[3];
+  int offset = 0;
+  int decompressed_size = 0;
+  while (disk_manager->ReadLog(reinterpret_cast<char *>(block_header), sizeof(block_header), offset)) {
+    ASSERT_EQ(block_header[0], COMPRESSED_BLOCK_MARKER);
+    decompressed_size += block_header[2];
+    offset += COMPRESSED_BLOCK_HEADER_SIZE + block_header[1];
+  }
+  EXPECT_EQ(decompressed_size, raw_size);
+  EXPECT_LT(offset * 4, raw_size);
+
+  delete log_manager;
+  disk_manager->ShutDown();
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -10,7 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <random>
 #include <string>
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "common/bustub_instance.h"
@@ -19,8 +24,10 @@
 #include "concurrency/transaction_manager.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "recovery/checkpoint_manager.h"
 #include "recovery/log_recovery.h"
 #include "storage/table/table_heap.h"
+#include "storage/page/table_page.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
@@ -40,10 +47,131 @@ class RecoveryTest : public ::testing::Test {
     remove("test.db");
     remove("test.log");
   };
+
+  /**
+   * Writes a log of num_txns transactions over num_pages pages, none of which reach the disk, and recovers from it with
+   * every number of workers. Checks every page after redo and every loser after undo, and prints the recovery times if
+   * report_time is set.
+   */
+  void CheckParallelRecovery(int num_pages, int num_txns, const std::vector<size_t> &worker_counts, bool report_time) {
+    const int ops_per_txn = 100;
+    const int num_losers = 20;
+
+    Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::INTEGER}}};
+    auto make_tuple = [&](int a, int b) {
+      return Tuple{std::vector<Value>{Value(TypeId::INTEGER, a), Value(TypeId::INTEGER, b)}, &schema};
+    };
+
+    // Run the workload on private copies of the pages to know which RIDs the log must contain and what the pages look
+    // like after redo. The LSN of the i-th record is i because the log is appended by a single thread below.
+    ASSERT_FALSE(enable_logging);
+    std::unique_ptr<Page[]> expected_pages(new Page[num_pages]);
+    std::vector<LogRecord> log_records;
+    std::vector<RID> loser_rids;
+    std::vector<uint32_t> tuple_counts(num_pages, 0);
+    std::mt19937 generator(15445);
+    auto table_page = [&](int page_id) { return reinterpret_cast<TablePage *>(&expected_pages[page_id]); };
+
+    lsn_t prev_lsn = INVALID_LSN;
+    for (int page_id = 0; page_id < num_pages; page_id++) {
+      table_page(page_id)->Init(page_id, PAGE_SIZE, page_id - 1, nullptr, nullptr);
+      table_page(page_id)->SetLSN(log_records.size());
+      log_records.emplace_back(0, prev_lsn, LogRecordType::NEWPAGE, page_id - 1, page_id);
+      prev_lsn = log_records.size() - 1;
+      if (page_id > 0) {
+        table_page(page_id - 1)->SetNextPageId(page_id);
+      }
+    }
+    log_records.emplace_back(0, prev_lsn, LogRecordType::COMMIT);
+
+    for (txn_id_t txn_id = 1; txn_id <= num_txns; txn_id++) {
+      bool is_loser = txn_id > num_txns - num_losers;
+      prev_lsn = log_records.size();
+      log_records.emplace_back(txn_id, INVALID_LSN, LogRecordType::BEGIN);
+      for (int i = 0; i < ops_per_txn; i++) {
+        int page_id = (txn_id * ops_per_txn + i) % num_pages;
+        TablePage *page = table_page(page_id);
+        lsn_t lsn = log_records.size();
+        Tuple tuple = make_tuple(txn_id, i);
+        if (!is_loser && i % 5 == 0 && tuple_counts[page_id] > 0) {
+          RID rid(page_id, generator() % tuple_counts[page_id]);
+          Tuple old_tuple;
+          ASSERT_TRUE(page->UpdateTuple(tuple, &old_tuple, rid, nullptr, nullptr, nullptr));
+          log_records.emplace_back(txn_id, prev_lsn, LogRecordType::UPDATE, rid, old_tuple, tuple);
+        } else {
+          RID rid;
+          ASSERT_TRUE(page->InsertTuple(tuple, &rid, nullptr, nullptr, nullptr));
+          log_records.emplace_back(txn_id, prev_lsn, LogRecordType::INSERT, rid, tuple);
+          tuple_counts[page_id]++;
+          if (is_loser) {
+            loser_rids.push_back(rid);
+          }
+        }
+        page->SetLSN(lsn);
+        prev_lsn = lsn;
+      }
+      if (!is_loser) {
+        log_records.emplace_back(txn_id, prev_lsn, LogRecordType::COMMIT);
+      }
+    }
+
+    // Write the log. None of the pages reach the disk, so recovery has to redo every record.
+    {
+      auto *disk_manager = new DiskManager("test.db");
+      auto *log_manager = new LogManager(disk_manager);
+      log_manager->RunFlushThread();
+      for (auto &log_record : log_records) {
+        log_manager->AppendLogRecord(&log_record);
+      }
+      log_manager->StopFlushThread();
+      ASSERT_EQ(log_manager->GetPersistentLSN(), static_cast<lsn_t>(log_records.size() - 1));
+      delete log_manager;
+      disk_manager->ShutDown();
+      delete disk_manager;
+    }
+
+    for (size_t num_workers : worker_counts) {
+      remove("test.db");
+      auto *disk_manager = new DiskManager("test.db");
+      auto *bpm = new BufferPoolManager(num_pages + 64, disk_manager);
+      auto *log_recovery = new LogRecovery(disk_manager, bpm, num_workers);
+
+      auto start = std::chrono::steady_clock::now();
+      log_recovery->Redo();
+      auto redo_elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      for (int page_id = 0; page_id < num_pages; page_id++) {
+        Page *page = bpm->FetchPage(page_id);
+        ASSERT_EQ(memcmp(page->GetData(), expected_pages[page_id].GetData(), PAGE_SIZE), 0);
+        bpm->UnpinPage(page_id, false);
+      }
+
+      start = std::chrono::steady_clock::now();
+      log_recovery->Undo();
+      auto undo_elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      for (const RID &rid : loser_rids) {
+        auto *page = reinterpret_cast<TablePage *>(bpm->FetchPage(rid.GetPageId()));
+        Tuple tuple;
+        EXPECT_FALSE(page->GetTuple(rid, &tuple, nullptr, nullptr));
+        bpm->UnpinPage(rid.GetPageId(), false);
+      }
+      if (report_time) {
+        std::cout << "recovery with " << num_workers << " workers: redo "
+                  << static_cast<int64_t>(log_records.size() / redo_elapsed) << " records/sec, undo of " << num_losers
+                  << " losers " << undo_elapsed * 1000 << " ms" << std::endl;
+      }
+
+      delete log_recovery;
+      delete bpm;
+      disk_manager->ShutDown();
+      delete disk_manager;
+    }
+  }
 };
 
 // NOLINTNEXTLINE
-TEST_F(RecoveryTest, DISABLED_RedoTest) {
+TEST_F(RecoveryTest, RedoTest) {
   BustubInstance *bustub_instance = new BustubInstance("test.db");
 
   ASSERT_FALSE(enable_logging);
@@ -132,7 +260,7 @@ TEST_F(RecoveryTest, DISABLED_RedoTest) {
 }
 
 // NOLINTNEXTLINE
-TEST_F(RecoveryTest, DISABLED_UndoTest) {
+TEST_F(RecoveryTest, UndoTest) {
   BustubInstance *bustub_instance = new BustubInstance("test.db");
 
   ASSERT_FALSE(enable_logging);
@@ -211,7 +339,7 @@ TEST_F(RecoveryTest, DISABLED_UndoTest) {
 }
 
 // NOLINTNEXTLINE
-TEST_F(RecoveryTest, DISABLED_CheckpointTest) {
+TEST_F(RecoveryTest, CheckpointTest) {
   BustubInstance *bustub_instance = new BustubInstance("test.db");
 
   EXPECT_FALSE(enable_logging);
@@ -313,4 +441,333 @@ TEST_F(RecoveryTest, DISABLED_CheckpointTest) {
   LOG_INFO("Shutdown System");
   delete bustub_instance;
 }
+
+// NOLINTNEXTLINE
+TEST_F(RecoveryTest, FuzzyCheckpointTest) {
+  auto *bustub_instance = new BustubInstance("test.db");
+  bustub_instance->log_manager_->RunFlushThread();
+
+  Transaction *txn = bustub_instance->transaction_manager_->Begin();
+  auto *test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                                   bustub_instance->log_manager_, txn);
+  page_id_t first_page_id = test_table->GetFirstPageId();
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  Schema schema{std::vector<Column>{col1, col2}};
+  Tuple tuple = ConstructTuple(&schema);
+
+  // Keep inserting while the checkpoint is taken: the checkpoint must not wait for the transactions.
+  const int num_txns = 40;
+  const int inserts_per_txn = 25;
+  std::thread writer([&] {
+    for (int i = 0; i < num_txns; i++) {
+      Transaction *writer_txn = bustub_instance->transaction_manager_->Begin();
+      for (int j = 0; j < inserts_per_txn; j++) {
+        RID rid;
+        ASSERT_TRUE(test_table->InsertTuple(tuple, &rid, writer_txn));
+      }
+      bustub_instance->transaction_manager_->Commit(writer_txn);
+      delete writer_txn;
+    }
+  });
+  for (int i = 0; i < 3; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    bustub_instance->checkpoint_manager_->BeginCheckpoint();
+    bustub_instance->checkpoint_manager_->EndCheckpoint();
+  }
+  writer.join();
+
+  // A transaction that is still running at the crash.
+  Transaction *loser_txn = bustub_instance->transaction_manager_->Begin();
+  std::vector<RID> loser_rids(10);
+  for (auto &rid : loser_rids) {
+    ASSERT_TRUE(test_table->InsertTuple(tuple, &rid, loser_txn));
+  }
+  bustub_instance->log_manager_->Flush(loser_txn->GetPrevLSN());
+  delete loser_txn;
+  delete test_table;
+
+  LOG_INFO("System crash");
+  delete bustub_instance;
+  bustub_instance = new BustubInstance("test.db");
+
+  auto *log_recovery = new LogRecovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_);
+  log_recovery->Redo();
+  // The log starts with the table creation, which was checkpointed long ago.
+  EXPECT_GT(log_recovery->GetRedoLSN(), 0);
+  log_recovery->Undo();
+  delete log_recovery;
+
+  txn = bustub_instance->transaction_manager_->Begin();
+  test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                             bustub_instance->log_manager_, first_page_id);
+  int num_tuples = 0;
+  for (auto it = test_table->Begin(txn); it != test_table->End(); ++it) {
+    EXPECT_EQ(it->GetValue(&schema, 0).CompareEquals(tuple.GetValue(&schema, 0)), CmpBool::CmpTrue);
+    num_tuples++;
+  }
+  EXPECT_EQ(num_tuples, num_txns * inserts_per_txn);
+  for (const auto &rid : loser_rids) {
+    Tuple old_tuple;
+    EXPECT_FALSE(test_table->GetTuple(rid, &old_tuple, txn));
+  }
+  bustub_instance->transaction_manager_->Commit(txn);
+  delete txn;
+  delete test_table;
+  delete bustub_instance;
+}
+
+// NOLINTNEXTLINE
+TEST_F(RecoveryTest, LargeCheckpointTest) {
+  // More dirty pages than one log record can list.
+  const int num_pages = 2 * LogRecord::MaxDirtyPagesPerRecord() + 100;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *log_manager = new LogManager(disk_manager);
+  auto *bpm = new BufferPoolManager(num_pages + 64, disk_manager, log_manager);
+  auto *checkpoint_manager = new CheckpointManager(nullptr, log_manager, bpm);
+  log_manager->RunFlushThread();
+
+  Transaction txn(0);
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    page_id_t new_page_id;
+    auto *page = reinterpret_cast<TablePage *>(bpm->NewPage(&new_page_id));
+    ASSERT_NE(page, nullptr);
+    ASSERT_EQ(new_page_id, page_id);
+    page->Init(page_id, PAGE_SIZE, page_id - 1, log_manager, &txn);
+    bpm->UnpinPage(page_id, true);
+  }
+  LogRecord commit_record(txn.GetTransactionId(), txn.GetPrevLSN(), LogRecordType::COMMIT);
+  log_manager->AppendLogRecord(&commit_record);
+
+  checkpoint_manager->BeginCheckpoint();
+  checkpoint_manager->EndCheckpoint();
+  log_manager->StopFlushThread();
+
+  // The dirty page table is split across several records that together list every page.
+  auto *log_recovery = new LogRecovery(disk_manager, bpm);
+  std::unique_ptr<char[]> log_buffer(new char[LOG_BUFFER_SIZE]);
+  int offset = 0;
+  int num_checkpoint_records = 0;
+  size_t num_dirty_pages = 0;
+  bool found_end = false;
+  while (!found_end && disk_manager->ReadLog(log_buffer.get(), LOG_BUFFER_SIZE, offset)) {
+    int pos = 0;
+    while (pos + static_cast<int>(sizeof(int32_t)) <= LOG_BUFFER_SIZE) {
+      int32_t record_size;
+      memcpy(&record_size, log_buffer.get() + pos, sizeof(int32_t));
+      // The end of the log, or a record that continues in the next read.
+      if (record_size <= 0 || pos + record_size > LOG_BUFFER_SIZE) {
+        break;
+      }
+      LogRecord log_record;
+      ASSERT_TRUE(log_recovery->DeserializeLogRecord(log_buffer.get() + pos, &log_record));
+      pos += record_size;
+      if (log_record.GetLogRecordType() == LogRecordType::CHECKPOINT_DIRTY_PAGES ||
+          log_record.GetLogRecordType() == LogRecordType::END_CHECKPOINT) {
+        num_checkpoint_records++;
+        num_dirty_pages += log_record.GetDirtyPageTable().size();
+        found_end = log_record.GetLogRecordType() == LogRecordType::END_CHECKPOINT;
+      }
+    }
+    ASSERT_GT(pos, 0);
+    offset += pos;
+  }
+  EXPECT_TRUE(found_end);
+  EXPECT_EQ(num_checkpoint_records, 3);
+  EXPECT_EQ(num_dirty_pages, static_cast<size_t>(num_pages));
+  delete log_recovery;
+
+  delete checkpoint_manager;
+  delete bpm;
+  delete log_manager;
+  disk_manager->ShutDown();
+  delete disk_manager;
+
+  // Redo starts from the first page, whose recLSN is in the first part.
+  disk_manager = new DiskManager("test.db");
+  bpm = new BufferPoolManager(BUFFER_POOL_SIZE, disk_manager);
+  log_recovery = new LogRecovery(disk_manager, bpm);
+  log_recovery->Redo();
+  EXPECT_EQ(log_recovery->GetRedoLSN(), 0);
+  log_recovery->Undo();
+  delete log_recovery;
+  delete bpm;
+  disk_manager->ShutDown();
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST_F(RecoveryTest, ParallelRedoTest) { CheckParallelRecovery(1000, 2000, {1, 4}, false); }
+
+// Times serial against parallel recovery of a larger log. Run with --gtest_also_run_disabled_tests.
+// NOLINTNEXTLINE
+TEST_F(RecoveryTest, DISABLED_ParallelRedoBenchmark) { CheckParallelRecovery(8000, 10000, {1, 2, 4, 8}, true); }
+
+// NOLINTNEXTLINE
+TEST_F(RecoveryTest, RepeatedRecoveryTest) {
+  Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}}};
+  auto make_tuple = [&](int a) { return Tuple{std::vector<Value>{Value(TypeId::INTEGER, a)}, &schema}; };
+
+  // Txn 0 inserts three tuples and txn 1 deletes the first one. Loser txn 2 updates the third tuple, deletes the
+  // second one and inserts a tuple into the slot of the first one. The page never reaches the disk.
+  ASSERT_FALSE(enable_logging);
+  Page expected_page;
+  auto *page = reinterpret_cast<TablePage *>(&expected_page);
+  std::vector<LogRecord> log_records;
+  page->Init(0, PAGE_SIZE, INVALID_PAGE_ID, nullptr, nullptr);
+  log_records.emplace_back(0, INVALID_LSN, LogRecordType::NEWPAGE, INVALID_PAGE_ID, 0);
+  std::vector<RID> rids(3);
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(page->InsertTuple(make_tuple(i), &rids[i], nullptr, nullptr, nullptr));
+    log_records.emplace_back(0, log_records.size() - 1, LogRecordType::INSERT, rids[i], make_tuple(i));
+  }
+  log_records.emplace_back(0, log_records.size() - 1, LogRecordType::COMMIT);
+  auto delete_tuple = [&](txn_id_t txn_id, const RID &rid) {
+    Tuple tuple;
+    ASSERT_TRUE(page->GetTuple(rid, &tuple, nullptr, nullptr));
+    ASSERT_TRUE(page->MarkDelete(rid, nullptr, nullptr, nullptr));
+    log_records.emplace_back(txn_id, log_records.size() - 1, LogRecordType::MARKDELETE, rid, Tuple());
+    page->ApplyDelete(rid, nullptr, nullptr);
+    log_records.emplace_back(txn_id, log_records.size() - 1, LogRecordType::APPLYDELETE, rid, tuple);
+  };
+  log_records.emplace_back(1, INVALID_LSN, LogRecordType::BEGIN);
+  delete_tuple(1, rids[0]);
+  log_records.emplace_back(1, log_records.size() - 1, LogRecordType::COMMIT);
+  log_records.emplace_back(2, INVALID_LSN, LogRecordType::BEGIN);
+  Tuple old_tuple;
+  ASSERT_TRUE(page->UpdateTuple(make_tuple(20), &old_tuple, rids[2], nullptr, nullptr, nullptr));
+  log_records.emplace_back(2, log_records.size() - 1, LogRecordType::UPDATE, rids[2], old_tuple, make_tuple(20));
+  delete_tuple(2, rids[1]);
+  RID rid;
+  ASSERT_TRUE(page->InsertTuple(make_tuple(3), &rid, nullptr, nullptr, nullptr));
+  ASSERT_EQ(rid, rids[0]);
+  log_records.emplace_back(2, log_records.size() - 1, LogRecordType::INSERT, rid, make_tuple(3));
+
+  auto *disk_manager = new DiskManager("test.db");
+  auto *log_manager = new LogManager(disk_manager);
+  log_manager->RunFlushThread();
+  for (auto &log_record : log_records) {
+    log_manager->AppendLogRecord(&log_record);
+  }
+  log_manager->StopFlushThread();
+  delete log_manager;
+
+  // Recover twice, as if the first recovery crashed right after writing out the page it undid. Both times the deleted
+  // tuple is back in its own slot and the loser's insert is gone.
+  for (int i = 0; i < 2; i++) {
+    auto *bpm = new BufferPoolManager(8, disk_manager);
+    auto *log_recovery = new LogRecovery(disk_manager, bpm);
+    log_recovery->Redo();
+    log_recovery->Undo();
+
+    auto *table_page = reinterpret_cast<TablePage *>(bpm->FetchPage(0));
+    int num_tuples = 0;
+    for (bool found = table_page->GetFirstTupleRid(&rid); found; found = table_page->GetNextTupleRid(rid, &rid)) {
+      num_tuples++;
+    }
+    EXPECT_EQ(num_tuples, 2);
+    Tuple tuple;
+    EXPECT_FALSE(table_page->GetTuple(rids[0], &tuple, nullptr, nullptr));
+    for (int a : {1, 2}) {
+      ASSERT_TRUE(table_page->GetTuple(rids[a], &tuple, nullptr, nullptr));
+      EXPECT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), a);
+    }
+    bpm->UnpinPage(0, false);
+    bpm->FlushAllPages();
+
+    delete log_recovery;
+    delete bpm;
+  }
+  disk_manager->ShutDown();
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST_F(RecoveryTest, CompressedDeltaLogTest) {
+  const int num_pages = 8;
+  const int tuples_per_page = 20;
+  const int num_columns = 16;
+
+  std::vector<Column> columns;
+  for (int i = 0; i < num_columns; i++) {
+    columns.emplace_back("col" + std::to_string(i), TypeId::BIGINT);
+  }
+  Schema schema{columns};
+  auto make_tuple = [&](int64_t key, int64_t version) {
+    std::vector<Value> values;
+    for (int i = 0; i < num_columns; i++) {
+      values.emplace_back(TypeId::BIGINT, i == num_columns / 2 ? version : key * num_columns + i);
+    }
+    return Tuple{values, &schema};
+  };
+
+  // Txn 0 fills the pages, txn 1 updates one column of every tuple and commits, txn 2 updates every tuple again but
+  // never commits. The pages never reach the disk and the log holds only compressed blocks.
+  ASSERT_FALSE(enable_logging);
+  std::unique_ptr<Page[]> pages(new Page[num_pages]);
+  auto table_page = [&](int page_id) { return reinterpret_cast<TablePage *>(&pages[page_id]); };
+  std::vector<LogRecord> log_records;
+  std::vector<RID> rids;
+  lsn_t prev_lsn = INVALID_LSN;
+  for (int page_id = 0; page_id < num_pages; page_id++) {
+    table_page(page_id)->Init(page_id, PAGE_SIZE, page_id - 1, nullptr, nullptr);
+    log_records.emplace_back(0, prev_lsn, LogRecordType::NEWPAGE, page_id - 1, page_id);
+    prev_lsn = log_records.size() - 1;
+    for (int i = 0; i < tuples_per_page; i++) {
+      RID rid;
+      Tuple tuple = make_tuple(rids.size(), 0);
+      ASSERT_TRUE(table_page(page_id)->InsertTuple(tuple, &rid, nullptr, nullptr, nullptr));
+      log_records.emplace_back(0, prev_lsn, LogRecordType::INSERT, rid, tuple);
+      prev_lsn = log_records.size() - 1;
+      rids.push_back(rid);
+    }
+  }
+  log_records.emplace_back(0, prev_lsn, LogRecordType::COMMIT);
+  for (txn_id_t txn_id : {1, 2}) {
+    log_records.emplace_back(txn_id, INVALID_LSN, LogRecordType::BEGIN);
+    prev_lsn = log_records.size() - 1;
+    for (size_t key = 0; key < rids.size(); key++) {
+      Tuple old_tuple = make_tuple(key, txn_id - 1);
+      log_records.emplace_back(txn_id, prev_lsn, LogRecordType::DELTA_UPDATE, rids[key], old_tuple,
+                               make_tuple(key, txn_id));
+      ASSERT_EQ(log_records.back().GetLogRecordType(), LogRecordType::DELTA_UPDATE);
+      prev_lsn = log_records.size() - 1;
+    }
+    if (txn_id == 1) {
+      log_records.emplace_back(txn_id, prev_lsn, LogRecordType::COMMIT);
+    }
+  }
+
+  auto *disk_manager = new DiskManager("test.db");
+  auto *log_manager = new LogManager(disk_manager, true);
+  log_manager->RunFlushThread();
+  for (auto &log_record : log_records) {
+    log_manager->AppendLogRecord(&log_record);
+  }
+  log_manager->StopFlushThread();
+  delete log_manager;
+
+  auto *bpm = new BufferPoolManager(num_pages + 8, disk_manager);
+  auto *log_recovery = new LogRecovery(disk_manager, bpm);
+  log_recovery->Redo();
+  log_recovery->Undo();
+
+  for (size_t key = 0; key < rids.size(); key++) {
+    auto *page = reinterpret_cast<TablePage *>(bpm->FetchPage(rids[key].GetPageId()));
+    Tuple tuple;
+    ASSERT_TRUE(page->GetTuple(rids[key], &tuple, nullptr, nullptr));
+    Tuple expected = make_tuple(key, 1);
+    ASSERT_EQ(tuple.GetLength(), expected.GetLength());
+    EXPECT_EQ(memcmp(tuple.GetData(), expected.GetData(), expected.GetLength()), 0);
+    bpm->UnpinPage(rids[key].GetPageId(), false);
+  }
+
+  delete log_recovery;
+  delete bpm;
+  disk_manager->ShutDown();
+  delete disk_manager;
+}
 }  // namespace bustub
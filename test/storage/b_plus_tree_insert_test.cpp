@@ -244,4 +244,59 @@ TEST(BPlusTreeTests, test_insert_out_of_order) {
   delete transaction;
 }
 
+TEST(BPlusTreeTests, BatchedLookupTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+  GenericKey<8> index_key;
+  RID rid;
+  Transaction *transaction = new Transaction(0);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // Only even keys are in the tree, which spans dozens of leaves.
+  for (int64_t key = 0; key < 10000; key += 2) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  // Sorted lookups with duplicates, misses and keys beyond both ends.
+  std::vector<GenericKey<8>> lookup_keys;
+  std::vector<int64_t> lookup_values;
+  for (int64_t key = -3; key < 10010; key++) {
+    for (int copies = key % 5 == 0 ? 2 : 1; copies > 0; copies--) {
+      index_key.SetFromInteger(key);
+      lookup_keys.push_back(index_key);
+      lookup_values.push_back(key);
+    }
+  }
+  std::vector<std::vector<RID>> results;
+  tree.GetValues(lookup_keys, &results, transaction);
+  ASSERT_EQ(results.size(), lookup_keys.size());
+  for (size_t i = 0; i < lookup_keys.size(); i++) {
+    int64_t key = lookup_values[i];
+    if (key >= 0 && key < 10000 && key % 2 == 0) {
+      ASSERT_EQ(results[i].size(), 1);
+      EXPECT_EQ(results[i][0].GetSlotNum(), key);
+    } else {
+      EXPECT_TRUE(results[i].empty()) << key;
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
 }  // namespace bustub
@@ -0,0 +1,241 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_test.cpp
+//
+// Identification: test/storage/compressed_page_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "storage/page/compressed_page.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+const std::vector<std::string> CITIES{"Berlin", "Lisbon", "Oslo", "Pittsburgh"};
+const int64_t START = 1600000000000;
+
+/** A row of an event table: an increasing time and id, a low-cardinality VARCHAR, a DECIMAL and a flag. */
+std::vector<Value> MakeRow(int64_t i) {
+  return {ValueFactory::GetBigIntValue(START + i * 1000), ValueFactory::GetIntegerValue(static_cast<int32_t>(i)),
+          i % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR) : ValueFactory::GetVarcharValue(CITIES[i % 4]),
+          ValueFactory::GetDecimalValue(static_cast<double>(i) / 2),
+          ValueFactory::GetBooleanValue(static_cast<int8_t>(i % 2))};
+}
+
+Schema MakeSchema() {
+  return Schema({Column("ts", TypeId::BIGINT), Column("id", TypeId::INTEGER), Column("city", TypeId::VARCHAR, 16),
+                 Column("score", TypeId::DECIMAL), Column("flag", TypeId::BOOLEAN)});
+}
+
+void ExpectRow(CompressedPage *page, const Schema *schema, uint32_t slot, const std::vector<Value> &row) {
+  Tuple tuple;
+  ASSERT_TRUE(page->GetTuple(RID(page->GetTablePageId(), slot), schema, &tuple));
+  for (uint32_t col_idx = 0; col_idx < schema->GetColumnCount(); col_idx++) {
+    Value value = tuple.GetValue(schema, col_idx);
+    ASSERT_EQ(value.IsNull(), row[col_idx].IsNull());
+    if (!value.IsNull()) {
+      ASSERT_EQ(value.CompareEquals(row[col_idx]), CmpBool::CmpTrue) << slot << " " << col_idx;
+    }
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(CompressedPageTest, BasicTest) {
+  Schema schema = MakeSchema();
+  CompressedPage page{};
+  page.Init(15445, INVALID_PAGE_ID, &schema);
+  EXPECT_EQ(page.GetTablePageId(), 15445);
+  EXPECT_EQ(page.GetNextPageId(), INVALID_PAGE_ID);
+  EXPECT_EQ(page.GetTupleCount(), 0);
+  RID first;
+  EXPECT_FALSE(page.GetFirstTupleRid(&first));
+
+  // The frames and dictionaries grow with the rows, the page being encoded again whenever a row is out of them.
+  std::vector<std::vector<Value>> rows;
+  RID rid;
+  for (int64_t i = 0; i < 100; i++) {
+    rows.push_back(MakeRow(i));
+    ASSERT_TRUE(page.InsertTuple(Tuple(rows.back(), &schema), &schema, &rid));
+    ASSERT_EQ(rid, RID(15445, i));
+  }
+  std::vector<Value> outlier{ValueFactory::GetBigIntValue(0), ValueFactory::GetIntegerValue(-1000000),
+                             ValueFactory::GetVarcharValue("Amsterdam"), ValueFactory::GetDecimalValue(-1.5),
+                             ValueFactory::GetNullValueByType(TypeId::BOOLEAN)};
+  rows.push_back(outlier);
+  ASSERT_TRUE(page.InsertTuple(Tuple(outlier, &schema), &schema, &rid));
+  for (uint32_t slot = 0; slot < rows.size(); slot++) {
+    ExpectRow(&page, &schema, slot, rows[slot]);
+  }
+
+  // Without the outlier, the page holds many more rows than the slotted pages of whole tuples.
+  page.Init(15445, INVALID_PAGE_ID, &schema);
+  rows.clear();
+  for (int64_t i = 0;; i++) {
+    Tuple tuple(MakeRow(i), &schema);
+    if (!page.InsertTuple(tuple, &schema, &rid)) {
+      break;
+    }
+    rows.push_back(MakeRow(i));
+  }
+  EXPECT_EQ(page.GetTupleCount(), rows.size());
+  EXPECT_GT(rows.size(), 2 * PAGE_SIZE / Tuple(MakeRow(1), &schema).GetLength());
+  for (uint32_t slot = 0; slot < rows.size(); slot++) {
+    ExpectRow(&page, &schema, slot, rows[slot]);
+  }
+
+  // A marked tuple is hidden until rolled back, and an applied delete leaves a hole the iteration skips.
+  ASSERT_TRUE(page.MarkDelete(RID(15445, 1)));
+  Tuple tuple;
+  EXPECT_FALSE(page.GetTuple(RID(15445, 1), &schema, &tuple));
+  page.RollbackDelete(RID(15445, 1));
+  ExpectRow(&page, &schema, 1, rows[1]);
+  ASSERT_TRUE(page.MarkDelete(RID(15445, 0)));
+  page.ApplyDelete(RID(15445, 0));
+  EXPECT_FALSE(page.IsLive(0));
+  ASSERT_TRUE(page.GetFirstTupleRid(&first));
+  EXPECT_EQ(first.GetSlotNum(), 1);
+
+  // An update within the frames rewrites the codes of its slot, and one the full page has no room for fails.
+  Tuple old_tuple;
+  ASSERT_TRUE(page.UpdateTuple(Tuple(MakeRow(5), &schema), &old_tuple, RID(15445, 2), &schema));
+  EXPECT_EQ(old_tuple.GetValue(&schema, 1).GetAs<int32_t>(), 2);
+  ExpectRow(&page, &schema, 2, MakeRow(5));
+  ExpectRow(&page, &schema, 3, rows[3]);
+  EXPECT_FALSE(page.UpdateTuple(Tuple(outlier, &schema), &old_tuple, RID(15445, 3), &schema));
+  ExpectRow(&page, &schema, 3, rows[3]);
+  EXPECT_FALSE(page.UpdateTuple(Tuple(MakeRow(5), &schema), &old_tuple, RID(15445, 0), &schema));
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageTest, SelectRangeTest) {
+  Schema schema = MakeSchema();
+  CompressedPage page{};
+  page.Init(15445, INVALID_PAGE_ID, &schema);
+  const uint32_t num_rows = 200;
+  RID rid;
+  for (uint32_t i = 0; i < num_rows; i++) {
+    ASSERT_TRUE(page.InsertTuple(Tuple(MakeRow(i + 10), &schema), &schema, &rid));
+  }
+  ASSERT_TRUE(page.MarkDelete(RID(15445, 20)));
+
+  // Fixed-size columns decode to the values of a tuple, nulls being their sentinels.
+  std::vector<uint32_t> slots{0, 5, 7, 199};
+  std::vector<int64_t> times(slots.size());
+  page.DecodeFixed(&schema, 0, slots.data(), slots.size(), reinterpret_cast<char *>(times.data()));
+  std::vector<int8_t> flags(slots.size());
+  page.DecodeFixed(&schema, 4, slots.data(), slots.size(), reinterpret_cast<char *>(flags.data()));
+  std::vector<double> scores(slots.size());
+  page.DecodeFixed(&schema, 3, slots.data(), slots.size(), reinterpret_cast<char *>(scores.data()));
+  for (size_t i = 0; i < slots.size(); i++) {
+    EXPECT_EQ(times[i], START + (slots[i] + 10) * 1000);
+    EXPECT_EQ(flags[i], static_cast<int8_t>((slots[i] + 10) % 2));
+    EXPECT_EQ(scores[i], static_cast<double>(slots[i] + 10) / 2);
+  }
+
+  // Ranges are filtered on codes, skipping deleted slots and nulls.
+  std::vector<uint32_t> selection(num_rows);
+  Value low = ValueFactory::GetIntegerValue(15);
+  Value high = ValueFactory::GetIntegerValue(40);
+  uint32_t count = page.SelectRange(&schema, 1, &low, false, &high, true, 0, num_rows, selection.data());
+  ASSERT_EQ(count, 24);
+  EXPECT_EQ(selection[0], 6);
+  EXPECT_EQ(selection[9], 15);
+  EXPECT_EQ(selection[13], 19);
+  EXPECT_EQ(selection[14], 21);
+  EXPECT_EQ(page.SelectRange(&schema, 1, nullptr, false, &low, false, 0, num_rows, selection.data()), 5);
+  EXPECT_EQ(page.SelectRange(&schema, 1, &high, true, nullptr, false, 100, num_rows, selection.data()), 100);
+  EXPECT_EQ(selection[0], 100);
+  Value below = ValueFactory::GetIntegerValue(-5);
+  EXPECT_EQ(page.SelectRange(&schema, 1, nullptr, false, &below, true, 0, num_rows, selection.data()), 0);
+  Value time = ValueFactory::GetBigIntValue(START + 12000);
+  EXPECT_EQ(page.SelectRange(&schema, 0, &time, true, &time, true, 0, num_rows, selection.data()), 1);
+  EXPECT_EQ(selection[0], 2);
+
+  // VARCHAR bounds need not be in the dictionary.
+  Value oslo = ValueFactory::GetVarcharValue("Oslo");
+  count = page.SelectRange(&schema, 2, &oslo, true, &oslo, true, 0, num_rows, selection.data());
+  uint32_t expected = 0;
+  for (uint32_t i = 0; i < num_rows; i++) {
+    int64_t id = i + 10;
+    if (i != 20 && id % 7 != 0 && CITIES[id % 4] == "Oslo") {
+      ASSERT_LT(expected, count);
+      EXPECT_EQ(selection[expected++], i);
+    }
+  }
+  EXPECT_EQ(count, expected);
+  Value m = ValueFactory::GetVarcharValue("M");
+  Value p = ValueFactory::GetVarcharValue("P");
+  EXPECT_EQ(page.SelectRange(&schema, 2, &m, true, &p, false, 0, num_rows, selection.data()), count);
+  Value z = ValueFactory::GetVarcharValue("Z");
+  EXPECT_EQ(page.SelectRange(&schema, 2, &z, true, nullptr, false, 0, num_rows, selection.data()), 0);
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageTest, TableHeapTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(8, disk_manager);
+  LockManager lock_manager;
+  TransactionManager txn_mgr(&lock_manager, nullptr);
+  Transaction *txn = txn_mgr.Begin();
+
+  Schema schema = MakeSchema();
+  TableHeap table(bpm, &lock_manager, nullptr, txn, TableLayout::COMPRESSED, &schema);
+  EXPECT_EQ(table.GetLayout(), TableLayout::COMPRESSED);
+
+  const int64_t num_rows = 5000;
+  std::vector<RID> rids;
+  for (int64_t i = 0; i < num_rows; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(Tuple(MakeRow(i), &schema), &rid, txn));
+    rids.push_back(rid);
+  }
+  ASSERT_GT(table.GetPageIds().size(), 2);
+
+  for (int64_t i = 0; i < num_rows; i += 3) {
+    ASSERT_TRUE(table.MarkDelete(rids[i], txn));
+  }
+  txn_mgr.Commit(txn);
+  delete txn;
+
+  // The iterator walks every page in insertion order, skipping the deleted rows.
+  txn = txn_mgr.Begin();
+  int64_t expected = 1;
+  int64_t count = 0;
+  for (auto it = table.Begin(txn); it != table.End(); ++it) {
+    ASSERT_EQ(it->GetValue(&schema, 1).GetAs<int32_t>(), expected);
+    ASSERT_EQ(it->GetValue(&schema, 0).GetAs<int64_t>(), START + expected * 1000);
+    ASSERT_EQ(it->IsNull(&schema, 2), expected % 7 == 0);
+    expected += expected % 3 == 1 ? 1 : 2;
+    count++;
+  }
+  EXPECT_EQ(count, num_rows - (num_rows + 2) / 3);
+  Tuple tuple;
+  EXPECT_FALSE(table.GetTuple(rids[0], &tuple, txn));
+  ASSERT_TRUE(table.GetTuple(rids[1], &tuple, txn));
+  EXPECT_EQ(tuple.GetValue(&schema, 2).ToString(), CITIES[1]);
+  txn_mgr.Commit(txn);
+  delete txn;
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page_test.cpp
+//
+// Identification: test/storage/pax_page_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "storage/page/pax_page.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PaxPageTest, BasicTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 32), Column("c", TypeId::BIGINT)});
+  auto make_tuple = [&](int32_t i) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i),
+                              i % 4 == 0 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                                         : ValueFactory::GetVarcharValue("b" + std::to_string(i)),
+                              ValueFactory::GetBigIntValue(static_cast<int64_t>(i) * 10)};
+    return Tuple(values, &schema);
+  };
+
+  PaxPage page{};
+  page.Init(15445, INVALID_PAGE_ID, &schema);
+  EXPECT_EQ(page.GetTablePageId(), 15445);
+  EXPECT_EQ(page.GetNextPageId(), INVALID_PAGE_ID);
+  EXPECT_EQ(page.GetTupleCount(), 0);
+
+  // The page fills up to its capacity, with room left for the short VARCHARs.
+  uint32_t capacity = PaxPage::Capacity(&schema);
+  ASSERT_GT(capacity, 0);
+  RID rid;
+  for (uint32_t i = 0; i < capacity; i++) {
+    ASSERT_TRUE(page.InsertTuple(make_tuple(i), &schema, &rid));
+    ASSERT_EQ(rid.GetSlotNum(), i);
+  }
+  EXPECT_FALSE(page.InsertTuple(make_tuple(0), &schema, &rid));
+  EXPECT_EQ(page.GetTupleCount(), capacity);
+
+  // Values come back by row, and a fixed-size minipage is a plain array.
+  for (uint32_t i = 0; i < capacity; i++) {
+    Tuple tuple;
+    ASSERT_TRUE(page.GetTuple(RID(15445, i), &schema, &tuple));
+    EXPECT_EQ(tuple.GetRid(), RID(15445, i));
+    EXPECT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), static_cast<int32_t>(i));
+    EXPECT_EQ(tuple.IsNull(&schema, 1), i % 4 == 0);
+    if (i % 4 != 0) {
+      EXPECT_EQ(tuple.GetValue(&schema, 1).ToString(), "b" + std::to_string(i));
+    }
+    EXPECT_EQ(page.GetValue(&schema, i, 2).GetAs<int64_t>(), static_cast<int64_t>(i) * 10);
+    EXPECT_EQ(reinterpret_cast<const int32_t *>(page.GetColumnData(&schema, 0))[i], static_cast<int32_t>(i));
+  }
+
+  // A marked tuple is hidden until rolled back, and an applied delete leaves a hole the iteration skips.
+  ASSERT_TRUE(page.MarkDelete(RID(15445, 1)));
+  Tuple tuple;
+  EXPECT_FALSE(page.GetTuple(RID(15445, 1), &schema, &tuple));
+  page.RollbackDelete(RID(15445, 1));
+  EXPECT_TRUE(page.GetTuple(RID(15445, 1), &schema, &tuple));
+  ASSERT_TRUE(page.MarkDelete(RID(15445, 0)));
+  page.ApplyDelete(RID(15445, 0));
+  EXPECT_FALSE(page.IsLive(0));
+  RID first;
+  ASSERT_TRUE(page.GetFirstTupleRid(&first));
+  EXPECT_EQ(first.GetSlotNum(), 1);
+
+  // An update rewrites every minipage of the slot and returns the old tuple.
+  Tuple old_tuple;
+  ASSERT_TRUE(page.UpdateTuple(make_tuple(1001), &old_tuple, RID(15445, 2), &schema));
+  EXPECT_EQ(old_tuple.GetValue(&schema, 0).GetAs<int32_t>(), 2);
+  ASSERT_TRUE(page.GetTuple(RID(15445, 2), &schema, &tuple));
+  EXPECT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), 1001);
+  EXPECT_EQ(tuple.GetValue(&schema, 1).ToString(), "b1001");
+  EXPECT_EQ(tuple.GetValue(&schema, 2).GetAs<int64_t>(), 10010);
+}
+
+// NOLINTNEXTLINE
+TEST(PaxPageTest, TableHeapTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(8, disk_manager);
+  LockManager lock_manager;
+  TransactionManager txn_mgr(&lock_manager, nullptr);
+  Transaction *txn = txn_mgr.Begin();
+
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 64)});
+  TableHeap table(bpm, &lock_manager, nullptr, txn, TableLayout::PAX, &schema);
+  EXPECT_EQ(table.GetLayout(), TableLayout::PAX);
+
+  // Enough rows for many pages, some with payloads longer than the space reserved for them.
+  const int32_t num_rows = 5000;
+  std::vector<RID> rids;
+  for (int32_t i = 0; i < num_rows; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(i % 60, 'x'))}, &schema);
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(tuple, &rid, txn));
+    rids.push_back(rid);
+  }
+  ASSERT_GT(table.GetPageIds().size(), 2);
+
+  for (int32_t i = 0; i < num_rows; i += 3) {
+    ASSERT_TRUE(table.MarkDelete(rids[i], txn));
+  }
+  txn_mgr.Commit(txn);
+  delete txn;
+
+  // The iterator walks every page in insertion order, skipping the deleted rows.
+  txn = txn_mgr.Begin();
+  int32_t expected = 1;
+  int32_t count = 0;
+  for (auto it = table.Begin(txn); it != table.End(); ++it) {
+    ASSERT_EQ(it->GetValue(&schema, 0).GetAs<int32_t>(), expected);
+    ASSERT_EQ(it->GetValue(&schema, 1).ToString(), std::string(expected % 60, 'x'));
+    expected += expected % 3 == 1 ? 1 : 2;
+    count++;
+  }
+  EXPECT_EQ(count, num_rows - (num_rows + 2) / 3);
+  Tuple tuple;
+  EXPECT_FALSE(table.GetTuple(rids[0], &tuple, txn));
+  ASSERT_TRUE(table.GetTuple(rids[1], &tuple, txn));
+  EXPECT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), 1);
+  txn_mgr.Commit(txn);
+  delete txn;
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -10,16 +10,20 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <string>
 #include <vector>
 
+#include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
 #include "gtest/gtest.h"
 #include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tmp_tuple_run.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(TmpTuplePageTest, DISABLED_BasicTest) {
+TEST(TmpTuplePageTest, BasicTest) {
   // There are many ways to do this assignment, and this is only one of them.
   // If you don't like the TmpTuplePage idea, please feel free to delete this test case entirely.
   // You will get full credit as long as you are correctly using a linear probe hash table.
@@ -48,4 +52,85 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 4), 123);
 }
 
+// NOLINTNEXTLINE
+TEST(TmpTuplePageTest, RunTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  // The run is many times larger than the buffer pool.
+  auto *bpm = new BufferPoolManager(4, disk_manager);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::VARCHAR, 64);
+  Schema schema(columns);
+  auto make_tuple = [&](int i) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(i % 50, 'x'))};
+    return Tuple(values, &schema);
+  };
+
+  const int num_tuples = 20000;
+  TmpTupleRun run(bpm);
+  for (int i = 0; i < num_tuples; i++) {
+    ASSERT_TRUE(run.Append(make_tuple(i)));
+  }
+  run.FinishAppend();
+  EXPECT_EQ(run.GetTupleCount(), num_tuples);
+
+  // Tuples come back in append order, and again after a rewind.
+  for (int pass = 0; pass < 2; pass++) {
+    Tuple tuple;
+    for (int i = 0; i < num_tuples; i++) {
+      ASSERT_TRUE(run.Next(&tuple));
+      ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), i);
+      ASSERT_EQ(tuple.GetValue(&schema, 1).GetLength(), i % 50 + 1);
+    }
+    ASSERT_FALSE(run.Next(&tuple));
+    run.Rewind();
+  }
+
+  // Clearing returns every frame: the whole pool can be pinned again.
+  run.Clear();
+  page_id_t page_id;
+  for (int i = 0; i < 4; i++) {
+    ASSERT_NE(bpm->NewPage(&page_id), nullptr);
+  }
+
+  delete bpm;
+  disk_manager->ShutDown();
+  delete disk_manager;
+  remove("test.db");
+}
+
+// NOLINTNEXTLINE
+TEST(TmpTuplePageTest, OversizedTupleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(4, disk_manager);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::VARCHAR, PAGE_SIZE);
+  Schema schema(columns);
+  auto make_tuple = [&](size_t length) {
+    std::vector<Value> values{ValueFactory::GetVarcharValue(std::string(length, 'x'))};
+    return Tuple(values, &schema);
+  };
+  const size_t overhead = make_tuple(0).GetLength();
+  Tuple largest = make_tuple(TmpTuplePage::MaxTupleLength(PAGE_SIZE) - overhead);
+  ASSERT_EQ(largest.GetLength(), TmpTuplePage::MaxTupleLength(PAGE_SIZE));
+
+  // A tuple that fills a whole page still spills. A longer one is rejected, not reported as a lack of frames.
+  TmpTupleRun run(bpm);
+  ASSERT_TRUE(run.Append(largest));
+  EXPECT_THROW(run.Append(make_tuple(TmpTuplePage::MaxTupleLength(PAGE_SIZE) - overhead + 1)), Exception);
+  run.FinishAppend();
+  EXPECT_EQ(run.GetTupleCount(), 1);
+  Tuple tuple;
+  ASSERT_TRUE(run.Next(&tuple));
+  EXPECT_EQ(tuple.GetLength(), largest.GetLength());
+  run.Clear();
+
+  delete bpm;
+  disk_manager->ShutDown();
+  delete disk_manager;
+  remove("test.db");
+}
+
 }  // namespace bustub
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map_test.cpp
+//
+// Identification: test/storage/zone_map_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/zone_map.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ZoneMapTest, BasicTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 16), Column("c", TypeId::DECIMAL)});
+  ZoneMap zone_map(&schema);
+  for (uint32_t col_idx = 0; col_idx < schema.GetColumnCount(); col_idx++) {
+    EXPECT_TRUE(zone_map.GetMin(col_idx).IsNull());
+    EXPECT_TRUE(zone_map.GetMax(col_idx).IsNull());
+  }
+
+  // Nulls are left out of the ranges, and VARCHARs have none.
+  for (int32_t a : {5, -3, 12, 7}) {
+    Tuple tuple({ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue("b" + std::to_string(a)),
+                 ValueFactory::GetNullValueByType(TypeId::DECIMAL)},
+                &schema);
+    zone_map.Update(tuple, &schema);
+  }
+  EXPECT_EQ(zone_map.GetMin(0).GetAs<int32_t>(), -3);
+  EXPECT_EQ(zone_map.GetMax(0).GetAs<int32_t>(), 12);
+  EXPECT_TRUE(zone_map.GetMin(1).IsNull());
+  EXPECT_TRUE(zone_map.GetMin(2).IsNull());
+
+  Tuple tuple({ValueFactory::GetNullValueByType(TypeId::INTEGER), ValueFactory::GetVarcharValue("x"),
+               ValueFactory::GetDecimalValue(2.5)},
+              &schema);
+  zone_map.Update(tuple, &schema);
+  EXPECT_EQ(zone_map.GetMin(0).GetAs<int32_t>(), -3);
+  EXPECT_EQ(zone_map.GetMax(0).GetAs<int32_t>(), 12);
+  EXPECT_EQ(zone_map.GetMin(2).GetAs<double>(), 2.5);
+  EXPECT_EQ(zone_map.GetMax(2).GetAs<double>(), 2.5);
+}
+
+// NOLINTNEXTLINE
+TEST(ZoneMapTest, TableHeapTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(8, disk_manager);
+  LockManager lock_manager;
+  TransactionManager txn_mgr(&lock_manager, nullptr);
+  Transaction *txn = txn_mgr.Begin();
+
+  // An increasing column, as in a time series, gives every page a range of its own.
+  Schema schema({Column("ts", TypeId::BIGINT), Column("v", TypeId::INTEGER)});
+  TableHeap table(bpm, &lock_manager, nullptr, txn, TableLayout::ROW, &schema);
+  const int64_t num_rows = 2000;
+  std::vector<RID> rids;
+  for (int64_t i = 0; i < num_rows; i++) {
+    Tuple tuple({ValueFactory::GetBigIntValue(i), ValueFactory::GetIntegerValue(static_cast<int32_t>(i % 7))},
+                &schema);
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(tuple, &rid, txn));
+    rids.push_back(rid);
+  }
+  std::vector<page_id_t> page_ids = table.GetPageIds();
+  ASSERT_GT(page_ids.size(), 2);
+  int64_t next_min = 0;
+  for (page_id_t page_id : page_ids) {
+    Value min;
+    Value max;
+    ASSERT_TRUE(table.GetColumnRange(page_id, 0, &min, &max));
+    EXPECT_EQ(min.GetAs<int64_t>(), next_min);
+    EXPECT_GE(max.GetAs<int64_t>(), min.GetAs<int64_t>());
+    next_min = max.GetAs<int64_t>() + 1;
+    ASSERT_TRUE(table.GetColumnRange(page_id, 1, &min, &max));
+    EXPECT_EQ(min.GetAs<int32_t>(), 0);
+    EXPECT_EQ(max.GetAs<int32_t>(), 6);
+  }
+  EXPECT_EQ(next_min, num_rows);
+
+  // An update widens the range of its page, which a delete never narrows.
+  Tuple tuple({ValueFactory::GetBigIntValue(-100), ValueFactory::GetIntegerValue(0)}, &schema);
+  ASSERT_TRUE(table.UpdateTuple(tuple, rids[1], txn));
+  ASSERT_TRUE(table.MarkDelete(rids[0], txn));
+  txn_mgr.Commit(txn);
+  delete txn;
+  Value min;
+  Value max;
+  ASSERT_TRUE(table.GetColumnRange(rids[1].GetPageId(), 0, &min, &max));
+  EXPECT_EQ(min.GetAs<int64_t>(), -100);
+
+  // The pages of a table opened from disk have no zone map.
+  TableHeap reopened(bpm, &lock_manager, nullptr, table.GetFirstPageId(), TableLayout::ROW, &schema);
+  EXPECT_FALSE(reopened.GetColumnRange(page_ids[0], 0, &min, &max));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
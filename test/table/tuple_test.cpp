@@ -14,6 +14,7 @@
 #include <cstdio>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
@@ -21,8 +22,85 @@
 #include "logging/common.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
+// NOLINTNEXTLINE
+TEST(TupleTest, ArenaTupleTest) {
+  Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 16}}};
+  std::vector<Value> values{ValueFactory::GetIntegerValue(15445), ValueFactory::GetVarcharValue("bustub")};
+  Arena arena;
+
+  // A tuple in an arena is a view.
+  Tuple view(values, &schema, &arena);
+  EXPECT_FALSE(view.IsAllocated());
+  EXPECT_EQ(view.GetValue(&schema, 0).GetAs<int32_t>(), 15445);
+  EXPECT_EQ(view.GetValue(&schema, 1).ToString(), "bustub");
+
+  // Moving keeps it a view, copying makes a tuple that owns its data and outlives the arena's memory.
+  Tuple moved(std::move(view));
+  EXPECT_FALSE(moved.IsAllocated());
+  Tuple copy(moved);
+  EXPECT_TRUE(copy.IsAllocated());
+  EXPECT_NE(copy.GetData(), moved.GetData());
+  Tuple assigned;
+  assigned = moved;
+  EXPECT_TRUE(assigned.IsAllocated());
+  Tuple arena_copy(copy, &arena);
+  EXPECT_FALSE(arena_copy.IsAllocated());
+  arena.Reset();
+  Tuple overwrite({ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue("overwritten")}, &schema, &arena);
+  EXPECT_EQ(copy.GetValue(&schema, 0).GetAs<int32_t>(), 15445);
+  EXPECT_EQ(assigned.GetValue(&schema, 1).ToString(), "bustub");
+
+  // Moving an owning tuple hands its data over.
+  char *data = copy.GetData();
+  Tuple owner;
+  owner = std::move(copy);
+  EXPECT_TRUE(owner.IsAllocated());
+  EXPECT_EQ(owner.GetData(), data);
+  EXPECT_EQ(owner.GetValue(&schema, 1).ToString(), "bustub");
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, TupleFormatTest) {
+  std::vector<Column> columns{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 16},
+                              Column{"c", TypeId::BIGINT}, Column{"d", TypeId::BOOLEAN},
+                              Column{"e", TypeId::DECIMAL}, Column{"f", TypeId::VARCHAR, 16}};
+  std::vector<std::vector<Value>> rows{
+      {ValueFactory::GetIntegerValue(1), ValueFactory::GetVarcharValue("b"), ValueFactory::GetBigIntValue(3),
+       ValueFactory::GetBooleanValue(true), ValueFactory::GetDecimalValue(5.5), ValueFactory::GetVarcharValue("ff")},
+      {ValueFactory::GetNullValueByType(TypeId::INTEGER), ValueFactory::GetNullValueByType(TypeId::VARCHAR),
+       ValueFactory::GetBigIntValue(3), ValueFactory::GetNullValueByType(TypeId::BOOLEAN),
+       ValueFactory::GetNullValueByType(TypeId::DECIMAL), ValueFactory::GetVarcharValue("ff")}};
+  std::vector<uint32_t> sizes;
+  for (TupleFormat format : {TupleFormat::PLAIN, TupleFormat::NULL_BITMAP, TupleFormat::COMPACT}) {
+    Schema schema{columns, format};
+    for (const auto &values : rows) {
+      Tuple tuple(values, &schema);
+      sizes.push_back(tuple.GetLength());
+      for (uint32_t i = 0; i < values.size(); i++) {
+        EXPECT_EQ(tuple.IsNull(&schema, i), values[i].IsNull()) << "column " << i;
+        Value value = tuple.GetValue(&schema, i);
+        EXPECT_EQ(value.IsNull(), values[i].IsNull()) << "column " << i;
+        if (!values[i].IsNull()) {
+          EXPECT_EQ(value.CompareEquals(values[i]), CmpBool::CmpTrue) << "column " << i;
+        }
+      }
+    }
+  }
+  // The null bitmap takes a byte for six columns, and a compact tuple leaves its null columns out.
+  EXPECT_EQ(sizes[2], sizes[0] + 1);
+  EXPECT_EQ(sizes[3], sizes[1] + 1);
+  EXPECT_EQ(sizes[4], sizes[2]);
+  Schema schema{columns};
+  uint32_t null_size = sizeof(uint32_t);
+  for (uint32_t i : {0, 1, 3, 4}) {
+    null_size += schema.GetColumn(i).GetFixedLength();
+  }
+  EXPECT_EQ(sizes[5], sizes[3] - null_size);
+}
+
 // NOLINTNEXTLINE
 TEST(TupleTest, DISABLED_TableHeapTest) {
   // test1: parse create sql statement